@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <stdlib.h>
+#include <string.h>
 #include <audioutils/fmsynth.h>
 
 /****************************************************************************
@@ -57,42 +58,147 @@ static void fetch_feedback(FAR fmsynth_op_t *ops)
 }
 
 /****************************************************************************
- * name: update_phase
+ * name: ops_blocksize
+ *
+ * Description:
+ *   Return the number of samples that the operators can render per block.
+ *   An operator fed back from another operator needs that operator's
+ *   output of the previous sample, so such sounds render one sample at a
+ *   time.
+ *
  ****************************************************************************/
 
-static void update_phase(FAR fmsynth_sound_t *snd)
+static int ops_blocksize(FAR fmsynth_op_t *ops)
 {
-  snd->phase_time++;
-  if (snd->phase_time >= max_phase_time)
+  for (; ops != NULL; ops = ops->parallelop)
     {
-      snd->phase_time = 0;
+      if ((ops->feedback_ref != NULL &&
+           ops->feedback_ref != &ops->last_sigval) ||
+          ops_blocksize(ops->cascadeop) == 1)
+        {
+          return 1;
+        }
     }
+
+  return FMSYNTH_BLOCKSIZE;
 }
 
 /****************************************************************************
- * name: sound_modulate
+ * name: sound_render
+ *
+ * Description:
+ *   Render nsamples samples of a sound and add them to mix.  Blocks are
+ *   split where the phase time wraps, because the operators restart their
+ *   phase there.
+ *
  ****************************************************************************/
 
-static int sound_modulate(FAR fmsynth_sound_t *snd)
+static void sound_render(FAR fmsynth_sound_t *snd, FAR int *mix,
+                         int nsamples, int blksize)
 {
-  int out = 0;
+  int opout[FMSYNTH_BLOCKSIZE];
+  int sum[FMSYNTH_BLOCKSIZE];
   FAR fmsynth_op_t *op;
+  int done;
+  int n;
+  int i;
 
-  if (snd->operators == NULL)
+  for (done = 0; done < nsamples; done += n)
     {
-      return out;
+      n = nsamples - done;
+      if (n > blksize)
+        {
+          n = blksize;
+        }
+
+      if (max_phase_time > 0 && n > max_phase_time - snd->phase_time)
+        {
+          n = max_phase_time - snd->phase_time;
+        }
+
+      if (snd->operators != NULL)
+        {
+          fetch_feedback(snd->operators);
+
+          memset(sum, 0, n * sizeof(int));
+          for (op = snd->operators; op != NULL; op = op->parallelop)
+            {
+              fmsynthop_operate_block(op, snd->phase_time, opout, n);
+              for (i = 0; i < n; i++)
+                {
+                  sum[i] += opout[i];
+                }
+            }
+
+          for (i = 0; i < n; i++)
+            {
+              mix[done + i] += sum[i] * snd->volume / FMSYNTH_MAX_VOLUME;
+            }
+        }
+
+      snd->phase_time += n;
+      if (snd->phase_time >= max_phase_time)
+        {
+          snd->phase_time = 0;
+        }
     }
+}
 
-  fetch_feedback(snd->operators);
+/****************************************************************************
+ * name: store_samples
+ *
+ * Description:
+ *   Saturate a block of mixed samples to 16 bits and store them in every
+ *   channel.
+ *
+ ****************************************************************************/
 
-  for (op = snd->operators; op != NULL; op = op->parallelop)
+static FAR int16_t *store_samples(FAR int16_t *sample, FAR const int *mix,
+                                  int nframes, int chnum)
+{
+  int val;
+  int ch;
+  int i;
+
+  for (i = 0; i < nframes; i++)
     {
-      out += fmsynthop_operate(op, snd->phase_time);
+      val = mix[i];
+      val = val > SHRT_MAX ? SHRT_MAX : val < SHRT_MIN ? SHRT_MIN : val;
+
+      for (ch = 0; ch < chnum; ch++)
+        {
+          *sample++ = (int16_t)val;
+        }
     }
 
-  update_phase(snd);
+  return sample;
+}
 
-  return out * snd->volume / FMSYNTH_MAX_VOLUME;
+/****************************************************************************
+ * name: voice_finished
+ *
+ * Description:
+ *   A voice is finished when the envelopes of all of its carriers have
+ *   ended at a zero level.
+ *
+ ****************************************************************************/
+
+static int voice_finished(FAR fmsynth_voice_t *voice)
+{
+  FAR fmsynth_op_t *op;
+  FAR fmsynth_eg_t *eg;
+
+  for (op = voice->sound.operators; op != NULL; op = op->parallelop)
+    {
+      eg = op->eg;
+      if (eg->state != EGSTATE_RELEASED ||
+          eg->state_params[EGSTATE_RELEASED].initval != 0)
+        {
+          return 0;
+        }
+    }
+
+  return 1;
 }
 
 /****************************************************************************
@@ -229,42 +335,230 @@ int fmsynthsnd_add_subsound(FAR fmsynth_sound_t *top,
 
 /****************************************************************************
  * name: fmsynth_rendering
+ *
+ * Description:
+ *   Render all sounds of the list into sample.  Without a tick callback,
+ *   the sounds are rendered FMSYNTH_BLOCKSIZE samples at a time.  With a
+ *   callback, it is called after every frame so that the sounds can be
+ *   changed with single sample accuracy.
+ *
  ****************************************************************************/
 
 int fmsynth_rendering(FAR fmsynth_sound_t *snd,
                       FAR int16_t *sample, int sample_num, int chnum,
                       fmsynth_tickcb_t cb, unsigned long cbarg)
 {
-  int i;
-  int ch;
-  int out;
+  int mix[FMSYNTH_BLOCKSIZE];
+  int nframes;
+  int blksize;
+  int done;
+  int n;
   FAR fmsynth_sound_t *itr;
 
-  for (i = 0; i < sample_num; i += chnum)
+  nframes = sample_num / chnum;
+  blksize = cb != NULL ? 1 : FMSYNTH_BLOCKSIZE;
+
+  for (done = 0; done < nframes; done += n)
     {
-      out = 0;
-      for (itr = snd; itr != NULL; itr = itr->next_sound)
+      n = nframes - done;
+      if (n > blksize)
         {
-          out = out + sound_modulate(itr);
+          n = blksize;
         }
 
-      for (ch = 0; ch < chnum; ch++)
+      memset(mix, 0, n * sizeof(int));
+      for (itr = snd; itr != NULL; itr = itr->next_sound)
         {
-          *sample++ = (int16_t)out;
+          sound_render(itr, mix, n, ops_blocksize(itr->operators));
         }
 
+      sample = store_samples(sample, mix, n, chnum);
+
       if (cb != NULL)
         {
           cb(cbarg);
         }
     }
 
-  if (i > sample_num)
+  /* Return total bytes stored in the buffer */
+
+  return nframes * chnum * sizeof(int16_t);
+}
+
+/****************************************************************************
+ * name: fmsynth_voicepool_initialize
+ *
+ * Description:
+ *   Set up a pool of caller allocated voices.  The caller then attaches an
+ *   operator set to the sound of each voice with
+ *   fmsynthsnd_set_operator().  No memory is allocated while playing.
+ *
+ ****************************************************************************/
+
+int fmsynth_voicepool_initialize(FAR fmsynth_voicepool_t *pool,
+                                 FAR fmsynth_voice_t *voices, int nvoices)
+{
+  int i;
+
+  if (pool == NULL || voices == NULL || nvoices <= 0)
     {
-      i -= chnum;
+      return ERROR;
     }
 
-  /* Return total bytes stored in the buffer */
+  for (i = 0; i < nvoices; i++)
+    {
+      create_fmsynthsnd(&voices[i].sound);
+      voices[i].note   = -1;
+      voices[i].active = 0;
+      voices[i].age    = 0;
+    }
+
+  pool->voices  = voices;
+  pool->nvoices = nvoices;
+  pool->age     = 0;
+
+  return OK;
+}
+
+/****************************************************************************
+ * name: fmsynth_voice_noteon
+ *
+ * Description:
+ *   Start a note.  A voice already playing the same note is restarted.
+ *   Otherwise an idle voice is used, or, when all voices are busy, the
+ *   oldest released voice or finally the oldest playing voice is stolen.
+ *
+ ****************************************************************************/
+
+FAR fmsynth_voice_t *fmsynth_voice_noteon(FAR fmsynth_voicepool_t *pool,
+                                          int note, float freq, float vol)
+{
+  FAR fmsynth_voice_t *voice = NULL;
+  FAR fmsynth_voice_t *oldest = NULL;
+  FAR fmsynth_voice_t *released = NULL;
+  FAR fmsynth_voice_t *v;
+  int i;
+
+  for (i = 0; i < pool->nvoices; i++)
+    {
+      v = &pool->voices[i];
+
+      if (v->note == note)
+        {
+          voice = v;
+          break;
+        }
+
+      if (!v->active)
+        {
+          if (voice == NULL)
+            {
+              voice = v;
+            }
+        }
+      else if (v->note < 0)
+        {
+          if (released == NULL || v->age < released->age)
+            {
+              released = v;
+            }
+        }
+      else if (oldest == NULL || v->age < oldest->age)
+        {
+          oldest = v;
+        }
+    }
+
+  if (voice == NULL)
+    {
+      voice = released != NULL ? released : oldest;
+    }
+
+  voice->note   = note;
+  voice->active = 1;
+  voice->age    = ++pool->age;
+
+  voice->sound.phase_time = 0;
+  fmsynthsnd_set_volume(&voice->sound, vol);
+  fmsynthsnd_set_soundfreq(&voice->sound, freq);
+
+  return voice;
+}
+
+/****************************************************************************
+ * name: fmsynth_voice_noteoff
+ *
+ * Description:
+ *   Release a note.  The voice is free for reuse once its envelopes have
+ *   ended.
+ *
+ ****************************************************************************/
+
+void fmsynth_voice_noteoff(FAR fmsynth_voicepool_t *pool, int note)
+{
+  FAR fmsynth_voice_t *voice;
+  int i;
+
+  for (i = 0; i < pool->nvoices; i++)
+    {
+      voice = &pool->voices[i];
+      if (voice->note == note)
+        {
+          fmsynthsnd_stop(&voice->sound);
+          voice->note = -1;
+        }
+    }
+}
+
+/****************************************************************************
+ * name: fmsynth_voicepool_rendering
+ *
+ * Description:
+ *   Render and mix all sounding voices of the pool.  Idle voices cost
+ *   nothing.  Notes may be started and released between calls.
+ *
+ ****************************************************************************/
+
+int fmsynth_voicepool_rendering(FAR fmsynth_voicepool_t *pool,
+                                FAR int16_t *sample, int sample_num,
+                                int chnum)
+{
+  int mix[FMSYNTH_BLOCKSIZE];
+  FAR fmsynth_voice_t *voice;
+  int nframes;
+  int done;
+  int n;
+  int i;
+
+  nframes = sample_num / chnum;
+
+  for (done = 0; done < nframes; done += n)
+    {
+      n = nframes - done;
+      if (n > FMSYNTH_BLOCKSIZE)
+        {
+          n = FMSYNTH_BLOCKSIZE;
+        }
+
+      memset(mix, 0, n * sizeof(int));
+      for (i = 0; i < pool->nvoices; i++)
+        {
+          voice = &pool->voices[i];
+          if (voice->active)
+            {
+              sound_render(&voice->sound, mix, n,
+                           ops_blocksize(voice->sound.operators));
+
+              if (voice_finished(voice))
+                {
+                  voice->active = 0;
+                  voice->note   = -1;
+                }
+            }
+        }
+
+      sample = store_samples(sample, mix, n, chnum);
+    }
 
-  return i * sizeof(int16_t);
+  return nframes * chnum * sizeof(int16_t);
 }
@@ -24,6 +24,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
 #include <stdlib.h>
 #include <limits.h>
 
@@ -207,3 +208,90 @@ int fmsyntheg_operate(FAR fmsynth_eg_t *eg)
 
   return val;
 }
+
+/****************************************************************************
+ * name: fmsyntheg_operate_block
+ *
+ * Description:
+ *   Produce the next nsamples envelope values.  The result is identical to
+ *   calling fmsyntheg_operate() nsamples times, but the linear segments
+ *   are interpolated incrementally instead of with a division per sample.
+ *
+ ****************************************************************************/
+
+void fmsyntheg_operate_block(FAR fmsynth_eg_t *eg, FAR int *out,
+                             int nsamples)
+{
+  FAR fmsynth_egparam_t *param;
+  int i = 0;
+  int cnt;
+  int step;
+  int rest;
+  int quot;
+  int rem;
+  int sign;
+
+  while (i < nsamples)
+    {
+      param = &eg->state_params[eg->state];
+
+      if (eg->state == EGSTATE_RELEASED)
+        {
+          for (; i < nsamples; i++)
+            {
+              out[i] = param->initval;
+            }
+
+          break;
+        }
+
+      if (eg->state_counter >= param->period)
+        {
+          eg->state_counter = 0;
+
+          do
+            {
+              eg->state++;
+            }
+          while (eg->state < EGSTATE_RELEASED
+               && eg->state_params[eg->state].period == 0);
+
+          out[i++] = eg->state_params[eg->state].initval;
+          continue;
+        }
+
+      cnt = param->period - eg->state_counter;
+      if (cnt > nsamples - i)
+        {
+          cnt = nsamples - i;
+        }
+
+      /* initval + diff2next * counter / period, with the quotient of
+       * |diff2next| * counter kept as a running quotient and remainder.
+       * Division truncates towards zero, so the sign is applied last.
+       */
+
+      sign = param->diff2next < 0 ? -1 : 1;
+      step = param->diff2next * sign;
+      quot = step / param->period;
+      rest = step % param->period;
+
+      rem  = (int)(((int64_t)step * eg->state_counter) % param->period);
+      step = (int)(((int64_t)step * eg->state_counter) / param->period);
+
+      eg->state_counter += cnt;
+
+      while (cnt-- > 0)
+        {
+          out[i++] = param->initval + sign * step;
+
+          step += quot;
+          rem  += rest;
+          if (rem >= param->period)
+            {
+              rem -= param->period;
+              step++;
+            }
+        }
+    }
+}
@@ -34,6 +34,16 @@
 #define PHASE_ADJUST(th) \
         (((th) < 0 ? (FMSYNTH_PI) - (th) : (th)) % (FMSYNTH_PI * 2))
 
+/* Full-turn sine table of 1024 segments, one entry per 128 phase units,
+ * plus one extra entry closing the last segment.  It is not a plain
+ * lookup: table_sin() and the block renderer interpolate linearly between
+ * the two entries around the phase.
+ */
+
+#define WAVETBL_SHIFT (7)
+#define WAVETBL_SIZE  ((FMSYNTH_PI * 2) >> WAVETBL_SHIFT)
+#define WAVETBL_MASK  ((1 << WAVETBL_SHIFT) - 1)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -112,6 +122,7 @@ static const short s_sintbl[] =
   0x7fff, /* Extra data for linear completion */
 };
 
+static short s_wavetbl[WAVETBL_SIZE + 1];
 static int local_fs;
 
 /****************************************************************************
@@ -152,6 +163,46 @@ static int pseudo_sin256(int theta)
   return phase & 0x02 ? -short_sin : short_sin;
 }
 
+/****************************************************************************
+ * name: build_wavetbl
+ ****************************************************************************/
+
+static void build_wavetbl(void)
+{
+  int i;
+
+  if (s_wavetbl[WAVETBL_SIZE / 4] != 0)
+    {
+      return;
+    }
+
+  for (i = 0; i <= WAVETBL_SIZE; i++)
+    {
+      s_wavetbl[i] = pseudo_sin256(i << WAVETBL_SHIFT);
+    }
+}
+
+/****************************************************************************
+ * name: table_sin
+ *
+ * Description:
+ *   Same as pseudo_sin256() but interpolates a full-turn table, so that
+ *   there is no quadrant logic.  The block renderer uses the same
+ *   computation.
+ *
+ ****************************************************************************/
+
+static int table_sin(int theta)
+{
+  int idx;
+
+  theta = PHASE_ADJUST(theta);
+  idx   = theta >> WAVETBL_SHIFT;
+
+  return s_wavetbl[idx] + (((s_wavetbl[idx + 1] - s_wavetbl[idx]) *
+                            (theta & WAVETBL_MASK)) >> WAVETBL_SHIFT);
+}
+
 /****************************************************************************
  * name: triangle_wave
  ****************************************************************************/
@@ -220,14 +271,113 @@ static int square_wave(int theta)
 
 static void update_parameters(FAR fmsynth_op_t *op)
 {
+  float turns;
+
   if (local_fs != 0)
     {
-      op->delta_phase = 2 * FMSYNTH_PI * op->sound_freq * op->freq_rate
-                        / (float)local_fs;
+      /* Fraction of a turn per sample.  A whole turn is 2^32 in the
+       * Q15 phase accumulator.
+       */
+
+      turns = op->sound_freq * op->freq_rate / (float)local_fs;
+      turns = turns - (float)(int)turns;
+      op->delta_phase = (uint32_t)(turns * 4294967296.f);
+    }
+  else
+    {
+      op->delta_phase = 0;
+    }
+}
+
+/****************************************************************************
+ * name: adjust_block
+ *
+ * Description:
+ *   Apply PHASE_ADJUST() to a block of phases.  2 * FMSYNTH_PI is a power
+ *   of two, so the modulo is a mask and the loop has no branches.
+ *
+ ****************************************************************************/
+
+static void adjust_block(FAR int *phase, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      int th = phase[i];
+      phase[i] = (th < 0 ? FMSYNTH_PI - th : th) & (FMSYNTH_PI * 2 - 1);
+    }
+}
+
+/****************************************************************************
+ * name: wave_block
+ *
+ * Description:
+ *   Replace a block of phases with the waveform values of the operator.
+ *   The built-in waveforms are computed with straight loops that the
+ *   compiler can vectorize; other generators are called per sample.
+ *
+ ****************************************************************************/
+
+static void wave_block(FAR fmsynth_op_t *op, FAR int *phase, int n)
+{
+  static const int tri_base[4] =
+  {
+    0, SHRT_MAX, 0, -SHRT_MAX
+  };
+
+  static const int tri_slope[4] =
+  {
+    SHRT_MAX, -SHRT_MAX, -SHRT_MAX, SHRT_MAX
+  };
+
+  int i;
+
+  if (op->wavegen == table_sin)
+    {
+      adjust_block(phase, n);
+      for (i = 0; i < n; i++)
+        {
+          int idx = phase[i] >> WAVETBL_SHIFT;
+          int val = s_wavetbl[idx];
+
+          phase[i] = val + (((s_wavetbl[idx + 1] - val) *
+                             (phase[i] & WAVETBL_MASK)) >> WAVETBL_SHIFT);
+        }
+    }
+  else if (op->wavegen == triangle_wave)
+    {
+      adjust_block(phase, n);
+      for (i = 0; i < n; i++)
+        {
+          int quad = phase[i] >> 15;
+          int offs = phase[i] & (FMSYNTH_PI / 2 - 1);
+
+          phase[i] = tri_base[quad] + ((tri_slope[quad] * offs) >> 15);
+        }
+    }
+  else if (op->wavegen == sawtooth_wave)
+    {
+      adjust_block(phase, n);
+      for (i = 0; i < n; i++)
+        {
+          phase[i] = (phase[i] >> 1) - SHRT_MAX;
+        }
+    }
+  else if (op->wavegen == square_wave)
+    {
+      adjust_block(phase, n);
+      for (i = 0; i < n; i++)
+        {
+          phase[i] = phase[i] < FMSYNTH_PI ? SHRT_MAX : -SHRT_MAX;
+        }
     }
   else
     {
-      op->delta_phase = 0.f;
+      for (i = 0; i < n; i++)
+        {
+          phase[i] = op->wavegen(phase[i]);
+        }
     }
 }
 
@@ -247,6 +397,7 @@ int fmsynthop_set_samplerate(int fs)
     }
 
   local_fs = fs;
+  build_wavetbl();
   return OK;
 }
 
@@ -271,8 +422,8 @@ FAR fmsynth_op_t *create_fmsynthop(FAR fmsynth_op_t *op,
       op->last_sigval   = 0;
       op->freq_rate     = 1.f;
       op->sound_freq    = 0.f;
-      op->delta_phase   = 0.f;
-      op->current_phase = 0.f;
+      op->delta_phase   = 0;
+      op->current_phase = 0;
     }
 
   return op;
@@ -334,7 +485,8 @@ int fmsynthop_select_opfunc(FAR fmsynth_op_t *op, int type)
       switch (type)
         {
           case FMSYNTH_OPFUNC_SIN:
-            op->wavegen = pseudo_sin256;
+            build_wavetbl();
+            op->wavegen = table_sin;
             ret = OK;
             break;
 
@@ -520,18 +672,13 @@ void fmsynthop_stop(FAR fmsynth_op_t *op)
 
 int fmsynthop_operate(FAR fmsynth_op_t *op, int phase_time)
 {
-  int val;
-  int val2;
   int phase;
   FAR fmsynth_op_t *subop;
 
-  op->current_phase = phase_time ? op->current_phase + op->delta_phase : 0.f;
+  op->current_phase = phase_time ? op->current_phase + op->delta_phase : 0;
 
-  val = (int)op->current_phase;
-  val2 = (val / (2 * FMSYNTH_PI));
-
-  phase = (int)val + op->feedback_val;
-  op->current_phase = op->current_phase - (float)(val2 * (2 * FMSYNTH_PI));
+  phase = (int)(op->current_phase >> FMSYNTH_PHASE_FRACBITS)
+        + op->feedback_val;
 
   subop = op->cascadeop;
 
@@ -546,3 +693,84 @@ int fmsynthop_operate(FAR fmsynth_op_t *op, int phase_time)
 
   return op->last_sigval;
 }
+
+/****************************************************************************
+ * name: fmsynthop_operate_block
+ *
+ * Description:
+ *   Render nsamples (at most FMSYNTH_BLOCKSIZE) samples of the operator
+ *   and its cascaded operators into out.  phase_time is the time of the
+ *   first sample; the phase restarts if it is zero.  The result matches
+ *   nsamples calls of fmsynthop_operate() as long as the feedback source
+ *   of the operator is the operator itself, or nsamples is one:  Other
+ *   feedback sources are only sampled at the start of the block.
+ *
+ * Returned Value:
+ *   The last sample of the block.
+ *
+ ****************************************************************************/
+
+int fmsynthop_operate_block(FAR fmsynth_op_t *op, int phase_time,
+                            FAR int *out, int nsamples)
+{
+  int phase[FMSYNTH_BLOCKSIZE];
+  int env[FMSYNTH_BLOCKSIZE];
+  FAR fmsynth_op_t *subop;
+  uint32_t acc;
+  int fb;
+  int i;
+
+  /* Own phase of each sample */
+
+  acc = phase_time ? op->current_phase + op->delta_phase : 0;
+  for (i = 0; i < nsamples; i++)
+    {
+      phase[i] = (int)((acc + (uint32_t)i * op->delta_phase)
+                       >> FMSYNTH_PHASE_FRACBITS);
+    }
+
+  op->current_phase = acc + (uint32_t)(nsamples - 1) * op->delta_phase;
+
+  /* Add the modulation of the cascaded operators, using env as scratch */
+
+  for (subop = op->cascadeop; subop != NULL; subop = subop->parallelop)
+    {
+      fmsynthop_operate_block(subop, phase_time, env, nsamples);
+      for (i = 0; i < nsamples; i++)
+        {
+          phase[i] += env[i];
+        }
+    }
+
+  fmsyntheg_operate_block(op->eg, env, nsamples);
+
+  if (op->feedback_ref == &op->last_sigval)
+    {
+      /* Self feedback depends on the previous output sample */
+
+      fb = op->feedback_val;
+      for (i = 0; i < nsamples; i++)
+        {
+          out[i] = env[i] * op->wavegen(phase[i] + fb)
+                 / FMSYNTH_MAX_EGLEVEL;
+          fb = out[i] * op->feedbackrate / FMSYNTH_MAX_EGLEVEL;
+        }
+    }
+  else
+    {
+      for (i = 0; i < nsamples; i++)
+        {
+          phase[i] += op->feedback_val;
+        }
+
+      wave_block(op, phase, nsamples);
+
+      for (i = 0; i < nsamples; i++)
+        {
+          out[i] = env[i] * phase[i] / FMSYNTH_MAX_EGLEVEL;
+        }
+    }
+
+  op->last_sigval = out[nsamples - 1];
+  return op->last_sigval;
+}
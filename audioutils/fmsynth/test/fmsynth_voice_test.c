@@ -0,0 +1,273 @@
+/****************************************************************************
+ * apps/audioutils/fmsynth/test/fmsynth_voice_test.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include <audioutils/fmsynth_eg.h>
+#include <audioutils/fmsynth_op.h>
+#include <audioutils/fmsynth.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FS          (48000)
+#define VOICE_NUM   (16)
+#define CHANNEL_NUM (2)
+#define BUFF_FRAMES (480)
+#define BENCH_SEC   (2)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct voiceops_s
+{
+  fmsynth_op_t carrier;
+  fmsynth_op_t modulator;
+  fmsynth_eg_t careg;
+  fmsynth_eg_t modeg;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static fmsynth_voice_t g_voices[VOICE_NUM];
+static struct voiceops_s g_ops[VOICE_NUM];
+static fmsynth_voicepool_t g_pool;
+
+static int16_t g_block[FS];
+static int16_t g_ticked[FS];
+static int16_t g_buff[BUFF_FRAMES * CHANNEL_NUM];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * name: set_levels
+ ****************************************************************************/
+
+static void set_levels(fmsynth_eglevels_t *level, float atk, float sus,
+                       int rel_ms)
+{
+  level->attack.level = atk;
+  level->attack.period_ms = 5;
+  level->decaybrk.level = sus;
+  level->decaybrk.period_ms = 20;
+  level->decay.level = sus;
+  level->decay.period_ms = 0;
+  level->sustain.level = sus;
+  level->sustain.period_ms = 3000;
+  level->release.level = 0.f;
+  level->release.period_ms = rel_ms;
+}
+
+/****************************************************************************
+ * name: setup_ops
+ *
+ * Description:
+ *   A two operator patch:  A self feedback sine modulating a sine carrier.
+ *
+ ****************************************************************************/
+
+static fmsynth_op_t *setup_ops(struct voiceops_s *ops)
+{
+  fmsynth_eglevels_t levels;
+
+  create_fmsynthop(&ops->carrier, create_fmsyntheg(&ops->careg));
+  create_fmsynthop(&ops->modulator, create_fmsyntheg(&ops->modeg));
+
+  set_levels(&levels, 0.9f, 0.6f, 50);
+  fmsynthop_set_envelope(&ops->carrier, &levels);
+  fmsynthop_select_opfunc(&ops->carrier, FMSYNTH_OPFUNC_SIN);
+
+  set_levels(&levels, 1.f, 0.4f, 50);
+  fmsynthop_set_envelope(&ops->modulator, &levels);
+  fmsynthop_select_opfunc(&ops->modulator, FMSYNTH_OPFUNC_SIN);
+  fmsynthop_set_soundfreqrate(&ops->modulator, 2.f);
+  fmsynthop_bind_feedback(&ops->modulator, &ops->modulator, 0.4f);
+
+  fmsynthop_cascade_subop(&ops->carrier, &ops->modulator);
+
+  return &ops->carrier;
+}
+
+/****************************************************************************
+ * name: dummy_tick
+ ****************************************************************************/
+
+static void dummy_tick(unsigned long arg)
+{
+  (*(int *)arg)++;
+}
+
+/****************************************************************************
+ * name: block_test
+ *
+ * Description:
+ *   Block rendering must give exactly the same samples as rendering one
+ *   frame per tick.
+ *
+ ****************************************************************************/
+
+static int block_test(void)
+{
+  fmsynth_sound_t snd;
+  int ticks = 0;
+  int i;
+
+  create_fmsynthsnd(&snd);
+  fmsynthsnd_set_operator(&snd, setup_ops(&g_ops[0]));
+  fmsynthsnd_set_soundfreq(&snd, 440.f);
+  fmsynth_rendering(&snd, g_block, FS, 1, NULL, 0);
+
+  create_fmsynthsnd(&snd);
+  fmsynthsnd_set_operator(&snd, setup_ops(&g_ops[0]));
+  fmsynthsnd_set_soundfreq(&snd, 440.f);
+  fmsynth_rendering(&snd, g_ticked, FS, 1, dummy_tick,
+                    (unsigned long)&ticks);
+
+  for (i = 0; i < FS; i++)
+    {
+      if (g_block[i] != g_ticked[i])
+        {
+          printf("Block test: FAIL at %d: %d != %d\n",
+                 i, g_block[i], g_ticked[i]);
+          return 1;
+        }
+    }
+
+  printf("Block test: PASS (%d ticks)\n", ticks);
+  return ticks != FS;
+}
+
+/****************************************************************************
+ * name: steal_test
+ ****************************************************************************/
+
+static int steal_test(void)
+{
+  fmsynth_voice_t *first;
+  fmsynth_voice_t *v;
+  int i;
+
+  first = fmsynth_voice_noteon(&g_pool, 0, 110.f, 0.1f);
+  for (i = 1; i < VOICE_NUM; i++)
+    {
+      fmsynth_voice_noteon(&g_pool, i, 110.f + 10 * i, 0.1f);
+    }
+
+  /* The pool is full.  A released voice is taken before the oldest. */
+
+  fmsynth_voice_noteoff(&g_pool, 5);
+  v = fmsynth_voice_noteon(&g_pool, 100, 220.f, 0.1f);
+  if (v != &g_voices[5])
+    {
+      printf("Steal test: FAIL, released voice not reused\n");
+      return 1;
+    }
+
+  v = fmsynth_voice_noteon(&g_pool, 101, 220.f, 0.1f);
+  if (v != first)
+    {
+      printf("Steal test: FAIL, oldest voice not stolen\n");
+      return 1;
+    }
+
+  printf("Steal test: PASS\n");
+  return 0;
+}
+
+/****************************************************************************
+ * name: bench_test
+ ****************************************************************************/
+
+static void bench_test(void)
+{
+  struct timespec start;
+  struct timespec end;
+  double elapsed;
+  int i;
+
+  for (i = 0; i < VOICE_NUM; i++)
+    {
+      fmsynth_voice_noteon(&g_pool, i, 110.f * (1 + i / 4.f), 0.06f);
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (i = 0; i < BENCH_SEC * FS / BUFF_FRAMES; i++)
+    {
+      fmsynth_voicepool_rendering(&g_pool, g_buff,
+                                  BUFF_FRAMES * CHANNEL_NUM, CHANNEL_NUM);
+    }
+
+  clock_gettime(CLOCK_MONOTONIC, &end);
+
+  elapsed = (end.tv_sec - start.tv_sec) +
+            (end.tv_nsec - start.tv_nsec) / 1e9;
+  printf("Bench: %d voices, %d Hz, %d s rendered in %.3f s (%.1f%% CPU)\n",
+         VOICE_NUM, FS, BENCH_SEC, elapsed, elapsed * 100. / BENCH_SEC);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * name: main
+ ****************************************************************************/
+
+int main(void)
+{
+  int ret = 0;
+  int i;
+
+  fmsynth_initialize(FS);
+
+  ret += block_test();
+
+  fmsynth_voicepool_initialize(&g_pool, g_voices, VOICE_NUM);
+  for (i = 0; i < VOICE_NUM; i++)
+    {
+      fmsynthsnd_set_operator(&g_voices[i].sound, setup_ops(&g_ops[i]));
+    }
+
+  ret += steal_test();
+
+  for (i = 0; i < 128; i++)
+    {
+      fmsynth_voice_noteoff(&g_pool, i);
+    }
+
+  bench_test();
+
+  return ret;
+}
@@ -29,9 +29,13 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <mqueue.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
 #include <sys/ioctl.h>
 #include <nuttx/audio/audio.h>
 
@@ -43,10 +47,67 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#define NXAUDIO_RENDER_MINBUFS  2
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nxaudio_render_s
+{
+  pthread_t        thread;
+  nxaudio_render_t render;
+  unsigned long    arg;
+  int              framesize;     /* Bytes per frame */
+  int              nbufs;         /* Buffers allocated */
+  int              target;        /* Buffers to keep queued */
+  int              inflight;      /* Buffers queued in the driver */
+  int              nfree;         /* Entries of freebufs */
+  bool             draining;      /* Last buffer is queued */
+  uint64_t         playend;       /* When the driver runs out, in us */
+  FAR struct ap_buffer_s **freebufs;
+  FAR struct timespec *enqtime;   /* Enqueue time, by index in abufs */
+  struct nxaudio_stats_s stats;
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * name: elapsed_us
+ ****************************************************************************/
+
+static uint32_t elapsed_us(FAR const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1000000 +
+         (now.tv_nsec - start->tv_nsec) / 1000;
+}
+
+/****************************************************************************
+ * name: now_us
+ ****************************************************************************/
+
+static uint64_t now_us(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * name: frames_us
+ ****************************************************************************/
+
+static uint64_t frames_us(FAR struct nxaudio_s *nxaudio, int nframes)
+{
+  return (uint64_t)nframes * 1000000 / nxaudio->fs;
+}
+
 /****************************************************************************
  * name: configure_audio
  ****************************************************************************/
@@ -104,6 +165,10 @@ static FAR struct ap_buffer_s **create_audio_buffers(int fd, int num, int sz)
   FAR struct ap_buffer_s **ret;
 
   ret = (FAR struct ap_buffer_s **)calloc(num, sizeof(FAR void *));
+  if (ret == NULL)
+    {
+      return NULL;
+    }
 
   for (i = 0; i < num; i++)
     {
@@ -138,6 +203,197 @@ static void free_audio_buffers(FAR struct nxaudio_s *nxaudio)
   free(nxaudio->abufs);
 }
 
+/****************************************************************************
+ * name: render_buffer
+ *
+ * Description:
+ *   Fill a free buffer through the render callback and queue it.  Returns
+ *   the number of frames queued or a negated errno value.
+ *
+ ****************************************************************************/
+
+static int render_buffer(FAR struct nxaudio_s *nxaudio)
+{
+  FAR struct nxaudio_render_s *r = nxaudio->render;
+  FAR struct ap_buffer_s *apb;
+  struct timespec start;
+  uint32_t us;
+  int nframes;
+  int ret;
+  int i;
+
+  apb = r->freebufs[--r->nfree];
+  nframes = apb->nmaxbytes / r->framesize;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = r->render(r->arg, apb->samp, nframes);
+  us = elapsed_us(&start);
+  if (us > r->stats.maxrender_us)
+    {
+      r->stats.maxrender_us = us;
+    }
+
+  if (ret < 0)
+    {
+      r->freebufs[r->nfree++] = apb;
+      return ret;
+    }
+
+  apb->nbytes  = ret * r->framesize;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  if (ret < nframes)
+    {
+      apb->flags |= AUDIO_APB_FINAL;
+      r->draining = true;
+    }
+
+  for (i = 0; i < nxaudio->abufnum; i++)
+    {
+      if (nxaudio->abufs[i] == apb)
+        {
+          clock_gettime(CLOCK_MONOTONIC, &r->enqtime[i]);
+          break;
+        }
+    }
+
+  ret = nxaudio_enqbuffer(nxaudio, apb);
+  if (ret < 0)
+    {
+      r->freebufs[r->nfree++] = apb;
+      return -errno;
+    }
+
+  r->inflight++;
+  nframes = apb->nbytes / r->framesize;
+
+  /* Queued after the driver played everything it had: an xrun.  Keep one
+   * buffer more queued from now on.
+   */
+
+  if (r->playend != 0)
+    {
+      uint64_t now = now_us();
+
+      if (now > r->playend)
+        {
+          r->stats.xruns++;
+          r->playend = now;
+          if (r->target < r->nbufs)
+            {
+              r->target++;
+              r->stats.nbuffers = r->target;
+            }
+        }
+
+      r->playend += frames_us(nxaudio, nframes);
+    }
+
+  return nframes;
+}
+
+/****************************************************************************
+ * name: render_dequeued
+ *
+ * Description:
+ *   Take back a buffer the driver has played.  The buffers still queued
+ *   last at most until playend, which render_buffer() uses to detect
+ *   xruns; re-anchoring it here keeps the estimate from drifting away from
+ *   the driver's clock.
+ *
+ ****************************************************************************/
+
+static void render_dequeued(FAR struct nxaudio_s *nxaudio,
+                            FAR struct ap_buffer_s *apb)
+{
+  FAR struct nxaudio_render_s *r = nxaudio->render;
+  int i;
+
+  for (i = 0; i < nxaudio->abufnum; i++)
+    {
+      if (nxaudio->abufs[i] == apb)
+        {
+          r->stats.latency_us = elapsed_us(&r->enqtime[i]);
+          if (r->stats.latency_us > r->stats.maxlatency_us)
+            {
+              r->stats.maxlatency_us = r->stats.latency_us;
+            }
+
+          break;
+        }
+    }
+
+  r->freebufs[r->nfree++] = apb;
+  r->inflight--;
+  r->playend = now_us() + frames_us(nxaudio, r->inflight * r->stats.nframes);
+}
+
+/****************************************************************************
+ * name: render_thread
+ ****************************************************************************/
+
+static FAR void *render_thread(pthread_addr_t arg)
+{
+  FAR struct nxaudio_s *nxaudio = (FAR struct nxaudio_s *)arg;
+  FAR struct nxaudio_render_s *r = nxaudio->render;
+  struct audio_msg_s msg;
+  bool running = true;
+  unsigned int prio;
+  ssize_t size;
+
+  /* Queue the initial buffers before the driver starts pulling */
+
+  while (!r->draining && r->inflight < r->target && r->nfree > 0)
+    {
+      if (render_buffer(nxaudio) < 0)
+        {
+          break;
+        }
+    }
+
+  nxaudio_start(nxaudio);
+  r->playend = now_us() + frames_us(nxaudio, r->inflight * r->stats.nframes);
+
+  while (running)
+    {
+      size = mq_receive(nxaudio->mq, (FAR char *)&msg, sizeof(msg), &prio);
+      if (size != sizeof(msg))
+        {
+          continue;
+        }
+
+      switch (msg.msg_id)
+        {
+          case AUDIO_MSG_DEQUEUE:
+            render_dequeued(nxaudio, msg.u.ptr);
+            while (!r->draining && r->inflight < r->target && r->nfree > 0)
+              {
+                if (render_buffer(nxaudio) < 0)
+                  {
+                    /* The application wants to stop now.  The driver
+                     * reports completion once it has stopped.
+                     */
+
+                    r->draining = true;
+                    ioctl(nxaudio->fd, AUDIOIOC_STOP, 0);
+                  }
+              }
+            break;
+
+          case AUDIO_MSG_COMPLETE:
+          case AUDIO_MSG_STOP:
+            running = false;
+            break;
+
+          default:
+            break;
+        }
+    }
+
+  return NULL;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -193,6 +449,9 @@ int init_nxaudio_devname(FAR struct nxaudio_s *nxaudio,
       configure_audio(nxaudio->fd, chnum, fs, bps, 0);
 
       nxaudio->chnum = chnum;
+      nxaudio->fs = fs;
+      nxaudio->bps = bps;
+      nxaudio->render = NULL;
 
       ioctl(nxaudio->fd, AUDIOIOC_GETBUFFERINFO,
             (unsigned long)(uintptr_t)&buf_info);
@@ -351,3 +610,178 @@ int nxaudio_msgloop(FAR struct nxaudio_s *nxaudio,
 
   return 0;
 }
+
+/****************************************************************************
+ * name: nxaudio_render_start
+ *
+ * Description:
+ *   Start playback in the pull model: a real-time thread calls the render
+ *   callback whenever the driver hands back a buffer.  The buffers are
+ *   reallocated so that two of them hold latency_us of audio.  Each time
+ *   the driver runs dry, one more buffer is kept queued, up to
+ *   CONFIG_AUDIOUTILS_NXAUDIO_RENDER_MAXBUFS.
+ *
+ ****************************************************************************/
+
+int nxaudio_render_start(FAR struct nxaudio_s *nxaudio,
+                         uint32_t latency_us, nxaudio_render_t render,
+                         unsigned long arg)
+{
+  FAR struct nxaudio_render_s *r;
+#ifdef AUDIOIOC_SETBUFFERINFO
+  struct ap_buffer_info_s buf_info;
+#endif
+  struct sched_param sparam;
+  pthread_attr_t tattr;
+  int nframes;
+  int ret;
+  int i;
+
+  if (render == NULL || nxaudio->render != NULL)
+    {
+      return -EINVAL;
+    }
+
+  r = calloc(1, sizeof(struct nxaudio_render_s));
+  if (r == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  r->render    = render;
+  r->arg       = arg;
+  r->framesize = nxaudio->chnum * (nxaudio->bps / 8);
+
+  nframes = (uint64_t)nxaudio->fs * latency_us /
+            (1000000 * NXAUDIO_RENDER_MINBUFS);
+  if (nframes < 1)
+    {
+      nframes = 1;
+    }
+
+  /* Replace the driver sized buffers with ones that meet the latency */
+
+  free_audio_buffers(nxaudio);
+
+#ifdef AUDIOIOC_SETBUFFERINFO
+  buf_info.nbuffers    = CONFIG_AUDIOUTILS_NXAUDIO_RENDER_MAXBUFS;
+  buf_info.buffer_size = nframes * r->framesize;
+  ioctl(nxaudio->fd, AUDIOIOC_SETBUFFERINFO,
+        (unsigned long)(uintptr_t)&buf_info);
+#endif
+
+  nxaudio->abufnum = CONFIG_AUDIOUTILS_NXAUDIO_RENDER_MAXBUFS;
+  nxaudio->abufs   = create_audio_buffers(nxaudio->fd, nxaudio->abufnum,
+                                          nframes * r->framesize);
+
+  r->freebufs = calloc(nxaudio->abufnum, sizeof(FAR void *));
+  r->enqtime  = calloc(nxaudio->abufnum, sizeof(struct timespec));
+  if (nxaudio->abufs == NULL)
+    {
+      nxaudio->abufnum = 0;
+    }
+
+  if (nxaudio->abufs == NULL || r->freebufs == NULL || r->enqtime == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  for (i = 0; i < nxaudio->abufnum; i++)
+    {
+      if (nxaudio->abufs[i] != NULL)
+        {
+          r->freebufs[r->nfree++] = nxaudio->abufs[i];
+        }
+    }
+
+  if (r->nfree < NXAUDIO_RENDER_MINBUFS)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  r->nbufs          = r->nfree;
+  r->target         = NXAUDIO_RENDER_MINBUFS;
+  r->stats.nbuffers = r->target;
+  r->stats.nframes  = nframes;
+  nxaudio->render   = r;
+
+  pthread_attr_init(&tattr);
+  sparam.sched_priority = CONFIG_AUDIOUTILS_NXAUDIO_RENDER_PRIORITY;
+  pthread_attr_setschedpolicy(&tattr, SCHED_FIFO);
+  pthread_attr_setschedparam(&tattr, &sparam);
+  pthread_attr_setstacksize(&tattr,
+                            CONFIG_AUDIOUTILS_NXAUDIO_RENDER_STACKSIZE);
+
+  ret = pthread_create(&r->thread, &tattr, render_thread,
+                       (pthread_addr_t)nxaudio);
+  pthread_attr_destroy(&tattr);
+  if (ret != 0)
+    {
+      nxaudio->render = NULL;
+      ret = -ret;
+      goto errout;
+    }
+
+  pthread_setname_np(r->thread, "nxaudio_render");
+  return OK;
+
+errout:
+  free(r->freebufs);
+  free(r->enqtime);
+  free(r);
+  return ret;
+}
+
+/****************************************************************************
+ * name: nxaudio_render_stop
+ ****************************************************************************/
+
+int nxaudio_render_stop(FAR struct nxaudio_s *nxaudio)
+{
+  FAR struct nxaudio_render_s *r = nxaudio->render;
+  struct audio_msg_s msg;
+  struct timespec now;
+  unsigned int prio;
+
+  if (r == NULL)
+    {
+      return -EINVAL;
+    }
+
+  nxaudio_stop(nxaudio);
+  pthread_join(r->thread, NULL);
+
+  /* Drop what the thread left in the queue, such as the stop request if
+   * the stream had already completed.
+   */
+
+  clock_gettime(CLOCK_REALTIME, &now);
+  while (mq_timedreceive(nxaudio->mq, (FAR char *)&msg, sizeof(msg),
+                         &prio, &now) >= 0)
+    {
+    }
+
+  nxaudio->render = NULL;
+  free(r->freebufs);
+  free(r->enqtime);
+  free(r);
+  return OK;
+}
+
+/****************************************************************************
+ * name: nxaudio_getstats
+ ****************************************************************************/
+
+int nxaudio_getstats(FAR struct nxaudio_s *nxaudio,
+                     FAR struct nxaudio_stats_s *stats)
+{
+  if (nxaudio->render == NULL)
+    {
+      return -EINVAL;
+    }
+
+  memcpy(stats, &nxaudio->render->stats, sizeof(*stats));
+  return OK;
+}
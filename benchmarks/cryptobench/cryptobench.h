@@ -0,0 +1,112 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_BENCHMARKS_CRYPTOBENCH_CRYPTOBENCH_H
+#define __APPS_BENCHMARKS_CRYPTOBENCH_CRYPTOBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output buffers are this much larger than the largest message, room for
+ * an IV or tag that some APIs write next to the data.
+ */
+
+#define CRYPTOBENCH_SLACK       64
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+enum cryptobench_kind_e
+{
+  CRYPTOBENCH_BULK,   /* Throughput over a sweep of message sizes */
+  CRYPTOBENCH_OP      /* Fixed-size operation such as a signature */
+};
+
+/* One algorithm of one backend.  setup() may return -ENOTSUP when the
+ * library was built without it, the case is then skipped.  run() gets
+ * the message length for bulk cases and 0 for the others.
+ */
+
+struct cryptobench_case_s
+{
+  FAR const char *algo;
+  enum cryptobench_kind_e kind;
+  bool alt;           /* Goes through /dev/crypto or other hardware */
+  CODE int (*setup)(void);
+  CODE int (*run)(FAR const uint8_t *in, FAR uint8_t *out, size_t len);
+  CODE void (*teardown)(void);
+};
+
+struct cryptobench_backend_s
+{
+  FAR const char *name;
+  FAR const struct cryptobench_case_s *cases;
+  size_t ncases;
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_CRYPTO_MBEDTLS
+extern const struct cryptobench_backend_s g_cryptobench_mbedtls;
+#endif
+
+#ifdef CONFIG_CRYPTO_WOLFSSL
+extern const struct cryptobench_backend_s g_cryptobench_wolfssl;
+#endif
+
+#ifdef CONFIG_LIBSODIUM
+extern const struct cryptobench_backend_s g_cryptobench_sodium;
+#endif
+
+#ifdef CONFIG_TINYCRYPT
+extern const struct cryptobench_backend_s g_cryptobench_tinycrypt;
+#endif
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV
+extern const struct cryptobench_backend_s g_cryptobench_cryptodev;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Deterministic filler for keys, nonces and the RNG callbacks some
+ * libraries want.  Benchmark use only, it is not a secure generator.
+ */
+
+void cryptobench_random(FAR uint8_t *buf, size_t len);
+
+#endif /* __APPS_BENCHMARKS_CRYPTOBENCH_CRYPTOBENCH_H */
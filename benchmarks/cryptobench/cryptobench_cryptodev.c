@@ -0,0 +1,325 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench_cryptodev.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/param.h>
+#include <crypto/cryptodev.h>
+
+#include "cryptobench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CRYPTODEV_BENCH_NONCE  4
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The raw /dev/crypto interface, what the mbedtls alt layer costs on top
+ * of it shows when both are compared.  Ciphers keep one session for the
+ * whole sweep, hashes open one per message like hash.c does.
+ */
+
+struct cryptodev_bench_s
+{
+  int fd;
+  unsigned char key[32 + CRYPTODEV_BENCH_NONCE];
+  unsigned char iv[16];
+  struct session_op session;
+  struct crypt_op cryp;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct cryptodev_bench_s g_cryptodev;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int cryptodev_bench_open(void)
+{
+  int ret = 0;
+  int fd;
+
+  memset(&g_cryptodev, 0, sizeof(g_cryptodev));
+  cryptobench_random(g_cryptodev.key, sizeof(g_cryptodev.key));
+  cryptobench_random(g_cryptodev.iv, sizeof(g_cryptodev.iv));
+
+  fd = open("/dev/crypto", O_RDWR, 0);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  if (ioctl(fd, CRIOGET, &g_cryptodev.fd) < 0)
+    {
+      ret = -errno;
+    }
+
+  close(fd);
+  return ret;
+}
+
+static void cryptodev_bench_close(void)
+{
+  if (g_cryptodev.session.ses != 0)
+    {
+      ioctl(g_cryptodev.fd, CIOCFSESSION, &g_cryptodev.session.ses);
+    }
+
+  close(g_cryptodev.fd);
+}
+
+/* A driver without the algorithm fails CIOCGSESSION, report that as not
+ * available rather than as an error.
+ */
+
+static int cryptodev_bench_session(void)
+{
+  if (ioctl(g_cryptodev.fd, CIOCGSESSION, &g_cryptodev.session) < 0)
+    {
+      g_cryptodev.session.ses = 0;
+      return -ENOTSUP;
+    }
+
+  g_cryptodev.cryp.ses = g_cryptodev.session.ses;
+  return 0;
+}
+
+static int cryptodev_bench_cipher_setup(int cipher, int keylen)
+{
+  int ret;
+
+  ret = cryptodev_bench_open();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_cryptodev.session.cipher = cipher;
+  g_cryptodev.session.key = (caddr_t)g_cryptodev.key;
+  g_cryptodev.session.keylen = keylen;
+  ret = cryptodev_bench_session();
+  if (ret < 0)
+    {
+      close(g_cryptodev.fd);
+    }
+
+  return ret;
+}
+
+static int cryptodev_bench_cbc_setup(void)
+{
+  return cryptodev_bench_cipher_setup(CRYPTO_AES_CBC, 16);
+}
+
+static int cryptodev_bench_ctr_setup(void)
+{
+  return cryptodev_bench_cipher_setup(CRYPTO_AES_CTR,
+                                      16 + CRYPTODEV_BENCH_NONCE);
+}
+
+static int cryptodev_bench_cipher(FAR const uint8_t *in, FAR uint8_t *out,
+                                  size_t len)
+{
+  g_cryptodev.cryp.op = COP_ENCRYPT;
+  g_cryptodev.cryp.flags = 0;
+  g_cryptodev.cryp.len = len;
+  g_cryptodev.cryp.src = (caddr_t)in;
+  g_cryptodev.cryp.dst = (caddr_t)out;
+  g_cryptodev.cryp.iv = (caddr_t)g_cryptodev.iv;
+  g_cryptodev.cryp.mac = 0;
+  return ioctl(g_cryptodev.fd, CIOCCRYPT, &g_cryptodev.cryp) < 0 ?
+         -errno : 0;
+}
+
+static int cryptodev_bench_hash_setup(int mac)
+{
+  int ret;
+
+  ret = cryptodev_bench_open();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Probe once so a missing algorithm is skipped */
+
+  g_cryptodev.session.mac = mac;
+  ret = cryptodev_bench_session();
+  if (ret < 0)
+    {
+      close(g_cryptodev.fd);
+      return ret;
+    }
+
+  ioctl(g_cryptodev.fd, CIOCFSESSION, &g_cryptodev.session.ses);
+  g_cryptodev.session.ses = 0;
+  return 0;
+}
+
+static int cryptodev_bench_sha1_setup(void)
+{
+  return cryptodev_bench_hash_setup(CRYPTO_SHA1);
+}
+
+static int cryptodev_bench_sha256_setup(void)
+{
+  return cryptodev_bench_hash_setup(CRYPTO_SHA2_256);
+}
+
+static int cryptodev_bench_sha512_setup(void)
+{
+  return cryptodev_bench_hash_setup(CRYPTO_SHA2_512);
+}
+
+static int cryptodev_bench_hash(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  int ret = 0;
+
+  if (ioctl(g_cryptodev.fd, CIOCGSESSION, &g_cryptodev.session) < 0)
+    {
+      return -errno;
+    }
+
+  g_cryptodev.cryp.ses = g_cryptodev.session.ses;
+  g_cryptodev.cryp.op = COP_ENCRYPT;
+  g_cryptodev.cryp.flags = COP_FLAG_UPDATE;
+  g_cryptodev.cryp.src = (caddr_t)in;
+  g_cryptodev.cryp.len = len;
+  if (ioctl(g_cryptodev.fd, CIOCCRYPT, &g_cryptodev.cryp) < 0)
+    {
+      ret = -errno;
+    }
+  else
+    {
+      g_cryptodev.cryp.flags = 0;
+      g_cryptodev.cryp.mac = (caddr_t)out;
+      if (ioctl(g_cryptodev.fd, CIOCCRYPT, &g_cryptodev.cryp) < 0)
+        {
+          ret = -errno;
+        }
+    }
+
+  ioctl(g_cryptodev.fd, CIOCFSESSION, &g_cryptodev.session.ses);
+  g_cryptodev.session.ses = 0;
+  return ret;
+}
+
+static int cryptodev_bench_hmac_setup(void)
+{
+  int ret;
+
+  ret = cryptodev_bench_open();
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  g_cryptodev.session.mac = CRYPTO_SHA2_256_HMAC;
+  g_cryptodev.session.mackey = (caddr_t)g_cryptodev.key;
+  g_cryptodev.session.mackeylen = 32;
+  ret = cryptodev_bench_session();
+  if (ret < 0)
+    {
+      close(g_cryptodev.fd);
+    }
+
+  return ret;
+}
+
+static int cryptodev_bench_hmac(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  g_cryptodev.cryp.op = COP_ENCRYPT;
+  g_cryptodev.cryp.flags = 0;
+  g_cryptodev.cryp.len = len;
+  g_cryptodev.cryp.src = (caddr_t)in;
+  g_cryptodev.cryp.dst = 0;
+  g_cryptodev.cryp.iv = 0;
+  g_cryptodev.cryp.mac = (caddr_t)out;
+  return ioctl(g_cryptodev.fd, CIOCCRYPT, &g_cryptodev.cryp) < 0 ?
+         -errno : 0;
+}
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cryptobench_case_s g_cryptodev_cases[] =
+{
+  {
+    "aes-128-cbc", CRYPTOBENCH_BULK, true,
+    cryptodev_bench_cbc_setup, cryptodev_bench_cipher,
+    cryptodev_bench_close
+  },
+  {
+    "aes-128-ctr", CRYPTOBENCH_BULK, true,
+    cryptodev_bench_ctr_setup, cryptodev_bench_cipher,
+    cryptodev_bench_close
+  },
+  {
+    "sha1", CRYPTOBENCH_BULK, true,
+    cryptodev_bench_sha1_setup, cryptodev_bench_hash,
+    cryptodev_bench_close
+  },
+  {
+    "sha256", CRYPTOBENCH_BULK, true,
+    cryptodev_bench_sha256_setup, cryptodev_bench_hash,
+    cryptodev_bench_close
+  },
+  {
+    "sha512", CRYPTOBENCH_BULK, true,
+    cryptodev_bench_sha512_setup, cryptodev_bench_hash,
+    cryptodev_bench_close
+  },
+  {
+    "hmac-sha256", CRYPTOBENCH_BULK, true,
+    cryptodev_bench_hmac_setup, cryptodev_bench_hmac,
+    cryptodev_bench_close
+  },
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct cryptobench_backend_s g_cryptobench_cryptodev =
+{
+  "cryptodev", g_cryptodev_cases, nitems(g_cryptodev_cases)
+};
@@ -0,0 +1,444 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cryptobench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CRYPTOBENCH_PREFIX   "cryptobench: "
+
+#define CRYPTOBENCH_MINSIZE  16
+#define CRYPTOBENCH_MAXSIZE  16384
+#define CRYPTOBENCH_TIME_MS  200
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct cryptobench_s
+{
+  size_t minsize;
+  size_t maxsize;
+  uint32_t time_ms;
+  FAR const char *backend;
+  FAR const char *algo;
+  bool json;
+  bool first;
+  FAR uint8_t *in;
+  FAR uint8_t *out;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct cryptobench_backend_s *const g_backends[] =
+{
+#ifdef CONFIG_CRYPTO_MBEDTLS
+  &g_cryptobench_mbedtls,
+#endif
+#ifdef CONFIG_CRYPTO_WOLFSSL
+  &g_cryptobench_wolfssl,
+#endif
+#ifdef CONFIG_LIBSODIUM
+  &g_cryptobench_sodium,
+#endif
+#ifdef CONFIG_TINYCRYPT
+  &g_cryptobench_tinycrypt,
+#endif
+#ifdef CONFIG_CRYPTO_CRYPTODEV
+  &g_cryptobench_cryptodev,
+#endif
+};
+
+static uint32_t g_random_state = 0x2545f491;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: show_usage
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int exitcode)
+{
+  printf("\nUsage: %s -m <min-size> -s <max-size> -t <ms>"
+         " -b <backend> -a <algo> -j -l\n", progname);
+  printf("\nWhere:\n");
+  printf("  -m <decimal-size> smallest message in bytes, a multiple of 16"
+         " [default: %d].\n", CRYPTOBENCH_MINSIZE);
+  printf("  -s <decimal-size> largest message in bytes, sizes grow by 4x"
+         " [default: %d].\n", CRYPTOBENCH_MAXSIZE);
+  printf("  -t <ms> minimum run time of each measurement"
+         " [default: %d].\n", CRYPTOBENCH_TIME_MS);
+  printf("  -b <backend> only run this backend.\n");
+  printf("  -a <algo> only run algorithms containing this string.\n");
+  printf("  -j print JSON.\n");
+  printf("  -l list backends and algorithms.\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Name: cryptobench_list
+ ****************************************************************************/
+
+static void cryptobench_list(void)
+{
+  size_t i;
+  size_t j;
+
+  for (i = 0; i < nitems(g_backends); i++)
+    {
+      for (j = 0; j < g_backends[i]->ncases; j++)
+        {
+          printf("%-10s %s%s\n", g_backends[i]->name,
+                 g_backends[i]->cases[j].algo,
+                 g_backends[i]->cases[j].alt ? " (alt)" : "");
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: get_timestamp
+ ****************************************************************************/
+
+static uint64_t get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: cryptobench_measure
+ *
+ * Description:
+ *   Run the case in batches that double in size until one batch takes at
+ *   least the requested time, so reading the clock costs nothing next to
+ *   short operations.  Returns operations per second or a negated errno.
+ *
+ ****************************************************************************/
+
+static double cryptobench_measure(FAR struct cryptobench_s *info,
+                                  FAR const struct cryptobench_case_s *c,
+                                  size_t len)
+{
+  uint64_t target = (uint64_t)info->time_ms * 1000000;
+  uint64_t elapsed;
+  uint64_t start;
+  uint32_t batch = 1;
+  uint32_t i;
+  int ret;
+
+  for (; ; )
+    {
+      start = get_timestamp();
+      for (i = 0; i < batch; i++)
+        {
+          ret = c->run(info->in, info->out, len);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      elapsed = get_timestamp() - start;
+      if (elapsed >= target || batch >= UINT32_MAX / 2)
+        {
+          break;
+        }
+
+      batch *= 2;
+    }
+
+  return (double)batch * 1e9 / (double)MAX(elapsed, 1);
+}
+
+/****************************************************************************
+ * Name: cryptobench_report
+ ****************************************************************************/
+
+static void cryptobench_report(FAR struct cryptobench_s *info,
+                               FAR const struct cryptobench_backend_s *b,
+                               FAR const struct cryptobench_case_s *c,
+                               size_t len, double ops)
+{
+  double mbps = ops * (double)len / (1024.0 * 1024.0);
+
+  if (info->json)
+    {
+      printf("%s\n    {\"backend\": \"%s\", \"algo\": \"%s\", "
+             "\"alt\": %s, \"size\": %zu, \"ops_per_sec\": %.1f, "
+             "\"mb_per_sec\": %.3f}",
+             info->first ? "" : ",", b->name, c->algo,
+             c->alt ? "true" : "false", len, ops,
+             c->kind == CRYPTOBENCH_BULK ? mbps : 0.0);
+      info->first = false;
+    }
+  else if (c->kind == CRYPTOBENCH_BULK)
+    {
+      printf("%-10s %-20s %3s %8zu %12.1f %10.3f\n", b->name, c->algo,
+             c->alt ? "yes" : "no", len, ops, mbps);
+    }
+  else
+    {
+      printf("%-10s %-20s %3s %8s %12.1f %10s\n", b->name, c->algo,
+             c->alt ? "yes" : "no", "-", ops, "-");
+    }
+}
+
+/****************************************************************************
+ * Name: cryptobench_case
+ ****************************************************************************/
+
+static int cryptobench_case(FAR struct cryptobench_s *info,
+                            FAR const struct cryptobench_backend_s *b,
+                            FAR const struct cryptobench_case_s *c)
+{
+  double ops;
+  size_t len;
+  int ret;
+
+  ret = c->setup != NULL ? c->setup() : 0;
+  if (ret == -ENOTSUP)
+    {
+      if (!info->json)
+        {
+          printf("%-10s %-20s not available\n", b->name, c->algo);
+        }
+
+      return 0;
+    }
+  else if (ret < 0)
+    {
+      printf(CRYPTOBENCH_PREFIX "%s %s setup failed: %d\n",
+             b->name, c->algo, ret);
+      return ret;
+    }
+
+  if (c->kind == CRYPTOBENCH_OP)
+    {
+      ops = cryptobench_measure(info, c, 0);
+      if (ops >= 0)
+        {
+          cryptobench_report(info, b, c, 0, ops);
+        }
+    }
+  else
+    {
+      for (len = info->minsize, ops = 0; len <= info->maxsize; len *= 4)
+        {
+          ops = cryptobench_measure(info, c, len);
+          if (ops < 0)
+            {
+              break;
+            }
+
+          cryptobench_report(info, b, c, len, ops);
+        }
+    }
+
+  if (c->teardown != NULL)
+    {
+      c->teardown();
+    }
+
+  if (ops < 0)
+    {
+      printf(CRYPTOBENCH_PREFIX "%s %s failed: %d\n",
+             b->name, c->algo, (int)ops);
+      return (int)ops;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: parse_commandline
+ ****************************************************************************/
+
+static void parse_commandline(int argc, FAR char **argv,
+                              FAR struct cryptobench_s *info)
+{
+  int ch;
+
+  memset(info, 0, sizeof(struct cryptobench_s));
+  info->minsize = CRYPTOBENCH_MINSIZE;
+  info->maxsize = CRYPTOBENCH_MAXSIZE;
+  info->time_ms = CRYPTOBENCH_TIME_MS;
+  info->first   = true;
+
+  while ((ch = getopt(argc, argv, "m:s:t:b:a:jlh")) != ERROR)
+    {
+      switch (ch)
+        {
+          case 'm':
+            info->minsize = strtoul(optarg, NULL, 10);
+            break;
+          case 's':
+            info->maxsize = strtoul(optarg, NULL, 10);
+            break;
+          case 't':
+            info->time_ms = strtoul(optarg, NULL, 10);
+            break;
+          case 'b':
+            info->backend = optarg;
+            break;
+          case 'a':
+            info->algo = optarg;
+            break;
+          case 'j':
+            info->json = true;
+            break;
+          case 'l':
+            cryptobench_list();
+            exit(EXIT_SUCCESS);
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+          default:
+            printf(CRYPTOBENCH_PREFIX "Unknown option: %c\n",
+                   (char)optopt);
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (info->minsize == 0 || info->minsize % 16 != 0 ||
+      info->minsize > info->maxsize || info->time_ms == 0)
+    {
+      printf(CRYPTOBENCH_PREFIX "Invalid size or time\n");
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cryptobench_random
+ ****************************************************************************/
+
+void cryptobench_random(FAR uint8_t *buf, size_t len)
+{
+  uint32_t x = g_random_state;
+
+  while (len-- > 0)
+    {
+      x ^= x << 13;
+      x ^= x >> 17;
+      x ^= x << 5;
+      *buf++ = (uint8_t)x;
+    }
+
+  g_random_state = x;
+}
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  FAR const struct cryptobench_backend_s *b;
+  FAR const struct cryptobench_case_s *c;
+  struct cryptobench_s info;
+  int ret = 0;
+  size_t i;
+  size_t j;
+
+  parse_commandline(argc, argv, &info);
+
+  info.in  = malloc(info.maxsize + CRYPTOBENCH_SLACK);
+  info.out = malloc(info.maxsize + CRYPTOBENCH_SLACK);
+  if (info.in == NULL || info.out == NULL)
+    {
+      printf(CRYPTOBENCH_PREFIX "Alloc Memory Failed!\n");
+      free(info.in);
+      free(info.out);
+      return EXIT_FAILURE;
+    }
+
+  cryptobench_random(info.in, info.maxsize + CRYPTOBENCH_SLACK);
+
+  if (info.json)
+    {
+      printf("{\n  \"time_ms\": %" PRIu32 ",\n  \"results\": [",
+             info.time_ms);
+    }
+  else
+    {
+      printf("%-10s %-20s %3s %8s %12s %10s\n", "Backend", "Algorithm",
+             "Alt", "Bytes", "Ops/s", "MB/s");
+    }
+
+  for (i = 0; i < nitems(g_backends) && ret == 0; i++)
+    {
+      b = g_backends[i];
+      if (info.backend != NULL && strcmp(info.backend, b->name) != 0)
+        {
+          continue;
+        }
+
+      for (j = 0; j < b->ncases && ret == 0; j++)
+        {
+          c = &b->cases[j];
+          if (info.algo != NULL && strstr(c->algo, info.algo) == NULL)
+            {
+              continue;
+            }
+
+          ret = cryptobench_case(&info, b, c);
+        }
+    }
+
+  if (info.json)
+    {
+      printf("\n  ]\n}\n");
+    }
+
+  free(info.in);
+  free(info.out);
+  return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,403 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench_mbedtls.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <mbedtls/aes.h>
+#include <mbedtls/ecdsa.h>
+#include <mbedtls/gcm.h>
+#include <mbedtls/md.h>
+#include <mbedtls/rsa.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
+
+#include "cryptobench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The alt modules route through /dev/crypto, tag their results so runs of
+ * alt and plain builds can be told apart.
+ */
+
+#ifdef CONFIG_MBEDTLS_AES_ALT
+#  define MBEDTLS_BENCH_AES_ALT    true
+#else
+#  define MBEDTLS_BENCH_AES_ALT    false
+#endif
+
+#ifdef CONFIG_MBEDTLS_SHA1_ALT
+#  define MBEDTLS_BENCH_SHA1_ALT   true
+#else
+#  define MBEDTLS_BENCH_SHA1_ALT   false
+#endif
+
+#ifdef CONFIG_MBEDTLS_SHA256_ALT
+#  define MBEDTLS_BENCH_SHA256_ALT true
+#else
+#  define MBEDTLS_BENCH_SHA256_ALT false
+#endif
+
+#ifdef CONFIG_MBEDTLS_SHA512_ALT
+#  define MBEDTLS_BENCH_SHA512_ALT true
+#else
+#  define MBEDTLS_BENCH_SHA512_ALT false
+#endif
+
+#ifdef CONFIG_MBEDTLS_BIGNUM_ALT
+#  define MBEDTLS_BENCH_MPI_ALT    true
+#else
+#  define MBEDTLS_BENCH_MPI_ALT    false
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct mbedtls_bench_s
+{
+  unsigned char key[32];
+  unsigned char iv[16];
+  unsigned char stream[16];
+  unsigned char hash[32];
+  unsigned char sig[MBEDTLS_MPI_MAX_SIZE];
+  unsigned char scratch[MBEDTLS_MPI_MAX_SIZE];
+  size_t siglen;
+#ifdef MBEDTLS_AES_C
+  mbedtls_aes_context aes;
+#endif
+#ifdef MBEDTLS_GCM_C
+  mbedtls_gcm_context gcm;
+#endif
+#ifdef MBEDTLS_ECDSA_C
+  mbedtls_ecdsa_context ecdsa;
+#endif
+#ifdef MBEDTLS_RSA_C
+  mbedtls_rsa_context rsa;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct mbedtls_bench_s g_mbedtls;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int mbedtls_bench_rng(FAR void *arg, FAR unsigned char *buf,
+                             size_t len)
+{
+  cryptobench_random(buf, len);
+  return 0;
+}
+
+static void mbedtls_bench_keys(void)
+{
+  cryptobench_random(g_mbedtls.key, sizeof(g_mbedtls.key));
+  cryptobench_random(g_mbedtls.iv, sizeof(g_mbedtls.iv));
+  cryptobench_random(g_mbedtls.hash, sizeof(g_mbedtls.hash));
+}
+
+#ifdef MBEDTLS_AES_C
+static int mbedtls_bench_aes_setup(void)
+{
+  mbedtls_bench_keys();
+  mbedtls_aes_init(&g_mbedtls.aes);
+  return mbedtls_aes_setkey_enc(&g_mbedtls.aes, g_mbedtls.key, 128);
+}
+
+static void mbedtls_bench_aes_teardown(void)
+{
+  mbedtls_aes_free(&g_mbedtls.aes);
+}
+
+#ifdef MBEDTLS_CIPHER_MODE_CBC
+static int mbedtls_bench_aes_cbc(FAR const uint8_t *in, FAR uint8_t *out,
+                                 size_t len)
+{
+  return mbedtls_aes_crypt_cbc(&g_mbedtls.aes, MBEDTLS_AES_ENCRYPT, len,
+                               g_mbedtls.iv, in, out);
+}
+#endif
+
+#ifdef MBEDTLS_CIPHER_MODE_CTR
+static int mbedtls_bench_aes_ctr(FAR const uint8_t *in, FAR uint8_t *out,
+                                 size_t len)
+{
+  size_t off = 0;
+
+  return mbedtls_aes_crypt_ctr(&g_mbedtls.aes, len, &off, g_mbedtls.iv,
+                               g_mbedtls.stream, in, out);
+}
+#endif
+#endif /* MBEDTLS_AES_C */
+
+#ifdef MBEDTLS_GCM_C
+static int mbedtls_bench_gcm_setup(void)
+{
+  mbedtls_bench_keys();
+  mbedtls_gcm_init(&g_mbedtls.gcm);
+  return mbedtls_gcm_setkey(&g_mbedtls.gcm, MBEDTLS_CIPHER_ID_AES,
+                            g_mbedtls.key, 128);
+}
+
+static int mbedtls_bench_gcm(FAR const uint8_t *in, FAR uint8_t *out,
+                             size_t len)
+{
+  return mbedtls_gcm_crypt_and_tag(&g_mbedtls.gcm, MBEDTLS_GCM_ENCRYPT,
+                                   len, g_mbedtls.iv, 12, NULL, 0, in, out,
+                                   16, out + len);
+}
+
+static void mbedtls_bench_gcm_teardown(void)
+{
+  mbedtls_gcm_free(&g_mbedtls.gcm);
+}
+#endif
+
+#ifdef MBEDTLS_SHA1_C
+static int mbedtls_bench_sha1(FAR const uint8_t *in, FAR uint8_t *out,
+                              size_t len)
+{
+  return mbedtls_sha1(in, len, out);
+}
+#endif
+
+#ifdef MBEDTLS_SHA256_C
+static int mbedtls_bench_sha256(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  return mbedtls_sha256(in, len, out, 0);
+}
+#endif
+
+#ifdef MBEDTLS_SHA512_C
+static int mbedtls_bench_sha512(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  return mbedtls_sha512(in, len, out, 0);
+}
+#endif
+
+#if defined(MBEDTLS_MD_C) && defined(MBEDTLS_SHA256_C)
+static int mbedtls_bench_hmac_setup(void)
+{
+  mbedtls_bench_keys();
+  return 0;
+}
+
+static int mbedtls_bench_hmac(FAR const uint8_t *in, FAR uint8_t *out,
+                              size_t len)
+{
+  return mbedtls_md_hmac(mbedtls_md_info_from_type(MBEDTLS_MD_SHA256),
+                         g_mbedtls.key, sizeof(g_mbedtls.key), in, len,
+                         out);
+}
+#endif
+
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+static int mbedtls_bench_ecdsa_setup(void)
+{
+  int ret;
+
+  mbedtls_bench_keys();
+  mbedtls_ecdsa_init(&g_mbedtls.ecdsa);
+  ret = mbedtls_ecdsa_genkey(&g_mbedtls.ecdsa, MBEDTLS_ECP_DP_SECP256R1,
+                             mbedtls_bench_rng, NULL);
+  if (ret == 0)
+    {
+      ret = mbedtls_ecdsa_write_signature(&g_mbedtls.ecdsa,
+                                          MBEDTLS_MD_SHA256,
+                                          g_mbedtls.hash, 32,
+                                          g_mbedtls.sig,
+                                          sizeof(g_mbedtls.sig),
+                                          &g_mbedtls.siglen,
+                                          mbedtls_bench_rng, NULL);
+    }
+
+  return ret;
+}
+
+static int mbedtls_bench_ecdsa_sign(FAR const uint8_t *in,
+                                    FAR uint8_t *out, size_t len)
+{
+  size_t siglen;
+
+  return mbedtls_ecdsa_write_signature(&g_mbedtls.ecdsa, MBEDTLS_MD_SHA256,
+                                       g_mbedtls.hash, 32, g_mbedtls.scratch,
+                                       sizeof(g_mbedtls.scratch), &siglen,
+                                       mbedtls_bench_rng, NULL);
+}
+
+static int mbedtls_bench_ecdsa_verify(FAR const uint8_t *in,
+                                      FAR uint8_t *out, size_t len)
+{
+  return mbedtls_ecdsa_read_signature(&g_mbedtls.ecdsa, g_mbedtls.hash, 32,
+                                      g_mbedtls.sig, g_mbedtls.siglen);
+}
+
+static void mbedtls_bench_ecdsa_teardown(void)
+{
+  mbedtls_ecdsa_free(&g_mbedtls.ecdsa);
+}
+#endif
+
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_GENPRIME)
+static int mbedtls_bench_rsa_setup(void)
+{
+  int ret;
+
+  mbedtls_bench_keys();
+  mbedtls_rsa_init(&g_mbedtls.rsa);
+  ret = mbedtls_rsa_gen_key(&g_mbedtls.rsa, mbedtls_bench_rng, NULL,
+                            CONFIG_BENCHMARK_CRYPTOBENCH_RSA_BITS, 65537);
+  if (ret == 0)
+    {
+      ret = mbedtls_rsa_pkcs1_sign(&g_mbedtls.rsa, mbedtls_bench_rng, NULL,
+                                   MBEDTLS_MD_SHA256, 32, g_mbedtls.hash,
+                                   g_mbedtls.sig);
+    }
+
+  return ret;
+}
+
+static int mbedtls_bench_rsa_sign(FAR const uint8_t *in, FAR uint8_t *out,
+                                  size_t len)
+{
+  return mbedtls_rsa_pkcs1_sign(&g_mbedtls.rsa, mbedtls_bench_rng, NULL,
+                                MBEDTLS_MD_SHA256, 32, g_mbedtls.hash,
+                                g_mbedtls.scratch);
+}
+
+static int mbedtls_bench_rsa_verify(FAR const uint8_t *in,
+                                    FAR uint8_t *out, size_t len)
+{
+  return mbedtls_rsa_pkcs1_verify(&g_mbedtls.rsa, MBEDTLS_MD_SHA256, 32,
+                                  g_mbedtls.hash, g_mbedtls.sig);
+}
+
+static void mbedtls_bench_rsa_teardown(void)
+{
+  mbedtls_rsa_free(&g_mbedtls.rsa);
+}
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cryptobench_case_s g_mbedtls_cases[] =
+{
+#ifdef MBEDTLS_AES_C
+#ifdef MBEDTLS_CIPHER_MODE_CBC
+  {
+    "aes-128-cbc", CRYPTOBENCH_BULK, MBEDTLS_BENCH_AES_ALT,
+    mbedtls_bench_aes_setup, mbedtls_bench_aes_cbc,
+    mbedtls_bench_aes_teardown
+  },
+#endif
+#ifdef MBEDTLS_CIPHER_MODE_CTR
+  {
+    "aes-128-ctr", CRYPTOBENCH_BULK, MBEDTLS_BENCH_AES_ALT,
+    mbedtls_bench_aes_setup, mbedtls_bench_aes_ctr,
+    mbedtls_bench_aes_teardown
+  },
+#endif
+#endif
+#ifdef MBEDTLS_GCM_C
+  {
+    "aes-128-gcm", CRYPTOBENCH_BULK, MBEDTLS_BENCH_AES_ALT,
+    mbedtls_bench_gcm_setup, mbedtls_bench_gcm,
+    mbedtls_bench_gcm_teardown
+  },
+#endif
+#ifdef MBEDTLS_SHA1_C
+  {
+    "sha1", CRYPTOBENCH_BULK, MBEDTLS_BENCH_SHA1_ALT,
+    NULL, mbedtls_bench_sha1, NULL
+  },
+#endif
+#ifdef MBEDTLS_SHA256_C
+  {
+    "sha256", CRYPTOBENCH_BULK, MBEDTLS_BENCH_SHA256_ALT,
+    NULL, mbedtls_bench_sha256, NULL
+  },
+#endif
+#ifdef MBEDTLS_SHA512_C
+  {
+    "sha512", CRYPTOBENCH_BULK, MBEDTLS_BENCH_SHA512_ALT,
+    NULL, mbedtls_bench_sha512, NULL
+  },
+#endif
+#if defined(MBEDTLS_MD_C) && defined(MBEDTLS_SHA256_C)
+  {
+    "hmac-sha256", CRYPTOBENCH_BULK, MBEDTLS_BENCH_SHA256_ALT,
+    mbedtls_bench_hmac_setup, mbedtls_bench_hmac, NULL
+  },
+#endif
+#if defined(MBEDTLS_ECDSA_C) && defined(MBEDTLS_ECP_DP_SECP256R1_ENABLED)
+  {
+    "ecdsa-p256-sign", CRYPTOBENCH_OP, MBEDTLS_BENCH_MPI_ALT,
+    mbedtls_bench_ecdsa_setup, mbedtls_bench_ecdsa_sign,
+    mbedtls_bench_ecdsa_teardown
+  },
+  {
+    "ecdsa-p256-verify", CRYPTOBENCH_OP, MBEDTLS_BENCH_MPI_ALT,
+    mbedtls_bench_ecdsa_setup, mbedtls_bench_ecdsa_verify,
+    mbedtls_bench_ecdsa_teardown
+  },
+#endif
+#if defined(MBEDTLS_RSA_C) && defined(MBEDTLS_GENPRIME)
+  {
+    "rsa-sign", CRYPTOBENCH_OP, MBEDTLS_BENCH_MPI_ALT,
+    mbedtls_bench_rsa_setup, mbedtls_bench_rsa_sign,
+    mbedtls_bench_rsa_teardown
+  },
+  {
+    "rsa-verify", CRYPTOBENCH_OP, MBEDTLS_BENCH_MPI_ALT,
+    mbedtls_bench_rsa_setup, mbedtls_bench_rsa_verify,
+    mbedtls_bench_rsa_teardown
+  },
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct cryptobench_backend_s g_cryptobench_mbedtls =
+{
+  "mbedtls", g_mbedtls_cases, nitems(g_mbedtls_cases)
+};
@@ -0,0 +1,203 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench_sodium.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <sodium.h>
+
+#include "cryptobench.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* libsodium has no SHA-1, CBC/CTR or ECDSA/RSA, it is measured on what it
+ * offers instead: AES-GCM where the CPU supports it, ChaCha20-Poly1305
+ * and Ed25519.
+ */
+
+struct sodium_bench_s
+{
+  unsigned char key[32];
+  unsigned char nonce[24];
+  unsigned char hash[32];
+  unsigned char pk[crypto_sign_PUBLICKEYBYTES];
+  unsigned char sk[crypto_sign_SECRETKEYBYTES];
+  unsigned char sig[crypto_sign_BYTES];
+  unsigned char scratch[crypto_sign_BYTES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct sodium_bench_s g_sodium;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int sodium_bench_setup(void)
+{
+  if (sodium_init() < 0)
+    {
+      return -EIO;
+    }
+
+  cryptobench_random(g_sodium.key, sizeof(g_sodium.key));
+  cryptobench_random(g_sodium.nonce, sizeof(g_sodium.nonce));
+  cryptobench_random(g_sodium.hash, sizeof(g_sodium.hash));
+  return 0;
+}
+
+static int sodium_bench_gcm_setup(void)
+{
+  int ret;
+
+  ret = sodium_bench_setup();
+  if (ret == 0 && !crypto_aead_aes256gcm_is_available())
+    {
+      ret = -ENOTSUP;
+    }
+
+  return ret;
+}
+
+static int sodium_bench_gcm(FAR const uint8_t *in, FAR uint8_t *out,
+                            size_t len)
+{
+  unsigned long long clen;
+
+  return crypto_aead_aes256gcm_encrypt(out, &clen, in, len, NULL, 0, NULL,
+                                       g_sodium.nonce, g_sodium.key);
+}
+
+static int sodium_bench_chacha(FAR const uint8_t *in, FAR uint8_t *out,
+                               size_t len)
+{
+  unsigned long long clen;
+
+  return crypto_aead_chacha20poly1305_ietf_encrypt(out, &clen, in, len,
+                                                   NULL, 0, NULL,
+                                                   g_sodium.nonce,
+                                                   g_sodium.key);
+}
+
+static int sodium_bench_sha256(FAR const uint8_t *in, FAR uint8_t *out,
+                               size_t len)
+{
+  return crypto_hash_sha256(out, in, len);
+}
+
+static int sodium_bench_sha512(FAR const uint8_t *in, FAR uint8_t *out,
+                               size_t len)
+{
+  return crypto_hash_sha512(out, in, len);
+}
+
+static int sodium_bench_hmac(FAR const uint8_t *in, FAR uint8_t *out,
+                             size_t len)
+{
+  return crypto_auth_hmacsha256(out, in, len, g_sodium.key);
+}
+
+static int sodium_bench_ed25519_setup(void)
+{
+  int ret;
+
+  ret = sodium_bench_setup();
+  if (ret == 0)
+    {
+      crypto_sign_seed_keypair(g_sodium.pk, g_sodium.sk, g_sodium.key);
+      ret = crypto_sign_detached(g_sodium.sig, NULL, g_sodium.hash,
+                                 sizeof(g_sodium.hash), g_sodium.sk);
+    }
+
+  return ret;
+}
+
+static int sodium_bench_ed25519_sign(FAR const uint8_t *in,
+                                     FAR uint8_t *out, size_t len)
+{
+  return crypto_sign_detached(g_sodium.scratch, NULL, g_sodium.hash,
+                              sizeof(g_sodium.hash), g_sodium.sk);
+}
+
+static int sodium_bench_ed25519_verify(FAR const uint8_t *in,
+                                       FAR uint8_t *out, size_t len)
+{
+  return crypto_sign_verify_detached(g_sodium.sig, g_sodium.hash,
+                                     sizeof(g_sodium.hash), g_sodium.pk);
+}
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cryptobench_case_s g_sodium_cases[] =
+{
+  {
+    "aes-256-gcm", CRYPTOBENCH_BULK, false,
+    sodium_bench_gcm_setup, sodium_bench_gcm, NULL
+  },
+  {
+    "chacha20-poly1305", CRYPTOBENCH_BULK, false,
+    sodium_bench_setup, sodium_bench_chacha, NULL
+  },
+  {
+    "sha256", CRYPTOBENCH_BULK, false,
+    sodium_bench_setup, sodium_bench_sha256, NULL
+  },
+  {
+    "sha512", CRYPTOBENCH_BULK, false,
+    sodium_bench_setup, sodium_bench_sha512, NULL
+  },
+  {
+    "hmac-sha256", CRYPTOBENCH_BULK, false,
+    sodium_bench_setup, sodium_bench_hmac, NULL
+  },
+  {
+    "ed25519-sign", CRYPTOBENCH_OP, false,
+    sodium_bench_ed25519_setup, sodium_bench_ed25519_sign, NULL
+  },
+  {
+    "ed25519-verify", CRYPTOBENCH_OP, false,
+    sodium_bench_ed25519_setup, sodium_bench_ed25519_verify, NULL
+  },
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct cryptobench_backend_s g_cryptobench_sodium =
+{
+  "libsodium", g_sodium_cases, nitems(g_sodium_cases)
+};
@@ -0,0 +1,238 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench_tinycrypt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <tinycrypt/aes.h>
+#include <tinycrypt/cbc_mode.h>
+#include <tinycrypt/constants.h>
+#include <tinycrypt/ctr_mode.h>
+#include <tinycrypt/ecc.h>
+#include <tinycrypt/ecc_dsa.h>
+#include <tinycrypt/hmac.h>
+#include <tinycrypt/sha256.h>
+
+#include "cryptobench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* tinycrypt returns TC_CRYPTO_SUCCESS (1) or TC_CRYPTO_FAIL (0) */
+
+#define TC_BENCH_RET(x)  ((x) == TC_CRYPTO_SUCCESS ? 0 : -EIO)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tinycrypt_bench_s
+{
+  uint8_t key[32];
+  uint8_t iv[16];
+  uint8_t hash[32];
+  uint8_t pub[64];
+  uint8_t priv[32];
+  uint8_t sig[64];
+  uint8_t scratch[64];
+#ifdef CONFIG_TINYCRYPT_AES
+  struct tc_aes_key_sched_struct sched;
+#endif
+#ifdef CONFIG_TINYCRYPT_SHA256_HMAC
+  struct tc_hmac_state_struct hmac;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tinycrypt_bench_s g_tinycrypt;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void tinycrypt_bench_keys(void)
+{
+  cryptobench_random(g_tinycrypt.key, sizeof(g_tinycrypt.key));
+  cryptobench_random(g_tinycrypt.iv, sizeof(g_tinycrypt.iv));
+  cryptobench_random(g_tinycrypt.hash, sizeof(g_tinycrypt.hash));
+}
+
+#ifdef CONFIG_TINYCRYPT_AES
+static int tinycrypt_bench_aes_setup(void)
+{
+  tinycrypt_bench_keys();
+  return TC_BENCH_RET(tc_aes128_set_encrypt_key(&g_tinycrypt.sched,
+                                                g_tinycrypt.key));
+}
+
+#ifdef CONFIG_TINYCRYPT_AES_CBC
+static int tinycrypt_bench_aes_cbc(FAR const uint8_t *in, FAR uint8_t *out,
+                                   size_t len)
+{
+  /* The IV is written in front of the ciphertext */
+
+  return TC_BENCH_RET(tc_cbc_mode_encrypt(out, len + TC_AES_BLOCK_SIZE,
+                                          in, len, g_tinycrypt.iv,
+                                          &g_tinycrypt.sched));
+}
+#endif
+
+#ifdef CONFIG_TINYCRYPT_AES_CTR
+static int tinycrypt_bench_aes_ctr(FAR const uint8_t *in, FAR uint8_t *out,
+                                   size_t len)
+{
+  return TC_BENCH_RET(tc_ctr_mode(out, len, in, len, g_tinycrypt.iv,
+                                  &g_tinycrypt.sched));
+}
+#endif
+#endif /* CONFIG_TINYCRYPT_AES */
+
+#ifdef CONFIG_TINYCRYPT_SHA256
+static int tinycrypt_bench_sha256(FAR const uint8_t *in, FAR uint8_t *out,
+                                  size_t len)
+{
+  struct tc_sha256_state_struct s;
+
+  tc_sha256_init(&s);
+  tc_sha256_update(&s, in, len);
+  return TC_BENCH_RET(tc_sha256_final(out, &s));
+}
+#endif
+
+#ifdef CONFIG_TINYCRYPT_SHA256_HMAC
+static int tinycrypt_bench_hmac_setup(void)
+{
+  tinycrypt_bench_keys();
+  return TC_BENCH_RET(tc_hmac_set_key(&g_tinycrypt.hmac, g_tinycrypt.key,
+                                      sizeof(g_tinycrypt.key)));
+}
+
+static int tinycrypt_bench_hmac(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  tc_hmac_init(&g_tinycrypt.hmac);
+  tc_hmac_update(&g_tinycrypt.hmac, in, len);
+  return TC_BENCH_RET(tc_hmac_final(out, TC_SHA256_DIGEST_SIZE,
+                                    &g_tinycrypt.hmac));
+}
+#endif
+
+#ifdef CONFIG_TINYCRYPT_ECC_DSA
+static int tinycrypt_bench_rng(FAR uint8_t *dest, unsigned int size)
+{
+  cryptobench_random(dest, size);
+  return 1;
+}
+
+static int tinycrypt_bench_ecdsa_setup(void)
+{
+  tinycrypt_bench_keys();
+  uECC_set_rng(tinycrypt_bench_rng);
+
+  if (!uECC_make_key(g_tinycrypt.pub, g_tinycrypt.priv, uECC_secp256r1()))
+    {
+      return -EIO;
+    }
+
+  return TC_BENCH_RET(uECC_sign(g_tinycrypt.priv, g_tinycrypt.hash,
+                                sizeof(g_tinycrypt.hash), g_tinycrypt.sig,
+                                uECC_secp256r1()));
+}
+
+static int tinycrypt_bench_ecdsa_sign(FAR const uint8_t *in,
+                                      FAR uint8_t *out, size_t len)
+{
+  return TC_BENCH_RET(uECC_sign(g_tinycrypt.priv, g_tinycrypt.hash,
+                                sizeof(g_tinycrypt.hash),
+                                g_tinycrypt.scratch, uECC_secp256r1()));
+}
+
+static int tinycrypt_bench_ecdsa_verify(FAR const uint8_t *in,
+                                        FAR uint8_t *out, size_t len)
+{
+  return TC_BENCH_RET(uECC_verify(g_tinycrypt.pub, g_tinycrypt.hash,
+                                  sizeof(g_tinycrypt.hash), g_tinycrypt.sig,
+                                  uECC_secp256r1()));
+}
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cryptobench_case_s g_tinycrypt_cases[] =
+{
+#ifdef CONFIG_TINYCRYPT_AES_CBC
+  {
+    "aes-128-cbc", CRYPTOBENCH_BULK, false,
+    tinycrypt_bench_aes_setup, tinycrypt_bench_aes_cbc, NULL
+  },
+#endif
+#ifdef CONFIG_TINYCRYPT_AES_CTR
+  {
+    "aes-128-ctr", CRYPTOBENCH_BULK, false,
+    tinycrypt_bench_aes_setup, tinycrypt_bench_aes_ctr, NULL
+  },
+#endif
+#ifdef CONFIG_TINYCRYPT_SHA256
+  {
+    "sha256", CRYPTOBENCH_BULK, false,
+    NULL, tinycrypt_bench_sha256, NULL
+  },
+#endif
+#ifdef CONFIG_TINYCRYPT_SHA256_HMAC
+  {
+    "hmac-sha256", CRYPTOBENCH_BULK, false,
+    tinycrypt_bench_hmac_setup, tinycrypt_bench_hmac, NULL
+  },
+#endif
+#ifdef CONFIG_TINYCRYPT_ECC_DSA
+  {
+    "ecdsa-p256-sign", CRYPTOBENCH_OP, false,
+    tinycrypt_bench_ecdsa_setup, tinycrypt_bench_ecdsa_sign, NULL
+  },
+  {
+    "ecdsa-p256-verify", CRYPTOBENCH_OP, false,
+    tinycrypt_bench_ecdsa_setup, tinycrypt_bench_ecdsa_verify, NULL
+  },
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct cryptobench_backend_s g_cryptobench_tinycrypt =
+{
+  "tinycrypt", g_tinycrypt_cases, nitems(g_tinycrypt_cases)
+};
@@ -0,0 +1,425 @@
+/****************************************************************************
+ * apps/benchmarks/cryptobench/cryptobench_wolfssl.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
+#include <wolfssl/wolfcrypt/settings.h>
+#include <wolfssl/wolfcrypt/aes.h>
+#include <wolfssl/wolfcrypt/ecc.h>
+#include <wolfssl/wolfcrypt/hmac.h>
+#include <wolfssl/wolfcrypt/random.h>
+#include <wolfssl/wolfcrypt/rsa.h>
+#include <wolfssl/wolfcrypt/sha.h>
+#include <wolfssl/wolfcrypt/sha256.h>
+#include <wolfssl/wolfcrypt/sha512.h>
+
+#include "cryptobench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WOLFSSL_BENCH_SIGLEN  512
+
+#if !defined(NO_RSA) && defined(WOLFSSL_KEY_GEN)
+#  define WOLFSSL_BENCH_RSA
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wolfssl_bench_s
+{
+  byte key[32];
+  byte iv[16];
+  byte hash[32];
+  byte sig[WOLFSSL_BENCH_SIGLEN];
+  byte scratch[WOLFSSL_BENCH_SIGLEN];
+  word32 siglen;
+  WC_RNG rng;
+#ifndef NO_AES
+  Aes aes;
+#endif
+#ifndef NO_HMAC
+  Hmac hmac;
+#endif
+#ifdef HAVE_ECC
+  ecc_key ecc;
+#endif
+#ifdef WOLFSSL_BENCH_RSA
+  RsaKey rsa;
+#endif
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct wolfssl_bench_s g_wolfssl;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void wolfssl_bench_keys(void)
+{
+  cryptobench_random(g_wolfssl.key, sizeof(g_wolfssl.key));
+  cryptobench_random(g_wolfssl.iv, sizeof(g_wolfssl.iv));
+  cryptobench_random(g_wolfssl.hash, sizeof(g_wolfssl.hash));
+}
+
+#ifndef NO_AES
+static int wolfssl_bench_aes_setup(void)
+{
+  int ret;
+
+  wolfssl_bench_keys();
+  ret = wc_AesInit(&g_wolfssl.aes, NULL, INVALID_DEVID);
+  if (ret == 0)
+    {
+      ret = wc_AesSetKey(&g_wolfssl.aes, g_wolfssl.key, 16, g_wolfssl.iv,
+                         AES_ENCRYPTION);
+    }
+
+  return ret;
+}
+
+static void wolfssl_bench_aes_teardown(void)
+{
+  wc_AesFree(&g_wolfssl.aes);
+}
+
+#ifdef HAVE_AES_CBC
+static int wolfssl_bench_aes_cbc(FAR const uint8_t *in, FAR uint8_t *out,
+                                 size_t len)
+{
+  return wc_AesCbcEncrypt(&g_wolfssl.aes, out, in, len);
+}
+#endif
+
+#ifdef WOLFSSL_AES_COUNTER
+static int wolfssl_bench_aes_ctr(FAR const uint8_t *in, FAR uint8_t *out,
+                                 size_t len)
+{
+  return wc_AesCtrEncrypt(&g_wolfssl.aes, out, in, len);
+}
+#endif
+
+#ifdef HAVE_AESGCM
+static int wolfssl_bench_gcm_setup(void)
+{
+  int ret;
+
+  wolfssl_bench_keys();
+  ret = wc_AesInit(&g_wolfssl.aes, NULL, INVALID_DEVID);
+  if (ret == 0)
+    {
+      ret = wc_AesGcmSetKey(&g_wolfssl.aes, g_wolfssl.key, 16);
+    }
+
+  return ret;
+}
+
+static int wolfssl_bench_gcm(FAR const uint8_t *in, FAR uint8_t *out,
+                             size_t len)
+{
+  return wc_AesGcmEncrypt(&g_wolfssl.aes, out, in, len, g_wolfssl.iv, 12,
+                          out + len, 16, NULL, 0);
+}
+#endif
+#endif /* NO_AES */
+
+#ifndef NO_SHA
+static int wolfssl_bench_sha1(FAR const uint8_t *in, FAR uint8_t *out,
+                              size_t len)
+{
+  return wc_ShaHash(in, len, out);
+}
+#endif
+
+#ifndef NO_SHA256
+static int wolfssl_bench_sha256(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  return wc_Sha256Hash(in, len, out);
+}
+#endif
+
+#ifdef WOLFSSL_SHA512
+static int wolfssl_bench_sha512(FAR const uint8_t *in, FAR uint8_t *out,
+                                size_t len)
+{
+  return wc_Sha512Hash(in, len, out);
+}
+#endif
+
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+static int wolfssl_bench_hmac_setup(void)
+{
+  int ret;
+
+  wolfssl_bench_keys();
+  ret = wc_HmacInit(&g_wolfssl.hmac, NULL, INVALID_DEVID);
+  if (ret == 0)
+    {
+      ret = wc_HmacSetKey(&g_wolfssl.hmac, WC_SHA256, g_wolfssl.key,
+                          sizeof(g_wolfssl.key));
+    }
+
+  return ret;
+}
+
+static int wolfssl_bench_hmac(FAR const uint8_t *in, FAR uint8_t *out,
+                              size_t len)
+{
+  int ret;
+
+  ret = wc_HmacUpdate(&g_wolfssl.hmac, in, len);
+  if (ret == 0)
+    {
+      ret = wc_HmacFinal(&g_wolfssl.hmac, out);
+    }
+
+  return ret;
+}
+
+static void wolfssl_bench_hmac_teardown(void)
+{
+  wc_HmacFree(&g_wolfssl.hmac);
+}
+#endif
+
+#ifdef HAVE_ECC
+static int wolfssl_bench_ecc_setup(void)
+{
+  int ret;
+
+  wolfssl_bench_keys();
+  ret = wc_InitRng(&g_wolfssl.rng);
+  if (ret != 0)
+    {
+      return ret;
+    }
+
+  wc_ecc_init(&g_wolfssl.ecc);
+  ret = wc_ecc_make_key(&g_wolfssl.rng, 32, &g_wolfssl.ecc);
+  if (ret == 0)
+    {
+      g_wolfssl.siglen = sizeof(g_wolfssl.sig);
+      ret = wc_ecc_sign_hash(g_wolfssl.hash, 32, g_wolfssl.sig,
+                             &g_wolfssl.siglen, &g_wolfssl.rng,
+                             &g_wolfssl.ecc);
+    }
+
+  return ret;
+}
+
+static int wolfssl_bench_ecc_sign(FAR const uint8_t *in, FAR uint8_t *out,
+                                  size_t len)
+{
+  word32 siglen = sizeof(g_wolfssl.scratch);
+
+  return wc_ecc_sign_hash(g_wolfssl.hash, 32, g_wolfssl.scratch, &siglen,
+                          &g_wolfssl.rng, &g_wolfssl.ecc);
+}
+
+static int wolfssl_bench_ecc_verify(FAR const uint8_t *in,
+                                    FAR uint8_t *out, size_t len)
+{
+  int stat = 0;
+  int ret;
+
+  ret = wc_ecc_verify_hash(g_wolfssl.sig, g_wolfssl.siglen, g_wolfssl.hash,
+                           32, &stat, &g_wolfssl.ecc);
+  return ret == 0 && stat != 1 ? -EINVAL : ret;
+}
+
+static void wolfssl_bench_ecc_teardown(void)
+{
+  wc_ecc_free(&g_wolfssl.ecc);
+  wc_FreeRng(&g_wolfssl.rng);
+}
+#endif
+
+#ifdef WOLFSSL_BENCH_RSA
+static int wolfssl_bench_rsa_setup(void)
+{
+  int ret;
+
+  wolfssl_bench_keys();
+  ret = wc_InitRng(&g_wolfssl.rng);
+  if (ret != 0)
+    {
+      return ret;
+    }
+
+  wc_InitRsaKey(&g_wolfssl.rsa, NULL);
+  ret = wc_MakeRsaKey(&g_wolfssl.rsa, CONFIG_BENCHMARK_CRYPTOBENCH_RSA_BITS,
+                      WC_RSA_EXPONENT, &g_wolfssl.rng);
+#ifdef WC_RSA_BLINDING
+  if (ret == 0)
+    {
+      ret = wc_RsaSetRNG(&g_wolfssl.rsa, &g_wolfssl.rng);
+    }
+#endif
+
+  if (ret == 0)
+    {
+      ret = wc_RsaSSL_Sign(g_wolfssl.hash, 32, g_wolfssl.sig,
+                           sizeof(g_wolfssl.sig), &g_wolfssl.rsa,
+                           &g_wolfssl.rng);
+      if (ret > 0)
+        {
+          g_wolfssl.siglen = ret;
+          ret = 0;
+        }
+    }
+
+  return ret;
+}
+
+static int wolfssl_bench_rsa_sign(FAR const uint8_t *in, FAR uint8_t *out,
+                                  size_t len)
+{
+  int ret;
+
+  ret = wc_RsaSSL_Sign(g_wolfssl.hash, 32, g_wolfssl.scratch,
+                       sizeof(g_wolfssl.scratch), &g_wolfssl.rsa,
+                       &g_wolfssl.rng);
+  return ret < 0 ? ret : 0;
+}
+
+static int wolfssl_bench_rsa_verify(FAR const uint8_t *in,
+                                    FAR uint8_t *out, size_t len)
+{
+  int ret;
+
+  ret = wc_RsaSSL_Verify(g_wolfssl.sig, g_wolfssl.siglen,
+                         g_wolfssl.scratch, sizeof(g_wolfssl.scratch),
+                         &g_wolfssl.rsa);
+  return ret < 0 ? ret : 0;
+}
+
+static void wolfssl_bench_rsa_teardown(void)
+{
+  wc_FreeRsaKey(&g_wolfssl.rsa);
+  wc_FreeRng(&g_wolfssl.rng);
+}
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct cryptobench_case_s g_wolfssl_cases[] =
+{
+#ifndef NO_AES
+#ifdef HAVE_AES_CBC
+  {
+    "aes-128-cbc", CRYPTOBENCH_BULK, false,
+    wolfssl_bench_aes_setup, wolfssl_bench_aes_cbc,
+    wolfssl_bench_aes_teardown
+  },
+#endif
+#ifdef WOLFSSL_AES_COUNTER
+  {
+    "aes-128-ctr", CRYPTOBENCH_BULK, false,
+    wolfssl_bench_aes_setup, wolfssl_bench_aes_ctr,
+    wolfssl_bench_aes_teardown
+  },
+#endif
+#ifdef HAVE_AESGCM
+  {
+    "aes-128-gcm", CRYPTOBENCH_BULK, false,
+    wolfssl_bench_gcm_setup, wolfssl_bench_gcm,
+    wolfssl_bench_aes_teardown
+  },
+#endif
+#endif
+#ifndef NO_SHA
+  {
+    "sha1", CRYPTOBENCH_BULK, false,
+    NULL, wolfssl_bench_sha1, NULL
+  },
+#endif
+#ifndef NO_SHA256
+  {
+    "sha256", CRYPTOBENCH_BULK, false,
+    NULL, wolfssl_bench_sha256, NULL
+  },
+#endif
+#ifdef WOLFSSL_SHA512
+  {
+    "sha512", CRYPTOBENCH_BULK, false,
+    NULL, wolfssl_bench_sha512, NULL
+  },
+#endif
+#if !defined(NO_HMAC) && !defined(NO_SHA256)
+  {
+    "hmac-sha256", CRYPTOBENCH_BULK, false,
+    wolfssl_bench_hmac_setup, wolfssl_bench_hmac,
+    wolfssl_bench_hmac_teardown
+  },
+#endif
+#ifdef HAVE_ECC
+  {
+    "ecdsa-p256-sign", CRYPTOBENCH_OP, false,
+    wolfssl_bench_ecc_setup, wolfssl_bench_ecc_sign,
+    wolfssl_bench_ecc_teardown
+  },
+  {
+    "ecdsa-p256-verify", CRYPTOBENCH_OP, false,
+    wolfssl_bench_ecc_setup, wolfssl_bench_ecc_verify,
+    wolfssl_bench_ecc_teardown
+  },
+#endif
+#ifdef WOLFSSL_BENCH_RSA
+  {
+    "rsa-sign", CRYPTOBENCH_OP, false,
+    wolfssl_bench_rsa_setup, wolfssl_bench_rsa_sign,
+    wolfssl_bench_rsa_teardown
+  },
+  {
+    "rsa-verify", CRYPTOBENCH_OP, false,
+    wolfssl_bench_rsa_setup, wolfssl_bench_rsa_verify,
+    wolfssl_bench_rsa_teardown
+  },
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct cryptobench_backend_s g_cryptobench_wolfssl =
+{
+  "wolfssl", g_wolfssl_cases, nitems(g_wolfssl_cases)
+};
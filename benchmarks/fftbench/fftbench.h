@@ -0,0 +1,73 @@
+/****************************************************************************
+ * apps/benchmarks/fftbench/fftbench.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_BENCHMARKS_FFTBENCH_FFTBENCH_H
+#define __APPS_BENCHMARKS_FFTBENCH_FFTBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One FFT implementation.  setup() prepares a forward real transform of
+ * nfft points and returns -ENOTSUP for a size the library does not
+ * support.  run() transforms the nfft samples in buf, which it may
+ * overwrite, into out, which has room for nfft + 2 floats, or into buf
+ * itself for in-place implementations.
+ */
+
+struct fftbench_backend_s
+{
+  FAR const char *name;
+  bool inplace;       /* The spectrum is left in buf */
+  bool packed;        /* The Nyquist bin is stored in the DC bin, as CMSIS
+                       * does, rather than after the last bin */
+  CODE int (*setup)(size_t nfft);
+  CODE void (*run)(FAR float *buf, FAR float *out);
+  CODE void (*teardown)(void);
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_MATH_KISSFFT
+extern const struct fftbench_backend_s g_fftbench_kissfft;
+#endif
+
+#ifdef CONFIG_MATH_KISSFFT_PLAN
+extern const struct fftbench_backend_s g_fftbench_kissfft_plan;
+#endif
+
+#ifdef CONFIG_CMSIS_DSP
+extern const struct fftbench_backend_s g_fftbench_cmsis;
+#endif
+
+#endif /* __APPS_BENCHMARKS_FFTBENCH_FFTBENCH_H */
@@ -0,0 +1,73 @@
+/****************************************************************************
+ * apps/benchmarks/fftbench/fftbench_cmsis.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+
+#include "arm_math.h"
+
+#include "fftbench.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static arm_rfft_fast_instance_f32 g_cmsis_rfft;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* arm_rfft_fast_f32() supports the powers of two from 32 to 4096 and uses
+ * its input as scratch.
+ */
+
+static int cmsis_setup(size_t nfft)
+{
+  if (nfft > UINT16_MAX ||
+      arm_rfft_fast_init_f32(&g_cmsis_rfft, (uint16_t)nfft) !=
+      ARM_MATH_SUCCESS)
+    {
+      return -ENOTSUP;
+    }
+
+  return 0;
+}
+
+static void cmsis_run(FAR float *buf, FAR float *out)
+{
+  arm_rfft_fast_f32(&g_cmsis_rfft, buf, out, 0);
+}
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct fftbench_backend_s g_fftbench_cmsis =
+{
+  "cmsis", false, true, cmsis_setup, cmsis_run, NULL
+};
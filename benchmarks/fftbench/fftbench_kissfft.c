@@ -0,0 +1,121 @@
+/****************************************************************************
+ * apps/benchmarks/fftbench/fftbench_kissfft.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdlib.h>
+
+#include "kiss_fft.h"
+#include "tools/kiss_fftr.h"
+
+#ifdef CONFIG_MATH_KISSFFT_PLAN
+#  include <math/kissfft_plan.h>
+#endif
+
+#include "fftbench.h"
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static kiss_fftr_cfg g_kissfft_cfg;
+
+#ifdef CONFIG_MATH_KISSFFT_PLAN
+static FAR struct kissfft_plan_s *g_kissfft_plan;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* kiss_fftr() as applications use it today: a configuration in memory of
+ * their own (the port builds kissfft without malloc) and the spectrum in
+ * a separate buffer of nfft / 2 + 1 bins.
+ */
+
+static int kissfft_setup(size_t nfft)
+{
+  size_t len = 0;
+
+  kiss_fftr_alloc((int)nfft, 0, NULL, &len);
+  g_kissfft_cfg = malloc(len);
+  if (g_kissfft_cfg == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  kiss_fftr_alloc((int)nfft, 0, g_kissfft_cfg, &len);
+  return 0;
+}
+
+static void kissfft_run(FAR float *buf, FAR float *out)
+{
+  kiss_fftr(g_kissfft_cfg, buf, (FAR kiss_fft_cpx *)out);
+}
+
+static void kissfft_teardown(void)
+{
+  free(g_kissfft_cfg);
+  g_kissfft_cfg = NULL;
+}
+
+#ifdef CONFIG_MATH_KISSFFT_PLAN
+static int kissfft_plan_setup(size_t nfft)
+{
+  g_kissfft_plan = kissfft_plan_get(nfft, KISSFFT_REAL | KISSFFT_FORWARD);
+  return g_kissfft_plan != NULL ? 0 : -errno;
+}
+
+static void kissfft_plan_run(FAR float *buf, FAR float *out)
+{
+  kissfft_plan_exec(g_kissfft_plan, buf);
+}
+
+static void kissfft_plan_teardown(void)
+{
+  kissfft_plan_put(g_kissfft_plan);
+  kissfft_plan_flush();
+  g_kissfft_plan = NULL;
+}
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct fftbench_backend_s g_fftbench_kissfft =
+{
+  "kissfft", false, false, kissfft_setup, kissfft_run, kissfft_teardown
+};
+
+#ifdef CONFIG_MATH_KISSFFT_PLAN
+const struct fftbench_backend_s g_fftbench_kissfft_plan =
+{
+  "kissfft_plan", true, true, kissfft_plan_setup, kissfft_plan_run,
+  kissfft_plan_teardown
+};
+#endif
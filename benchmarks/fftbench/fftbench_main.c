@@ -0,0 +1,475 @@
+/****************************************************************************
+ * apps/benchmarks/fftbench/fftbench_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "fftbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FFTBENCH_PREFIX    "fftbench: "
+
+#define FFTBENCH_MINSIZE   64
+#define FFTBENCH_MAXSIZE   4096
+#define FFTBENCH_TIME_MS   200
+
+/* The spectrum is checked at this many bins spread over 0 .. nfft / 2 */
+
+#define FFTBENCH_NCHECKS   17
+
+/* Largest error accepted, relative to the sum of the input magnitudes,
+ * which bounds every bin.  Single precision FFTs stay near 1e-7.
+ */
+
+#define FFTBENCH_MAXERR    1e-5
+
+/* Sample rate of the test signal, only used to place its tones */
+
+#define FFTBENCH_RATE      1000.0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fftbench_s
+{
+  size_t minsize;
+  size_t maxsize;
+  uint32_t time_ms;
+  FAR const char *backend;
+  bool json;
+  bool first;
+  FAR float *in;
+  FAR float *buf;
+  FAR float *out;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct fftbench_backend_s *const g_backends[] =
+{
+#ifdef CONFIG_MATH_KISSFFT
+  &g_fftbench_kissfft,
+#endif
+#ifdef CONFIG_MATH_KISSFFT_PLAN
+  &g_fftbench_kissfft_plan,
+#endif
+#ifdef CONFIG_CMSIS_DSP
+  &g_fftbench_cmsis,
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: show_usage
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int exitcode)
+{
+  printf("\nUsage: %s -m <min-size> -s <max-size> -t <ms> -b <backend>"
+         " -j -l\n", progname);
+  printf("\nWhere:\n");
+  printf("  -m <decimal-size> smallest FFT, a power of two"
+         " [default: %d].\n", FFTBENCH_MINSIZE);
+  printf("  -s <decimal-size> largest FFT, sizes grow by 2x"
+         " [default: %d].\n", FFTBENCH_MAXSIZE);
+  printf("  -t <ms> minimum run time of each measurement"
+         " [default: %d].\n", FFTBENCH_TIME_MS);
+  printf("  -b <backend> only run this backend.\n");
+  printf("  -j print JSON.\n");
+  printf("  -l list backends.\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Name: get_timestamp
+ ****************************************************************************/
+
+static uint64_t get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: fftbench_signal
+ *
+ * Description:
+ *   Fill in an accelerometer-like test signal: two tones, an offset and
+ *   some noise.
+ *
+ ****************************************************************************/
+
+static void fftbench_signal(FAR float *x, size_t nfft)
+{
+  uint32_t seed = 0x2545f491;
+  double t;
+  size_t i;
+
+  for (i = 0; i < nfft; i++)
+    {
+      seed ^= seed << 13;
+      seed ^= seed >> 17;
+      seed ^= seed << 5;
+
+      t = (double)i / FFTBENCH_RATE;
+      x[i] = (float)(0.1 + 0.8 * sin(2.0 * M_PI * 50.0 * t) +
+                     0.3 * sin(2.0 * M_PI * 123.4 * t) +
+                     0.05 * ((double)(seed >> 8) / (1 << 24) - 0.5));
+    }
+}
+
+/****************************************************************************
+ * Name: fftbench_check
+ *
+ * Description:
+ *   Compare the spectrum at a few bins with a double precision DFT.  A
+ *   full reference transform would need more memory than the benchmark
+ *   itself.  Returns the largest error relative to the sum of the input
+ *   magnitudes.
+ *
+ ****************************************************************************/
+
+static double fftbench_check(FAR const struct fftbench_s *info,
+                             FAR const struct fftbench_backend_s *b,
+                             FAR const float *spec, size_t nfft)
+{
+  double maxerr = 0.0;
+  double norm = 0.0;
+  double phase;
+  double refr;
+  double refi;
+  float re;
+  float im;
+  size_t i;
+  size_t k;
+  size_t n;
+
+  for (n = 0; n < nfft; n++)
+    {
+      norm += fabs(info->in[n]);
+    }
+
+  for (i = 0; i < FFTBENCH_NCHECKS; i++)
+    {
+      k = i * (nfft / 2) / (FFTBENCH_NCHECKS - 1);
+
+      for (n = 0, refr = 0.0, refi = 0.0; n < nfft; n++)
+        {
+          phase = -2.0 * M_PI * (double)(k * n % nfft) / nfft;
+          refr += info->in[n] * cos(phase);
+          refi += info->in[n] * sin(phase);
+        }
+
+      if (b->packed && k == 0)
+        {
+          re = spec[0];
+          im = 0.0f;
+        }
+      else if (b->packed && k == nfft / 2)
+        {
+          re = spec[1];
+          im = 0.0f;
+        }
+      else
+        {
+          re = spec[2 * k];
+          im = spec[2 * k + 1];
+        }
+
+      maxerr = MAX(maxerr, hypot(re - refr, im - refi));
+    }
+
+  return maxerr / MAX(norm, 1e-30);
+}
+
+/****************************************************************************
+ * Name: fftbench_measure
+ *
+ * Description:
+ *   Run the transform in batches that double in size until one batch
+ *   takes at least the requested time.  Every run first copies the input
+ *   into the work buffer, as a sensor pipeline copies its sample block,
+ *   since some implementations transform in place or use their input as
+ *   scratch.  Returns microseconds per transform.
+ *
+ ****************************************************************************/
+
+static double fftbench_measure(FAR struct fftbench_s *info,
+                               FAR const struct fftbench_backend_s *b,
+                               size_t nfft)
+{
+  uint64_t target = (uint64_t)info->time_ms * 1000000;
+  uint64_t elapsed;
+  uint64_t start;
+  uint32_t batch = 1;
+  uint32_t i;
+
+  for (; ; )
+    {
+      start = get_timestamp();
+      for (i = 0; i < batch; i++)
+        {
+          memcpy(info->buf, info->in, nfft * sizeof(float));
+          b->run(info->buf, info->out);
+        }
+
+      elapsed = get_timestamp() - start;
+      if (elapsed >= target || batch >= UINT32_MAX / 2)
+        {
+          break;
+        }
+
+      batch *= 2;
+    }
+
+  return (double)elapsed / 1000.0 / (double)batch;
+}
+
+/****************************************************************************
+ * Name: fftbench_report
+ ****************************************************************************/
+
+static void fftbench_report(FAR struct fftbench_s *info,
+                            FAR const struct fftbench_backend_s *b,
+                            size_t nfft, double us, double err)
+{
+  if (info->json)
+    {
+      printf("%s\n    {\"backend\": \"%s\", \"size\": %zu, "
+             "\"us_per_fft\": %.3f, \"ffts_per_sec\": %.1f, "
+             "\"error\": %.3e}",
+             info->first ? "" : ",", b->name, nfft, us, 1e6 / us, err);
+      info->first = false;
+    }
+  else
+    {
+      printf("%-14s %6zu %12.3f %12.1f %10.3e%s\n", b->name, nfft, us,
+             1e6 / us, err, err > FFTBENCH_MAXERR ? " FAILED" : "");
+    }
+}
+
+/****************************************************************************
+ * Name: fftbench_backend
+ ****************************************************************************/
+
+static int fftbench_backend(FAR struct fftbench_s *info,
+                            FAR const struct fftbench_backend_s *b)
+{
+  FAR const float *spec;
+  double err;
+  double us;
+  size_t nfft;
+  int ret = 0;
+
+  for (nfft = info->minsize; nfft <= info->maxsize; nfft *= 2)
+    {
+      ret = b->setup(nfft);
+      if (ret == -ENOTSUP)
+        {
+          if (!info->json)
+            {
+              printf("%-14s %6zu not supported\n", b->name, nfft);
+            }
+
+          ret = 0;
+          continue;
+        }
+      else if (ret < 0)
+        {
+          printf(FFTBENCH_PREFIX "%s %zu setup failed: %d\n",
+                 b->name, nfft, ret);
+          break;
+        }
+
+      fftbench_signal(info->in, nfft);
+      memcpy(info->buf, info->in, nfft * sizeof(float));
+      b->run(info->buf, info->out);
+      spec = b->inplace ? info->buf : info->out;
+      err  = fftbench_check(info, b, spec, nfft);
+
+      us = fftbench_measure(info, b, nfft);
+      if (b->teardown != NULL)
+        {
+          b->teardown();
+        }
+
+      fftbench_report(info, b, nfft, us, err);
+      if (err > FFTBENCH_MAXERR)
+        {
+          ret = -EIO;
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: parse_commandline
+ ****************************************************************************/
+
+static void parse_commandline(int argc, FAR char **argv,
+                              FAR struct fftbench_s *info)
+{
+  size_t i;
+  int ch;
+
+  memset(info, 0, sizeof(struct fftbench_s));
+  info->minsize = FFTBENCH_MINSIZE;
+  info->maxsize = FFTBENCH_MAXSIZE;
+  info->time_ms = FFTBENCH_TIME_MS;
+  info->first   = true;
+
+  while ((ch = getopt(argc, argv, "m:s:t:b:jlh")) != ERROR)
+    {
+      switch (ch)
+        {
+          case 'm':
+            info->minsize = strtoul(optarg, NULL, 10);
+            break;
+          case 's':
+            info->maxsize = strtoul(optarg, NULL, 10);
+            break;
+          case 't':
+            info->time_ms = strtoul(optarg, NULL, 10);
+            break;
+          case 'b':
+            info->backend = optarg;
+            break;
+          case 'j':
+            info->json = true;
+            break;
+          case 'l':
+            for (i = 0; i < nitems(g_backends); i++)
+              {
+                printf("%s\n", g_backends[i]->name);
+              }
+
+            exit(EXIT_SUCCESS);
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+          default:
+            printf(FFTBENCH_PREFIX "Unknown option: %c\n", (char)optopt);
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (info->minsize < 4 || (info->minsize & (info->minsize - 1)) != 0 ||
+      info->minsize > info->maxsize || info->time_ms == 0)
+    {
+      printf(FFTBENCH_PREFIX "Invalid size or time\n");
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct fftbench_s info;
+  int status = EXIT_SUCCESS;
+  size_t i;
+
+  parse_commandline(argc, argv, &info);
+
+  info.in  = malloc(info.maxsize * sizeof(float));
+  info.buf = malloc((info.maxsize + 2) * sizeof(float));
+  info.out = malloc((info.maxsize + 2) * sizeof(float));
+  if (info.in == NULL || info.buf == NULL || info.out == NULL)
+    {
+      printf(FFTBENCH_PREFIX "Alloc Memory Failed!\n");
+      free(info.in);
+      free(info.buf);
+      free(info.out);
+      return EXIT_FAILURE;
+    }
+
+  if (info.json)
+    {
+      printf("{\n  \"time_ms\": %" PRIu32 ",\n  \"results\": [",
+             info.time_ms);
+    }
+  else
+    {
+      printf("%-14s %6s %12s %12s %10s\n", "Backend", "Size", "us/FFT",
+             "FFT/s", "Error");
+    }
+
+  for (i = 0; i < nitems(g_backends); i++)
+    {
+      if (info.backend != NULL &&
+          strcmp(info.backend, g_backends[i]->name) != 0)
+        {
+          continue;
+        }
+
+      /* A failing backend does not keep the others from running */
+
+      if (fftbench_backend(&info, g_backends[i]) < 0)
+        {
+          status = EXIT_FAILURE;
+        }
+    }
+
+  if (info.json)
+    {
+      printf("\n  ]\n}\n");
+    }
+
+  free(info.in);
+  free(info.buf);
+  free(info.out);
+  return status;
+}
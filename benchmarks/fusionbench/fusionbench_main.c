@@ -0,0 +1,848 @@
+/****************************************************************************
+ * apps/benchmarks/fusionbench/fusionbench_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/param.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <inertial/madgwick.h>
+
+#include "Fusion/Fusion.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FUSIONBENCH_PREFIX    "fusionbench: "
+
+#define FUSIONBENCH_NSAMPLES  256
+#define FUSIONBENCH_RATE      1000
+#define FUSIONBENCH_BATCH     32
+#define FUSIONBENCH_TIME_MS   200
+
+/* The accuracy check runs this many seconds of its own motion, harsher
+ * than the recording that is timed: rates of several rad/s on each axis
+ * and 4 m/s^2 of accelerometer noise, peak to peak.
+ */
+
+#define FUSIONBENCH_CHECK_S   10
+#define FUSIONBENCH_CHECK_W   8.0
+#define FUSIONBENCH_CHECK_N   4.0
+
+/* The timed recording */
+
+#define FUSIONBENCH_RECORD_W  4.0
+#define FUSIONBENCH_RECORD_N  0.5
+
+/* Largest deviation of the fast paths from the reference, in degrees.  A
+ * float Madgwick filter is only as exact as its rounding: on harsh motion
+ * the reference itself departs from a double precision evaluation, and
+ * the fast paths, which round differently, may depart from it by as much.
+ */
+
+#define FUSIONBENCH_MAXERR    0.1
+
+/* Filter gain, in rad/s */
+
+#define FUSIONBENCH_BETA      0.1f
+
+/* A +-2000 dps gyroscope and a +-16 g accelerometer with 16 bit output */
+
+#define FUSIONBENCH_GYRO_LSB  (2000.0f * (float)M_PI / 180.0f / 32768.0f)
+#define FUSIONBENCH_ACCEL_LSB (16.0f * 9.80665f / 32768.0f)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* State of the simulated motion, so that it can be generated in pieces */
+
+struct fusionbench_motion_s
+{
+  double q[4];       /* True orientation */
+  double rate;       /* Peak rotation rate in rad/s */
+  double noise;      /* Accelerometer noise in m/s^2 peak to peak */
+  uint32_t seed;
+  size_t index;      /* Samples generated so far */
+};
+
+struct fusionbench_s
+{
+  size_t nsamples;
+  uint32_t rate;
+  size_t batch;
+  uint32_t time_ms;
+  FAR const char *path;
+  bool json;
+  bool check;
+  bool first;
+  float dt;
+
+  /* The samples as published on uORB, and the raw FIFO words they were
+   * converted from
+   */
+
+  FAR struct sensor_gyro *gyro;
+  FAR struct sensor_accel *accel;
+  FAR int16_t *raw_gyro;
+  FAR int16_t *raw_accel;
+
+  /* One filter of each kind */
+
+  FusionAhrs fusion;
+  struct madgwick_s ref;
+  struct madgwick_s madgwick;
+  struct madgwick_fixed_s fixed;
+};
+
+/* One way of running the filter over samples [start, start + n) */
+
+struct fusionbench_path_s
+{
+  FAR const char *name;
+  CODE void (*init)(FAR struct fusionbench_s *info);
+  CODE void (*run)(FAR struct fusionbench_s *info, size_t start, size_t n);
+
+  /* Orientation as w, x, y, z, NULL if the path is not a Madgwick filter
+   * and cannot be compared with the reference.
+   */
+
+  CODE void (*quat)(FAR struct fusionbench_s *info, FAR double *q);
+
+  /* Largest deviation from the reference accepted, in degrees */
+
+  double maxerr;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void fusion_init(FAR struct fusionbench_s *info);
+static void fusion_run(FAR struct fusionbench_s *info, size_t start,
+                       size_t n);
+static void ref_init(FAR struct fusionbench_s *info);
+static void ref_run(FAR struct fusionbench_s *info, size_t start,
+                    size_t n);
+static void ref_quat(FAR struct fusionbench_s *info, FAR double *q);
+static void batch_init(FAR struct fusionbench_s *info);
+static void batch_run(FAR struct fusionbench_s *info, size_t start,
+                      size_t n);
+static void batch_quat(FAR struct fusionbench_s *info, FAR double *q);
+static void fixed_init(FAR struct fusionbench_s *info);
+static void fixed_run(FAR struct fusionbench_s *info, size_t start,
+                      size_t n);
+static void fixed_quat(FAR struct fusionbench_s *info, FAR double *q);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct fusionbench_path_s g_paths[] =
+{
+  {
+    "fusion", fusion_init, fusion_run, NULL, 0.0
+  },
+  {
+    "reference", ref_init, ref_run, ref_quat, 0.0
+  },
+  {
+    "batch", batch_init, batch_run, batch_quat, FUSIONBENCH_MAXERR
+  },
+  {
+    "fixed", fixed_init, fixed_run, fixed_quat, FUSIONBENCH_MAXERR
+  },
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: show_usage
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int exitcode)
+{
+  printf("\nUsage: %s -n <samples> -r <hz> -s <batch> -t <ms> -p <path>"
+         " -c -j -l\n", progname);
+  printf("\nWhere:\n");
+  printf("  -n <decimal-count> samples recorded and replayed"
+         " [default: %d].\n", FUSIONBENCH_NSAMPLES);
+  printf("  -r <decimal-hz> sample rate of the recording"
+         " [default: %d].\n", FUSIONBENCH_RATE);
+  printf("  -s <decimal-count> samples per batch update"
+         " [default: %d].\n", FUSIONBENCH_BATCH);
+  printf("  -t <ms> minimum run time of each measurement"
+         " [default: %d].\n", FUSIONBENCH_TIME_MS);
+  printf("  -p <path> only run this path.\n");
+  printf("  -c only check accuracy.\n");
+  printf("  -j print JSON.\n");
+  printf("  -l list paths.\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Name: get_timestamp
+ ****************************************************************************/
+
+static uint64_t get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: fusion_*
+ *
+ * Description:
+ *   The Fusion AHRS one sample at a time, as applications use it today.
+ *
+ ****************************************************************************/
+
+static void fusion_init(FAR struct fusionbench_s *info)
+{
+  FusionAhrsInitialise(&info->fusion);
+}
+
+static void fusion_run(FAR struct fusionbench_s *info, size_t start,
+                       size_t n)
+{
+  FusionVector gyroscope;
+  FusionVector accelerometer;
+  size_t i;
+
+  for (i = start; i < start + n; i++)
+    {
+      gyroscope.axis.x = info->gyro[i].x * (180.0f / (float)M_PI);
+      gyroscope.axis.y = info->gyro[i].y * (180.0f / (float)M_PI);
+      gyroscope.axis.z = info->gyro[i].z * (180.0f / (float)M_PI);
+
+      accelerometer.axis.x = info->accel[i].x * (1.0f / 9.80665f);
+      accelerometer.axis.y = info->accel[i].y * (1.0f / 9.80665f);
+      accelerometer.axis.z = info->accel[i].z * (1.0f / 9.80665f);
+
+      FusionAhrsUpdateNoMagnetometer(&info->fusion, gyroscope,
+                                     accelerometer, info->dt);
+    }
+}
+
+/****************************************************************************
+ * Name: ref_*
+ *
+ * Description:
+ *   madgwick_update() one sample at a time.
+ *
+ ****************************************************************************/
+
+static void ref_init(FAR struct fusionbench_s *info)
+{
+  madgwick_init(&info->ref, FUSIONBENCH_BETA);
+}
+
+static void ref_run(FAR struct fusionbench_s *info, size_t start,
+                    size_t n)
+{
+  size_t i;
+
+  for (i = start; i < start + n; i++)
+    {
+      madgwick_update(&info->ref,
+                      info->gyro[i].x, info->gyro[i].y, info->gyro[i].z,
+                      info->accel[i].x, info->accel[i].y,
+                      info->accel[i].z, info->dt);
+    }
+}
+
+static void ref_quat(FAR struct fusionbench_s *info, FAR double *q)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      q[i] = info->ref.q[i];
+    }
+}
+
+/****************************************************************************
+ * Name: batch_*
+ *
+ * Description:
+ *   madgwick_update_batch() over the batches uORB would deliver.
+ *
+ ****************************************************************************/
+
+static void batch_init(FAR struct fusionbench_s *info)
+{
+  madgwick_init(&info->madgwick, FUSIONBENCH_BETA);
+}
+
+static void batch_run(FAR struct fusionbench_s *info, size_t start,
+                      size_t n)
+{
+  madgwick_update_batch(&info->madgwick, info->gyro + start,
+                        info->accel + start, n, info->dt);
+}
+
+static void batch_quat(FAR struct fusionbench_s *info, FAR double *q)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      q[i] = info->madgwick.q[i];
+    }
+}
+
+/****************************************************************************
+ * Name: fixed_*
+ *
+ * Description:
+ *   madgwick_fixed_update_batch() over the raw samples.
+ *
+ ****************************************************************************/
+
+static void fixed_init(FAR struct fusionbench_s *info)
+{
+  madgwick_fixed_init(&info->fixed, FUSIONBENCH_BETA,
+                      FUSIONBENCH_GYRO_LSB, info->dt);
+}
+
+static void fixed_run(FAR struct fusionbench_s *info, size_t start,
+                      size_t n)
+{
+  madgwick_fixed_update_batch(&info->fixed, info->raw_gyro + 3 * start,
+                              info->raw_accel + 3 * start, n);
+}
+
+static void fixed_quat(FAR struct fusionbench_s *info, FAR double *q)
+{
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      q[i] = ldexp(info->fixed.q[i], -MADGWICK_FIXED_SHIFT);
+    }
+}
+
+/****************************************************************************
+ * Name: fusionbench_quantize
+ ****************************************************************************/
+
+static int16_t fusionbench_quantize(double v, float lsb)
+{
+  v = round(v / lsb);
+  return (int16_t)MIN(MAX(v, INT16_MIN), INT16_MAX);
+}
+
+/****************************************************************************
+ * Name: fusionbench_motion
+ ****************************************************************************/
+
+static void fusionbench_motion(FAR struct fusionbench_motion_s *motion,
+                               double rate, double noise)
+{
+  memset(motion, 0, sizeof(*motion));
+  motion->q[0]  = 1.0;
+  motion->rate  = rate;
+  motion->noise = noise;
+  motion->seed  = 0x2545f491;
+}
+
+/****************************************************************************
+ * Name: fusionbench_record
+ *
+ * Description:
+ *   Simulate an IMU on a tumbling body, rolling over all the while:
+ *   integrate its orientation, and sample the rotation rate with a bias
+ *   and the gravity with some noise, quantized as a 16 bit IMU would.
+ *   The next n samples of the motion are stored from index 0, so every
+ *   path sees the same values.
+ *
+ ****************************************************************************/
+
+static void fusionbench_record(FAR struct fusionbench_s *info,
+                               FAR struct fusionbench_motion_s *motion,
+                               size_t n)
+{
+  FAR double *q = motion->q;
+  double w[3];
+  double g[3];
+  double d[4];
+  double norm;
+  double t;
+  size_t i;
+  int j;
+
+  for (i = 0; i < n; i++)
+    {
+      t = (double)motion->index++ * info->dt;
+      w[0] = motion->rate * (0.25 + sin(2.0 * M_PI * 0.7 * t));
+      w[1] = motion->rate * 0.75 * sin(2.0 * M_PI * 1.3 * t + 1.0);
+      w[2] = motion->rate * 0.5 * cos(2.0 * M_PI * 0.4 * t);
+
+      /* Gravity in the sensor frame, as the filter estimates it */
+
+      g[0] = 2.0 * (q[1] * q[3] - q[0] * q[2]);
+      g[1] = 2.0 * (q[0] * q[1] + q[2] * q[3]);
+      g[2] = q[0] * q[0] - q[1] * q[1] - q[2] * q[2] + q[3] * q[3];
+
+      for (j = 0; j < 3; j++)
+        {
+          motion->seed ^= motion->seed << 13;
+          motion->seed ^= motion->seed >> 17;
+          motion->seed ^= motion->seed << 5;
+
+          info->raw_gyro[3 * i + j] =
+            fusionbench_quantize(w[j] + 0.01 +
+                                 0.02 * ((double)(motion->seed >> 8) /
+                                         (1 << 24) - 0.5),
+                                 FUSIONBENCH_GYRO_LSB);
+          info->raw_accel[3 * i + j] =
+            fusionbench_quantize(9.80665 * g[j] + motion->noise *
+                                 ((double)(motion->seed & 0xff) / 256 -
+                                  0.5),
+                                 FUSIONBENCH_ACCEL_LSB);
+        }
+
+      info->gyro[i].timestamp  = (uint64_t)(t * 1e6);
+      info->gyro[i].x = info->raw_gyro[3 * i] * FUSIONBENCH_GYRO_LSB;
+      info->gyro[i].y = info->raw_gyro[3 * i + 1] * FUSIONBENCH_GYRO_LSB;
+      info->gyro[i].z = info->raw_gyro[3 * i + 2] * FUSIONBENCH_GYRO_LSB;
+      info->gyro[i].temperature = 25.0f;
+
+      info->accel[i].timestamp = info->gyro[i].timestamp;
+      info->accel[i].x = info->raw_accel[3 * i] * FUSIONBENCH_ACCEL_LSB;
+      info->accel[i].y = info->raw_accel[3 * i + 1] * FUSIONBENCH_ACCEL_LSB;
+      info->accel[i].z = info->raw_accel[3 * i + 2] * FUSIONBENCH_ACCEL_LSB;
+      info->accel[i].temperature = 25.0f;
+
+      /* Advance the true orientation by the true rate */
+
+      d[0] = -q[1] * w[0] - q[2] * w[1] - q[3] * w[2];
+      d[1] = q[0] * w[0] + q[2] * w[2] - q[3] * w[1];
+      d[2] = q[0] * w[1] - q[1] * w[2] + q[3] * w[0];
+      d[3] = q[0] * w[2] + q[1] * w[1] - q[2] * w[0];
+
+      for (j = 0, norm = 0.0; j < 4; j++)
+        {
+          q[j] += 0.5 * info->dt * d[j];
+          norm += q[j] * q[j];
+        }
+
+      for (j = 0, norm = sqrt(norm); j < 4; j++)
+        {
+          q[j] /= norm;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fusionbench_replay
+ *
+ * Description:
+ *   Feed the recording through a path passes times, a batch at a time.
+ *   Batches do not straddle the end of the recording.
+ *
+ ****************************************************************************/
+
+static void fusionbench_replay(FAR struct fusionbench_s *info,
+                               FAR const struct fusionbench_path_s *p,
+                               uint32_t passes)
+{
+  size_t start;
+  uint32_t i;
+
+  for (i = 0; i < passes; i++)
+    {
+      for (start = 0; start < info->nsamples; start += info->batch)
+        {
+          p->run(info, start, MIN(info->batch, info->nsamples - start));
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fusionbench_angle
+ *
+ * Description:
+ *   Rotation between two orientations in degrees.  The quaternions are
+ *   normalized first, as the fast paths only keep them unit to a few ppm,
+ *   and the angle is taken from their sum and difference, since acos() of
+ *   their dot product loses all precision for small angles.
+ *
+ ****************************************************************************/
+
+static double fusionbench_angle(FAR const double *a, FAR const double *b)
+{
+  double na = 0.0;
+  double nb = 0.0;
+  double dot = 0.0;
+  double sum = 0.0;
+  double diff = 0.0;
+  double v;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    {
+      na  += a[i] * a[i];
+      nb  += b[i] * b[i];
+      dot += a[i] * b[i];
+    }
+
+  /* q and -q are the same orientation */
+
+  na = 1.0 / sqrt(na);
+  nb = (dot < 0.0 ? -1.0 : 1.0) / sqrt(nb);
+
+  for (i = 0; i < 4; i++)
+    {
+      v     = a[i] * na - b[i] * nb;
+      diff += v * v;
+      v     = a[i] * na + b[i] * nb;
+      sum  += v * v;
+    }
+
+  return 4.0 * atan2(sqrt(diff), sqrt(sum)) * 180.0 / M_PI;
+}
+
+/****************************************************************************
+ * Name: fusionbench_check
+ *
+ * Description:
+ *   Run a path side by side with the reference over FUSIONBENCH_CHECK_S
+ *   seconds of harsh motion, generated a batch at a time, and return the
+ *   largest angle between their orientations after each batch, in
+ *   degrees.  The recording is restored afterwards.
+ *
+ ****************************************************************************/
+
+static double fusionbench_check(FAR struct fusionbench_s *info,
+                                FAR const struct fusionbench_path_s *p)
+{
+  struct fusionbench_motion_s motion;
+  size_t total = (size_t)FUSIONBENCH_CHECK_S * info->rate;
+  size_t batch = MIN(info->batch, info->nsamples);
+  double maxerr = 0.0;
+  double qr[4];
+  double q[4];
+  size_t done;
+  size_t n;
+
+  ref_init(info);
+  p->init(info);
+
+  fusionbench_motion(&motion, FUSIONBENCH_CHECK_W, FUSIONBENCH_CHECK_N);
+
+  for (done = 0; done < total; done += n)
+    {
+      n = MIN(batch, total - done);
+      fusionbench_record(info, &motion, n);
+
+      ref_run(info, 0, n);
+      p->run(info, 0, n);
+
+      ref_quat(info, qr);
+      p->quat(info, q);
+      maxerr = MAX(maxerr, fusionbench_angle(qr, q));
+    }
+
+  fusionbench_motion(&motion, FUSIONBENCH_RECORD_W, FUSIONBENCH_RECORD_N);
+  fusionbench_record(info, &motion, info->nsamples);
+  return maxerr;
+}
+
+/****************************************************************************
+ * Name: fusionbench_measure
+ *
+ * Description:
+ *   Replay the recording a number of times that doubles until one run
+ *   takes at least the requested time.  Returns nanoseconds per sample.
+ *
+ ****************************************************************************/
+
+static double fusionbench_measure(FAR struct fusionbench_s *info,
+                                  FAR const struct fusionbench_path_s *p)
+{
+  uint64_t target = (uint64_t)info->time_ms * 1000000;
+  uint64_t elapsed;
+  uint64_t start;
+  uint32_t passes = 1;
+
+  p->init(info);
+
+  for (; ; )
+    {
+      start = get_timestamp();
+      fusionbench_replay(info, p, passes);
+      elapsed = get_timestamp() - start;
+      if (elapsed >= target || passes >= UINT32_MAX / 2)
+        {
+          break;
+        }
+
+      passes *= 2;
+    }
+
+  return (double)elapsed / ((double)passes * info->nsamples);
+}
+
+/****************************************************************************
+ * Name: fusionbench_report
+ *
+ * Description:
+ *   Print the cost of a path and the share of a CPU it takes at the usual
+ *   IMU rates.  A negative err means the path was not checked.
+ *
+ ****************************************************************************/
+
+static void fusionbench_report(FAR struct fusionbench_s *info,
+                               FAR const struct fusionbench_path_s *p,
+                               double ns, double err)
+{
+  bool failed = err > p->maxerr && p->quat != NULL;
+
+  if (info->json)
+    {
+      printf("%s\n    {\"path\": \"%s\"", info->first ? "" : ",",
+             p->name);
+      if (ns >= 0.0)
+        {
+          printf(", \"ns_per_sample\": %.1f, \"load_1khz\": %.4f, "
+                 "\"load_2khz\": %.4f, \"load_4khz\": %.4f",
+                 ns, ns * 1e-6, ns * 2e-6, ns * 4e-6);
+        }
+
+      if (err >= 0.0)
+        {
+          printf(", \"error_deg\": %.3e", err);
+        }
+
+      printf("}");
+      info->first = false;
+    }
+  else
+    {
+      printf("%-10s", p->name);
+      if (ns >= 0.0)
+        {
+          printf(" %10.1f %8.3f%% %8.3f%% %8.3f%%", ns, ns * 1e-4,
+                 ns * 2e-4, ns * 4e-4);
+        }
+      else
+        {
+          printf(" %10s %9s %9s %9s", "-", "-", "-", "-");
+        }
+
+      if (err >= 0.0)
+        {
+          printf(" %10.3e%s\n", err, failed ? " FAILED" : "");
+        }
+      else
+        {
+          printf(" %10s\n", "-");
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: fusionbench_path
+ ****************************************************************************/
+
+static int fusionbench_path(FAR struct fusionbench_s *info,
+                            FAR const struct fusionbench_path_s *p)
+{
+  double err = -1.0;
+  double ns = -1.0;
+
+  /* The reference has nothing to be checked against */
+
+  if (p->quat != NULL && p->quat != ref_quat)
+    {
+      err = fusionbench_check(info, p);
+    }
+
+  if (!info->check)
+    {
+      ns = fusionbench_measure(info, p);
+    }
+
+  fusionbench_report(info, p, ns, err);
+  return err > p->maxerr ? -EIO : 0;
+}
+
+/****************************************************************************
+ * Name: parse_commandline
+ ****************************************************************************/
+
+static void parse_commandline(int argc, FAR char **argv,
+                              FAR struct fusionbench_s *info)
+{
+  size_t i;
+  int ch;
+
+  memset(info, 0, sizeof(struct fusionbench_s));
+  info->nsamples = FUSIONBENCH_NSAMPLES;
+  info->rate     = FUSIONBENCH_RATE;
+  info->batch    = FUSIONBENCH_BATCH;
+  info->time_ms  = FUSIONBENCH_TIME_MS;
+  info->first    = true;
+
+  while ((ch = getopt(argc, argv, "n:r:s:t:p:cjlh")) != ERROR)
+    {
+      switch (ch)
+        {
+          case 'n':
+            info->nsamples = strtoul(optarg, NULL, 10);
+            break;
+          case 'r':
+            info->rate = strtoul(optarg, NULL, 10);
+            break;
+          case 's':
+            info->batch = strtoul(optarg, NULL, 10);
+            break;
+          case 't':
+            info->time_ms = strtoul(optarg, NULL, 10);
+            break;
+          case 'p':
+            info->path = optarg;
+            break;
+          case 'c':
+            info->check = true;
+            break;
+          case 'j':
+            info->json = true;
+            break;
+          case 'l':
+            for (i = 0; i < nitems(g_paths); i++)
+              {
+                printf("%s\n", g_paths[i].name);
+              }
+
+            exit(EXIT_SUCCESS);
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+          default:
+            printf(FUSIONBENCH_PREFIX "Unknown option: %c\n",
+                   (char)optopt);
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (info->nsamples == 0 || info->rate == 0 || info->batch == 0 ||
+      info->time_ms == 0)
+    {
+      printf(FUSIONBENCH_PREFIX "Invalid count, rate or time\n");
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  info->dt = 1.0f / (float)info->rate;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct fusionbench_motion_s motion;
+  struct fusionbench_s info;
+  int status = EXIT_SUCCESS;
+  size_t i;
+
+  parse_commandline(argc, argv, &info);
+
+  info.gyro      = malloc(info.nsamples * sizeof(struct sensor_gyro));
+  info.accel     = malloc(info.nsamples * sizeof(struct sensor_accel));
+  info.raw_gyro  = malloc(info.nsamples * 3 * sizeof(int16_t));
+  info.raw_accel = malloc(info.nsamples * 3 * sizeof(int16_t));
+  if (info.gyro == NULL || info.accel == NULL || info.raw_gyro == NULL ||
+      info.raw_accel == NULL)
+    {
+      printf(FUSIONBENCH_PREFIX "Alloc Memory Failed!\n");
+      status = EXIT_FAILURE;
+      goto out;
+    }
+
+  fusionbench_motion(&motion, FUSIONBENCH_RECORD_W, FUSIONBENCH_RECORD_N);
+  fusionbench_record(&info, &motion, info.nsamples);
+
+  if (info.json)
+    {
+      printf("{\n  \"rate\": %" PRIu32 ",\n  \"batch\": %zu,\n"
+             "  \"results\": [", info.rate, info.batch);
+    }
+  else
+    {
+      printf("%-10s %10s %9s %9s %9s %10s\n", "Path", "ns/sample",
+             "1 kHz", "2 kHz", "4 kHz", "Error deg");
+    }
+
+  for (i = 0; i < nitems(g_paths); i++)
+    {
+      if (info.path != NULL && strcmp(info.path, g_paths[i].name) != 0)
+        {
+          continue;
+        }
+
+      /* A failing path does not keep the others from running */
+
+      if (fusionbench_path(&info, &g_paths[i]) < 0)
+        {
+          status = EXIT_FAILURE;
+        }
+    }
+
+  if (info.json)
+    {
+      printf("\n  ]\n}\n");
+    }
+
+out:
+  free(info.gyro);
+  free(info.accel);
+  free(info.raw_gyro);
+  free(info.raw_accel);
+  return status;
+}
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/guest/interpbench_guest.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The workloads as a wasm module, for the wasm runtimes.  The C code is
+ * the one the native baseline runs, and the module imports
+ * interpbench_add from "env".  The Make flow compiles the file natively
+ * as well, where only an empty main is left.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#ifdef __wasm__
+#  include "../interpbench_workloads.c"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define GUEST_EXPORT(name) __attribute__((export_name(name)))
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+#ifdef __wasm__
+GUEST_EXPORT("bench_fib") int32_t guest_fib(int32_t n)
+{
+  return interpbench_fib(n);
+}
+
+GUEST_EXPORT("bench_string") int32_t guest_string(int32_t n)
+{
+  return interpbench_string(n);
+}
+
+GUEST_EXPORT("bench_table") int32_t guest_table(int32_t n)
+{
+  return interpbench_table(n);
+}
+
+GUEST_EXPORT("bench_json") int32_t guest_json(int32_t n)
+{
+  return interpbench_json(n);
+}
+
+GUEST_EXPORT("bench_ffi") int32_t guest_ffi(int32_t n)
+{
+  return interpbench_ffi(n);
+}
+#endif
+
+int main(int argc, char *argv[])
+{
+  return 0;
+}
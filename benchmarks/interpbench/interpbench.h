@@ -0,0 +1,106 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_BENCHMARKS_INTERPBENCH_INTERPBENCH_H
+#define __APPS_BENCHMARKS_INTERPBENCH_INTERPBENCH_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "interpbench_workloads.h"
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* One scripting runtime.  open() creates the runtime and loads the
+ * workload definitions, which is what the startup time measures.  run()
+ * runs one workload and stores its result, to be checked against the C
+ * implementation; it returns -ENOTSUP for a workload the language has no
+ * sensible way to express, and the case is then skipped.
+ */
+
+struct interpbench_runtime_s
+{
+  FAR const char *name;
+  CODE int (*open)(void);
+  CODE int (*run)(int workload, int32_t n, FAR int32_t *result);
+  CODE void (*close)(void);
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_INTERPRETERS_LUA
+extern const struct interpbench_runtime_s g_interpbench_lua;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_QUICKJS
+extern const struct interpbench_runtime_s g_interpbench_quickjs;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_WASM3
+extern const struct interpbench_runtime_s g_interpbench_wasm3;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_WAMR
+extern const struct interpbench_runtime_s g_interpbench_wamr;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_TOYWASM
+extern const struct interpbench_runtime_s g_interpbench_toywasm;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_FICL
+extern const struct interpbench_runtime_s g_interpbench_ficl;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_BAS
+extern const struct interpbench_runtime_s g_interpbench_bas;
+#endif
+
+#ifdef CONFIG_INTERPRETERS_MINIBASIC
+extern const struct interpbench_runtime_s g_interpbench_minibasic;
+#endif
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Read a whole file, the wasm module of the wasm runtimes.  The buffer is
+ * released with free().
+ */
+
+FAR uint8_t *interpbench_readfile(FAR const char *path, FAR size_t *size);
+
+/* Path of the wasm workload module, set with -m */
+
+FAR const char *interpbench_wasmpath(void);
+
+#endif /* __APPS_BENCHMARKS_INTERPBENCH_INTERPBENCH_H */
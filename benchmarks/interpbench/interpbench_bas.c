@@ -0,0 +1,202 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_bas.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bas.h"
+#include "bas_fs.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define BAS_PROGRAM  CONFIG_LIBC_TMPDIR "/interpbench.bas"
+#define BAS_OUTPUT   CONFIG_LIBC_TMPDIR "/interpbench.out"
+
+#define BAS_LINE_SIZE  32
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_bas_open(void);
+static int bench_bas_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_bas_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* bas loads programs from files only.  The functions are loaded once and
+ * then called from direct mode lines, which print their result to the line
+ * printer, a file read back afterwards.  There are no hash tables, JSON
+ * or host functions to call, so only fib and string are defined.
+ */
+
+static const char g_bas_program[] =
+  "10 FUNCTION FIB(N)\n"
+  "20   IF N < 2 THEN FIB = N : EXIT FUNCTION\n"
+  "30   FIB = FIB(N - 1) + FIB(N - 2)\n"
+  "40 END FUNCTION\n"
+  "50 FUNCTION STRBUILD(N)\n"
+  "60   LOCAL I, S$\n"
+  "70   S$ = \"\"\n"
+  "80   FOR I = 0 TO N - 1\n"
+  "90     S$ = S$ + LTRIM$(STR$(I)) + \",\"\n"
+  "100  NEXT I\n"
+  "110  STRBUILD = LEN(S$)\n"
+  "120 END FUNCTION\n";
+
+static FAR const char *const g_bas_functions[INTERPBENCH_NWORKLOADS] =
+{
+  "FIB", "STRBUILD", NULL, NULL, NULL
+};
+
+static int g_bas_lpfd = -1;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_bas =
+{
+  "bas", bench_bas_open, bench_bas_run, bench_bas_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_bas_open
+ ****************************************************************************/
+
+static int bench_bas_open(void)
+{
+  ssize_t len = sizeof(g_bas_program) - 1;
+  int fd;
+
+  fd = open(BAS_PROGRAM, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (fd < 0)
+    {
+      return -errno;
+    }
+
+  if (write(fd, g_bas_program, len) != len)
+    {
+      close(fd);
+      unlink(BAS_PROGRAM);
+      return -EIO;
+    }
+
+  close(fd);
+
+  g_bas_lpfd = open(BAS_OUTPUT, O_RDWR | O_CREAT | O_TRUNC, 0666);
+  if (g_bas_lpfd < 0)
+    {
+      unlink(BAS_PROGRAM);
+      return -errno;
+    }
+
+  /* Restricted, so the program cannot run SHELL */
+
+  bas_init(0, 1, 0, g_bas_lpfd);
+  bas_runFile(BAS_PROGRAM);
+  unlink(BAS_PROGRAM);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_bas_run
+ ****************************************************************************/
+
+static int bench_bas_run(int workload, int32_t n, FAR int32_t *result)
+{
+  char line[BAS_LINE_SIZE];
+  FAR char *end;
+  ssize_t nread;
+
+  if (g_bas_functions[workload] == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  ftruncate(g_bas_lpfd, 0);
+  lseek(g_bas_lpfd, 0, SEEK_SET);
+
+  snprintf(line, sizeof(line), "LPRINT %s(%" PRId32 ")",
+           g_bas_functions[workload], n);
+  bas_runLine(line);
+  FS_flush(LPCHANNEL);
+
+  nread = pread(g_bas_lpfd, line, sizeof(line) - 1, 0);
+  if (nread <= 0)
+    {
+      return -EIO;
+    }
+
+  line[nread] = '\0';
+  *result = (int32_t)strtol(line, &end, 10);
+  return end != line ? 0 : -EIO;
+}
+
+/****************************************************************************
+ * Name: bench_bas_close
+ ****************************************************************************/
+
+static void bench_bas_close(void)
+{
+  int in;
+  int out;
+
+  /* bas_exit() closes the line printer and the standard channel, which
+   * are stdin and stdout, so keep copies of those to put back.
+   */
+
+  fflush(stdout);
+  in = dup(STDIN_FILENO);
+  out = dup(STDOUT_FILENO);
+
+  bas_exit();
+
+  dup2(in, STDIN_FILENO);
+  dup2(out, STDOUT_FILENO);
+  close(in);
+  close(out);
+
+  g_bas_lpfd = -1;
+  unlink(BAS_OUTPUT);
+}
@@ -0,0 +1,173 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_ficl.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "ficl.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FICL_COMMAND_SIZE  32
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_ficl_open(void);
+static int bench_ficl_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_ficl_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Forth has neither hash tables nor JSON, so only fib, string and ffi are
+ * defined.  The string is built in a fixed buffer, as Forth code would,
+ * large enough for INTERPBENCH_STRING_N numbers.
+ */
+
+static char g_ficl_script[] =
+  ": bench-fib ( n -- f )\n"
+  "  dup 2 < if exit then\n"
+  "  dup 1- recurse swap 2 - recurse + ;\n"
+  "\n"
+  "create sbuf 8192 allot\n"
+  "variable slen\n"
+  "\n"
+  ": sappend ( c-addr u -- )\n"
+  "  dup >r sbuf slen @ + swap move r> slen +! ;\n"
+  "\n"
+  ": bench-string ( n -- len )\n"
+  "  0 slen !\n"
+  "  0 ?do i 0 <# #s #> sappend s\" ,\" sappend loop\n"
+  "  slen @ ;\n"
+  "\n"
+  ": bench-ffi ( n -- acc )\n"
+  "  0 swap 0 ?do i host-add loop ;\n";
+
+static FAR const char *const g_ficl_words[INTERPBENCH_NWORKLOADS] =
+{
+  "bench-fib", "bench-string", NULL, NULL, "bench-ffi"
+};
+
+static FAR ficlSystem *g_ficl_system;
+static FAR ficlVm *g_ficl_vm;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_ficl =
+{
+  "ficl", bench_ficl_open, bench_ficl_run, bench_ficl_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_ficl_add
+ ****************************************************************************/
+
+static void bench_ficl_add(FAR ficlVm *vm)
+{
+  ficlInteger b = ficlStackPopInteger(vm->dataStack);
+  ficlInteger a = ficlStackPopInteger(vm->dataStack);
+
+  ficlStackPushInteger(vm->dataStack, interpbench_add(a, b));
+}
+
+/****************************************************************************
+ * Name: bench_ficl_open
+ ****************************************************************************/
+
+static int bench_ficl_open(void)
+{
+  g_ficl_system = ficlSystemCreate(NULL);
+  if (g_ficl_system == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ficlDictionarySetPrimitive(ficlSystemGetDictionary(g_ficl_system),
+                             "host-add", bench_ficl_add,
+                             FICL_WORD_DEFAULT);
+
+  g_ficl_vm = ficlSystemCreateVm(g_ficl_system);
+  if (g_ficl_vm == NULL ||
+      ficlVmEvaluate(g_ficl_vm, g_ficl_script) !=
+      FICL_VM_STATUS_OUT_OF_TEXT)
+    {
+      ficlSystemDestroy(g_ficl_system);
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_ficl_run
+ ****************************************************************************/
+
+static int bench_ficl_run(int workload, int32_t n, FAR int32_t *result)
+{
+  char command[FICL_COMMAND_SIZE];
+
+  if (g_ficl_words[workload] == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  snprintf(command, sizeof(command), "%" PRId32 " %s", n,
+           g_ficl_words[workload]);
+
+  if (ficlVmEvaluate(g_ficl_vm, command) != FICL_VM_STATUS_OUT_OF_TEXT ||
+      ficlStackDepth(g_ficl_vm->dataStack) < 1)
+    {
+      return -EIO;
+    }
+
+  *result = (int32_t)ficlStackPopInteger(g_ficl_vm->dataStack);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_ficl_close
+ ****************************************************************************/
+
+static void bench_ficl_close(void)
+{
+  ficlSystemDestroy(g_ficl_system);
+}
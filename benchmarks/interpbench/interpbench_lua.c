@@ -0,0 +1,263 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_lua.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+
+#include "lua.h"
+#include "lauxlib.h"
+#include "lualib.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_lua_open(void);
+static int bench_lua_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_lua_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char g_lua_script[] =
+  "function bench_fib(n)\n"
+  "  if n < 2 then\n"
+  "    return n\n"
+  "  end\n"
+  "  return bench_fib(n - 1) + bench_fib(n - 2)\n"
+  "end\n"
+  "\n"
+  "function bench_string(n)\n"
+  "  local parts = {}\n"
+  "  for i = 0, n - 1 do\n"
+  "    parts[i + 1] = i .. \",\"\n"
+  "  end\n"
+  "  return #table.concat(parts)\n"
+  "end\n"
+  "\n"
+  "function bench_table(n)\n"
+  "  local t = {}\n"
+  "  local sum = 0\n"
+  "  local count = 0\n"
+  "  for i = 0, n - 1 do\n"
+  "    t[\"k\" .. i] = i\n"
+  "  end\n"
+  "  for i = 0, n - 1 do\n"
+  "    sum = sum + t[\"k\" .. i]\n"
+  "  end\n"
+  "  for i = 0, n - 1, 2 do\n"
+  "    t[\"k\" .. i] = nil\n"
+  "  end\n"
+  "  for i = 0, n - 1 do\n"
+  "    sum = sum + (t[\"k\" .. i] or 0)\n"
+  "  end\n"
+  "  for _ in pairs(t) do\n"
+  "    count = count + 1\n"
+  "  end\n"
+  "  return sum + count\n"
+  "end\n"
+  "\n"
+  "-- JSON for the values the benchmark uses: tables, strings without\n"
+  "-- escapes and integers\n"
+  "\n"
+  "local function json_encode(v, out)\n"
+  "  if type(v) == \"table\" then\n"
+  "    if v[1] ~= nil then\n"
+  "      out[#out + 1] = \"[\"\n"
+  "      for i, e in ipairs(v) do\n"
+  "        if i > 1 then\n"
+  "          out[#out + 1] = \",\"\n"
+  "        end\n"
+  "        json_encode(e, out)\n"
+  "      end\n"
+  "      out[#out + 1] = \"]\"\n"
+  "    else\n"
+  "      local first = true\n"
+  "      out[#out + 1] = \"{\"\n"
+  "      for k, e in pairs(v) do\n"
+  "        if not first then\n"
+  "          out[#out + 1] = \",\"\n"
+  "        end\n"
+  "        first = false\n"
+  "        out[#out + 1] = '\"' .. k .. '\":'\n"
+  "        json_encode(e, out)\n"
+  "      end\n"
+  "      out[#out + 1] = \"}\"\n"
+  "    end\n"
+  "  elseif type(v) == \"string\" then\n"
+  "    out[#out + 1] = '\"' .. v .. '\"'\n"
+  "  else\n"
+  "    out[#out + 1] = tostring(v)\n"
+  "  end\n"
+  "  return out\n"
+  "end\n"
+  "\n"
+  "local function json_decode(s, pos)\n"
+  "  local c = string.sub(s, pos, pos)\n"
+  "  if c == \"{\" or c == \"[\" then\n"
+  "    local v = {}\n"
+  "    local close = c == \"{\" and \"}\" or \"]\"\n"
+  "    pos = pos + 1\n"
+  "    if string.sub(s, pos, pos) == close then\n"
+  "      return v, pos + 1\n"
+  "    end\n"
+  "    while true do\n"
+  "      if close == \"}\" then\n"
+  "        local k\n"
+  "        k, pos = json_decode(s, pos)\n"
+  "        v[k], pos = json_decode(s, pos + 1)\n"
+  "      else\n"
+  "        v[#v + 1], pos = json_decode(s, pos)\n"
+  "      end\n"
+  "      c = string.sub(s, pos, pos)\n"
+  "      pos = pos + 1\n"
+  "      if c == close then\n"
+  "        return v, pos\n"
+  "      end\n"
+  "    end\n"
+  "  elseif c == '\"' then\n"
+  "    local e = string.find(s, '\"', pos + 1, true)\n"
+  "    return string.sub(s, pos + 1, e - 1), e + 1\n"
+  "  else\n"
+  "    local num = string.match(s, \"^-?%d+\", pos)\n"
+  "    return math.tointeger(tonumber(num)), pos + #num\n"
+  "  end\n"
+  "end\n"
+  "\n"
+  "function bench_json(n)\n"
+  "  local sum = 0\n"
+  "  for i = 0, n - 1 do\n"
+  "    local s = table.concat(json_encode({\n"
+  "      id = i, name = \"item\" .. i, tags = {\"x\", \"y\"},\n"
+  "      values = {i, i + 1, i + 2}\n"
+  "    }, {}))\n"
+  "    local r = json_decode(s, 1)\n"
+  "    sum = sum + #s + r.id + #r.name + #r.tags + #r.tags[1] +\n"
+  "          #r.tags[2] + #r.values + r.values[1] + r.values[2] +\n"
+  "          r.values[3]\n"
+  "  end\n"
+  "  return sum\n"
+  "end\n"
+  "\n"
+  "function bench_ffi(n)\n"
+  "  local add = interpbench_add\n"
+  "  local acc = 0\n"
+  "  for i = 0, n - 1 do\n"
+  "    acc = add(acc, i)\n"
+  "  end\n"
+  "  return acc\n"
+  "end\n";
+
+static FAR const char *const g_lua_functions[INTERPBENCH_NWORKLOADS] =
+{
+  "bench_fib", "bench_string", "bench_table", "bench_json", "bench_ffi"
+};
+
+static FAR lua_State *g_lua;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_lua =
+{
+  "lua", bench_lua_open, bench_lua_run, bench_lua_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_lua_add
+ ****************************************************************************/
+
+static int bench_lua_add(FAR lua_State *L)
+{
+  lua_pushinteger(L, interpbench_add(luaL_checkinteger(L, 1),
+                                     luaL_checkinteger(L, 2)));
+  return 1;
+}
+
+/****************************************************************************
+ * Name: bench_lua_open
+ ****************************************************************************/
+
+static int bench_lua_open(void)
+{
+  g_lua = luaL_newstate();
+  if (g_lua == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  luaL_openlibs(g_lua);
+  lua_register(g_lua, "interpbench_add", bench_lua_add);
+
+  if (luaL_dostring(g_lua, g_lua_script) != LUA_OK)
+    {
+      fprintf(stderr, "lua: %s\n", lua_tostring(g_lua, -1));
+      lua_close(g_lua);
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_lua_run
+ ****************************************************************************/
+
+static int bench_lua_run(int workload, int32_t n, FAR int32_t *result)
+{
+  lua_getglobal(g_lua, g_lua_functions[workload]);
+  lua_pushinteger(g_lua, n);
+
+  if (lua_pcall(g_lua, 1, 1, 0) != LUA_OK)
+    {
+      fprintf(stderr, "lua: %s\n", lua_tostring(g_lua, -1));
+      lua_pop(g_lua, 1);
+      return -EIO;
+    }
+
+  *result = (int32_t)lua_tointeger(g_lua, -1);
+  lua_pop(g_lua, 1);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_lua_close
+ ****************************************************************************/
+
+static void bench_lua_close(void)
+{
+  lua_close(g_lua);
+}
@@ -0,0 +1,730 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define INTERPBENCH_PREFIX    "interpbench: "
+
+#define INTERPBENCH_TIME_MS   200
+#define INTERPBENCH_STARTUPS  3
+
+/* Period of the heap sampler in microseconds */
+
+#define INTERPBENCH_SAMPLE_US 1000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct interpbench_s
+{
+  uint32_t time_ms;
+  FAR const char *runtime;
+  FAR const char *workload;
+  bool json;
+  bool first;
+};
+
+struct interpbench_workload_s
+{
+  FAR const char *name;
+  int32_t n;
+  CODE int32_t (*reference)(int32_t n);
+};
+
+/* Highest heap use seen by the sampler thread */
+
+struct interpbench_sampler_s
+{
+  pthread_t thread;
+  volatile bool stop;
+  size_t peak;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int native_open(void);
+static int native_run(int workload, int32_t n, FAR int32_t *result);
+static void native_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct interpbench_workload_s g_workloads[] =
+{
+  { "fib",    INTERPBENCH_FIB_N,    interpbench_fib    },
+  { "string", INTERPBENCH_STRING_N, interpbench_string },
+  { "table",  INTERPBENCH_TABLE_N,  interpbench_table  },
+  { "json",   INTERPBENCH_JSON_N,   interpbench_json   },
+  { "ffi",    INTERPBENCH_FFI_N,    interpbench_ffi    },
+};
+
+/* The C implementation, as the baseline the runtimes are compared to */
+
+static const struct interpbench_runtime_s g_interpbench_native =
+{
+  "native", native_open, native_run, native_close
+};
+
+static FAR const struct interpbench_runtime_s *const g_runtimes[] =
+{
+  &g_interpbench_native,
+#ifdef CONFIG_INTERPRETERS_LUA
+  &g_interpbench_lua,
+#endif
+#ifdef CONFIG_INTERPRETERS_QUICKJS
+  &g_interpbench_quickjs,
+#endif
+#ifdef CONFIG_INTERPRETERS_WASM3
+  &g_interpbench_wasm3,
+#endif
+#ifdef CONFIG_INTERPRETERS_WAMR
+  &g_interpbench_wamr,
+#endif
+#ifdef CONFIG_INTERPRETERS_TOYWASM
+  &g_interpbench_toywasm,
+#endif
+#ifdef CONFIG_INTERPRETERS_FICL
+  &g_interpbench_ficl,
+#endif
+#ifdef CONFIG_INTERPRETERS_BAS
+  &g_interpbench_bas,
+#endif
+#ifdef CONFIG_INTERPRETERS_MINIBASIC
+  &g_interpbench_minibasic,
+#endif
+};
+
+static FAR const char *g_wasmpath = CONFIG_BENCHMARK_INTERPBENCH_WASM;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: native_open
+ ****************************************************************************/
+
+static int native_open(void)
+{
+  return 0;
+}
+
+/****************************************************************************
+ * Name: native_run
+ ****************************************************************************/
+
+static int native_run(int workload, int32_t n, FAR int32_t *result)
+{
+  *result = g_workloads[workload].reference(n);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: native_close
+ ****************************************************************************/
+
+static void native_close(void)
+{
+}
+
+/****************************************************************************
+ * Name: show_usage
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int exitcode)
+{
+  printf("\nUsage: %s -t <ms> -r <runtime> -w <workload> -m <wasm>"
+         " -j -l\n", progname);
+  printf("\nWhere:\n");
+  printf("  -t <ms> minimum run time of each measurement"
+         " [default: %d].\n", INTERPBENCH_TIME_MS);
+  printf("  -r <runtime> only run this runtime.\n");
+  printf("  -w <workload> only run this workload.\n");
+  printf("  -m <path> wasm module of the wasm runtimes"
+         " [default: %s].\n", CONFIG_BENCHMARK_INTERPBENCH_WASM);
+  printf("  -j print JSON.\n");
+  printf("  -l list runtimes and workloads.\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Name: interpbench_list
+ ****************************************************************************/
+
+static void interpbench_list(void)
+{
+  size_t i;
+
+  printf("Runtimes:");
+  for (i = 0; i < nitems(g_runtimes); i++)
+    {
+      printf(" %s", g_runtimes[i]->name);
+    }
+
+  printf("\nWorkloads:");
+  for (i = 0; i < nitems(g_workloads); i++)
+    {
+      printf(" %s", g_workloads[i].name);
+    }
+
+  printf("\n");
+}
+
+/****************************************************************************
+ * Name: get_timestamp
+ ****************************************************************************/
+
+static uint64_t get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: heap_used
+ ****************************************************************************/
+
+static size_t heap_used(void)
+{
+  struct mallinfo info = mallinfo();
+
+  return info.uordblks;
+}
+
+/****************************************************************************
+ * Name: sampler_thread
+ ****************************************************************************/
+
+static FAR void *sampler_thread(FAR void *arg)
+{
+  FAR struct interpbench_sampler_s *sampler = arg;
+  size_t used;
+
+  while (!sampler->stop)
+    {
+      used = heap_used();
+      if (used > sampler->peak)
+        {
+          sampler->peak = used;
+        }
+
+      usleep(INTERPBENCH_SAMPLE_US);
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: sampler_start
+ *
+ * Description:
+ *   There are no allocator hooks to follow the heap with, so a thread one
+ *   priority above the benchmark samples it instead.  Allocations that
+ *   live shorter than the period can be missed, which is why the caller
+ *   samples after every step as well.
+ *
+ ****************************************************************************/
+
+static int sampler_start(FAR struct interpbench_sampler_s *sampler)
+{
+  struct sched_param param;
+  pthread_attr_t attr;
+  int ret;
+
+  sampler->stop = false;
+  sampler->peak = heap_used();
+
+  pthread_attr_init(&attr);
+  sched_getparam(0, &param);
+  param.sched_priority = MIN(param.sched_priority + 1,
+                             sched_get_priority_max(SCHED_FIFO));
+  pthread_attr_setschedparam(&attr, &param);
+
+  ret = pthread_create(&sampler->thread, &attr, sampler_thread, sampler);
+  pthread_attr_destroy(&attr);
+  if (ret != 0)
+    {
+      ret = pthread_create(&sampler->thread, NULL, sampler_thread, sampler);
+    }
+
+  return -ret;
+}
+
+/****************************************************************************
+ * Name: sampler_stop
+ ****************************************************************************/
+
+static size_t sampler_stop(FAR struct interpbench_sampler_s *sampler)
+{
+  sampler->stop = true;
+  pthread_join(sampler->thread, NULL);
+  return sampler->peak;
+}
+
+/****************************************************************************
+ * Name: interpbench_startup
+ *
+ * Description:
+ *   Create and destroy the runtime a few times and keep the fastest
+ *   start, and the heap held by the started runtime.
+ *
+ ****************************************************************************/
+
+static int interpbench_startup(FAR const struct interpbench_runtime_s *rt,
+                               FAR uint64_t *ns, FAR size_t *heap)
+{
+  uint64_t elapsed;
+  uint64_t start;
+  size_t base;
+  int ret;
+  int i;
+
+  *ns = UINT64_MAX;
+
+  for (i = 0; i < INTERPBENCH_STARTUPS; i++)
+    {
+      base = heap_used();
+      start = get_timestamp();
+      ret = rt->open();
+      elapsed = get_timestamp() - start;
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      *heap = heap_used() - base;
+      *ns = MIN(*ns, elapsed);
+      rt->close();
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: interpbench_measure
+ *
+ * Description:
+ *   Run the workload in batches that double in size until one batch takes
+ *   at least the requested time.  Returns microseconds per run or a
+ *   negated errno.
+ *
+ ****************************************************************************/
+
+static double interpbench_measure(FAR struct interpbench_s *info,
+                                  FAR const struct interpbench_runtime_s *rt,
+                                  int workload)
+{
+  uint64_t target = (uint64_t)info->time_ms * 1000000;
+  uint64_t elapsed;
+  uint64_t start;
+  uint32_t batch = 1;
+  uint32_t i;
+  int32_t result;
+  int ret;
+
+  for (; ; )
+    {
+      start = get_timestamp();
+      for (i = 0; i < batch; i++)
+        {
+          ret = rt->run(workload, g_workloads[workload].n, &result);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      elapsed = get_timestamp() - start;
+      if (elapsed >= target || batch >= UINT32_MAX / 2)
+        {
+          break;
+        }
+
+      batch *= 2;
+    }
+
+  return (double)elapsed / 1000.0 / (double)batch;
+}
+
+/****************************************************************************
+ * Name: interpbench_runtime
+ *
+ * Description:
+ *   Measure one runtime.  Every workload is first run once with the heap
+ *   sampler going, which gives the peak heap and the result to check, and
+ *   only then timed, with the sampler stopped.
+ *
+ ****************************************************************************/
+
+static int interpbench_runtime(FAR struct interpbench_s *info,
+                               FAR const struct interpbench_runtime_s *rt)
+{
+  struct interpbench_sampler_s sampler;
+  int32_t result[INTERPBENCH_NWORKLOADS];
+  bool selected[INTERPBENCH_NWORKLOADS];
+  int status[INTERPBENCH_NWORKLOADS];
+  double us[INTERPBENCH_NWORKLOADS];
+  uint64_t startup;
+  size_t startup_heap;
+  size_t base;
+  size_t peak;
+  size_t used;
+  bool first = true;
+  bool ok;
+  int ret;
+  int i;
+
+  ret = interpbench_startup(rt, &startup, &startup_heap);
+  if (ret < 0)
+    {
+      fprintf(stderr, INTERPBENCH_PREFIX "%s failed to start: %d\n",
+              rt->name, ret);
+      return ret;
+    }
+
+  ret = sampler_start(&sampler);
+  if (ret < 0)
+    {
+      fprintf(stderr, INTERPBENCH_PREFIX "heap sampler failed: %d\n", ret);
+      return ret;
+    }
+
+  /* The base is taken after the sampler thread has been created, so that
+   * its stack is not counted as held by the runtime.
+   */
+
+  base = heap_used();
+
+  ret = rt->open();
+  peak = heap_used();
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS && ret >= 0; i++)
+    {
+      selected[i] = info->workload == NULL ||
+                    strcmp(info->workload, g_workloads[i].name) == 0;
+      if (!selected[i])
+        {
+          continue;
+        }
+
+      status[i] = rt->run(i, g_workloads[i].n, &result[i]);
+      used = heap_used();
+      peak = MAX(peak, used);
+    }
+
+  peak = MAX(peak, sampler_stop(&sampler));
+  if (ret < 0)
+    {
+      fprintf(stderr, INTERPBENCH_PREFIX "%s failed to start: %d\n",
+              rt->name, ret);
+      return ret;
+    }
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      if (!selected[i] || status[i] < 0)
+        {
+          continue;
+        }
+
+      us[i] = interpbench_measure(info, rt, i);
+      if (us[i] < 0)
+        {
+          status[i] = (int)us[i];
+        }
+    }
+
+  rt->close();
+
+  if (info->json)
+    {
+      printf("%s\n    {\"name\": \"%s\", \"startup_us\": %.1f, "
+             "\"startup_heap\": %zu, \"peak_heap\": %zu, \"workloads\": [",
+             info->first ? "" : ",", rt->name, (double)startup / 1000.0,
+             startup_heap, peak - MIN(peak, base));
+      info->first = false;
+    }
+  else
+    {
+      printf("%-10s %-8s %6s %12.1f %12zu %12zu\n", rt->name, "startup",
+             "-", (double)startup / 1000.0, startup_heap,
+             peak - MIN(peak, base));
+    }
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      if (!selected[i])
+        {
+          continue;
+        }
+
+      if (status[i] == -ENOTSUP)
+        {
+          if (!info->json)
+            {
+              printf("%-10s %-8s not supported\n", rt->name,
+                     g_workloads[i].name);
+            }
+
+          continue;
+        }
+
+      if (status[i] < 0)
+        {
+          fprintf(stderr, INTERPBENCH_PREFIX "%s %s failed: %d\n",
+                  rt->name, g_workloads[i].name, status[i]);
+          ret = status[i];
+          continue;
+        }
+
+      ok = result[i] == g_workloads[i].reference(g_workloads[i].n);
+      if (!ok)
+        {
+          ret = -EINVAL;
+        }
+
+      if (info->json)
+        {
+          printf("%s\n      {\"name\": \"%s\", \"n\": %" PRId32 ", "
+                 "\"us_per_run\": %.3f, \"result\": %" PRId32 ", "
+                 "\"ok\": %s}", first ? "" : ",", g_workloads[i].name,
+                 g_workloads[i].n, us[i], result[i],
+                 ok ? "true" : "false");
+          first = false;
+        }
+      else
+        {
+          printf("%-10s %-8s %6" PRId32 " %12.3f %12" PRId32 " %12s\n",
+                 rt->name, g_workloads[i].name, g_workloads[i].n, us[i],
+                 result[i], ok ? "ok" : "WRONG");
+        }
+    }
+
+  if (info->json)
+    {
+      printf("\n    ]}");
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: parse_commandline
+ ****************************************************************************/
+
+static void parse_commandline(int argc, FAR char **argv,
+                              FAR struct interpbench_s *info)
+{
+  int ch;
+
+  memset(info, 0, sizeof(struct interpbench_s));
+  info->time_ms = INTERPBENCH_TIME_MS;
+  info->first   = true;
+
+  while ((ch = getopt(argc, argv, "t:r:w:m:jlh")) != ERROR)
+    {
+      switch (ch)
+        {
+          case 't':
+            info->time_ms = strtoul(optarg, NULL, 10);
+            break;
+          case 'r':
+            info->runtime = optarg;
+            break;
+          case 'w':
+            info->workload = optarg;
+            break;
+          case 'm':
+            g_wasmpath = optarg;
+            break;
+          case 'j':
+            info->json = true;
+            break;
+          case 'l':
+            interpbench_list();
+            exit(EXIT_SUCCESS);
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+          default:
+            fprintf(stderr, INTERPBENCH_PREFIX "Unknown option: %c\n",
+                    (char)optopt);
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (info->time_ms == 0)
+    {
+      fprintf(stderr, INTERPBENCH_PREFIX "Invalid time\n");
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: interpbench_add
+ ****************************************************************************/
+
+int32_t interpbench_add(int32_t a, int32_t b)
+{
+  return (int32_t)(((uint32_t)a + (uint32_t)b) & 0x7fffffff);
+}
+
+/****************************************************************************
+ * Name: interpbench_readfile
+ ****************************************************************************/
+
+FAR uint8_t *interpbench_readfile(FAR const char *path, FAR size_t *size)
+{
+  FAR uint8_t *buf;
+  struct stat st;
+  ssize_t nread;
+  size_t done;
+  int fd;
+
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    {
+      return NULL;
+    }
+
+  if (fstat(fd, &st) < 0 || st.st_size == 0 ||
+      (buf = malloc(st.st_size)) == NULL)
+    {
+      close(fd);
+      return NULL;
+    }
+
+  for (done = 0; done < (size_t)st.st_size; done += nread)
+    {
+      nread = read(fd, buf + done, st.st_size - done);
+      if (nread <= 0)
+        {
+          free(buf);
+          close(fd);
+          return NULL;
+        }
+    }
+
+  close(fd);
+  *size = st.st_size;
+  return buf;
+}
+
+/****************************************************************************
+ * Name: interpbench_wasmpath
+ ****************************************************************************/
+
+FAR const char *interpbench_wasmpath(void)
+{
+  return g_wasmpath;
+}
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  FAR const struct interpbench_runtime_s *rt;
+  struct interpbench_s info;
+  int status = 0;
+  int ret;
+  size_t i;
+
+  parse_commandline(argc, argv, &info);
+
+  if (info.json)
+    {
+      printf("{\n  \"time_ms\": %" PRIu32 ",\n  \"runtimes\": [",
+             info.time_ms);
+    }
+  else
+    {
+      printf("%-10s %-8s %6s %12s %12s %12s\n", "Runtime", "Workload",
+             "N", "us/run", "Result", "Check");
+      printf("%-10s %-8s %6s %12s %12s %12s\n", "", "", "",
+             "startup us", "heap B", "peak heap B");
+    }
+
+  for (i = 0; i < nitems(g_runtimes); i++)
+    {
+      rt = g_runtimes[i];
+      if (info.runtime != NULL && strcmp(info.runtime, rt->name) != 0)
+        {
+          continue;
+        }
+
+      /* A runtime that fails does not stop the others from being
+       * measured, but the failure shows in the exit status.
+       */
+
+      ret = interpbench_runtime(&info, rt);
+      if (ret < 0)
+        {
+          status = ret;
+        }
+    }
+
+  if (info.json)
+    {
+      printf("\n  ]\n}\n");
+    }
+
+  return status < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
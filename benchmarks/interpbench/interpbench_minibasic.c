@@ -0,0 +1,163 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_minibasic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "interpreters/minibasic.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MINIBASIC_SCRIPT_SIZE  512
+#define MINIBASIC_OUTPUT_SIZE  32
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_minibasic_open(void);
+static int bench_minibasic_run(int workload, int32_t n,
+                               FAR int32_t *result);
+static void bench_minibasic_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* basic() runs a whole script, so every run parses its script again; that
+ * is what running a minibasic script costs.  There are no subroutines, so
+ * fib walks the same call tree with an explicit stack, and there are no
+ * hash tables, JSON or host functions, so only fib and string are defined.
+ * Numbers print with %g, so results are printed in two halves.
+ */
+
+static FAR const char *const g_minibasic_scripts[INTERPBENCH_NWORKLOADS] =
+{
+  "10 DIM S(64)\n"
+  "20 LET S(1) = %" PRId32 "\n"
+  "30 LET P = 1\n"
+  "40 LET R = 0\n"
+  "50 IF P = 0 THEN 150\n"
+  "60 LET M = S(P)\n"
+  "70 LET P = P - 1\n"
+  "80 IF M < 2 THEN 130\n"
+  "90 LET S(P + 1) = M - 1\n"
+  "100 LET S(P + 2) = M - 2\n"
+  "110 LET P = P + 2\n"
+  "120 GOTO 50\n"
+  "130 LET R = R + M\n"
+  "140 GOTO 50\n"
+  "150 PRINT INT(R / 1000), R - INT(R / 1000) * 1000\n",
+
+  "10 LET S$ = \"\"\n"
+  "20 FOR I = 0 TO %" PRId32 " - 1\n"
+  "30 LET S$ = S$ + STR$(I) + \",\"\n"
+  "40 NEXT I\n"
+  "50 LET R = LEN(S$)\n"
+  "60 PRINT INT(R / 1000), R - INT(R / 1000) * 1000\n",
+
+  NULL, NULL, NULL
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_minibasic =
+{
+  "minibasic", bench_minibasic_open, bench_minibasic_run,
+  bench_minibasic_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_minibasic_open
+ ****************************************************************************/
+
+static int bench_minibasic_open(void)
+{
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_minibasic_run
+ ****************************************************************************/
+
+static int bench_minibasic_run(int workload, int32_t n,
+                               FAR int32_t *result)
+{
+  char script[MINIBASIC_SCRIPT_SIZE];
+  char output[MINIBASIC_OUTPUT_SIZE];
+  int32_t high;
+  int32_t low;
+  FAR FILE *out;
+  int ret;
+
+  if (g_minibasic_scripts[workload] == NULL)
+    {
+      return -ENOTSUP;
+    }
+
+  snprintf(script, sizeof(script), g_minibasic_scripts[workload], n);
+
+  memset(output, 0, sizeof(output));
+  out = fmemopen(output, sizeof(output) - 1, "w");
+  if (out == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  ret = basic(script, stdin, out, stdout);
+  fclose(out);
+
+  if (ret != 0 ||
+      sscanf(output, "%" SCNd32 " %" SCNd32, &high, &low) != 2)
+    {
+      return -EIO;
+    }
+
+  *result = high * 1000 + low;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_minibasic_close
+ ****************************************************************************/
+
+static void bench_minibasic_close(void)
+{
+}
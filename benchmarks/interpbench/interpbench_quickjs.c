@@ -0,0 +1,248 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_quickjs.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "quickjs/quickjs.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_qjs_open(void);
+static int bench_qjs_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_qjs_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const char g_qjs_script[] =
+  "function bench_fib(n) {\n"
+  "  return n < 2 ? n : bench_fib(n - 1) + bench_fib(n - 2);\n"
+  "}\n"
+  "\n"
+  "function bench_string(n) {\n"
+  "  let s = '';\n"
+  "  for (let i = 0; i < n; i++) {\n"
+  "    s += i + ',';\n"
+  "  }\n"
+  "  return s.length;\n"
+  "}\n"
+  "\n"
+  "function bench_table(n) {\n"
+  "  const t = new Map();\n"
+  "  let sum = 0;\n"
+  "  for (let i = 0; i < n; i++) {\n"
+  "    t.set('k' + i, i);\n"
+  "  }\n"
+  "  for (let i = 0; i < n; i++) {\n"
+  "    sum += t.get('k' + i);\n"
+  "  }\n"
+  "  for (let i = 0; i < n; i += 2) {\n"
+  "    t.delete('k' + i);\n"
+  "  }\n"
+  "  for (let i = 0; i < n; i++) {\n"
+  "    sum += t.get('k' + i) || 0;\n"
+  "  }\n"
+  "  return sum + t.size;\n"
+  "}\n"
+  "\n"
+  "function bench_json(n) {\n"
+  "  let sum = 0;\n"
+  "  for (let i = 0; i < n; i++) {\n"
+  "    const s = JSON.stringify({\n"
+  "      id: i, name: 'item' + i, tags: ['x', 'y'],\n"
+  "      values: [i, i + 1, i + 2]\n"
+  "    });\n"
+  "    const r = JSON.parse(s);\n"
+  "    sum += s.length + r.id + r.name.length + r.tags.length +\n"
+  "           r.tags[0].length + r.tags[1].length + r.values.length +\n"
+  "           r.values[0] + r.values[1] + r.values[2];\n"
+  "  }\n"
+  "  return sum;\n"
+  "}\n"
+  "\n"
+  "function bench_ffi(n) {\n"
+  "  const add = interpbench_add;\n"
+  "  let acc = 0;\n"
+  "  for (let i = 0; i < n; i++) {\n"
+  "    acc = add(acc, i);\n"
+  "  }\n"
+  "  return acc;\n"
+  "}\n";
+
+static FAR const char *const g_qjs_functions[INTERPBENCH_NWORKLOADS] =
+{
+  "bench_fib", "bench_string", "bench_table", "bench_json", "bench_ffi"
+};
+
+static FAR JSRuntime *g_qjs_rt;
+static FAR JSContext *g_qjs_ctx;
+static JSValue g_qjs_global;
+static JSValue g_qjs_funcs[INTERPBENCH_NWORKLOADS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_quickjs =
+{
+  "quickjs", bench_qjs_open, bench_qjs_run, bench_qjs_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_qjs_error
+ ****************************************************************************/
+
+static void bench_qjs_error(void)
+{
+  JSValue exception = JS_GetException(g_qjs_ctx);
+  FAR const char *msg = JS_ToCString(g_qjs_ctx, exception);
+
+  fprintf(stderr, "quickjs: %s\n", msg != NULL ? msg : "exception");
+  JS_FreeCString(g_qjs_ctx, msg);
+  JS_FreeValue(g_qjs_ctx, exception);
+}
+
+/****************************************************************************
+ * Name: bench_qjs_add
+ ****************************************************************************/
+
+static JSValue bench_qjs_add(FAR JSContext *ctx, JSValueConst this_val,
+                             int argc, FAR JSValueConst *argv)
+{
+  int32_t a;
+  int32_t b;
+
+  if (JS_ToInt32(ctx, &a, argv[0]) < 0 || JS_ToInt32(ctx, &b, argv[1]) < 0)
+    {
+      return JS_EXCEPTION;
+    }
+
+  return JS_NewInt32(ctx, interpbench_add(a, b));
+}
+
+/****************************************************************************
+ * Name: bench_qjs_open
+ ****************************************************************************/
+
+static int bench_qjs_open(void)
+{
+  JSValue ret;
+  int i;
+
+  g_qjs_rt = JS_NewRuntime();
+  if (g_qjs_rt == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  g_qjs_ctx = JS_NewContext(g_qjs_rt);
+  if (g_qjs_ctx == NULL)
+    {
+      JS_FreeRuntime(g_qjs_rt);
+      return -ENOMEM;
+    }
+
+  g_qjs_global = JS_GetGlobalObject(g_qjs_ctx);
+  JS_SetPropertyStr(g_qjs_ctx, g_qjs_global, "interpbench_add",
+                    JS_NewCFunction(g_qjs_ctx, bench_qjs_add,
+                                    "interpbench_add", 2));
+
+  ret = JS_Eval(g_qjs_ctx, g_qjs_script, sizeof(g_qjs_script) - 1,
+                "interpbench.js", JS_EVAL_TYPE_GLOBAL);
+  if (JS_IsException(ret))
+    {
+      bench_qjs_error();
+      JS_FreeValue(g_qjs_ctx, g_qjs_global);
+      JS_FreeContext(g_qjs_ctx);
+      JS_FreeRuntime(g_qjs_rt);
+      return -EINVAL;
+    }
+
+  JS_FreeValue(g_qjs_ctx, ret);
+
+  /* Look the functions up once, as the embedding would */
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      g_qjs_funcs[i] = JS_GetPropertyStr(g_qjs_ctx, g_qjs_global,
+                                         g_qjs_functions[i]);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_qjs_run
+ ****************************************************************************/
+
+static int bench_qjs_run(int workload, int32_t n, FAR int32_t *result)
+{
+  JSValue arg = JS_NewInt32(g_qjs_ctx, n);
+  JSValue ret;
+  int err;
+
+  ret = JS_Call(g_qjs_ctx, g_qjs_funcs[workload], JS_UNDEFINED, 1, &arg);
+  if (JS_IsException(ret))
+    {
+      bench_qjs_error();
+      return -EIO;
+    }
+
+  err = JS_ToInt32(g_qjs_ctx, result, ret);
+  JS_FreeValue(g_qjs_ctx, ret);
+  return err < 0 ? -EIO : 0;
+}
+
+/****************************************************************************
+ * Name: bench_qjs_close
+ ****************************************************************************/
+
+static void bench_qjs_close(void)
+{
+  int i;
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      JS_FreeValue(g_qjs_ctx, g_qjs_funcs[i]);
+    }
+
+  JS_FreeValue(g_qjs_ctx, g_qjs_global);
+  JS_FreeContext(g_qjs_ctx);
+  JS_FreeRuntime(g_qjs_rt);
+}
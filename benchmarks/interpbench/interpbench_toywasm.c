@@ -0,0 +1,320 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_toywasm.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "exec_context.h"
+#include "host_instance.h"
+#include "instance.h"
+#include "load_context.h"
+#include "mem.h"
+#include "module.h"
+#include "name.h"
+#include "report.h"
+#include "type.h"
+#include "wasi.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_toywasm_add(FAR struct exec_context *ctx,
+                             FAR struct host_instance *hi,
+                             FAR const struct functype *ft,
+                             FAR const struct cell *params,
+                             FAR struct cell *results);
+static int bench_toywasm_open(void);
+static int bench_toywasm_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_toywasm_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *const g_toywasm_exports[INTERPBENCH_NWORKLOADS] =
+{
+  "bench_fib", "bench_string", "bench_table", "bench_json", "bench_ffi"
+};
+
+static const struct name g_toywasm_env = NAME_FROM_CSTR_LITERAL("env");
+
+static const struct host_func g_toywasm_funcs[] =
+{
+  {
+    .name = NAME_FROM_CSTR_LITERAL("interpbench_add"),
+    .type = "(ii)i",
+    .func = bench_toywasm_add,
+  },
+};
+
+static const struct host_module g_toywasm_modules[] =
+{
+  {
+    .module_name = &g_toywasm_env,
+    .funcs = g_toywasm_funcs,
+    .nfuncs = nitems(g_toywasm_funcs),
+  },
+};
+
+static struct mem_context g_toywasm_mctx;
+static struct host_instance g_toywasm_host;
+static FAR struct wasi_instance *g_toywasm_wasi;
+static FAR struct import_object *g_toywasm_wasi_imports;
+static FAR struct import_object *g_toywasm_imports;
+static FAR struct module *g_toywasm_module;
+static FAR struct instance *g_toywasm_inst;
+static struct exec_context g_toywasm_ctx;
+static bool g_toywasm_ctx_valid;
+static uint32_t g_toywasm_funcs_idx[INTERPBENCH_NWORKLOADS];
+
+/* toywasm refers to the bytecode for as long as the module lives */
+
+static FAR uint8_t *g_toywasm_bytes;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_toywasm =
+{
+  "toywasm", bench_toywasm_open, bench_toywasm_run, bench_toywasm_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_toywasm_add
+ ****************************************************************************/
+
+static int bench_toywasm_add(FAR struct exec_context *ctx,
+                             FAR struct host_instance *hi,
+                             FAR const struct functype *ft,
+                             FAR const struct cell *params,
+                             FAR struct cell *results)
+{
+  HOST_FUNC_CONVERT_PARAMS(ft, params);
+  int32_t a = HOST_FUNC_PARAM(ft, params, 0, i32);
+  int32_t b = HOST_FUNC_PARAM(ft, params, 1, i32);
+
+  HOST_FUNC_RESULT_SET(ft, results, 0, i32, interpbench_add(a, b));
+  HOST_FUNC_FREE_CONVERTED_PARAMS();
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_toywasm_open
+ ****************************************************************************/
+
+static int bench_toywasm_open(void)
+{
+  struct load_context lctx;
+  struct report report;
+  struct name name;
+  size_t size;
+  int ret;
+  int i;
+
+  g_toywasm_bytes = interpbench_readfile(interpbench_wasmpath(), &size);
+  if (g_toywasm_bytes == NULL)
+    {
+      fprintf(stderr, "toywasm: cannot read %s\n", interpbench_wasmpath());
+      return -ENOENT;
+    }
+
+  mem_context_init(&g_toywasm_mctx);
+
+  load_context_init(&lctx, &g_toywasm_mctx);
+  ret = module_create(&g_toywasm_module, g_toywasm_bytes,
+                      g_toywasm_bytes + size, &lctx);
+  if (ret != 0)
+    {
+      fprintf(stderr, "toywasm: %s\n", report_getmessage(&lctx.report));
+    }
+
+  load_context_clear(&lctx);
+  if (ret != 0)
+    {
+      goto errout;
+    }
+
+  /* The module is linked against wasi-libc.  Unlike wasm3 and WAMR,
+   * toywasm refuses to instantiate it with unresolved imports, so the WASI
+   * imports are chained behind the host module.
+   */
+
+  ret = wasi_instance_create(&g_toywasm_mctx, &g_toywasm_wasi);
+  if (ret != 0)
+    {
+      goto errout;
+    }
+
+  ret = import_object_create_for_wasi(&g_toywasm_mctx, g_toywasm_wasi,
+                                      &g_toywasm_wasi_imports);
+  if (ret != 0)
+    {
+      goto errout;
+    }
+
+  ret = import_object_create_for_host_funcs(&g_toywasm_mctx,
+                                            g_toywasm_modules,
+                                            nitems(g_toywasm_modules),
+                                            &g_toywasm_host,
+                                            &g_toywasm_imports);
+  if (ret != 0)
+    {
+      goto errout;
+    }
+
+  g_toywasm_imports->next = g_toywasm_wasi_imports;
+
+  report_init(&report);
+  ret = instance_create(&g_toywasm_mctx, g_toywasm_module,
+                        &g_toywasm_inst, g_toywasm_imports, &report);
+  if (ret != 0)
+    {
+      fprintf(stderr, "toywasm: %s\n", report_getmessage(&report));
+    }
+
+  report_clear(&report);
+  if (ret != 0)
+    {
+      goto errout;
+    }
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      set_name_cstr(&name, g_toywasm_exports[i]);
+      ret = module_find_export(g_toywasm_module, &name, EXTERNTYPE_FUNC,
+                               &g_toywasm_funcs_idx[i]);
+      if (ret != 0)
+        {
+          fprintf(stderr, "toywasm: %s not exported\n",
+                  g_toywasm_exports[i]);
+          goto errout;
+        }
+    }
+
+  exec_context_init(&g_toywasm_ctx, g_toywasm_inst, &g_toywasm_mctx);
+  g_toywasm_ctx_valid = true;
+  return 0;
+
+errout:
+  bench_toywasm_close();
+  return -ret;
+}
+
+/****************************************************************************
+ * Name: bench_toywasm_run
+ ****************************************************************************/
+
+static int bench_toywasm_run(int workload, int32_t n, FAR int32_t *result)
+{
+  struct val param;
+  struct val res;
+  int ret;
+
+  param.u.i32 = (uint32_t)n;
+
+  ret = instance_execute_func(&g_toywasm_ctx,
+                              g_toywasm_funcs_idx[workload], &param, &res);
+  ret = instance_execute_handle_restart(&g_toywasm_ctx, ret);
+  if (ret != 0)
+    {
+      fprintf(stderr, "toywasm: %s\n",
+              report_getmessage(g_toywasm_ctx.report));
+
+      /* Start over with a clean context after a trap */
+
+      exec_context_clear(&g_toywasm_ctx);
+      exec_context_init(&g_toywasm_ctx, g_toywasm_inst, &g_toywasm_mctx);
+      return -EIO;
+    }
+
+  *result = (int32_t)res.u.i32;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_toywasm_close
+ ****************************************************************************/
+
+static void bench_toywasm_close(void)
+{
+  if (g_toywasm_ctx_valid)
+    {
+      exec_context_clear(&g_toywasm_ctx);
+      g_toywasm_ctx_valid = false;
+    }
+
+  if (g_toywasm_inst != NULL)
+    {
+      instance_destroy(g_toywasm_inst);
+      g_toywasm_inst = NULL;
+    }
+
+  if (g_toywasm_imports != NULL)
+    {
+      g_toywasm_imports->next = NULL;
+      import_object_destroy(&g_toywasm_mctx, g_toywasm_imports);
+      g_toywasm_imports = NULL;
+    }
+
+  if (g_toywasm_wasi_imports != NULL)
+    {
+      import_object_destroy(&g_toywasm_mctx, g_toywasm_wasi_imports);
+      g_toywasm_wasi_imports = NULL;
+    }
+
+  if (g_toywasm_wasi != NULL)
+    {
+      wasi_instance_destroy(g_toywasm_wasi);
+      g_toywasm_wasi = NULL;
+    }
+
+  if (g_toywasm_module != NULL)
+    {
+      module_destroy(&g_toywasm_mctx, g_toywasm_module);
+      g_toywasm_module = NULL;
+    }
+
+  if (g_toywasm_bytes != NULL)
+    {
+      mem_context_clear(&g_toywasm_mctx);
+      free(g_toywasm_bytes);
+      g_toywasm_bytes = NULL;
+    }
+}
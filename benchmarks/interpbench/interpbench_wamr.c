@@ -0,0 +1,228 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_wamr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "wasm_export.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WAMR_STACK_SIZE  (64 * 1024)
+#define WAMR_HEAP_SIZE   0
+#define WAMR_ERROR_SIZE  128
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int32_t bench_wamr_add(wasm_exec_env_t exec_env,
+                              int32_t a, int32_t b);
+
+static int bench_wamr_open(void);
+static int bench_wamr_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_wamr_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *const g_wamr_exports[INTERPBENCH_NWORKLOADS] =
+{
+  "bench_fib", "bench_string", "bench_table", "bench_json", "bench_ffi"
+};
+
+static NativeSymbol g_wamr_natives[] =
+{
+  { "interpbench_add", bench_wamr_add, "(ii)i", NULL },
+};
+
+static FAR uint8_t *g_wamr_bytes;
+static wasm_module_t g_wamr_module;
+static wasm_module_inst_t g_wamr_inst;
+static wasm_exec_env_t g_wamr_exec_env;
+static wasm_function_inst_t g_wamr_funcs[INTERPBENCH_NWORKLOADS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_wamr =
+{
+  "wamr", bench_wamr_open, bench_wamr_run, bench_wamr_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_wamr_add
+ ****************************************************************************/
+
+static int32_t bench_wamr_add(wasm_exec_env_t exec_env,
+                              int32_t a, int32_t b)
+{
+  return interpbench_add(a, b);
+}
+
+/****************************************************************************
+ * Name: bench_wamr_open
+ ****************************************************************************/
+
+static int bench_wamr_open(void)
+{
+  char error[WAMR_ERROR_SIZE];
+  RuntimeInitArgs init;
+  size_t size;
+  int i;
+
+  g_wamr_bytes = interpbench_readfile(interpbench_wasmpath(), &size);
+  if (g_wamr_bytes == NULL)
+    {
+      fprintf(stderr, "wamr: cannot read %s\n", interpbench_wasmpath());
+      return -ENOENT;
+    }
+
+  memset(&init, 0, sizeof(init));
+  init.mem_alloc_type = Alloc_With_System_Allocator;
+  init.native_module_name = "env";
+  init.native_symbols = g_wamr_natives;
+  init.n_native_symbols = sizeof(g_wamr_natives) / sizeof(NativeSymbol);
+
+  if (!wasm_runtime_full_init(&init))
+    {
+      free(g_wamr_bytes);
+      g_wamr_bytes = NULL;
+      return -ENOMEM;
+    }
+
+  /* Loading modifies the bytecode in place, so it is kept until the
+   * module is unloaded.
+   */
+
+  g_wamr_module = wasm_runtime_load(g_wamr_bytes, size, error,
+                                    sizeof(error));
+  if (g_wamr_module == NULL)
+    {
+      goto errout;
+    }
+
+  g_wamr_inst = wasm_runtime_instantiate(g_wamr_module, WAMR_STACK_SIZE,
+                                         WAMR_HEAP_SIZE, error,
+                                         sizeof(error));
+  if (g_wamr_inst == NULL)
+    {
+      goto errout;
+    }
+
+  g_wamr_exec_env = wasm_runtime_create_exec_env(g_wamr_inst,
+                                                 WAMR_STACK_SIZE);
+  if (g_wamr_exec_env == NULL)
+    {
+      snprintf(error, sizeof(error), "cannot create exec env");
+      goto errout;
+    }
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      g_wamr_funcs[i] = wasm_runtime_lookup_function(g_wamr_inst,
+                                                     g_wamr_exports[i]);
+      if (g_wamr_funcs[i] == NULL)
+        {
+          snprintf(error, sizeof(error), "%s not exported",
+                   g_wamr_exports[i]);
+          goto errout;
+        }
+    }
+
+  return 0;
+
+errout:
+  fprintf(stderr, "wamr: %s\n", error);
+  bench_wamr_close();
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: bench_wamr_run
+ ****************************************************************************/
+
+static int bench_wamr_run(int workload, int32_t n, FAR int32_t *result)
+{
+  uint32_t argv[1];
+
+  /* The result replaces the argument */
+
+  argv[0] = (uint32_t)n;
+  if (!wasm_runtime_call_wasm(g_wamr_exec_env, g_wamr_funcs[workload],
+                              1, argv))
+    {
+      fprintf(stderr, "wamr: %s\n", wasm_runtime_get_exception(g_wamr_inst));
+      wasm_runtime_clear_exception(g_wamr_inst);
+      return -EIO;
+    }
+
+  *result = (int32_t)argv[0];
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_wamr_close
+ ****************************************************************************/
+
+static void bench_wamr_close(void)
+{
+  if (g_wamr_exec_env != NULL)
+    {
+      wasm_runtime_destroy_exec_env(g_wamr_exec_env);
+      g_wamr_exec_env = NULL;
+    }
+
+  if (g_wamr_inst != NULL)
+    {
+      wasm_runtime_deinstantiate(g_wamr_inst);
+      g_wamr_inst = NULL;
+    }
+
+  if (g_wamr_module != NULL)
+    {
+      wasm_runtime_unload(g_wamr_module);
+      g_wamr_module = NULL;
+    }
+
+  wasm_runtime_destroy();
+  free(g_wamr_bytes);
+  g_wamr_bytes = NULL;
+}
@@ -0,0 +1,207 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_wasm3.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "wasm3.h"
+#include "m3_env.h"
+
+#include "interpbench.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define WASM3_STACK_SIZE  (64 * 1024)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int bench_wasm3_open(void);
+static int bench_wasm3_run(int workload, int32_t n, FAR int32_t *result);
+static void bench_wasm3_close(void);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *const g_wasm3_exports[INTERPBENCH_NWORKLOADS] =
+{
+  "bench_fib", "bench_string", "bench_table", "bench_json", "bench_ffi"
+};
+
+static IM3Environment g_wasm3_env;
+static IM3Runtime g_wasm3_runtime;
+static IM3Function g_wasm3_funcs[INTERPBENCH_NWORKLOADS];
+
+/* wasm3 refers to the bytecode for as long as the module lives */
+
+static FAR uint8_t *g_wasm3_bytes;
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct interpbench_runtime_s g_interpbench_wasm3 =
+{
+  "wasm3", bench_wasm3_open, bench_wasm3_run, bench_wasm3_close
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bench_wasm3_add
+ ****************************************************************************/
+
+m3ApiRawFunction(bench_wasm3_add)
+{
+  m3ApiReturnType(int32_t)
+  m3ApiGetArg(int32_t, a)
+  m3ApiGetArg(int32_t, b)
+
+  m3ApiReturn(interpbench_add(a, b));
+}
+
+/****************************************************************************
+ * Name: bench_wasm3_open
+ ****************************************************************************/
+
+static int bench_wasm3_open(void)
+{
+  IM3Module module;
+  M3Result res;
+  size_t size;
+  int i;
+
+  g_wasm3_bytes = interpbench_readfile(interpbench_wasmpath(), &size);
+  if (g_wasm3_bytes == NULL)
+    {
+      fprintf(stderr, "wasm3: cannot read %s\n", interpbench_wasmpath());
+      return -ENOENT;
+    }
+
+  g_wasm3_env = m3_NewEnvironment();
+  g_wasm3_runtime = g_wasm3_env != NULL ?
+    m3_NewRuntime(g_wasm3_env, WASM3_STACK_SIZE, NULL) : NULL;
+  if (g_wasm3_runtime == NULL)
+    {
+      res = m3Err_mallocFailed;
+      goto errout;
+    }
+
+  res = m3_ParseModule(g_wasm3_env, &module, g_wasm3_bytes, size);
+  if (res != m3Err_none)
+    {
+      goto errout;
+    }
+
+  res = m3_LoadModule(g_wasm3_runtime, module);
+  if (res != m3Err_none)
+    {
+      m3_FreeModule(module);
+      goto errout;
+    }
+
+  res = m3_LinkRawFunction(module, "env", "interpbench_add", "i(ii)",
+                           &bench_wasm3_add);
+  if (res != m3Err_none && res != m3Err_functionLookupFailed)
+    {
+      goto errout;
+    }
+
+  for (i = 0; i < INTERPBENCH_NWORKLOADS; i++)
+    {
+      res = m3_FindFunction(&g_wasm3_funcs[i], g_wasm3_runtime,
+                            g_wasm3_exports[i]);
+      if (res != m3Err_none)
+        {
+          goto errout;
+        }
+    }
+
+  return 0;
+
+errout:
+  fprintf(stderr, "wasm3: %s\n", res);
+  bench_wasm3_close();
+  return -EINVAL;
+}
+
+/****************************************************************************
+ * Name: bench_wasm3_run
+ ****************************************************************************/
+
+static int bench_wasm3_run(int workload, int32_t n, FAR int32_t *result)
+{
+  FAR const char *argv[1];
+  char arg[12];
+  M3Result res;
+
+  snprintf(arg, sizeof(arg), "%" PRId32, n);
+  argv[0] = arg;
+
+  res = m3_CallWithArgs(g_wasm3_funcs[workload], 1, argv);
+  if (res != m3Err_none)
+    {
+      fprintf(stderr, "wasm3: %s\n", res);
+      return -EIO;
+    }
+
+  /* The result is left in the first stack slot */
+
+  *result = *(FAR int32_t *)g_wasm3_runtime->stack;
+  return 0;
+}
+
+/****************************************************************************
+ * Name: bench_wasm3_close
+ ****************************************************************************/
+
+static void bench_wasm3_close(void)
+{
+  if (g_wasm3_runtime != NULL)
+    {
+      m3_FreeRuntime(g_wasm3_runtime);
+      g_wasm3_runtime = NULL;
+    }
+
+  if (g_wasm3_env != NULL)
+    {
+      m3_FreeEnvironment(g_wasm3_env);
+      g_wasm3_env = NULL;
+    }
+
+  free(g_wasm3_bytes);
+  g_wasm3_bytes = NULL;
+}
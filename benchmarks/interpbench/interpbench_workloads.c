@@ -0,0 +1,416 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_workloads.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "interpbench_workloads.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* At most 5 digits and a comma per number */
+
+#define STRING_SIZE   (INTERPBENCH_STRING_N * 6)
+
+/* Open addressing with linear probing, kept at most half full.  The slot
+ * count must be a power of two.
+ */
+
+#define TABLE_SLOTS   2048
+#define TABLE_KEYLEN  8
+
+#define SLOT_FREE     0
+#define SLOT_USED     1
+#define SLOT_DELETED  2
+
+#define JSON_SIZE     128
+#define JSON_DEPTH    4
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static char g_string[STRING_SIZE];
+
+static char g_keys[TABLE_SLOTS][TABLE_KEYLEN];
+static int32_t g_values[TABLE_SLOTS];
+static uint8_t g_state[TABLE_SLOTS];
+
+static char g_json[JSON_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Write the decimal digits of v, without a terminator, and return their
+ * count.
+ */
+
+static int ib_utoa(char *buf, uint32_t v)
+{
+  char tmp[10];
+  int len = 0;
+  int i;
+
+  do
+    {
+      tmp[len++] = '0' + v % 10;
+      v /= 10;
+    }
+  while (v != 0);
+
+  for (i = 0; i < len; i++)
+    {
+      buf[i] = tmp[len - 1 - i];
+    }
+
+  return len;
+}
+
+static int ib_copy(char *buf, const char *s)
+{
+  int len = 0;
+
+  while (s[len] != '\0')
+    {
+      buf[len] = s[len];
+      len++;
+    }
+
+  return len;
+}
+
+static int ib_streq(const char *a, const char *b)
+{
+  while (*a != '\0' && *a == *b)
+    {
+      a++;
+      b++;
+    }
+
+  return *a == *b;
+}
+
+static uint32_t ib_hash(const char *s)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*s != '\0')
+    {
+      hash ^= (uint8_t)*s++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/* Return the slot holding key, or -1 */
+
+static int table_find(const char *key)
+{
+  uint32_t i = ib_hash(key) & (TABLE_SLOTS - 1);
+
+  while (g_state[i] != SLOT_FREE)
+    {
+      if (g_state[i] == SLOT_USED && ib_streq(g_keys[i], key))
+        {
+          return i;
+        }
+
+      i = (i + 1) & (TABLE_SLOTS - 1);
+    }
+
+  return -1;
+}
+
+static void table_set(const char *key, int32_t value)
+{
+  uint32_t i = ib_hash(key) & (TABLE_SLOTS - 1);
+  int slot = table_find(key);
+
+  if (slot < 0)
+    {
+      /* Reuse the first deleted slot on the probe sequence */
+
+      while (g_state[i] == SLOT_USED)
+        {
+          i = (i + 1) & (TABLE_SLOTS - 1);
+        }
+
+      slot = i;
+      g_keys[slot][ib_copy(g_keys[slot], key)] = '\0';
+      g_state[slot] = SLOT_USED;
+    }
+
+  g_values[slot] = value;
+}
+
+static void table_key(char *key, int32_t i)
+{
+  key[0] = 'k';
+  key[1 + ib_utoa(key + 1, i)] = '\0';
+}
+
+/* Parse the JSON value at p, adding every number, string length and array
+ * length to *sum.  Returns the end of the value or NULL.  Only the subset
+ * the encoder produces is understood: objects, arrays, strings without
+ * escapes and integers.
+ */
+
+static const char *json_value(const char *p, int depth, int32_t *sum)
+{
+  int32_t count;
+  int32_t value;
+  int neg;
+
+  if (depth > JSON_DEPTH)
+    {
+      return 0;
+    }
+
+  switch (*p)
+    {
+      case '{':
+        p++;
+        if (*p == '}')
+          {
+            return p + 1;
+          }
+
+        for (; ; )
+          {
+            int32_t key = 0;
+
+            if (*p != '"' || (p = json_value(p, depth + 1, &key)) == 0 ||
+                *p++ != ':' || (p = json_value(p, depth + 1, sum)) == 0)
+              {
+                return 0;
+              }
+
+            if (*p == '}')
+              {
+                return p + 1;
+              }
+
+            if (*p++ != ',')
+              {
+                return 0;
+              }
+          }
+
+      case '[':
+        p++;
+        count = 0;
+        if (*p != ']')
+          {
+            for (; ; )
+              {
+                if ((p = json_value(p, depth + 1, sum)) == 0)
+                  {
+                    return 0;
+                  }
+
+                count++;
+                if (*p == ']')
+                  {
+                    break;
+                  }
+
+                if (*p++ != ',')
+                  {
+                    return 0;
+                  }
+              }
+          }
+
+        *sum += count;
+        return p + 1;
+
+      case '"':
+        p++;
+        count = 0;
+        while (*p != '"')
+          {
+            if (*p == '\0' || *p == '\\')
+              {
+                return 0;
+              }
+
+            p++;
+            count++;
+          }
+
+        *sum += count;
+        return p + 1;
+
+      default:
+        neg = *p == '-';
+        p += neg;
+        if (*p < '0' || *p > '9')
+          {
+            return 0;
+          }
+
+        for (value = 0; *p >= '0' && *p <= '9'; p++)
+          {
+            value = value * 10 + (*p - '0');
+          }
+
+        *sum += neg ? -value : value;
+        return p;
+    }
+}
+
+static int json_encode(char *buf, int32_t i)
+{
+  int len = 0;
+
+  len += ib_copy(buf + len, "{\"id\":");
+  len += ib_utoa(buf + len, i);
+  len += ib_copy(buf + len, ",\"name\":\"item");
+  len += ib_utoa(buf + len, i);
+  len += ib_copy(buf + len, "\",\"tags\":[\"x\",\"y\"],\"values\":[");
+  len += ib_utoa(buf + len, i);
+  buf[len++] = ',';
+  len += ib_utoa(buf + len, i + 1);
+  buf[len++] = ',';
+  len += ib_utoa(buf + len, i + 2);
+  len += ib_copy(buf + len, "]}");
+  buf[len] = '\0';
+
+  return len;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int32_t interpbench_fib(int32_t n)
+{
+  return n < 2 ? n : interpbench_fib(n - 1) + interpbench_fib(n - 2);
+}
+
+int32_t interpbench_string(int32_t n)
+{
+  int32_t len = 0;
+  int32_t i;
+
+  if (n > INTERPBENCH_STRING_N)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      len += ib_utoa(g_string + len, i);
+      g_string[len++] = ',';
+    }
+
+  return len;
+}
+
+int32_t interpbench_table(int32_t n)
+{
+  char key[TABLE_KEYLEN];
+  int32_t count = 0;
+  int32_t sum = 0;
+  int32_t i;
+  int slot;
+
+  if (n > INTERPBENCH_TABLE_N)
+    {
+      return -1;
+    }
+
+  for (i = 0; i < TABLE_SLOTS; i++)
+    {
+      g_state[i] = SLOT_FREE;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      table_key(key, i);
+      table_set(key, i);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      table_key(key, i);
+      sum += g_values[table_find(key)];
+    }
+
+  for (i = 0; i < n; i += 2)
+    {
+      table_key(key, i);
+      g_state[table_find(key)] = SLOT_DELETED;
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      table_key(key, i);
+      slot = table_find(key);
+      if (slot >= 0)
+        {
+          sum += g_values[slot];
+        }
+    }
+
+  for (i = 0; i < TABLE_SLOTS; i++)
+    {
+      count += g_state[i] == SLOT_USED;
+    }
+
+  return sum + count;
+}
+
+int32_t interpbench_json(int32_t n)
+{
+  int32_t sum = 0;
+  int32_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      sum += json_encode(g_json, i);
+      if (json_value(g_json, 0, &sum) == 0)
+        {
+          return -1;
+        }
+    }
+
+  return sum;
+}
+
+int32_t interpbench_ffi(int32_t n)
+{
+  int32_t acc = 0;
+  int32_t i;
+
+  for (i = 0; i < n; i++)
+    {
+      acc = interpbench_add(acc, i);
+    }
+
+  return acc;
+}
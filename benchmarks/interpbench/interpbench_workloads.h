@@ -0,0 +1,107 @@
+/****************************************************************************
+ * apps/benchmarks/interpbench/interpbench_workloads.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_BENCHMARKS_INTERPBENCH_INTERPBENCH_WORKLOADS_H
+#define __APPS_BENCHMARKS_INTERPBENCH_INTERPBENCH_WORKLOADS_H
+
+/* The C implementation of the workloads is the reference every runtime is
+ * checked against, the "native" baseline, and, built by the Wasm toolchain
+ * (guest/), the module the wasm runtimes run.  It therefore depends on
+ * nothing but the compiler.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Workloads.  Every implementation computes the same int32 result:
+ *
+ *   fib     Recursive Fibonacci number of n.
+ *   string  Append the decimal numbers 0 .. n - 1, each followed by a
+ *           comma, to a string and return its length.
+ *   table   Map the keys "k0" .. "k<n-1>" to 0 .. n - 1, sum the values
+ *           looked up by key, delete the even keys, add the values still
+ *           found for all n keys and the number of keys left.
+ *   json    n times, encode {"id": i, "name": "item<i>", "tags": ["x",
+ *           "y"], "values": [i, i + 1, i + 2]} as compact JSON and parse
+ *           it back, summing the text length and every number, string
+ *           length and array length of the parsed record.
+ *   ffi     n times, acc = interpbench_add(acc, i), a host function.
+ */
+
+#define INTERPBENCH_FIB         0
+#define INTERPBENCH_STRING      1
+#define INTERPBENCH_TABLE       2
+#define INTERPBENCH_JSON        3
+#define INTERPBENCH_FFI         4
+#define INTERPBENCH_NWORKLOADS  5
+
+/* Problem sizes.  The C implementation holds at most these many entries,
+ * the results stay well below 2^31 and below 10^9 (the BASIC scripts
+ * print them in two halves).
+ */
+
+#define INTERPBENCH_FIB_N       20
+#define INTERPBENCH_STRING_N    1000
+#define INTERPBENCH_TABLE_N     1000
+#define INTERPBENCH_JSON_N      100
+#define INTERPBENCH_FFI_N       10000
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+int32_t interpbench_fib(int32_t n);
+int32_t interpbench_string(int32_t n);
+int32_t interpbench_table(int32_t n);
+int32_t interpbench_json(int32_t n);
+int32_t interpbench_ffi(int32_t n);
+
+/* The host function of the ffi workload, (a + b) mod 2^31.  Provided by
+ * interpbench_main.c, and imported from "env" by the wasm module.
+ */
+
+#ifdef __wasm__
+__attribute__((import_module("env"), import_name("interpbench_add")))
+#endif
+int32_t interpbench_add(int32_t a, int32_t b);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APPS_BENCHMARKS_INTERPBENCH_INTERPBENCH_WORKLOADS_H */
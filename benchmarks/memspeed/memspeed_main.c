@@ -0,0 +1,630 @@
+/****************************************************************************
+ * apps/benchmarks/memspeed/memspeed_main.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MEMSPEED_PREFIX      "MEM Speed: "
+
+#define MEMSPEED_MINSIZE     1024
+#define MEMSPEED_MAXSIZE     (1024 * 1024)
+#define MEMSPEED_VOLUME      (16 * 1024 * 1024)
+#define MEMSPEED_LINE        64
+
+#ifdef CONFIG_SMP
+#  define MEMSPEED_MAXTHREADS CONFIG_SMP_NCPUS
+#else
+#  define MEMSPEED_MAXTHREADS 1
+#endif
+
+/* GCC/Clang vector extensions are lowered to NEON, SSE, RVV, ... when the
+ * target has them and to plain word copies otherwise.
+ */
+
+#if defined(__GNUC__) || defined(__clang__)
+#  define MEMSPEED_HAVE_VECTOR
+typedef uint32_t memspeed_vec_t __attribute__((vector_size(16)));
+#endif
+
+#define OPTARG_TO_VALUE(value, type, base) \
+  do \
+  { \
+    FAR char *ptr; \
+    value = (type)strtoul(optarg, &ptr, base); \
+    if (*ptr != '\0') \
+      { \
+        printf(MEMSPEED_PREFIX "Parameter error: -%c %s\n", ch, optarg); \
+        show_usage(argv[0], EXIT_FAILURE); \
+      } \
+  } while (0)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum memspeed_kernel_e
+{
+  MEMSPEED_READ = 0,
+  MEMSPEED_WRITE,
+  MEMSPEED_COPY,
+#ifdef MEMSPEED_HAVE_VECTOR
+  MEMSPEED_COPY_VEC,
+#endif
+  MEMSPEED_STRIDE,
+  MEMSPEED_NKERNELS
+};
+
+struct memspeed_s
+{
+  FAR uint8_t *base;       /* Buffer of 2 * maxsize bytes per thread */
+  bool allocated;          /* base comes from the heap */
+  size_t minsize;
+  size_t maxsize;
+  size_t volume;           /* Bytes touched per measurement point */
+  size_t stride;
+  int nthreads;
+  bool bandwidth;
+  bool latency;
+};
+
+struct memspeed_worker_s
+{
+  FAR pthread_barrier_t *barrier;
+  FAR uint8_t *src;
+  FAR uint8_t *dst;
+  size_t size;
+  size_t stride;
+  uint32_t repeat;
+  int kernel;
+  uint64_t cost;           /* Elapsed nanoseconds */
+  uintptr_t sink;          /* Keeps the read kernels alive */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const char *g_kernel_name[MEMSPEED_NKERNELS] =
+{
+  "read",
+  "write",
+  "memcpy",
+#ifdef MEMSPEED_HAVE_VECTOR
+  "copy-vec",
+#endif
+  "stride",
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: show_usage
+ ****************************************************************************/
+
+static void show_usage(FAR const char *progname, int exitcode)
+{
+  printf("\nUsage: %s -m <min-size> -s <max-size> -v <volume>"
+         " -S <stride> -t <threads> -a <hex-address> -b -l\n", progname);
+  printf("\nWhere:\n");
+  printf("  -m <decimal-size> smallest working set in bytes"
+         " [default: %d].\n", MEMSPEED_MINSIZE);
+  printf("  -s <decimal-size> largest working set in bytes"
+         " [default: %d].\n", MEMSPEED_MAXSIZE);
+  printf("  -v <decimal-size> bytes accessed per measurement"
+         " [default: %d].\n", MEMSPEED_VOLUME);
+  printf("  -S <decimal-size> stride of the stride kernel and size of the"
+         " latency nodes [default: %d].\n", MEMSPEED_LINE);
+  printf("  -t <threads> run bandwidth with 1..threads CPUs"
+         " [default: 1, max: %d].\n", MEMSPEED_MAXTHREADS);
+  printf("  -a <hex-address> test this region instead of the heap, it must"
+         " hold 2 * max-size bytes per thread.\n");
+  printf("  -b bandwidth curves only.\n");
+  printf("  -l latency curve only.\n");
+  exit(exitcode);
+}
+
+/****************************************************************************
+ * Name: parse_commandline
+ ****************************************************************************/
+
+static void parse_commandline(int argc, FAR char **argv,
+                              FAR struct memspeed_s *info)
+{
+  int ch;
+
+  memset(info, 0, sizeof(struct memspeed_s));
+  info->minsize   = MEMSPEED_MINSIZE;
+  info->maxsize   = MEMSPEED_MAXSIZE;
+  info->volume    = MEMSPEED_VOLUME;
+  info->stride    = MEMSPEED_LINE;
+  info->nthreads  = 1;
+  info->bandwidth = true;
+  info->latency   = true;
+
+  while ((ch = getopt(argc, argv, "m:s:v:S:t:a:blh")) != ERROR)
+    {
+      switch (ch)
+        {
+          case 'm':
+            OPTARG_TO_VALUE(info->minsize, size_t, 10);
+            break;
+          case 's':
+            OPTARG_TO_VALUE(info->maxsize, size_t, 10);
+            break;
+          case 'v':
+            OPTARG_TO_VALUE(info->volume, size_t, 10);
+            break;
+          case 'S':
+            OPTARG_TO_VALUE(info->stride, size_t, 10);
+            break;
+          case 't':
+            OPTARG_TO_VALUE(info->nthreads, int, 10);
+            break;
+          case 'a':
+            OPTARG_TO_VALUE(info->base, FAR uint8_t *, 16);
+            break;
+          case 'b':
+            info->latency = false;
+            break;
+          case 'l':
+            info->bandwidth = false;
+            break;
+          case 'h':
+            show_usage(argv[0], EXIT_SUCCESS);
+            break;
+          default:
+            printf(MEMSPEED_PREFIX "Unknown option: %c\n", (char)optopt);
+            show_usage(argv[0], EXIT_FAILURE);
+            break;
+        }
+    }
+
+  if (info->minsize < MEMSPEED_LINE || info->minsize > info->maxsize ||
+      info->stride < sizeof(uintptr_t) || info->stride > info->minsize ||
+      (info->stride & (sizeof(uintptr_t) - 1)) != 0 ||
+      info->nthreads < 1 || info->nthreads > MEMSPEED_MAXTHREADS)
+    {
+      printf(MEMSPEED_PREFIX "Invalid size, stride or thread count\n");
+      show_usage(argv[0], EXIT_FAILURE);
+    }
+
+  if (info->base == NULL)
+    {
+      info->base = malloc(2 * info->maxsize * info->nthreads);
+      if (info->base == NULL)
+        {
+          printf(MEMSPEED_PREFIX "Alloc Memory Failed!\n");
+          exit(EXIT_FAILURE);
+        }
+
+      info->allocated = true;
+    }
+
+  printf(MEMSPEED_PREFIX "Address: %p\n", info->base);
+  printf(MEMSPEED_PREFIX "Working set: %zu .. %zu bytes\n",
+         info->minsize, info->maxsize);
+  printf(MEMSPEED_PREFIX "Volume per point: %zu bytes\n", info->volume);
+  printf(MEMSPEED_PREFIX "Stride: %zu bytes\n", info->stride);
+  printf(MEMSPEED_PREFIX "Threads: %d\n", info->nthreads);
+}
+
+/****************************************************************************
+ * Name: get_timestamp
+ ****************************************************************************/
+
+static uint64_t get_timestamp(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/****************************************************************************
+ * Name: kernel_read
+ ****************************************************************************/
+
+static uintptr_t kernel_read(FAR const uint8_t *src, size_t size)
+{
+  FAR const uintptr_t *s = (FAR const uintptr_t *)src;
+  size_t n = size / sizeof(uintptr_t);
+  uintptr_t sum0 = 0;
+  uintptr_t sum1 = 0;
+  uintptr_t sum2 = 0;
+  uintptr_t sum3 = 0;
+
+  for (; n >= 4; n -= 4, s += 4)
+    {
+      sum0 += s[0];
+      sum1 += s[1];
+      sum2 += s[2];
+      sum3 += s[3];
+    }
+
+  return sum0 + sum1 + sum2 + sum3;
+}
+
+/****************************************************************************
+ * Name: kernel_write
+ ****************************************************************************/
+
+static void kernel_write(FAR uint8_t *dst, size_t size, uintptr_t value)
+{
+  FAR volatile uintptr_t *d = (FAR volatile uintptr_t *)dst;
+  size_t n = size / sizeof(uintptr_t);
+
+  for (; n >= 4; n -= 4, d += 4)
+    {
+      d[0] = value;
+      d[1] = value;
+      d[2] = value;
+      d[3] = value;
+    }
+}
+
+/****************************************************************************
+ * Name: kernel_copy_vec
+ ****************************************************************************/
+
+#ifdef MEMSPEED_HAVE_VECTOR
+static void kernel_copy_vec(FAR uint8_t *dst, FAR const uint8_t *src,
+                            size_t size)
+{
+  FAR memspeed_vec_t *d = (FAR memspeed_vec_t *)dst;
+  FAR const memspeed_vec_t *s = (FAR const memspeed_vec_t *)src;
+  size_t n = size / sizeof(memspeed_vec_t);
+
+  for (; n >= 4; n -= 4, d += 4, s += 4)
+    {
+      memspeed_vec_t v0 = s[0];
+      memspeed_vec_t v1 = s[1];
+      memspeed_vec_t v2 = s[2];
+      memspeed_vec_t v3 = s[3];
+
+      d[0] = v0;
+      d[1] = v1;
+      d[2] = v2;
+      d[3] = v3;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: kernel_stride
+ *
+ * Description:
+ *   Touch one word per stride, this measures the line fetch rate rather
+ *   than the raw bus bandwidth once the stride reaches the cache line.
+ *
+ ****************************************************************************/
+
+static uintptr_t kernel_stride(FAR const uint8_t *src, size_t size,
+                               size_t stride)
+{
+  uintptr_t sum = 0;
+  size_t i;
+
+  for (i = 0; i < size; i += stride)
+    {
+      sum += *(FAR const uintptr_t *)(src + i);
+    }
+
+  return sum;
+}
+
+/****************************************************************************
+ * Name: memspeed_worker
+ ****************************************************************************/
+
+static FAR void *memspeed_worker(FAR void *arg)
+{
+  FAR struct memspeed_worker_s *worker = arg;
+  uintptr_t sink = 0;
+  uint64_t start;
+  uint32_t i;
+
+  /* Warm up the working set so that page faults and cold misses of the
+   * first pass are not measured.
+   */
+
+  memcpy(worker->dst, worker->src, worker->size);
+  pthread_barrier_wait(worker->barrier);
+
+  start = get_timestamp();
+  for (i = 0; i < worker->repeat; i++)
+    {
+      switch (worker->kernel)
+        {
+          case MEMSPEED_READ:
+            sink += kernel_read(worker->src, worker->size);
+            break;
+          case MEMSPEED_WRITE:
+            kernel_write(worker->dst, worker->size, i);
+            break;
+          case MEMSPEED_COPY:
+            memcpy(worker->dst, worker->src, worker->size);
+            break;
+#ifdef MEMSPEED_HAVE_VECTOR
+          case MEMSPEED_COPY_VEC:
+            kernel_copy_vec(worker->dst, worker->src, worker->size);
+            break;
+#endif
+          case MEMSPEED_STRIDE:
+            sink += kernel_stride(worker->src, worker->size,
+                                  worker->stride);
+            break;
+        }
+    }
+
+  worker->cost = get_timestamp() - start;
+  worker->sink = sink;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: memspeed_run
+ *
+ * Description:
+ *   Run one kernel on "nthreads" threads pinned to CPU 0..nthreads-1 and
+ *   return the aggregate rate in MB/s, bounded by the slowest thread.
+ *
+ ****************************************************************************/
+
+static double memspeed_run(FAR struct memspeed_s *info, int kernel,
+                           size_t size, int nthreads)
+{
+  struct memspeed_worker_s worker[MEMSPEED_MAXTHREADS];
+  pthread_barrier_t barrier;
+  pthread_t thread[MEMSPEED_MAXTHREADS];
+  pthread_attr_t attr;
+  uint64_t bytes;
+  uint64_t cost = 0;
+  uint32_t repeat;
+  int ret;
+  int i;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
+
+  repeat = info->volume / size;
+  if (repeat == 0)
+    {
+      repeat = 1;
+    }
+
+  pthread_barrier_init(&barrier, NULL, nthreads);
+  for (i = 0; i < nthreads; i++)
+    {
+      worker[i].barrier = &barrier;
+      worker[i].src     = info->base + 2 * info->maxsize * i;
+      worker[i].dst     = worker[i].src + info->maxsize;
+      worker[i].size    = size;
+      worker[i].stride  = info->stride;
+      worker[i].repeat  = repeat;
+      worker[i].kernel  = kernel;
+
+      pthread_attr_init(&attr);
+#ifdef CONFIG_SMP
+      CPU_ZERO(&cpuset);
+      CPU_SET(i, &cpuset);
+      pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+#endif
+
+      ret = pthread_create(&thread[i], &attr, memspeed_worker, &worker[i]);
+      pthread_attr_destroy(&attr);
+      if (ret != 0)
+        {
+          printf(MEMSPEED_PREFIX "Create thread failed: %d\n", ret);
+          exit(EXIT_FAILURE);
+        }
+    }
+
+  for (i = 0; i < nthreads; i++)
+    {
+      pthread_join(thread[i], NULL);
+      if (worker[i].cost > cost)
+        {
+          cost = worker[i].cost;
+        }
+    }
+
+  pthread_barrier_destroy(&barrier);
+
+  if (cost == 0)
+    {
+      return 0;
+    }
+
+  /* The stride kernel is charged for the whole working set, so with a
+   * stride of one cache line it reports the line fill bandwidth.
+   */
+
+  bytes = (uint64_t)size * repeat * nthreads;
+  return (double)bytes * 1000.0 / cost;
+}
+
+/****************************************************************************
+ * Name: memspeed_bandwidth
+ ****************************************************************************/
+
+static void memspeed_bandwidth(FAR struct memspeed_s *info)
+{
+  size_t size;
+  int nthreads;
+  int kernel;
+
+  for (nthreads = 1; nthreads <= info->nthreads; nthreads++)
+    {
+      printf("______Bandwidth (MB/s), %d thread(s)______\n", nthreads);
+      printf("%10s", "size");
+      for (kernel = 0; kernel < MEMSPEED_NKERNELS; kernel++)
+        {
+          printf(" %10s", g_kernel_name[kernel]);
+        }
+
+      printf("\n");
+
+      for (size = info->minsize; size <= info->maxsize; size <<= 1)
+        {
+          printf("%10zu", size);
+          for (kernel = 0; kernel < MEMSPEED_NKERNELS; kernel++)
+            {
+              printf(" %10.1f", memspeed_run(info, kernel, size, nthreads));
+            }
+
+          printf("\n");
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: memspeed_latency
+ *
+ * Description:
+ *   Chase a random cyclic permutation of stride-sized nodes through the
+ *   working set.  Every load depends on the previous one, so the time per
+ *   load is the access latency of the level the working set fits in.
+ *
+ ****************************************************************************/
+
+static void memspeed_latency(FAR struct memspeed_s *info)
+{
+  FAR uint8_t *base = info->base;
+  FAR void **node;
+  uint32_t seed = 0x12345678;
+  uint64_t start;
+  uint64_t cost;
+  size_t nodes;
+  size_t loads;
+  size_t size;
+  size_t i;
+  size_t j;
+  FAR void *tmp;
+
+  printf("______Latency (ns/load), random chase______\n");
+  printf("%10s %10s\n", "size", "latency");
+
+  for (size = info->minsize; size <= info->maxsize; size <<= 1)
+    {
+      nodes = size / info->stride;
+
+      /* Point every node at itself, then shuffle the pointers with
+       * Sattolo's algorithm: applied to the identity it yields a single
+       * cycle through all nodes.  Shuffling any other permutation, even a
+       * cyclic one, may split it into several shorter cycles.
+       */
+
+      for (i = 0; i < nodes; i++)
+        {
+          *(FAR void **)(base + i * info->stride) = base + i * info->stride;
+        }
+
+      for (i = nodes - 1; i > 0; i--)
+        {
+          seed = seed * 1103515245 + 12345;
+          j    = (seed >> 8) % i;
+
+          tmp = *(FAR void **)(base + i * info->stride);
+          *(FAR void **)(base + i * info->stride) =
+            *(FAR void **)(base + j * info->stride);
+          *(FAR void **)(base + j * info->stride) = tmp;
+        }
+
+      loads = info->volume / info->stride;
+      if (loads < nodes)
+        {
+          loads = nodes;
+        }
+
+      node = (FAR void **)base;
+      for (i = 0; i < nodes; i++)
+        {
+          node = *node;
+        }
+
+      start = get_timestamp();
+      for (i = 0; i < loads; i++)
+        {
+          node = *node;
+        }
+
+      cost = get_timestamp() - start;
+
+      /* Make the chain result observable so it is not optimized out */
+
+      printf("%10zu %10.2f%s\n", size, (double)cost / loads,
+             node == NULL ? "?" : "");
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: memspeed_main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct memspeed_s memspeed;
+
+  parse_commandline(argc, argv, &memspeed);
+
+  if (memspeed.bandwidth)
+    {
+      memspeed_bandwidth(&memspeed);
+    }
+
+  if (memspeed.latency)
+    {
+      memspeed_latency(&memspeed);
+    }
+
+  if (memspeed.allocated)
+    {
+      free(memspeed.base);
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
  ****************************************************************************/
 
 #include <assert.h>
+#include <errno.h>
 #include <limits.h>
 #include <pthread.h>
 #include <sched.h>
@@ -35,11 +36,51 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/param.h>
 #include <sys/poll.h>
 
+#ifdef CONFIG_EVENT_FD
+#  include <sys/eventfd.h>
+#endif
+
+#ifndef CONFIG_DISABLE_MQUEUE
+#  include <mqueue.h>
+#endif
+
+#include <fcntl.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+
 #include <nuttx/sched.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Time given to a helper thread on another CPU to block on the primitive
+ * under test before the measurement starts.
+ */
+
+#define PERFORMANCE_SETTLE_US  1000
+
+/* Relative expiry of the timer benchmark */
+
+#define PERFORMANCE_TIMER_NS   NSEC_PER_MSEC
+
+#define PERFORMANCE_MQ_NAME    "/osperf"
+
+/* Lock/unlock pairs each thread of a contention benchmark runs */
+
+#define PERFORMANCE_CONTEND_LOOPS  1000
+
+#ifdef CONFIG_SMP
+#  define PERFORMANCE_NCPUS        CONFIG_SMP_NCPUS
+#else
+#  define PERFORMANCE_NCPUS        1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -56,6 +97,54 @@ struct performance_thread_s
   struct performance_time_s time;
 };
 
+/* Shared state of the wakeup benchmarks: the helper thread signals
+ * "ready" and then blocks on the primitive under test, the main thread
+ * starts the clock and releases it, and the helper stops the clock.
+ */
+
+struct performance_wakeup_s
+{
+  sem_t ready;
+  int fd;
+  struct performance_time_s time;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+  pthread_rwlock_t rwlock;
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+  pthread_spinlock_t spinlock;
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+  mqd_t mq;
+#endif
+  volatile bool flag;
+};
+
+/* Shared state of the contention benchmarks: every thread, one per CPU,
+ * takes and releases the same lock PERFORMANCE_CONTEND_LOOPS times.
+ */
+
+struct performance_contend_s
+{
+  sem_t ready;
+  sem_t go;
+  CODE void (*lock)(FAR struct performance_contend_s *contend);
+  CODE void (*unlock)(FAR struct performance_contend_s *contend);
+  pthread_mutex_t mutex;
+  pthread_rwlock_t rwlock;
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+  pthread_spinlock_t spinlock;
+#endif
+};
+
+struct performance_result_s
+{
+  size_t min;
+  size_t max;
+  size_t avg;
+  size_t p50;
+  size_t p99;
+};
+
 struct performance_entry_s
 {
   const char name[NAME_MAX];
@@ -73,6 +162,28 @@ static size_t hpwork_performance(void);
 static size_t poll_performance(void);
 static size_t semwait_performance(void);
 static size_t sempost_performance(void);
+static size_t mutex_performance(void);
+static size_t condvar_performance(void);
+static size_t rwlock_performance(void);
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+static size_t spinlock_performance(void);
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+static size_t mqueue_performance(void);
+#endif
+#ifdef CONFIG_EVENT_FD
+static size_t eventfd_performance(void);
+#endif
+static size_t signal_performance(void);
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+static size_t timer_performance(void);
+#endif
+static size_t epoll_performance(void);
+static size_t mutex_contend_performance(void);
+static size_t rwlock_contend_performance(void);
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+static size_t spinlock_contend_performance(void);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -87,28 +198,117 @@ static const struct performance_entry_s g_entry_list[] =
   {"poll-write", poll_performance},
   {"semwait", semwait_performance},
   {"sempost", sempost_performance},
+  {"mutex-handoff", mutex_performance},
+  {"condvar-signal", condvar_performance},
+  {"rwlock-handoff", rwlock_performance},
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+  {"spinlock", spinlock_performance},
+#endif
+#ifndef CONFIG_DISABLE_MQUEUE
+  {"mqueue", mqueue_performance},
+#endif
+#ifdef CONFIG_EVENT_FD
+  {"eventfd", eventfd_performance},
+#endif
+  {"signal", signal_performance},
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+  {"timer-expiry", timer_performance},
+#endif
+  {"epoll-write", epoll_performance},
+  {"mutex-contend", mutex_contend_performance},
+  {"rwlock-contend", rwlock_contend_performance},
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+  {"spinlock-contend", spinlock_contend_performance},
+#endif
 };
 
+/* CPU the helper threads are pinned to with -s, the main thread then runs
+ * on CPU 0.  -1 leaves the placement of all threads to the scheduler.
+ */
+
+static int g_performance_cpu = -1;
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
-static int performance_thread_create(FAR void *(*entry)(FAR void *),
-                                     FAR void *arg, int priority)
+/* Whether a run stays on the CPU of the main thread.  Only then may it
+ * hold the critical section: across CPUs the helper would queue behind
+ * the main thread for it on every wakeup.
+ */
+
+static bool performance_local(void)
+{
+#ifdef CONFIG_SMP
+  return g_performance_cpu == 0;
+#else
+  return true;
+#endif
+}
+
+static pthread_t performance_thread_create_on(FAR void *(*entry)(FAR void *),
+                                              FAR void *arg, int priority,
+                                              int cpu)
 {
   struct sched_param param;
   pthread_attr_t attr;
   pthread_t tid;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
 
   param.sched_priority = priority;
   pthread_attr_init(&attr);
   pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
   pthread_attr_setschedparam(&attr, &param);
+
+#ifdef CONFIG_SMP
+  if (cpu >= 0)
+    {
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+    }
+#else
+  UNUSED(cpu);
+#endif
+
   pthread_create(&tid, &attr, entry, arg);
   DEBUGASSERT(tid > 0);
   return tid;
 }
 
+static pthread_t performance_thread_create(FAR void *(*entry)(FAR void *),
+                                           FAR void *arg, int priority)
+{
+  return performance_thread_create_on(entry, arg, priority,
+                                      g_performance_cpu);
+}
+
+/* Create a higher priority helper and wait until it is about to block */
+
+static pthread_t performance_wakeup_create(FAR void *(*entry)(FAR void *),
+                                           FAR struct performance_wakeup_s
+                                           *wakeup)
+{
+  pthread_t tid;
+
+  tid = performance_thread_create(entry, wakeup,
+                                  CONFIG_BENCHMARK_OSPERF_PRIORITY + 1);
+  sem_wait(&wakeup->ready);
+
+  /* On the same CPU the helper preempts us and is blocked by now, on
+   * another CPU give it time to reach the blocking call.
+   */
+
+  if (!performance_local())
+    {
+      usleep(PERFORMANCE_SETTLE_US);
+    }
+
+  return tid;
+}
+
 static void performance_start(FAR struct performance_time_s *result)
 {
   result->start = perf_gettime();
@@ -133,10 +333,21 @@ static size_t performance_gettime(FAR struct performance_time_s *result)
 static FAR void *pthread_switch_task(FAR void *arg)
 {
   FAR struct performance_thread_s *perf = arg;
-  irqstate_t flags = enter_critical_section();
+  irqstate_t flags = 0;
+
+  if (performance_local())
+    {
+      flags = enter_critical_section();
+    }
+
   sem_wait(&perf->sem);
   performance_end(&perf->time);
-  leave_critical_section(flags);
+
+  if (performance_local())
+    {
+      leave_critical_section(flags);
+    }
+
   return NULL;
 }
 
@@ -193,24 +404,35 @@ static size_t pthread_create_performance(void)
 
 static FAR void *context_swtich_task(FAR void *arg)
 {
-  FAR struct performance_time_s *time = arg;
-  sched_yield();
-  performance_end(time);
+  FAR struct performance_wakeup_s *wakeup = arg;
+
+  /* Yield until the clock runs.  On our CPU this hands the CPU back to
+   * the main thread, on another CPU nothing else would hold us back.
+   */
+
+  while (!wakeup->flag)
+    {
+      sched_yield();
+    }
+
+  performance_end(&wakeup->time);
   return 0;
 }
 
 static size_t context_switch_performance(void)
 {
-  struct performance_time_s time;
+  struct performance_wakeup_s wakeup;
   int tid;
 
-  tid = performance_thread_create(context_swtich_task, &time,
+  wakeup.flag = false;
+  tid = performance_thread_create(context_swtich_task, &wakeup,
                                   CONFIG_INIT_PRIORITY);
   sched_yield();
-  performance_start(&time);
+  performance_start(&wakeup.time);
+  wakeup.flag = true;
   sched_yield();
   pthread_join(tid, NULL);
-  return performance_gettime(&time);
+  return performance_gettime(&wakeup.time);
 }
 
 /****************************************************************************
@@ -259,6 +481,13 @@ static FAR void *poll_task(FAR void *arg)
   FAR struct performance_time_s *time = argv[0];
   int pipefd = (int)(uintptr_t)argv[1];
 
+  /* On another CPU give the main thread time to block in poll() */
+
+  if (!performance_local())
+    {
+      usleep(PERFORMANCE_SETTLE_US);
+    }
+
   performance_start(time);
   write(pipefd, "a", 1);
   return 0;
@@ -328,6 +557,530 @@ static size_t sempost_performance(void)
   return performance_gettime(&result);
 }
 
+/****************************************************************************
+ * mutex_performance
+ ****************************************************************************/
+
+static FAR void *mutex_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+
+  sem_post(&wakeup->ready);
+  pthread_mutex_lock(&wakeup->mutex);
+  performance_end(&wakeup->time);
+  pthread_mutex_unlock(&wakeup->mutex);
+  return NULL;
+}
+
+static size_t mutex_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  pthread_t tid;
+
+  sem_init(&wakeup.ready, 0, 0);
+  pthread_mutex_init(&wakeup.mutex, NULL);
+
+  pthread_mutex_lock(&wakeup.mutex);
+  tid = performance_wakeup_create(mutex_task, &wakeup);
+
+  performance_start(&wakeup.time);
+  pthread_mutex_unlock(&wakeup.mutex);
+  pthread_join(tid, NULL);
+
+  pthread_mutex_destroy(&wakeup.mutex);
+  sem_destroy(&wakeup.ready);
+  return performance_gettime(&wakeup.time);
+}
+
+/****************************************************************************
+ * condvar_performance
+ ****************************************************************************/
+
+static FAR void *condvar_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+
+  pthread_mutex_lock(&wakeup->mutex);
+  sem_post(&wakeup->ready);
+  while (!wakeup->flag)
+    {
+      pthread_cond_wait(&wakeup->cond, &wakeup->mutex);
+    }
+
+  performance_end(&wakeup->time);
+  pthread_mutex_unlock(&wakeup->mutex);
+  return NULL;
+}
+
+static size_t condvar_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  pthread_t tid;
+
+  sem_init(&wakeup.ready, 0, 0);
+  pthread_mutex_init(&wakeup.mutex, NULL);
+  pthread_cond_init(&wakeup.cond, NULL);
+  wakeup.flag = false;
+
+  tid = performance_wakeup_create(condvar_task, &wakeup);
+
+  pthread_mutex_lock(&wakeup.mutex);
+  wakeup.flag = true;
+  performance_start(&wakeup.time);
+  pthread_cond_signal(&wakeup.cond);
+  pthread_mutex_unlock(&wakeup.mutex);
+  pthread_join(tid, NULL);
+
+  pthread_cond_destroy(&wakeup.cond);
+  pthread_mutex_destroy(&wakeup.mutex);
+  sem_destroy(&wakeup.ready);
+  return performance_gettime(&wakeup.time);
+}
+
+/****************************************************************************
+ * rwlock_performance
+ ****************************************************************************/
+
+static FAR void *rwlock_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+
+  sem_post(&wakeup->ready);
+  pthread_rwlock_rdlock(&wakeup->rwlock);
+  performance_end(&wakeup->time);
+  pthread_rwlock_unlock(&wakeup->rwlock);
+  return NULL;
+}
+
+static size_t rwlock_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  pthread_t tid;
+
+  sem_init(&wakeup.ready, 0, 0);
+  pthread_rwlock_init(&wakeup.rwlock, NULL);
+
+  pthread_rwlock_wrlock(&wakeup.rwlock);
+  tid = performance_wakeup_create(rwlock_task, &wakeup);
+
+  performance_start(&wakeup.time);
+  pthread_rwlock_unlock(&wakeup.rwlock);
+  pthread_join(tid, NULL);
+
+  pthread_rwlock_destroy(&wakeup.rwlock);
+  sem_destroy(&wakeup.ready);
+  return performance_gettime(&wakeup.time);
+}
+
+/****************************************************************************
+ * spinlock_performance
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+static FAR void *spinlock_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+
+  sem_post(&wakeup->ready);
+  pthread_spin_lock(&wakeup->spinlock);
+  performance_end(&wakeup->time);
+  pthread_spin_unlock(&wakeup->spinlock);
+  return NULL;
+}
+
+static size_t spinlock_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  pthread_t tid;
+
+  pthread_spin_init(&wakeup.spinlock, PTHREAD_PROCESS_PRIVATE);
+
+  /* A spinning helper on our own CPU would never let us release the
+   * lock, so only measure the uncontended lock/unlock pair unless the
+   * helper is pinned to another CPU.
+   */
+
+  if (g_performance_cpu <= 0)
+    {
+      performance_start(&wakeup.time);
+      pthread_spin_lock(&wakeup.spinlock);
+      pthread_spin_unlock(&wakeup.spinlock);
+      performance_end(&wakeup.time);
+    }
+  else
+    {
+      sem_init(&wakeup.ready, 0, 0);
+      pthread_spin_lock(&wakeup.spinlock);
+      tid = performance_wakeup_create(spinlock_task, &wakeup);
+
+      performance_start(&wakeup.time);
+      pthread_spin_unlock(&wakeup.spinlock);
+      pthread_join(tid, NULL);
+      sem_destroy(&wakeup.ready);
+    }
+
+  pthread_spin_destroy(&wakeup.spinlock);
+  return performance_gettime(&wakeup.time);
+}
+#endif
+
+/****************************************************************************
+ * mqueue_performance
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_MQUEUE
+static FAR void *mqueue_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+  char msg;
+
+  sem_post(&wakeup->ready);
+  mq_receive(wakeup->mq, &msg, sizeof(msg), NULL);
+  performance_end(&wakeup->time);
+  return NULL;
+}
+
+static size_t mqueue_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  struct mq_attr attr;
+  pthread_t tid;
+
+  memset(&attr, 0, sizeof(attr));
+  attr.mq_maxmsg  = 1;
+  attr.mq_msgsize = 1;
+
+  wakeup.mq = mq_open(PERFORMANCE_MQ_NAME, O_RDWR | O_CREAT, 0666, &attr);
+  DEBUGASSERT(wakeup.mq != (mqd_t)-1);
+  sem_init(&wakeup.ready, 0, 0);
+
+  tid = performance_wakeup_create(mqueue_task, &wakeup);
+
+  performance_start(&wakeup.time);
+  mq_send(wakeup.mq, "a", 1, 0);
+  pthread_join(tid, NULL);
+
+  sem_destroy(&wakeup.ready);
+  mq_close(wakeup.mq);
+  mq_unlink(PERFORMANCE_MQ_NAME);
+  return performance_gettime(&wakeup.time);
+}
+#endif
+
+/****************************************************************************
+ * eventfd_performance
+ ****************************************************************************/
+
+#ifdef CONFIG_EVENT_FD
+static FAR void *eventfd_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+  eventfd_t value;
+
+  sem_post(&wakeup->ready);
+  eventfd_read(wakeup->fd, &value);
+  performance_end(&wakeup->time);
+  return NULL;
+}
+
+static size_t eventfd_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  pthread_t tid;
+
+  wakeup.fd = eventfd(0, 0);
+  DEBUGASSERT(wakeup.fd >= 0);
+  sem_init(&wakeup.ready, 0, 0);
+
+  tid = performance_wakeup_create(eventfd_task, &wakeup);
+
+  performance_start(&wakeup.time);
+  eventfd_write(wakeup.fd, 1);
+  pthread_join(tid, NULL);
+
+  sem_destroy(&wakeup.ready);
+  close(wakeup.fd);
+  return performance_gettime(&wakeup.time);
+}
+#endif
+
+/****************************************************************************
+ * signal_performance
+ ****************************************************************************/
+
+static FAR void *signal_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+  sigset_t set;
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGUSR1);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  sem_post(&wakeup->ready);
+  sigwaitinfo(&set, NULL);
+  performance_end(&wakeup->time);
+  return NULL;
+}
+
+static size_t signal_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  pthread_t tid;
+
+  sem_init(&wakeup.ready, 0, 0);
+  tid = performance_wakeup_create(signal_task, &wakeup);
+
+  performance_start(&wakeup.time);
+  pthread_kill(tid, SIGUSR1);
+  pthread_join(tid, NULL);
+
+  sem_destroy(&wakeup.ready);
+  return performance_gettime(&wakeup.time);
+}
+
+/****************************************************************************
+ * timer_performance
+ ****************************************************************************/
+
+#ifndef CONFIG_DISABLE_POSIX_TIMERS
+static size_t timer_performance(void)
+{
+  struct performance_time_s result;
+  struct itimerspec its;
+  struct sigevent sev;
+  timer_t timerid;
+  sigset_t set;
+  size_t time;
+  int ret;
+
+  sigemptyset(&set);
+  sigaddset(&set, SIGUSR2);
+  sigprocmask(SIG_BLOCK, &set, NULL);
+
+  memset(&sev, 0, sizeof(sev));
+  sev.sigev_notify = SIGEV_SIGNAL;
+  sev.sigev_signo  = SIGUSR2;
+  ret = timer_create(CLOCK_MONOTONIC, &sev, &timerid);
+  DEBUGASSERT(ret == 0);
+
+  memset(&its, 0, sizeof(its));
+  its.it_value.tv_nsec = PERFORMANCE_TIMER_NS;
+
+  /* Report the lateness of the expiry notification, not the period */
+
+  performance_start(&result);
+  timer_settime(timerid, 0, &its, NULL);
+  sigwaitinfo(&set, NULL);
+  performance_end(&result);
+
+  timer_delete(timerid);
+  sigprocmask(SIG_UNBLOCK, &set, NULL);
+
+  time = performance_gettime(&result);
+  return time > PERFORMANCE_TIMER_NS ? time - PERFORMANCE_TIMER_NS : 0;
+}
+#endif
+
+/****************************************************************************
+ * epoll_performance
+ ****************************************************************************/
+
+static FAR void *epoll_task(FAR void *arg)
+{
+  FAR struct performance_wakeup_s *wakeup = arg;
+  struct epoll_event event;
+
+  sem_post(&wakeup->ready);
+  epoll_wait(wakeup->fd, &event, 1, -1);
+  performance_end(&wakeup->time);
+  return NULL;
+}
+
+static size_t epoll_performance(void)
+{
+  struct performance_wakeup_s wakeup;
+  struct epoll_event event;
+  int pipefd[2];
+  pthread_t tid;
+  int ret;
+
+  ret = pipe(pipefd);
+  DEBUGASSERT(ret == 0);
+
+  wakeup.fd = epoll_create1(0);
+  DEBUGASSERT(wakeup.fd >= 0);
+
+  event.events  = EPOLLIN;
+  event.data.fd = pipefd[0];
+  ret = epoll_ctl(wakeup.fd, EPOLL_CTL_ADD, pipefd[0], &event);
+  DEBUGASSERT(ret == 0);
+
+  sem_init(&wakeup.ready, 0, 0);
+  tid = performance_wakeup_create(epoll_task, &wakeup);
+
+  performance_start(&wakeup.time);
+  write(pipefd[1], "a", 1);
+  pthread_join(tid, NULL);
+
+  sem_destroy(&wakeup.ready);
+  close(wakeup.fd);
+  close(pipefd[0]);
+  close(pipefd[1]);
+  return performance_gettime(&wakeup.time);
+}
+
+/****************************************************************************
+ * Contention performance
+ ****************************************************************************/
+
+static void performance_contend_loop(FAR struct performance_contend_s
+                                     *contend)
+{
+  int i;
+
+  for (i = 0; i < PERFORMANCE_CONTEND_LOOPS; i++)
+    {
+      contend->lock(contend);
+      contend->unlock(contend);
+    }
+}
+
+static FAR void *contend_task(FAR void *arg)
+{
+  FAR struct performance_contend_s *contend = arg;
+
+  sem_post(&contend->ready);
+  sem_wait(&contend->go);
+  performance_contend_loop(contend);
+  return NULL;
+}
+
+/* Run the lock/unlock loop on one thread per CPU at once and return the
+ * time per pair.  With -s the threads are pinned to CPU 0 up to the swept
+ * CPU, so the sweep scales the contention from 1 to N CPUs; otherwise one
+ * thread per CPU is left to the scheduler.
+ */
+
+static size_t performance_contend(FAR struct performance_contend_s *contend)
+{
+  struct performance_time_s time;
+  pthread_t tid[PERFORMANCE_NCPUS];
+  int nthreads;
+  int i;
+
+  nthreads = g_performance_cpu < 0 ? PERFORMANCE_NCPUS :
+             g_performance_cpu + 1;
+
+  sem_init(&contend->ready, 0, 0);
+  sem_init(&contend->go, 0, 0);
+
+  for (i = 1; i < nthreads; i++)
+    {
+      tid[i] = performance_thread_create_on(contend_task, contend,
+                                            CONFIG_BENCHMARK_OSPERF_PRIORITY,
+                                            g_performance_cpu < 0 ? -1 : i);
+      sem_wait(&contend->ready);
+    }
+
+  performance_start(&time);
+  for (i = 1; i < nthreads; i++)
+    {
+      sem_post(&contend->go);
+    }
+
+  performance_contend_loop(contend);
+  for (i = 1; i < nthreads; i++)
+    {
+      pthread_join(tid[i], NULL);
+    }
+
+  performance_end(&time);
+
+  sem_destroy(&contend->go);
+  sem_destroy(&contend->ready);
+  return performance_gettime(&time) /
+         (nthreads * PERFORMANCE_CONTEND_LOOPS);
+}
+
+static void mutex_contend_lock(FAR struct performance_contend_s *contend)
+{
+  pthread_mutex_lock(&contend->mutex);
+}
+
+static void mutex_contend_unlock(FAR struct performance_contend_s *contend)
+{
+  pthread_mutex_unlock(&contend->mutex);
+}
+
+static size_t mutex_contend_performance(void)
+{
+  struct performance_contend_s contend;
+  size_t time;
+
+  pthread_mutex_init(&contend.mutex, NULL);
+  contend.lock   = mutex_contend_lock;
+  contend.unlock = mutex_contend_unlock;
+
+  time = performance_contend(&contend);
+
+  pthread_mutex_destroy(&contend.mutex);
+  return time;
+}
+
+static void rwlock_contend_lock(FAR struct performance_contend_s *contend)
+{
+  pthread_rwlock_wrlock(&contend->rwlock);
+}
+
+static void rwlock_contend_unlock(FAR struct performance_contend_s *contend)
+{
+  pthread_rwlock_unlock(&contend->rwlock);
+}
+
+static size_t rwlock_contend_performance(void)
+{
+  struct performance_contend_s contend;
+  size_t time;
+
+  pthread_rwlock_init(&contend.rwlock, NULL);
+  contend.lock   = rwlock_contend_lock;
+  contend.unlock = rwlock_contend_unlock;
+
+  time = performance_contend(&contend);
+
+  pthread_rwlock_destroy(&contend.rwlock);
+  return time;
+}
+
+#ifdef CONFIG_PTHREAD_SPINLOCKS
+static void spinlock_contend_lock(FAR struct performance_contend_s *contend)
+{
+  pthread_spin_lock(&contend->spinlock);
+}
+
+static void
+spinlock_contend_unlock(FAR struct performance_contend_s *contend)
+{
+  pthread_spin_unlock(&contend->spinlock);
+}
+
+static size_t spinlock_contend_performance(void)
+{
+  struct performance_contend_s contend;
+  size_t time;
+
+  pthread_spin_init(&contend.spinlock, PTHREAD_PROCESS_PRIVATE);
+  contend.lock   = spinlock_contend_lock;
+  contend.unlock = spinlock_contend_unlock;
+
+  time = performance_contend(&contend);
+
+  pthread_spin_destroy(&contend.spinlock);
+  return time;
+}
+#endif
+
 /****************************************************************************
  * performance_help
  ****************************************************************************/
@@ -338,47 +1091,119 @@ static void performance_help(void)
   printf("OPTIONS:\n");
   printf("\t-c, \tNumber of times to run each test\n");
   printf("\t-d, \tShow detail of each test\n");
+  printf("\t-j, \tPrint the results as JSON\n");
+#ifdef CONFIG_SMP
+  printf("\t-s, \tPin the main thread to CPU 0 and repeat for CPU 0..N-1:\n"
+         "\t    \twakeup helpers on that CPU, contention on CPU 0 to it\n");
+#endif
   printf("\t-h, \tShow this help message\n");
   printf("\t-l, \tList all tests\n");
 }
 
+/****************************************************************************
+ * performance_compare
+ ****************************************************************************/
+
+static int performance_compare(FAR const void *a, FAR const void *b)
+{
+  size_t ta = *(FAR const size_t *)a;
+  size_t tb = *(FAR const size_t *)b;
+
+  return ta < tb ? -1 : ta > tb;
+}
+
 /****************************************************************************
  * performance_run
  ****************************************************************************/
 
-static void performance_run(const FAR struct performance_entry_s *item,
-                            size_t count, bool detail)
+static int performance_run(const FAR struct performance_entry_s *item,
+                           size_t count, bool detail,
+                           FAR struct performance_result_s *result)
 {
+  FAR size_t *samples;
   size_t total = 0;
-  size_t max = 0;
-  size_t min = 0;
   size_t i;
 
+  samples = malloc(count * sizeof(*samples));
+  if (samples == NULL)
+    {
+      return -ENOMEM;
+    }
+
   for (i = 0; i < count; i++)
     {
-      irqstate_t flags = enter_critical_section();
-      size_t time = item->entry();
-      leave_critical_section(flags);
+      irqstate_t flags = 0;
 
-      total += time;
-      if (time > max)
+      if (performance_local())
         {
-          max = time;
+          flags = enter_critical_section();
         }
 
-      if (time < min || min == 0)
+      samples[i] = item->entry();
+
+      if (performance_local())
         {
-          min = time;
+          leave_critical_section(flags);
         }
 
+      total += samples[i];
       if (detail)
         {
-          printf("\t%zu: %zu\n", i, time);
+          printf("\t%zu: %zu\n", i, samples[i]);
         }
     }
 
-  printf("%-*s %10zu %10zu %10zu\n", NAME_MAX, item->name, max, min,
-         total / count);
+  qsort(samples, count, sizeof(*samples), performance_compare);
+
+  result->min = samples[0];
+  result->max = samples[count - 1];
+  result->avg = total / count;
+  result->p50 = samples[(count - 1) / 2];
+  result->p99 = samples[(count - 1) * 99 / 100];
+
+  free(samples);
+  return 0;
+}
+
+/****************************************************************************
+ * performance_report
+ ****************************************************************************/
+
+static void performance_report(const FAR struct performance_entry_s *item,
+                               FAR const struct performance_result_s *result,
+                               bool json, FAR bool *first)
+{
+  char cpu[12];
+
+  /* Without -s the threads are not pinned to any CPU */
+
+  if (g_performance_cpu < 0)
+    {
+      strlcpy(cpu, json ? "null" : "-", sizeof(cpu));
+    }
+  else
+    {
+      snprintf(cpu, sizeof(cpu), "%d", g_performance_cpu);
+    }
+
+  if (json)
+    {
+      printf("%s\n    {\"name\": \"%s\", \"cpu\": %s, "
+             "\"csection\": %s, \"max\": %zu, \"min\": %zu, "
+             "\"avg\": %zu, \"p50\": %zu, \"p99\": %zu}",
+             *first ? "" : ",", item->name, cpu,
+             performance_local() ? "true" : "false",
+             result->max, result->min, result->avg, result->p50,
+             result->p99);
+    }
+  else
+    {
+      printf("%-*s %3s %10zu %10zu %10zu %10zu %10zu\n", NAME_MAX,
+             item->name, cpu, result->max, result->min,
+             result->avg, result->p50, result->p99);
+    }
+
+  *first = false;
 }
 
 /****************************************************************************
@@ -418,12 +1243,21 @@ void performance_list(void)
 int main(int argc, FAR char *argv[])
 {
   const FAR struct performance_entry_s *item = NULL;
+  struct performance_result_s result;
   bool detail = false;
+  bool sweep = false;
+  bool json = false;
+  bool first = true;
   size_t count = 100;
+  int ncpus = 1;
   size_t i;
+  int cpu;
   int opt;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+#endif
 
-  while ((opt = getopt(argc, argv, "dc:hl")) != -1)
+  while ((opt = getopt(argc, argv, "dc:hljs")) != -1)
     {
       switch (opt)
         {
@@ -439,12 +1273,24 @@ int main(int argc, FAR char *argv[])
           case 'l':
             performance_list();
             return EXIT_SUCCESS;
+          case 'j':
+            json = true;
+            break;
+          case 's':
+            sweep = true;
+            break;
           default:
             performance_help();
             return EXIT_FAILURE;
         }
     }
 
+  if (count == 0)
+    {
+      performance_help();
+      return EXIT_FAILURE;
+    }
+
   if (optind < argc)
     {
       item = find_entry(argv[optind]);
@@ -455,22 +1301,80 @@ int main(int argc, FAR char *argv[])
         }
     }
 
-  printf("OS performance args: count:%zu, detail:%s\n", count,
-         detail ? "true" : "false");
+#ifdef CONFIG_SMP
+  /* With -s keep the main thread on CPU 0 so the CPU column is the
+   * placement of the helper threads relative to it.
+   */
 
-  printf("==============================================================\n");
-  printf("%-*s %10s %10s %10s\n", NAME_MAX, "Describe", "Max", "Min", "Avg");
+  if (sweep)
+    {
+      CPU_ZERO(&cpuset);
+      CPU_SET(0, &cpuset);
+      sched_setaffinity(0, sizeof(cpuset), &cpuset);
+      ncpus = CONFIG_SMP_NCPUS;
+    }
+#else
+  UNUSED(sweep);
+#endif
 
-  if (item != NULL)
+  if (json)
     {
-      performance_run(item, count, detail);
-      return EXIT_SUCCESS;
+      printf("{\n  \"count\": %zu,\n  \"unit\": \"ns\",\n"
+             "  \"results\": [", count);
     }
+  else
+    {
+      printf("OS performance args: count:%zu, detail:%s\n", count,
+             detail ? "true" : "false");
 
-  for (i = 0; i < nitems(g_entry_list); i++)
+      printf("========================================"
+             "========================================\n");
+      printf("%-*s %3s %10s %10s %10s %10s %10s\n", NAME_MAX, "Describe",
+             "CPU", "Max", "Min", "Avg", "P50", "P99");
+
+#ifdef CONFIG_SMP
+      /* The samples are only taken inside the critical section when all
+       * threads share the CPU of the main thread, see
+       * performance_local(), so say which rows are not.
+       */
+
+      if (sweep)
+        {
+          printf("Critical section held on CPU 0 only, a helper on "
+                 "another CPU would wait for it\n");
+        }
+      else
+        {
+          printf("Critical section not held, threads are not pinned "
+                 "(use -s to pin them)\n");
+        }
+#endif
+    }
+
+  for (cpu = 0; cpu < ncpus; cpu++)
+    {
+      g_performance_cpu = sweep ? cpu : -1;
+      for (i = 0; i < nitems(g_entry_list); i++)
+        {
+          if (item != NULL && item != &g_entry_list[i])
+            {
+              continue;
+            }
+
+          if (performance_run(&g_entry_list[i], count, detail,
+                              &result) < 0)
+            {
+              printf("Run %s fail\n", g_entry_list[i].name);
+              return EXIT_FAILURE;
+            }
+
+          performance_report(&g_entry_list[i], &result, json, &first);
+        }
+    }
+
+  if (json)
     {
-      item = &g_entry_list[i];
-      performance_run(item, count, detail);
+      printf("\n  ]\n}\n");
     }
 
   return EXIT_SUCCESS;
@@ -38,6 +38,7 @@ typedef struct mbedtls_aes_context
 {
   cryptodev_context_t dev;
   unsigned char key[MAX_KEY_SIZE];
+  unsigned int keylen;
 }
 mbedtls_aes_context;
 
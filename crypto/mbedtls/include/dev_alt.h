@@ -26,6 +26,7 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
 #include <crypto/cryptodev.h>
 
 typedef struct cryptodev_context_s
@@ -33,6 +34,8 @@ typedef struct cryptodev_context_s
   int fd;
   struct session_op session;
   struct crypt_op crypt;
+  struct session_op active;  /* Parameters of the open session */
+  bool opened;               /* A session is open */
 }
 cryptodev_context_t;
 
@@ -41,6 +44,7 @@ int cryptodev_clone(FAR cryptodev_context_t *dst,
                     FAR const cryptodev_context_t *src);
 void cryptodev_free(FAR cryptodev_context_t *ctx);
 int cryptodev_get_session(FAR cryptodev_context_t *ctx);
+int cryptodev_reuse_session(FAR cryptodev_context_t *ctx);
 void cryptodev_free_session(FAR cryptodev_context_t *ctx);
 int cryptodev_crypt(FAR cryptodev_context_t *ctx);
 
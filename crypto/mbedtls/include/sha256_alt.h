@@ -26,8 +26,44 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+#include <stddef.h>
+
 #include "dev_alt.h"
 
-#define mbedtls_sha256_context cryptodev_context_t
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MBEDTLS_SHA256_ALT_THRESHOLD
+#  define CONFIG_MBEDTLS_SHA256_ALT_THRESHOLD 256
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Input is collected in buf until it no longer fits, so short messages
+ * are hashed in software without touching /dev/crypto at all.
+ */
+
+typedef struct mbedtls_sha256_context
+{
+  cryptodev_context_t dev;
+  unsigned char buf[CONFIG_MBEDTLS_SHA256_ALT_THRESHOLD];
+  size_t buflen;
+  int is224;
+  bool offload;
+}
+mbedtls_sha256_context;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/* Hash a whole message in software, regardless of its length */
+
+void mbedtls_sha256_sw(FAR const unsigned char *input, size_t ilen,
+                       FAR unsigned char *output, int is224);
 
 #endif /* __APPS_CRYPTO_MBEDTLS_INCLUDE_SHA256_ALT_H */
@@ -65,9 +65,13 @@ int mbedtls_aes_setkey_enc(FAR mbedtls_aes_context *ctx,
         return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
     }
 
+  /* The open session was made with the old key */
+
+  cryptodev_free_session(&ctx->dev);
   memcpy(ctx->key, key, keybits / 8);
+  ctx->keylen = keybits / 8;
   ctx->dev.session.key = (caddr_t)ctx->key;
-  ctx->dev.session.keylen = keybits / 8;
+  ctx->dev.session.keylen = ctx->keylen;
   return 0;
 }
 
@@ -94,7 +98,7 @@ int mbedtls_aes_crypt_ecb(FAR mbedtls_aes_context *ctx,
     }
 
   ctx->dev.session.cipher = CRYPTO_AES_CBC;
-  ret = cryptodev_get_session(&ctx->dev);
+  ret = cryptodev_reuse_session(&ctx->dev);
   if (ret != 0)
     {
       return ret;
@@ -109,7 +113,6 @@ int mbedtls_aes_crypt_ecb(FAR mbedtls_aes_context *ctx,
   ctx->dev.crypt.dst = (caddr_t)output;
   ctx->dev.crypt.iv = (caddr_t)iv;
   ret = cryptodev_crypt(&ctx->dev);
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 
@@ -137,7 +140,7 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
     }
 
   ctx->dev.session.cipher = CRYPTO_AES_CBC;
-  ret = cryptodev_get_session(&ctx->dev);
+  ret = cryptodev_reuse_session(&ctx->dev);
   if (ret != 0)
     {
       return ret;
@@ -151,7 +154,6 @@ int mbedtls_aes_crypt_cbc(mbedtls_aes_context *ctx,
   ctx->dev.crypt.dst = (caddr_t)output;
   ctx->dev.crypt.iv = (caddr_t)iv;
   ret = cryptodev_crypt(&ctx->dev);
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 #endif /* MBEDTLS_CIPHER_MODE_CBC */
@@ -175,11 +177,18 @@ int mbedtls_aes_crypt_ctr(FAR mbedtls_aes_context *ctx,
       return MBEDTLS_ERR_AES_BAD_INPUT_DATA;
     }
 
+  /* The nonce is passed to the driver as part of the key */
+
+  if (memcmp(ctx->key + ctx->keylen, nonce_counter, NONCE_LENGTH) != 0)
+    {
+      cryptodev_free_session(&ctx->dev);
+      memcpy(ctx->key + ctx->keylen, nonce_counter, NONCE_LENGTH);
+    }
+
   ctx->dev.session.cipher = CRYPTO_AES_CTR;
-  memcpy(ctx->key + ctx->dev.session.keylen,
-         nonce_counter, NONCE_LENGTH);
-  ctx->dev.session.keylen += NONCE_LENGTH;
-  ret = cryptodev_get_session(&ctx->dev);
+  ctx->dev.session.keylen = ctx->keylen + NONCE_LENGTH;
+  ret = cryptodev_reuse_session(&ctx->dev);
+  ctx->dev.session.keylen = ctx->keylen;
   if (ret != 0)
     {
       return ret;
@@ -197,7 +206,6 @@ int mbedtls_aes_crypt_ctr(FAR mbedtls_aes_context *ctx,
       *nc_off = length % ECB_BLOCK_SIZE;
     }
 
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 #endif /* MBEDTLS_CIPHER_MODE_CTR */
@@ -222,9 +230,13 @@ int mbedtls_aes_xts_setkey_enc(FAR mbedtls_aes_xts_context *ctx,
       return MBEDTLS_ERR_AES_INVALID_KEY_LENGTH;
     }
 
+  /* The open session was made with the old key */
+
+  cryptodev_free_session(&ctx->dev);
   memcpy(ctx->key, key, keybits / 8);
+  ctx->keylen = keybits / 8;
   ctx->dev.session.key = (caddr_t)ctx->key;
-  ctx->dev.session.keylen = keybits / 8;
+  ctx->dev.session.keylen = ctx->keylen;
   return 0;
 }
 
@@ -265,7 +277,7 @@ int mbedtls_aes_crypt_xts(FAR mbedtls_aes_xts_context *ctx,
     }
 
   ctx->dev.session.cipher = CRYPTO_AES_XTS;
-  ret = cryptodev_get_session(&ctx->dev);
+  ret = cryptodev_reuse_session(&ctx->dev);
   if (ret != 0)
     {
       return ret;
@@ -280,7 +292,6 @@ int mbedtls_aes_crypt_xts(FAR mbedtls_aes_xts_context *ctx,
   ctx->dev.crypt.dst = (caddr_t)output;
   ctx->dev.crypt.iv = (caddr_t)iv;
   ret = cryptodev_crypt(&ctx->dev);
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 #endif /* MBEDTLS_CIPHER_MODE_XTS */
@@ -310,7 +321,7 @@ int mbedtls_aes_crypt_cfb128(FAR mbedtls_aes_context *ctx,
     }
 
   ctx->dev.session.cipher = CRYPTO_AES_CFB_128;
-  ret = cryptodev_get_session(&ctx->dev);
+  ret = cryptodev_reuse_session(&ctx->dev);
   if (ret != 0)
     {
       return ret;
@@ -329,7 +340,6 @@ int mbedtls_aes_crypt_cfb128(FAR mbedtls_aes_context *ctx,
       *iv_off = length % ECB_BLOCK_SIZE;
     }
 
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 
@@ -350,7 +360,7 @@ int mbedtls_aes_crypt_cfb8(FAR mbedtls_aes_context *ctx,
     }
 
   ctx->dev.session.cipher = CRYPTO_AES_CFB_8;
-  ret = cryptodev_get_session(&ctx->dev);
+  ret = cryptodev_reuse_session(&ctx->dev);
   if (ret != 0)
     {
       return ret;
@@ -364,7 +374,6 @@ int mbedtls_aes_crypt_cfb8(FAR mbedtls_aes_context *ctx,
   ctx->dev.crypt.dst = (caddr_t)output;
   ctx->dev.crypt.iv = (caddr_t)iv;
   ret = cryptodev_crypt(&ctx->dev);
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 #endif /* MBEDTLS_CIPHER_MODE_CFB */
@@ -388,7 +397,7 @@ int mbedtls_aes_crypt_ofb(FAR mbedtls_aes_context *ctx,
     }
 
   ctx->dev.session.cipher = CRYPTO_AES_OFB;
-  ret = cryptodev_get_session(&ctx->dev);
+  ret = cryptodev_reuse_session(&ctx->dev);
   if (ret != 0)
     {
       return ret;
@@ -406,7 +415,6 @@ int mbedtls_aes_crypt_ofb(FAR mbedtls_aes_context *ctx,
       *iv_off = length % ECB_BLOCK_SIZE;
     }
 
-  cryptodev_free_session(&ctx->dev);
   return ret;
 }
 #endif /* MBEDTLS_CIPHER_MODE_OFB */
@@ -59,6 +59,7 @@ int cryptodev_init(FAR cryptodev_context_t *ctx)
 
 void cryptodev_free(FAR cryptodev_context_t *ctx)
 {
+  cryptodev_free_session(ctx);
   close(ctx->fd);
   memset(ctx, 0, sizeof(cryptodev_context_t));
 }
@@ -67,19 +68,50 @@ int cryptodev_get_session(FAR cryptodev_context_t *ctx)
 {
   int ret;
 
+  cryptodev_free_session(ctx);
+
   ret = ioctl(ctx->fd, CIOCGSESSION, &ctx->session);
   if (ret < 0)
     {
       return -errno;
     }
 
+  ctx->active = ctx->session;
+  ctx->opened = true;
   ctx->crypt.ses = ctx->session.ses;
   return ret;
 }
 
+/* Keep using the open session if it was made for the same algorithms and
+ * key, which saves two ioctls per operation for stateless ciphers.
+ * Callers changing the key material in place must free the session first.
+ */
+
+int cryptodev_reuse_session(FAR cryptodev_context_t *ctx)
+{
+  if (ctx->opened &&
+      ctx->active.cipher == ctx->session.cipher &&
+      ctx->active.mac == ctx->session.mac &&
+      ctx->active.key == ctx->session.key &&
+      ctx->active.keylen == ctx->session.keylen &&
+      ctx->active.mackey == ctx->session.mackey &&
+      ctx->active.mackeylen == ctx->session.mackeylen)
+    {
+      ctx->crypt.ses = ctx->active.ses;
+      return 0;
+    }
+
+  return cryptodev_get_session(ctx);
+}
+
 void cryptodev_free_session(FAR cryptodev_context_t *ctx)
 {
-  ioctl(ctx->fd, CIOCFSESSION, &ctx->session.ses);
+  if (ctx->opened)
+    {
+      ioctl(ctx->fd, CIOCFSESSION, &ctx->active.ses);
+      ctx->opened = false;
+    }
+
   ctx->crypt.ses = 0;
 }
 
@@ -96,5 +128,7 @@ int cryptodev_clone(FAR cryptodev_context_t *dst,
 {
   dst->session = src->session;
   dst->crypt = src->crypt;
+  dst->active = src->active;
+  dst->opened = src->opened;
   return dup2(src->fd, dst->fd);
 }
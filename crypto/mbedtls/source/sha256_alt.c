@@ -23,51 +23,281 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
 #include "mbedtls/sha256.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ROR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_sha256_k[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t g_sha256_iv[8] =
+{
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+static const uint32_t g_sha224_iv[8] =
+{
+  0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939,
+  0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void sha256_block(FAR uint32_t *state, FAR const unsigned char *p)
+{
+  uint32_t w[64];
+  uint32_t v[8];
+  uint32_t t1;
+  uint32_t t2;
+  int i;
+
+  for (i = 0; i < 16; i++, p += 4)
+    {
+      w[i] = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+             ((uint32_t)p[2] << 8) | p[3];
+    }
+
+  for (; i < 64; i++)
+    {
+      t1 = ROR32(w[i - 2], 17) ^ ROR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      t2 = ROR32(w[i - 15], 7) ^ ROR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      w[i] = t1 + w[i - 7] + t2 + w[i - 16];
+    }
+
+  memcpy(v, state, sizeof(v));
+
+  for (i = 0; i < 64; i++)
+    {
+      t1 = v[7] + (ROR32(v[4], 6) ^ ROR32(v[4], 11) ^ ROR32(v[4], 25)) +
+           ((v[4] & v[5]) ^ (~v[4] & v[6])) + g_sha256_k[i] + w[i];
+      t2 = (ROR32(v[0], 2) ^ ROR32(v[0], 13) ^ ROR32(v[0], 22)) +
+           ((v[0] & v[1]) ^ (v[0] & v[2]) ^ (v[1] & v[2]));
+      v[7] = v[6];
+      v[6] = v[5];
+      v[5] = v[4];
+      v[4] = v[3] + t1;
+      v[3] = v[2];
+      v[2] = v[1];
+      v[1] = v[0];
+      v[0] = t1 + t2;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      state[i] += v[i];
+    }
+}
+
+/* Push buffered input to /dev/crypto as one update */
+
+static int sha256_flush(FAR mbedtls_sha256_context *ctx)
+{
+  int ret;
+
+  if (ctx->buflen == 0)
+    {
+      return 0;
+    }
+
+  ctx->dev.crypt.op = COP_ENCRYPT;
+  ctx->dev.crypt.flags |= COP_FLAG_UPDATE;
+  ctx->dev.crypt.src = (caddr_t)ctx->buf;
+  ctx->dev.crypt.len = ctx->buflen;
+  ret = cryptodev_crypt(&ctx->dev);
+  ctx->buflen = 0;
+  return ret;
+}
+
+/* Move the hash to /dev/crypto once the input outgrows the buffer */
+
+static int sha256_offload(FAR mbedtls_sha256_context *ctx)
+{
+  int ret;
+
+  if (!ctx->offload)
+    {
+      ret = cryptodev_init(&ctx->dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      ctx->offload = true;
+    }
+
+  ctx->dev.session.mac = ctx->is224 ? CRYPTO_SHA2_224 : CRYPTO_SHA2_256;
+  ret = cryptodev_get_session(&ctx->dev);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return sha256_flush(ctx);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+void mbedtls_sha256_sw(FAR const unsigned char *input, size_t ilen,
+                       FAR unsigned char *output, int is224)
+{
+  unsigned char last[128];
+  uint32_t state[8];
+  uint64_t bits = (uint64_t)ilen << 3;
+  size_t rest;
+  size_t n;
+  int i;
+
+  memcpy(state, is224 ? g_sha224_iv : g_sha256_iv, sizeof(state));
+
+  for (; ilen >= 64; ilen -= 64, input += 64)
+    {
+      sha256_block(state, input);
+    }
+
+  rest = ilen;
+  memset(last, 0, sizeof(last));
+  memcpy(last, input, rest);
+  last[rest] = 0x80;
+  n = rest < 56 ? 64 : 128;
+
+  for (i = 0; i < 8; i++)
+    {
+      last[n - 1 - i] = (unsigned char)(bits >> (i * 8));
+    }
+
+  sha256_block(state, last);
+  if (n == 128)
+    {
+      sha256_block(state, last + 64);
+    }
+
+  for (i = 0; i < (is224 ? 7 : 8); i++)
+    {
+      output[i * 4]     = (unsigned char)(state[i] >> 24);
+      output[i * 4 + 1] = (unsigned char)(state[i] >> 16);
+      output[i * 4 + 2] = (unsigned char)(state[i] >> 8);
+      output[i * 4 + 3] = (unsigned char)state[i];
+    }
+}
+
 void mbedtls_sha256_clone(FAR mbedtls_sha256_context *dst,
                           FAR const mbedtls_sha256_context *src)
 {
-  cryptodev_clone(dst, src);
+  if (dst->offload)
+    {
+      cryptodev_free(&dst->dev);
+    }
+
+  memcpy(dst, src, sizeof(*dst));
+  if (src->offload)
+    {
+      dst->dev.fd = dup(src->dev.fd);
+    }
 }
 
 void mbedtls_sha256_init(FAR mbedtls_sha256_context *ctx)
 {
-  cryptodev_init(ctx);
+  memset(ctx, 0, sizeof(*ctx));
 }
 
 void mbedtls_sha256_free(FAR mbedtls_sha256_context *ctx)
 {
-  cryptodev_free(ctx);
+  if (ctx->offload)
+    {
+      cryptodev_free(&ctx->dev);
+    }
+
+  memset(ctx, 0, sizeof(*ctx));
 }
 
 int mbedtls_sha256_starts(FAR mbedtls_sha256_context *ctx, int is224)
 {
-  if (is224)
+  if (ctx->offload)
     {
-      ctx->session.mac = CRYPTO_SHA2_224;
-    }
-  else
-    {
-      ctx->session.mac = CRYPTO_SHA2_256;
+      cryptodev_free_session(&ctx->dev);
+      ctx->dev.crypt.flags = 0;
     }
 
-  return cryptodev_get_session(ctx);
+  ctx->is224 = is224;
+  ctx->buflen = 0;
+  return 0;
 }
 
 int mbedtls_sha256_update(FAR mbedtls_sha256_context *ctx,
                           FAR const unsigned char *input,
                           size_t ilen)
 {
-  ctx->crypt.op = COP_ENCRYPT;
-  ctx->crypt.flags |= COP_FLAG_UPDATE;
-  ctx->crypt.src = (caddr_t)input;
-  ctx->crypt.len = ilen;
-  return cryptodev_crypt(ctx);
+  int ret;
+
+  if (ilen <= sizeof(ctx->buf) - ctx->buflen)
+    {
+      memcpy(ctx->buf + ctx->buflen, input, ilen);
+      ctx->buflen += ilen;
+      return 0;
+    }
+
+  if (!ctx->dev.opened)
+    {
+      ret = sha256_offload(ctx);
+    }
+  else
+    {
+      ret = sha256_flush(ctx);
+    }
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Large inputs go straight to the driver, small ones are coalesced */
+
+  if (ilen >= sizeof(ctx->buf))
+    {
+      ctx->dev.crypt.op = COP_ENCRYPT;
+      ctx->dev.crypt.flags |= COP_FLAG_UPDATE;
+      ctx->dev.crypt.src = (caddr_t)input;
+      ctx->dev.crypt.len = ilen;
+      return cryptodev_crypt(&ctx->dev);
+    }
+
+  memcpy(ctx->buf, input, ilen);
+  ctx->buflen = ilen;
+  return 0;
 }
 
 int mbedtls_sha256_finish(FAR mbedtls_sha256_context *ctx,
@@ -75,10 +305,22 @@ int mbedtls_sha256_finish(FAR mbedtls_sha256_context *ctx,
 {
   int ret;
 
-  ctx->crypt.op = COP_ENCRYPT;
-  ctx->crypt.flags = 0;
-  ctx->crypt.mac = (caddr_t)output;
-  ret = cryptodev_crypt(ctx);
-  cryptodev_free_session(ctx);
+  if (!ctx->offload || !ctx->dev.opened)
+    {
+      mbedtls_sha256_sw(ctx->buf, ctx->buflen, output, ctx->is224);
+      ctx->buflen = 0;
+      return 0;
+    }
+
+  ret = sha256_flush(ctx);
+  if (ret >= 0)
+    {
+      ctx->dev.crypt.op = COP_ENCRYPT;
+      ctx->dev.crypt.flags = 0;
+      ctx->dev.crypt.mac = (caddr_t)output;
+      ret = cryptodev_crypt(&ctx->dev);
+    }
+
+  cryptodev_free_session(&ctx->dev);
   return ret;
 }
@@ -29,9 +29,8 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
-#include <pthread.h>
-#include <sched.h>
 #include <limits.h>
+#include <inttypes.h>
 
 #include <nuttx/audio/audio.h>
 #include <audioutils/fmsynth.h>
@@ -50,6 +49,10 @@
 
 #define APP_DEFAULT_VOL (400)
 
+/* Key press to sound, kept low for playing in time */
+
+#define APP_LATENCY_US (8000)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -81,11 +84,7 @@ struct key_convert_s
  * Private Function Prototypes
  ****************************************************************************/
 
-static void app_dequeue_cb(unsigned long arg,
-                           FAR struct ap_buffer_s *apb);
-static void app_complete_cb(unsigned long arg);
-static void app_user_cb(unsigned long arg,
-                        FAR struct audio_msg_s *msg, FAR bool *running);
+static int app_render_cb(unsigned long arg, FAR void *buf, int nframes);
 
 /****************************************************************************
  * Private Data
@@ -94,13 +93,6 @@ static void app_user_cb(unsigned long arg,
 static struct kbd_s g_kbd;
 static bool g_running = true;
 
-static struct nxaudio_callbacks_s cbs =
-{
-  app_dequeue_cb,
-  app_complete_cb,
-  app_user_cb
-};
-
 static struct key_convert_s key_convert[] =
 {
   { OCTAVE(4, MUSIC_SCALE_C),  'a', "O4C"  },
@@ -165,95 +157,30 @@ static void tick_callback(unsigned long arg)
 }
 
 /****************************************************************************
- * name: app_dequeue_cb
+ * name: app_render_cb
  ****************************************************************************/
 
-static void app_dequeue_cb(unsigned long arg,
-                           FAR struct ap_buffer_s *apb)
+static int app_render_cb(unsigned long arg, FAR void *buf, int nframes)
 {
   FAR struct kbd_s *kbd = (FAR struct kbd_s *)(uintptr_t)arg;
-
-  apb->curbyte = 0;
-  apb->flags = 0;
+  int nbytes;
 
   if (kbd->request_scale != -1)
     {
-      apb->nbytes = fmsynth_rendering(kbd->sound,
-                                      (FAR int16_t *)apb->samp,
-                                      apb->nmaxbytes / sizeof(int16_t),
-                                      kbd->nxaudio.chnum,
-                                      tick_callback, (unsigned long)kbd);
+      nbytes = fmsynth_rendering(kbd->sound, (FAR int16_t *)buf,
+                                 nframes * kbd->nxaudio.chnum,
+                                 kbd->nxaudio.chnum,
+                                 tick_callback, (unsigned long)kbd);
     }
   else
     {
-      apb->nbytes = fmsynth_rendering(kbd->sound,
-                                      (FAR int16_t *)apb->samp,
-                                      apb->nmaxbytes / sizeof(int16_t),
-                                      kbd->nxaudio.chnum,
-                                      NULL, 0);
+      nbytes = fmsynth_rendering(kbd->sound, (FAR int16_t *)buf,
+                                 nframes * kbd->nxaudio.chnum,
+                                 kbd->nxaudio.chnum,
+                                 NULL, 0);
     }
 
-  if (g_running)
-    {
-      nxaudio_enqbuffer(&kbd->nxaudio, apb);
-    }
-}
-
-/****************************************************************************
- * name: app_complete_cb
- ****************************************************************************/
-
-static void app_complete_cb(unsigned long arg)
-{
-  /* Do nothing.. */
-
-  printf("Audio loop is Done\n");
-}
-
-/****************************************************************************
- * name: app_user_cb
- ****************************************************************************/
-
-static void app_user_cb(unsigned long arg,
-                        FAR struct audio_msg_s *msg, FAR bool *running)
-{
-  /* Do nothing.. */
-}
-
-/****************************************************************************
- * name: audio_loop_thread
- ****************************************************************************/
-
-static FAR void *audio_loop_thread(pthread_addr_t arg)
-{
-  FAR struct kbd_s *kbd = (FAR struct kbd_s *)arg;
-
-  nxaudio_start(&kbd->nxaudio);
-  nxaudio_msgloop(&kbd->nxaudio, &cbs, (unsigned long)kbd);
-
-  return NULL;
-}
-
-/****************************************************************************
- * name: create_audio_thread
- ****************************************************************************/
-
-static pthread_t create_audio_thread(FAR struct kbd_s *kbd)
-{
-  pthread_t pid;
-  pthread_attr_t tattr;
-  struct sched_param sparam;
-
-  pthread_attr_init(&tattr);
-  sparam.sched_priority = sched_get_priority_max(SCHED_FIFO) - 9;
-  pthread_attr_setschedparam(&tattr, &sparam);
-  pthread_attr_setstacksize(&tattr, 4096);
-
-  pthread_create(&pid, &tattr, audio_loop_thread,
-                              (pthread_addr_t)kbd);
-  pthread_setname_np(pid, "musickeyboard_thread");
-
-  return pid;
+  return nbytes / (kbd->nxaudio.chnum * sizeof(int16_t));
 }
 
 /****************************************************************************
@@ -375,11 +302,10 @@ static void print_keyusage(void)
 
 int main(int argc, FAR char *argv[])
 {
-  int i;
   int ret;
   int key;
-  pthread_t pid;
   struct app_options appopt;
+  struct nxaudio_stats_s stats;
   int key_idx;
 
   g_running = true;
@@ -406,16 +332,15 @@ int main(int argc, FAR char *argv[])
       return -1;
     }
 
-  /* Render audio samples in audio buffers */
-
-  for (i = 0; i < g_kbd.nxaudio.abufnum; i++)
+  ret = nxaudio_render_start(&g_kbd.nxaudio, APP_LATENCY_US,
+                             app_render_cb, (unsigned long)&g_kbd);
+  if (ret < 0)
     {
-      app_dequeue_cb((unsigned long)&g_kbd,
-                           g_kbd.nxaudio.abufs[i]);
+      fin_keyboard(&g_kbd);
+      printf("nxaudio_render_start() error: %d\n", ret);
+      return -1;
     }
 
-  pid = create_audio_thread(&g_kbd);
-
   printf("Start %s\n", argv[0]);
   print_keyusage();
 
@@ -443,8 +368,15 @@ int main(int argc, FAR char *argv[])
         }
     }
 
-  nxaudio_stop(&g_kbd.nxaudio);
-  pthread_join(pid, NULL);
+  if (nxaudio_getstats(&g_kbd.nxaudio, &stats) == OK)
+    {
+      printf("Latency %" PRIu32 " us (max %" PRIu32 " us), "
+             "%d x %d frames, %" PRIu32 " xruns\n",
+             stats.latency_us, stats.maxlatency_us,
+             stats.nbuffers, stats.nframes, stats.xruns);
+    }
+
+  nxaudio_render_stop(&g_kbd.nxaudio);
 
   fin_keyboard(&g_kbd);
 
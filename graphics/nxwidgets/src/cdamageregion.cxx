@@ -0,0 +1,183 @@
+/****************************************************************************
+ * apps/graphics/nxwidgets/src/cdamageregion.cxx
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/cdamageregion.hxx"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Return the number of pixels in a (non-null) rectangle.
+ */
+
+static inline uint32_t rectArea(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/**
+ * Return the number of pixels that the union of two rectangles covers
+ * beyond the two rectangles themselves.  Overlapping or touching
+ * rectangles with matching edges cost nothing to merge.
+ */
+
+static inline int32_t mergeCost(FAR const struct nxgl_rect_s *a,
+                                 FAR const struct nxgl_rect_s *b)
+{
+  struct nxgl_rect_s both;
+  nxgl_rectunion(&both, a, b);
+  return (int32_t)rectArea(&both) - (int32_t)rectArea(a) -
+         (int32_t)rectArea(b);
+}
+
+/****************************************************************************
+ * CDamageRegion Method Implementations
+ ****************************************************************************/
+
+/**
+ * Remove the rectangle at the given index.
+ */
+
+void CDamageRegion::remove(int index)
+{
+  m_nRects--;
+  if (index < m_nRects)
+    {
+      m_rects[index] = m_rects[m_nRects];
+    }
+}
+
+/**
+ * Merge rectangles that are better represented by their union until
+ * no such pair remains.
+ */
+
+void CDamageRegion::coalesce(void)
+{
+  bool merged;
+
+  do
+    {
+      merged = false;
+      for (int i = 0; i < m_nRects && !merged; i++)
+        {
+          for (int j = i + 1; j < m_nRects; j++)
+            {
+              if (mergeCost(&m_rects[i], &m_rects[j]) <= 0)
+                {
+                  nxgl_rectunion(&m_rects[i], &m_rects[i], &m_rects[j]);
+                  remove(j);
+                  merged = true;
+                  break;
+                }
+            }
+        }
+    }
+  while (merged);
+}
+
+/**
+ * Add a rectangle to the region.
+ *
+ * @param rect The rectangle to add.  Empty rectangles are ignored.
+ */
+
+void CDamageRegion::add(FAR const struct nxgl_rect_s *rect)
+{
+  if (nxgl_nullrect(rect))
+    {
+      return;
+    }
+
+  // If the list is full, make room by merging the cheapest pair
+
+  if (m_nRects >= CONFIG_NXWIDGETS_DAMAGE_NRECTS)
+    {
+      int32_t bestCost = INT32_MAX;
+      int     bestI    = 0;
+      int     bestJ    = 1;
+
+      for (int i = 0; i < m_nRects; i++)
+        {
+          for (int j = i + 1; j < m_nRects; j++)
+            {
+              int32_t cost = mergeCost(&m_rects[i], &m_rects[j]);
+              if (cost < bestCost)
+                {
+                  bestCost = cost;
+                  bestI    = i;
+                  bestJ    = j;
+                }
+            }
+        }
+
+      // With a single slot, everything collapses into one rectangle
+
+      if (m_nRects < 2)
+        {
+          nxgl_rectunion(&m_rects[0], &m_rects[0], rect);
+          return;
+        }
+
+      nxgl_rectunion(&m_rects[bestI], &m_rects[bestI], &m_rects[bestJ]);
+      remove(bestJ);
+    }
+
+  m_rects[m_nRects++] = *rect;
+  coalesce();
+}
+
+/**
+ * Check if a rectangle overlaps the region.
+ *
+ * @param rect The rectangle to check.
+ * @return True if any part of the rectangle is in the region.
+ */
+
+bool CDamageRegion::intersects(FAR const struct nxgl_rect_s *rect) const
+{
+  for (int i = 0; i < m_nRects; i++)
+    {
+      if (nxgl_rectoverlap(&m_rects[i], rect))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
@@ -0,0 +1,390 @@
+/****************************************************************************
+ * apps/graphics/nxwidgets/src/cglyphcache.cxx
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/cnxfont.hxx"
+#include "graphics/nxwidgets/cbitmap.hxx"
+#include "graphics/nxwidgets/cglyphcache.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+#define GLYPH_NONE 0xffff
+
+/****************************************************************************
+ * CGlyphCache Method Implementations
+ ****************************************************************************/
+
+using namespace NXWidgets;
+
+/**
+ * Constructor.
+ *
+ * @param font The font whose glyphs are cached.  The font must outlive
+ *   the cache.
+ * @param entries The number of glyphs to cache.
+ */
+
+CGlyphCache::CGlyphCache(CNxFont *font, unsigned int entries)
+{
+  m_pFont      = font;
+  m_entries    = (FAR struct SCachedGlyph *)0;
+  m_buckets    = (FAR uint16_t *)0;
+  m_pool       = (FAR uint8_t *)0;
+  m_nEntries   = 0;
+  m_nUsed      = 0;
+  m_bucketMask = 0;
+  m_lruHead    = GLYPH_NONE;
+  m_lruTail    = GLYPH_NONE;
+
+  if (entries < 1)
+    {
+      return;
+    }
+
+  if (entries >= GLYPH_NONE)
+    {
+      entries = GLYPH_NONE - 1;
+    }
+
+  // Every entry can hold the widest glyph of the font
+
+  unsigned int bmWidth = ((unsigned int)font->getMaxWidth() *
+                          CONFIG_NXWIDGETS_BPP + 7) >> 3;
+  m_glyphSize          = bmWidth * (unsigned int)font->getHeight();
+
+  // Use a power-of-two number of hash buckets, at least as many as there
+  // are entries, to keep the chains short.
+
+  unsigned int nBuckets = 1;
+  while (nBuckets < entries)
+    {
+      nBuckets <<= 1;
+    }
+
+  m_entries = new struct SCachedGlyph[entries];
+  m_buckets = new uint16_t[nBuckets];
+  m_pool    = new uint8_t[entries * m_glyphSize];
+
+  if (!m_entries || !m_buckets || !m_pool)
+    {
+      gerr("ERROR: Failed to allocate a %u entry glyph cache\n", entries);
+
+      delete[] m_entries;
+      delete[] m_buckets;
+      delete[] m_pool;
+
+      m_entries = (FAR struct SCachedGlyph *)0;
+      m_buckets = (FAR uint16_t *)0;
+      m_pool    = (FAR uint8_t *)0;
+      return;
+    }
+
+  m_nEntries   = (uint16_t)entries;
+  m_bucketMask = (uint16_t)(nBuckets - 1);
+
+  for (unsigned int i = 0; i < entries; i++)
+    {
+      m_entries[i].data = &m_pool[i * m_glyphSize];
+    }
+
+  flush();
+}
+
+/**
+ * Destructor.
+ */
+
+CGlyphCache::~CGlyphCache(void)
+{
+  delete[] m_entries;
+  delete[] m_buckets;
+  delete[] m_pool;
+}
+
+/**
+ * Remove an entry from the LRU list.
+ */
+
+void CGlyphCache::lruUnlink(uint16_t index)
+{
+  FAR struct SCachedGlyph *entry = &m_entries[index];
+
+  if (entry->lruPrev != GLYPH_NONE)
+    {
+      m_entries[entry->lruPrev].lruNext = entry->lruNext;
+    }
+  else
+    {
+      m_lruHead = entry->lruNext;
+    }
+
+  if (entry->lruNext != GLYPH_NONE)
+    {
+      m_entries[entry->lruNext].lruPrev = entry->lruPrev;
+    }
+  else
+    {
+      m_lruTail = entry->lruPrev;
+    }
+
+  entry->lruPrev = GLYPH_NONE;
+  entry->lruNext = GLYPH_NONE;
+}
+
+/**
+ * Insert an entry at the most-recently-used end of the LRU list.
+ */
+
+void CGlyphCache::lruPushFront(uint16_t index)
+{
+  FAR struct SCachedGlyph *entry = &m_entries[index];
+
+  entry->lruPrev = GLYPH_NONE;
+  entry->lruNext = m_lruHead;
+
+  if (m_lruHead != GLYPH_NONE)
+    {
+      m_entries[m_lruHead].lruPrev = index;
+    }
+  else
+    {
+      m_lruTail = index;
+    }
+
+  m_lruHead = index;
+}
+
+/**
+ * Remove an entry from its hash chain.
+ */
+
+void CGlyphCache::hashUnlink(uint16_t index)
+{
+  FAR struct SCachedGlyph *entry = &m_entries[index];
+  FAR uint16_t *link = &m_buckets[hash(entry->letter, entry->color,
+                                       entry->background, entry->mask)];
+
+  while (*link != GLYPH_NONE)
+    {
+      if (*link == index)
+        {
+          *link = entry->hashNext;
+          break;
+        }
+
+      link = &m_entries[*link].hashNext;
+    }
+
+  entry->hashNext = GLYPH_NONE;
+}
+
+/**
+ * Render a glyph into a cache entry.  The key fields of the entry must
+ * already be set.
+ */
+
+void CGlyphCache::render(FAR struct SCachedGlyph *entry)
+{
+  m_pFont->getCharMetrics(entry->letter, &entry->metrics);
+
+  entry->width  = (nxgl_coord_t)(entry->metrics.width +
+                                 entry->metrics.xoffset);
+  entry->height = (nxgl_coord_t)m_pFont->getHeight();
+  entry->stride = (entry->width * CONFIG_NXWIDGETS_BPP + 7) >> 3;
+
+  // Fill the glyph memory with the background color
+
+  FAR nxwidget_pixel_t *bmPtr   = (FAR nxwidget_pixel_t *)entry->data;
+  unsigned int          npixels = entry->width * entry->height;
+  for (unsigned int j = 0; j < npixels; j++)
+    {
+      *bmPtr++ = entry->background;
+    }
+
+  // Then render the glyph over the background
+
+  struct SBitmap bitmap;
+  bitmap.bpp    = CONFIG_NXWIDGETS_BPP;
+  bitmap.fmt    = CONFIG_NXWIDGETS_FMT;
+  bitmap.width  = entry->width;
+  bitmap.height = entry->height;
+  bitmap.stride = entry->stride;
+  bitmap.data   = (FAR const void *)entry->data;
+
+  nxgl_mxpixel_t savedColor = m_pFont->getColor();
+  m_pFont->setColor(entry->color);
+  m_pFont->drawChar(&bitmap, entry->letter);
+  m_pFont->setColor(savedColor);
+}
+
+/**
+ * Copy the coverage mask of a glyph into a cache entry.  The key fields
+ * of the entry must already be set.  The mask is the font's own
+ * monochrome bitmap, so it fits in any entry.
+ */
+
+void CGlyphCache::renderMask(FAR struct SCachedGlyph *entry)
+{
+  m_pFont->getCharMetrics(entry->letter, &entry->metrics);
+
+  FAR const struct nx_fontbitmap_s *fbm =
+    m_pFont->getFontBitmap(entry->letter);
+
+  if (!fbm || fbm->metric.stride * fbm->metric.height > m_glyphSize)
+    {
+      // Nothing to draw, only advance by the width of a space
+
+      entry->width  = 0;
+      entry->height = 0;
+      entry->stride = 0;
+      return;
+    }
+
+  entry->width  = (nxgl_coord_t)fbm->metric.width;
+  entry->height = (nxgl_coord_t)fbm->metric.height;
+  entry->stride = fbm->metric.stride;
+
+  memcpy(entry->data, fbm->bitmap, entry->stride * entry->height);
+}
+
+/**
+ * Find an entry, filling the least recently used one on a miss.
+ *
+ * @param letter The character to get.
+ * @param color The font color to render with.
+ * @param background The opaque background color.
+ * @param mask True to get the coverage mask instead of a bitmap.
+ * @return The cached entry or NULL if the cache is not valid.
+ */
+
+FAR const struct SCachedGlyph *
+CGlyphCache::lookup(nxwidget_char_t letter, nxgl_mxpixel_t color,
+                    nxgl_mxpixel_t background, bool mask)
+{
+  if (!m_pool)
+    {
+      return (FAR const struct SCachedGlyph *)0;
+    }
+
+  // Look for the glyph in its hash chain
+
+  unsigned int bucket = hash(letter, color, background, mask);
+  uint16_t index;
+
+  for (index = m_buckets[bucket]; index != GLYPH_NONE;
+       index = m_entries[index].hashNext)
+    {
+      FAR struct SCachedGlyph *entry = &m_entries[index];
+      if (entry->letter == letter && entry->color == color &&
+          entry->background == background && entry->mask == mask)
+        {
+          // Hit.  Make it the most recently used entry.
+
+          if (index != m_lruHead)
+            {
+              lruUnlink(index);
+              lruPushFront(index);
+            }
+
+          return entry;
+        }
+    }
+
+  // Miss.  Take an unused entry or recycle the least recently used one.
+
+  if (m_nUsed < m_nEntries)
+    {
+      index = m_nUsed++;
+    }
+  else
+    {
+      index = m_lruTail;
+      hashUnlink(index);
+      lruUnlink(index);
+    }
+
+  FAR struct SCachedGlyph *entry = &m_entries[index];
+  entry->letter     = letter;
+  entry->color      = color;
+  entry->background = background;
+  entry->mask       = mask;
+
+  if (mask)
+    {
+      renderMask(entry);
+    }
+  else
+    {
+      render(entry);
+    }
+
+  entry->hashNext    = m_buckets[bucket];
+  m_buckets[bucket]  = index;
+  lruPushFront(index);
+
+  return entry;
+}
+
+/**
+ * Discard all cached glyphs.
+ */
+
+void CGlyphCache::flush(void)
+{
+  if (!m_pool)
+    {
+      return;
+    }
+
+  for (unsigned int i = 0; i <= m_bucketMask; i++)
+    {
+      m_buckets[i] = GLYPH_NONE;
+    }
+
+  for (unsigned int i = 0; i < m_nEntries; i++)
+    {
+      m_entries[i].hashNext = GLYPH_NONE;
+      m_entries[i].lruPrev  = GLYPH_NONE;
+      m_entries[i].lruNext  = GLYPH_NONE;
+    }
+
+  m_nUsed   = 0;
+  m_lruHead = GLYPH_NONE;
+  m_lruTail = GLYPH_NONE;
+}
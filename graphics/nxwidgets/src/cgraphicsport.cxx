@@ -77,6 +77,7 @@
 #include "graphics/nxwidgets/cgraphicsport.hxx"
 #include "graphics/nxwidgets/cwidgetstyle.hxx"
 #include "graphics/nxwidgets/cbitmap.hxx"
+#include "graphics/nxwidgets/cglyphcache.hxx"
 #include "graphics/nxwidgets/singletons.hxx"
 
 /****************************************************************************
@@ -102,11 +103,17 @@ CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd, nxgl_mxpixel_t backColor)
 {
   m_pNxWnd    = pNxWnd;
   m_backColor = backColor;
+  m_glyph     = (FAR uint8_t *)0;
+  m_glyphSize = 0;
+  m_clipped   = false;
 }
 #else
 CGraphicsPort::CGraphicsPort(INxWindow *pNxWnd)
 {
-  m_pNxWnd = pNxWnd;
+  m_pNxWnd    = pNxWnd;
+  m_glyph     = (FAR uint8_t *)0;
+  m_glyphSize = 0;
+  m_clipped   = false;
 }
 #endif
 
@@ -119,8 +126,123 @@ CGraphicsPort::~CGraphicsPort(void)
   // m_pNxWnd is not deleted.  This is an abstract base class and
   // the caller of the CGraphicsPort instance is responsible for
   // the window destruction.
+
+  delete[] m_glyph;
 };
 
+/**
+ * Return scratch memory of at least the requested size for rendering
+ * glyphs.  The memory is retained across calls.
+ *
+ * @param size The number of bytes required.
+ * @return The scratch memory or NULL if it could not be allocated.
+ */
+
+FAR uint8_t *CGraphicsPort::getGlyphBuffer(unsigned int size)
+{
+  if (size > m_glyphSize)
+    {
+      delete[] m_glyph;
+
+      m_glyph     = new uint8_t[size];
+      m_glyphSize = m_glyph ? size : 0;
+    }
+
+  return m_glyph;
+}
+
+/**
+ * Fill a rectangle of the window, limited to the clipping rectangle.
+ *
+ * @param rect The window-relative rectangle to fill.
+ * @param color The fill color.
+ * @return True if successful or if nothing was left to fill.
+ */
+
+bool CGraphicsPort::fillClipped(FAR const struct nxgl_rect_s *rect,
+                                nxgl_mxpixel_t color)
+{
+  struct nxgl_rect_s clipped;
+
+  if (m_clipped)
+    {
+      nxgl_rectintersect(&clipped, rect, &m_clip);
+      if (nxgl_nullrect(&clipped))
+        {
+          return true;
+        }
+
+      rect = &clipped;
+    }
+
+  return m_pNxWnd->fill(rect, color);
+}
+
+/**
+ * Copy a bitmap to the window, limited to the clipping rectangle.  The
+ * origin does not move, so a clipped destination selects the matching
+ * part of the bitmap.
+ *
+ * @param dest The window-relative rectangle that receives the bitmap.
+ * @param src The bitmap memory.
+ * @param origin The window-relative position of the upper left corner of
+ *   the full bitmap.
+ * @param stride The width of a bitmap row in bytes.
+ * @return True if successful or if nothing was left to copy.
+ */
+
+bool CGraphicsPort::bitmapClipped(FAR const struct nxgl_rect_s *dest,
+                                  FAR const void *src,
+                                  FAR const struct nxgl_point_s *origin,
+                                  unsigned int stride)
+{
+  struct nxgl_rect_s clipped;
+
+  if (m_clipped)
+    {
+      nxgl_rectintersect(&clipped, dest, &m_clip);
+      if (nxgl_nullrect(&clipped))
+        {
+          return true;
+        }
+
+      dest = &clipped;
+    }
+
+  return m_pNxWnd->bitmap(dest, src, origin, stride);
+}
+
+/**
+ * Move a rectangle of the window, limited to the clipping rectangle at the
+ * destination.
+ *
+ * @param rect The window-relative rectangle to move.
+ * @param offset The distance to move it by.
+ */
+
+void CGraphicsPort::moveClipped(FAR const struct nxgl_rect_s *rect,
+                                FAR const struct nxgl_point_s *offset)
+{
+  struct nxgl_rect_s clipped;
+
+  if (m_clipped)
+    {
+      // Clip the destination, then move it back to the source
+
+      nxgl_rectoffset(&clipped, rect, offset->x, offset->y);
+      nxgl_rectintersect(&clipped, &clipped, &m_clip);
+      if (nxgl_nullrect(&clipped))
+        {
+          return;
+        }
+
+      nxgl_rectoffset(&clipped, &clipped, -offset->x, -offset->y);
+      rect = &clipped;
+    }
+
+  m_pNxWnd->move(rect, offset);
+}
+
 /**
  * Return the absolute x coordinate of the upper left hand corner of the
  * underlying window.
@@ -163,7 +285,11 @@ void CGraphicsPort::drawPixel(nxgl_coord_t x, nxgl_coord_t y,
   struct nxgl_point_s pos;
   pos.x = x;
   pos.y = y;
-  m_pNxWnd->setPixel(&pos, color);
+
+  if (!m_clipped || nxgl_rectinside(&m_clip, &pos))
+    {
+      m_pNxWnd->setPixel(&pos, color);
+    }
 }
 
 /**
@@ -189,7 +315,7 @@ void CGraphicsPort::drawHorizLine(nxgl_coord_t x, nxgl_coord_t y,
 
   // Draw the line
 
-  if (!m_pNxWnd->fill(&dest, color))
+  if (!fillClipped(&dest, color))
     {
       gerr("ERROR: INxWindow::fill failed\n");
     }
@@ -219,7 +345,7 @@ void CGraphicsPort::drawVertLine(nxgl_coord_t x, nxgl_coord_t y,
 
   // Draw the line
 
-  if (!m_pNxWnd->fill(&dest, color))
+  if (!fillClipped(&dest, color))
     {
       gerr("ERROR: INxWindow::fill failed\n");
     }
@@ -248,6 +374,40 @@ void CGraphicsPort::drawLine(nxgl_coord_t x1, nxgl_coord_t y1,
   vector.pt2.x = x2;
   vector.pt2.y = y2;
 
+  // NX cannot clip lines.  Split the line into trapezoids the same way
+  // that nx_drawline() does and fill them within the clipping rectangle.
+  // Lines drawn by CGraphicsPort are one pixel wide, so there are no caps
+  // to draw.
+
+  if (m_clipped)
+    {
+      struct nxgl_trapezoid_s traps[3];
+      struct nxgl_rect_s rect;
+
+      switch (nxgl_splitline(&vector, traps, &rect, 1))
+        {
+          case 0:
+            m_pNxWnd->fillTrapezoid(&m_clip, &traps[0], color);
+            m_pNxWnd->fillTrapezoid(&m_clip, &traps[1], color);
+            m_pNxWnd->fillTrapezoid(&m_clip, &traps[2], color);
+            break;
+
+          case 1:
+            m_pNxWnd->fillTrapezoid(&m_clip, &traps[1], color);
+            break;
+
+          case 2:
+            fillClipped(&rect, color);
+            break;
+
+          default:
+            gerr("ERROR: nxgl_splitline failed\n");
+            break;
+        }
+
+      return;
+    }
+
   if (!m_pNxWnd->drawLine(&vector, 1, color, caps))
     {
       gerr("ERROR: INxWindow::drawLine failed\n");
@@ -273,7 +433,7 @@ void CGraphicsPort::drawFilledRect(nxgl_coord_t x, nxgl_coord_t y,
   rect.pt1.y = y;
   rect.pt2.x = x + width - 1;
   rect.pt2.y = y + height - 1;
-  m_pNxWnd->fill(&rect, color);
+  fillClipped(&rect, color);
 }
 
 /**
@@ -356,7 +516,8 @@ void CGraphicsPort::drawBitmap(nxgl_coord_t x, nxgl_coord_t y,
 
   // Blit the bitmap
 
-  m_pNxWnd->bitmap(&dest, (FAR const void *)bitmap->data, &origin, bitmap->stride);
+  bitmapClipped(&dest, (FAR const void *)bitmap->data, &origin,
+                bitmap->stride);
 }
 
 /**
@@ -494,7 +655,8 @@ void CGraphicsPort::drawBitmap(nxgl_coord_t x, nxgl_coord_t y,
 
       // Blit the bitmap
 
-      m_pNxWnd->bitmap(&dest, (FAR const void *)runPtr, &origin, bitmap->stride);
+      bitmapClipped(&dest, (FAR const void *)runPtr, &origin,
+                    bitmap->stride);
     }
 }
 
@@ -569,7 +731,7 @@ void CGraphicsPort::drawBitmapGreyScale(nxgl_coord_t x, nxgl_coord_t y,
 
       // Now blit the single row
 
-      m_pNxWnd->bitmap(&dest, run, &origin, bitmap->stride);
+      bitmapClipped(&dest, run, &origin, bitmap->stride);
 
        // Setup for the next source row
 
@@ -720,13 +882,18 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
     }
 #endif
 
-  // Allocate a bit of memory to hold the largest rendered font
+  // Get memory to hold the largest rendered font.  This is only needed
+  // for glyphs that are not drawn from the font's glyph cache.
 
   unsigned int bmWidth   = ((unsigned int)font->getMaxWidth() * CONFIG_NXWIDGETS_BPP + 7) >> 3;
   unsigned int bmHeight  = (unsigned int)font->getHeight();
 
-  unsigned int glyphSize =  bmWidth * bmHeight;
-  FAR uint8_t  *glyph    =  new uint8_t[glyphSize];
+  FAR uint8_t  *glyph    =  getGlyphBuffer(bmWidth * bmHeight);
+  if (!glyph)
+    {
+      gerr("ERROR: Failed to allocate glyph memory\n");
+      return;
+    }
 
   // Get the bounding rectangle in NX form
 
@@ -748,6 +915,94 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
       const nxwidget_char_t letter = string.getCharAt(i);
 
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+      // Opaque glyphs do not depend on what is already on the display and
+      // can be drawn directly from the pre-rendered glyph cache.
+      // Transparent glyphs use the cached coverage mask instead.
+
+      FAR const struct SCachedGlyph *cached =
+        transparent ? font->getCachedMask(letter) :
+        font->getCachedGlyph(letter, background);
+
+      if (cached && transparent)
+        {
+          // Only the inked box of the glyph changes, so only that is read
+          // back, has its covered pixels set to the font color and is put
+          // back on the display.
+
+          struct nxgl_point_s origin;
+          origin.x = pos->x + cached->metrics.xoffset;
+          origin.y = pos->y + cached->metrics.yoffset;
+
+          struct nxgl_rect_s dest;
+          dest.pt1.x = origin.x;
+          dest.pt1.y = origin.y;
+          dest.pt2.x = origin.x + cached->width - 1;
+          dest.pt2.y = origin.y + cached->height - 1;
+
+          struct nxgl_rect_s intersection;
+          nxgl_rectintersect(&intersection, &dest, &boundingBox);
+
+          if (cached->width > 0 && cached->height > 0 &&
+              !nxgl_nullrect(&intersection))
+            {
+              bitmap.width  = cached->width;
+              bitmap.height = cached->height;
+              bitmap.stride = (cached->width * bitmap.bpp + 7) >> 3;
+
+              m_pNxWnd->getRectangle(&dest, &bitmap);
+
+              nxgl_mxpixel_t color = font->getColor();
+              for (nxgl_coord_t y = 0; y < cached->height; y++)
+                {
+                  FAR const uint8_t *src = &cached->data[y * cached->stride];
+                  FAR nxwidget_pixel_t *dst =
+                    (FAR nxwidget_pixel_t *)&glyph[y * bitmap.stride];
+
+                  for (nxgl_coord_t x = 0; x < cached->width; x++)
+                    {
+                      if (src[x >> 3] & (0x80 >> (x & 7)))
+                        {
+                          dst[x] = color;
+                        }
+                    }
+                }
+
+              if (!bitmapClipped(&intersection, (FAR const void *)glyph,
+                                 &origin, bitmap.stride))
+                {
+                  ginfo("nx_bitmapwindow failed: %d\n", errno);
+                }
+            }
+
+          pos->x += cached->metrics.width + cached->metrics.xoffset;
+          continue;
+        }
+
+      if (cached)
+        {
+          struct nxgl_rect_s dest;
+          dest.pt1.x = pos->x;
+          dest.pt1.y = pos->y;
+          dest.pt2.x = pos->x + cached->width - 1;
+          dest.pt2.y = pos->y + cached->height - 1;
+
+          struct nxgl_rect_s intersection;
+          nxgl_rectintersect(&intersection, &dest, &boundingBox);
+
+          if (!nxgl_nullrect(&intersection) &&
+              !bitmapClipped(&intersection,
+                             (FAR const void *)cached->data,
+                             pos, cached->stride))
+            {
+              ginfo("nx_bitmapwindow failed: %d\n", errno);
+            }
+
+          pos->x += cached->width;
+          continue;
+        }
+#endif
+
       // Get the font metrics for this letter
 
       struct nx_fontmetric_s metrics;
@@ -813,8 +1068,9 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
               // Then put the font on the display
 
-              if (!m_pNxWnd->bitmap(&intersection, (FAR const void *)bitmap.data,
-                                   pos, bitmap.stride))
+              if (!bitmapClipped(&intersection,
+                                 (FAR const void *)bitmap.data,
+                                 pos, bitmap.stride))
                 {
                   ginfo("nx_bitmapwindow failed: %d\n", errno);
                 }
@@ -825,8 +1081,6 @@ void CGraphicsPort::_drawText(struct nxgl_point_s *pos, CRect *bound,
 
       pos->x += fontWidth;
     }
-
-  delete[] glyph;
 }
 
 /**
@@ -856,7 +1110,7 @@ void CGraphicsPort::copy(nxgl_coord_t sourceX, nxgl_coord_t sourceY,
   offset.x = destX - sourceX;
   offset.y = destY - sourceY;
 
-  m_pNxWnd->move(&rect, &offset);
+  moveClipped(&rect, &offset);
 }
 
 /**
@@ -884,7 +1138,7 @@ void CGraphicsPort::move(nxgl_coord_t x, nxgl_coord_t y,
   offset.x = deltaX;
   offset.y = deltaY;
 
-  m_pNxWnd->move(&rect, &offset);
+  moveClipped(&rect, &offset);
 }
 
 /**
@@ -960,8 +1214,8 @@ void CGraphicsPort::greyScale(nxgl_coord_t x, nxgl_coord_t y,
       // Then write the row back to graphics memory
 
       origin.y = rect.pt1.y;
-      m_pNxWnd->bitmap(&rect, (FAR const void *)rowBitmap.data,
-                       &origin, rowBitmap.stride) ;
+      bitmapClipped(&rect, (FAR const void *)rowBitmap.data,
+                    &origin, rowBitmap.stride) ;
     }
 
   delete[] rowBuffer;
@@ -1036,8 +1290,8 @@ void CGraphicsPort::invert(nxgl_coord_t x, nxgl_coord_t y,
       // Then write the row back to graphics memory
 
       origin.y = rect.pt1.y;
-      m_pNxWnd->bitmap(&rect, (FAR const void *)rowBitmap.data,
-                       &origin, rowBitmap.stride) ;
+      bitmapClipped(&rect, (FAR const void *)rowBitmap.data,
+                    &origin, rowBitmap.stride) ;
     }
 
   delete[] rowBuffer;
@@ -39,6 +39,7 @@
 #include "graphics/nxwidgets/cstringiterator.hxx"
 #include "graphics/nxwidgets/cnxfont.hxx"
 #include "graphics/nxwidgets/cbitmap.hxx"
+#include "graphics/nxwidgets/cglyphcache.hxx"
 
 /****************************************************************************
  * Pre-Processor Definitions
@@ -67,6 +68,20 @@ CNxFont::CNxFont(enum nx_fontid_e fontid, nxgl_mxpixel_t fontColor,
   m_pFontSet         = nxf_getfontset(m_fontHandle);
   m_fontColor        = fontColor;
   m_transparentColor = transparentColor;
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+  m_pGlyphCache      = (CGlyphCache *)0;
+#endif
+}
+
+/**
+ * CNxFont Destructor.
+ */
+
+CNxFont::~CNxFont(void)
+{
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+  delete m_pGlyphCache;
+#endif
 }
 
 /**
@@ -119,6 +134,69 @@ void CNxFont::drawChar(FAR SBitmap *bitmap, nxwidget_char_t letter)
     }
 }
 
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+/**
+ * Get the glyph cache, creating it on first use so that fonts only used
+ * for measuring do not pay for it.
+ *
+ * @return The cache or NULL if it could not be allocated.
+ */
+
+CGlyphCache *CNxFont::getGlyphCache(void)
+{
+  if (!m_pGlyphCache)
+    {
+      m_pGlyphCache = new CGlyphCache(this,
+                                      CONFIG_NXWIDGETS_GLYPHCACHE_SIZE);
+    }
+
+  return m_pGlyphCache;
+}
+
+/**
+ * Get a glyph rendered in the current font color over an opaque
+ * background from the font's glyph cache.  The returned glyph is valid
+ * until the next call to this method.
+ *
+ * @param letter The character to get.
+ * @param background The background color to render over.
+ * @return The cached glyph or NULL if no cache could be allocated.
+ */
+
+FAR const struct SCachedGlyph *
+CNxFont::getCachedGlyph(nxwidget_char_t letter, nxgl_mxpixel_t background)
+{
+  CGlyphCache *cache = getGlyphCache();
+  if (!cache)
+    {
+      return (FAR const struct SCachedGlyph *)0;
+    }
+
+  return cache->getGlyph(letter, m_fontColor, background);
+}
+
+/**
+ * Get the coverage mask of a glyph, for drawing it transparently, from
+ * the font's glyph cache.  The returned mask is valid until the next call
+ * to this method or to getCachedGlyph().
+ *
+ * @param letter The character to get.
+ * @return The cached mask or NULL if no cache could be allocated.
+ */
+
+FAR const struct SCachedGlyph *
+CNxFont::getCachedMask(nxwidget_char_t letter)
+{
+  CGlyphCache *cache = getGlyphCache();
+  if (!cache)
+    {
+      return (FAR const struct SCachedGlyph *)0;
+    }
+
+  return cache->getMask(letter);
+}
+#endif
+
 /**
  * Get the width of a string in pixels when drawn with this font.
  *
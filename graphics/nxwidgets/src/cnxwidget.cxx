@@ -471,6 +471,14 @@ void CNxWidget::redraw(void)
 {
   if (isDrawingEnabled())
     {
+      // If the widget control is batching redraws, it will call back here
+      // from flushRedraw() to do the drawing.
+
+      if (m_widgetControl->queueRedraw(this))
+        {
+          return;
+        }
+
       // Get the graphics port needed to draw on this window
 
       CGraphicsPort *port = m_widgetControl->getGraphicsPort();
@@ -490,6 +498,29 @@ void CNxWidget::redraw(void)
     }
 }
 
+/**
+ * Draws the part of the widget, but not of its children, that lies within
+ * a rectangle.  Used by CWidgetControl::flushRedraw(), which visits the
+ * children itself.
+ *
+ * @param clip The window-relative rectangle to draw.
+ */
+
+void CNxWidget::redrawClipped(FAR const struct nxgl_rect_s *clip)
+{
+  if (isDrawingEnabled())
+    {
+      CGraphicsPort *port = m_widgetControl->getGraphicsPort();
+
+      port->setClipRect(clip);
+      drawBorder(port);
+      drawContents(port);
+      port->setClipRect(NULL);
+
+      m_flags.erased = false;
+    }
+}
+
 /**
  * Enables the widget.
  *
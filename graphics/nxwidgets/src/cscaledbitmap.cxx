@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <climits>
 #include <cstring>
 #include <debug.h>
 
@@ -39,29 +40,187 @@
  * Pre-Processor Definitions
  ****************************************************************************/
 
+/* Interpolation weights are SCALE_SHIFT-bit fractions, chosen so that a
+ * whole pixel can be interpolated at once with integer arithmetic: The
+ * color components are spread out in a 32-bit word with enough zero bits
+ * between them to hold the products.
+ */
+
+#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
+#  define SCALE_SHIFT 8
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
+#  define SCALE_SHIFT 5
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24 || CONFIG_NXWIDGETS_FMT == FB_FMT_RGB32
+#  define SCALE_SHIFT 8
+#else
+#  error Unsupported, invalid, or undefined color format
+#endif
+
+#define SCALE_ONE   (1 << SCALE_SHIFT)
+#define SCALE_HALF  (1 << (SCALE_SHIFT - 1))
+
 /****************************************************************************
- * Method Implementations
+ * Private Functions
  ****************************************************************************/
 
 using namespace NXWidgets;
 
+/**
+ * Get one pixel from a row of pixels
+ *
+ * @param row - The row of pixels
+ * @param col - The column of the pixel
+ */
+
+static inline uint32_t loadPixel(FAR const uint8_t *row, unsigned int col)
+{
+#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
+  return row[col];
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
+  return ((FAR const uint16_t *)row)[col];
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24
+  row += 3 * col;
+  return (uint32_t)row[0] | ((uint32_t)row[1] << 8) |
+         ((uint32_t)row[2] << 16);
+#else
+  return ((FAR const uint32_t *)row)[col];
+#endif
+}
+
+/**
+ * Put one pixel into a row of pixels
+ *
+ * @param row - The row of pixels
+ * @param col - The column of the pixel
+ * @param pixel - The pixel value
+ */
+
+static inline void storePixel(FAR uint8_t *row, unsigned int col,
+                              uint32_t pixel)
+{
+#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
+  row[col] = (uint8_t)pixel;
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
+  ((FAR uint16_t *)row)[col] = (uint16_t)pixel;
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24
+  row   += 3 * col;
+  row[0] = (uint8_t)pixel;
+  row[1] = (uint8_t)(pixel >> 8);
+  row[2] = (uint8_t)(pixel >> 16);
+#else
+  ((FAR uint32_t *)row)[col] = pixel;
+#endif
+}
+
+/**
+ * Interpolate between two pixels
+ *
+ * @param pixel1 - The first pixel
+ * @param pixel2 - The second pixel
+ * @param weight - The weight of pixel2, 0 through SCALE_ONE - 1
+ */
+
+static inline uint32_t lerpPixel(uint32_t pixel1, uint32_t pixel2,
+                                 unsigned int weight)
+{
+  unsigned int remainder = SCALE_ONE - weight;
+
+#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
+  // RRRGGGBB -> RRR00000 000GGG00 00000000 BB, leaving eight bits above
+  // each component.  The constant rounds each component to nearest.
+
+  uint32_t a = (pixel1 & 0x03) | ((pixel1 & 0x1c) << 8) |
+               ((pixel1 & 0xe0) << 16);
+  uint32_t b = (pixel2 & 0x03) | ((pixel2 & 0x1c) << 8) |
+               ((pixel2 & 0xe0) << 16);
+  uint32_t c = ((a * remainder + b * weight + 0x10020080) >> SCALE_SHIFT) &
+               0x00e01c03;
+  return (c & 0x03) | ((c >> 8) & 0x1c) | ((c >> 16) & 0xe0);
+
+#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
+  // RRRRRGGGGGGBBBBB -> 00000GGGGGG00000 RRRRR000000BBBBB, leaving five
+  // bits above each component.  The constant rounds each component to
+  // nearest.
+
+  uint32_t a = (pixel1 | (pixel1 << 16)) & 0x07e0f81f;
+  uint32_t b = (pixel2 | (pixel2 << 16)) & 0x07e0f81f;
+  uint32_t c = ((a * remainder + b * weight + 0x02008010) >> SCALE_SHIFT) &
+               0x07e0f81f;
+  return (c | (c >> 16)) & 0xffff;
+
+#else
+  // Red and blue are interpolated together, then green, rounding each
+  // component to nearest
+
+  uint32_t rb = (((pixel1 & 0xff00ff) * remainder +
+                  (pixel2 & 0xff00ff) * weight + 0x800080) >> SCALE_SHIFT) &
+                0xff00ff;
+  uint32_t g  = (((pixel1 & 0x00ff00) * remainder +
+                  (pixel2 & 0x00ff00) * weight + 0x008000) >> SCALE_SHIFT) &
+                0x00ff00;
+  return rb | g;
+#endif
+}
+
+/**
+ * Interpolate between two pixels, but do not interpolate within
+ * transparent regions or between transparent and opaque regions.  In
+ * that case the pixel closest to the requested position is returned.
+ *
+ * @param pixel1 - The first pixel
+ * @param pixel2 - The second pixel
+ * @param weight - The weight of pixel2, 0 through SCALE_ONE - 1
+ */
+
+static inline uint32_t blendPixel(uint32_t pixel1, uint32_t pixel2,
+                                  unsigned int weight)
+{
+  if (weight == 0 || pixel1 == pixel2)
+    {
+      return pixel1;
+    }
+
+  if (pixel1 == (uint32_t)CONFIG_NXWIDGETS_TRANSPARENT_COLOR ||
+      pixel2 == (uint32_t)CONFIG_NXWIDGETS_TRANSPARENT_COLOR)
+    {
+      return weight < SCALE_HALF ? pixel1 : pixel2;
+    }
+
+  return lerpPixel(pixel1, pixel2, weight);
+}
+
+/****************************************************************************
+ * Method Implementations
+ ****************************************************************************/
+
 /**
  * Constructor.
  *
  * @param bitmap The bitmap structure being scaled.
  * @newSize The new, scaled size of the image
+ * @param cacheImage True: Scale the whole image now and keep it in memory.
  */
 
-CScaledBitmap::CScaledBitmap(IBitmap *bitmap, struct nxgl_size_s &newSize)
+CScaledBitmap::CScaledBitmap(IBitmap *bitmap, struct nxgl_size_s &newSize,
+                             bool cacheImage)
 : m_bitmap(bitmap), m_size(newSize)
 {
+  m_srcRow      = (FAR uint8_t *)0;
+  m_rowCache[0] = (FAR uint8_t *)0;
+  m_rowCache[1] = (FAR uint8_t *)0;
+  m_image       = (FAR uint8_t *)0;
+  m_xIndex      = (FAR uint16_t *)0;
+  m_xWeight     = (FAR uint8_t *)0;
+  m_row         = UINT_MAX;           // Set to an impossible value
+
   // xScale will be used to convert a request X position to an X position
   // in the contained bitmap:
   //
   // xImage = xRequested * oldWidth / newWidth
   //        = xRequested * xScale
 
-  m_xScale = itob16((uint32_t)m_bitmap->getWidth()) / newSize.w;
+  nxgl_coord_t bitmapWidth = m_bitmap->getWidth();
+  m_xScale = itob16((uint32_t)bitmapWidth) / newSize.w;
 
   // Similarly, yScale will be used to convert a request Y position to a Y
   // positionin the contained bitmap:
@@ -71,16 +230,80 @@ CScaledBitmap::CScaledBitmap(IBitmap *bitmap, struct nxgl_size_s &newSize)
 
   m_yScale = itob16((uint32_t)m_bitmap->getHeight()) / newSize.h;
 
-  // Allocate and initialize the row cache
+  // Pre-compute the source column and the weight of the column after it
+  // for every column of the scaled image.  The last source column has
+  // nothing after it to interpolate with.
+
+  m_xIndex  = new uint16_t[newSize.w];
+  m_xWeight = new uint8_t[newSize.w];
+
+  if (!m_xIndex || !m_xWeight)
+    {
+      gerr("ERROR: Failed to allocate column tables\n");
+      return;
+    }
 
-  size_t stride = bitmap->getStride();
+  for (int x = 0; x < newSize.w; x++)
+    {
+      b16_t column      = x * m_xScale;
+      nxgl_coord_t col1 = b16toi(column);
+
+      if (col1 >= bitmapWidth - 1)
+        {
+          m_xIndex[x]  = bitmapWidth - 1;
+          m_xWeight[x] = 0;
+        }
+      else
+        {
+          m_xIndex[x]  = col1;
+          m_xWeight[x] = (uint8_t)(b16frac(column) >> (16 - SCALE_SHIFT));
+        }
+    }
+
+  // Allocate the unscaled row buffer and the cache of scaled rows
+
+  size_t stride = getStride();
+  m_srcRow      = new uint8_t[bitmap->getStride()];
   m_rowCache[0] = new uint8_t[stride];
   m_rowCache[1] = new uint8_t[stride];
 
-  // Read the first two rows into the cache
+  if (!m_srcRow || !m_rowCache[0] || !m_rowCache[1])
+    {
+      gerr("ERROR: Failed to allocate row cache\n");
+      return;
+    }
+
+  // Render the whole image now if so requested.  The row cache is not
+  // needed after that.
+
+  if (cacheImage)
+    {
+      FAR uint8_t *image = new uint8_t[stride * newSize.h];
+      if (!image)
+        {
+          gerr("ERROR: Failed to allocate image cache, not caching\n");
+          return;
+        }
+
+      for (int y = 0; y < newSize.h; y++)
+        {
+          if (!scaleRun(0, y, newSize.w, &image[y * stride]))
+            {
+              delete[] image;
+              return;
+            }
+        }
+
+      m_image = image;
 
-  m_row = m_bitmap->getWidth(); // Set to an impossible value
-  cacheRows(0);
+      delete[] m_srcRow;
+      delete[] m_rowCache[0];
+      delete[] m_rowCache[1];
+
+      m_srcRow      = (FAR uint8_t *)0;
+      m_rowCache[0] = (FAR uint8_t *)0;
+      m_rowCache[1] = (FAR uint8_t *)0;
+    }
 }
 
 /**
@@ -89,17 +312,14 @@ CScaledBitmap::CScaledBitmap(IBitmap *bitmap, struct nxgl_size_s &newSize)
 
 CScaledBitmap::~CScaledBitmap(void)
 {
-  // Delete the allocated row cache memory
-
-  if (m_rowCache[0])
-    {
-      delete m_rowCache[0];
-    }
+  // Delete the allocated row cache, image and column table memory
 
-  if (m_rowCache[1])
-    {
-      delete m_rowCache[1];
-   }
+  delete[] m_srcRow;
+  delete[] m_rowCache[0];
+  delete[] m_rowCache[1];
+  delete[] m_image;
+  delete[] m_xIndex;
+  delete[] m_xWeight;
 
   // We are also responsible for deleting the contained IBitmap
 
@@ -185,417 +405,185 @@ const size_t CScaledBitmap::getStride(void) const
 bool CScaledBitmap::getRun(nxgl_coord_t x, nxgl_coord_t y,
                            nxgl_coord_t width, FAR void *data)
 {
-#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332 || CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24
-  FAR uint8_t  *dest = (FAR uint8_t *)data;
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
-  FAR uint16_t *dest = (FAR uint16_t *)data;
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB32
-  FAR uint32_t *dest = (FAR uint32_t *)data;
-#else
-#  error Unsupported, invalid, or undefined color format
-#endif
-
-  // Check ranges.  Casts to unsigned int are ugly but permit one-sided comparisons
+  // Check ranges.  Casts to unsigned int are ugly but permit one-sided
+  // comparisons.  Runs extending past the right edge are truncated.
 
-  if (((unsigned int)x           >=  (unsigned int)m_size.w) &&
-      ((unsigned int)(x + width) > (unsigned int)m_size.w) &&
-      ((unsigned int)y           <= (unsigned int)m_size.h))
+  if ((unsigned int)x >= (unsigned int)m_size.w ||
+      (unsigned int)y >= (unsigned int)m_size.h)
     {
       return false;
     }
 
-  // Get the row number in the unscaled image corresponding to the
-  // requested y position.  This must be either the exact row or the
-  // closest row just before the requested position
-
-  b16_t row16      = y * m_yScale;
-  nxgl_coord_t row = b16toi(row16);
-
-  // Get that row and the one after it into the row cache. We know that
-  // the pixel value that we want is one between the two rows.  This
-  // may seem wasteful to read two entire rows.  However, in normal usage
-  // we will be traversal each image from top-left to bottom-right in
-  // order.  In that case, the caching is most efficient.
-
-  if (!cacheRows(row))
+  if (width > m_size.w - x)
     {
-      return false;
+      width = m_size.w - x;
     }
 
-  // Now scale and copy the data from the cached row data
+  // Static images are simply copied from the scaled image
 
-  for (int i = 0; i < width; i++, x++)
+  if (m_image)
     {
-      // Get the column number in the unscaled row corresponding to the
-      // requested x position.  This must be either the exact column or the
-      // closest column just before the requested position
-
-      b16_t column = x * m_xScale;
-
-      // Get the color at the position on the first row
-
-      struct rgbcolor_s color1;
-      if (!rowColor(m_rowCache[0], column, color1))
-        {
-          gerr("ERROR: rowColor failed for the first row\n");
-          return false;
-        }
-
-      // Get the color at the position on the first row
-
-      struct rgbcolor_s color2;
-      if (!rowColor(m_rowCache[1], column, color2))
-        {
-          gerr("ERROR: rowColor failed for the second row\n");
-          return false;
-        }
-
-      // Check for transparent colors
-
-      bool transparent1;
-      bool transparent2;
-
-#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
-      uint8_t color = RGBTO8(color1.r, color1.g, color1.b);
-      transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-      color = RGBTO8(color2.r, color2.g, color2.b);
-      transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
-      uint16_t color = RGBTO16(color1.r, color1.g, color1.b);
-      transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-      color = RGBTO16(color2.r, color2.g, color2.b);
-      transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24 || CONFIG_NXWIDGETS_FMT == FB_FMT_RGB32
-      uint32_t color = RGBTO24(color1.r, color1.g, color1.b);
-      transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-      color = RGBTO24(color2.r, color2.g, color2.b);
-      transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-#else
-#  error Unsupported, invalid, or undefined color format
-#endif
-
-      // Is one of the colors transparent?
-
-      struct rgbcolor_s scaledColor;
-      b16_t fraction b16frac(row16);
-
-      if (transparent1 || transparent2)
-        {
-          // Yes.. don't interpolate within transparent regions or
-          // between transparent and opaque regions.
-
-          // Get the color closest to the requested position
-
-          if (fraction < b16HALF)
-            {
-              scaledColor.r = color1.r;
-              scaledColor.g = color1.g;
-              scaledColor.b = color1.b;
-            }
-          else
-            {
-              scaledColor.r = color2.r;
-              scaledColor.g = color2.g;
-              scaledColor.b = color2.b;
-            }
-        }
-      else
-        {
-          // No.. both colors are opaque
-
-          if (!scaleColor(color1, color2, fraction, scaledColor))
-            {
-              return false;
-            }
-        }
-
-      // Write the interpolated data to the user buffer
-
-#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
-      color = RGBTO8(scaledColor.r, scaledColor.g, scaledColor.b);
-      *dest++ = color;
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
-      color = RGBTO16(scaledColor.r, scaledColor.g, scaledColor.b);
-      *dest++ = color;
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24
-      *dest++ = color2.b;
-      *dest++ = color2.r;
-      *dest++ = color2.g;
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB32
-      color = RGBTO24(scaledColor.r, scaledColor.g, scaledColor.b);
-      *dest++ = color;
-
-#else
-#  error Unsupported, invalid, or undefined color format
-#endif
+      unsigned int bpp = m_bitmap->getBitsPerPixel();
+      memcpy(data, &m_image[y * getStride() + ((x * bpp) >> 3)],
+             (width * bpp) >> 3);
+      return true;
     }
 
-  return true;
+  return scaleRun(x, y, width, (FAR uint8_t *)data);
 }
 
 /**
- * Read two rows into the row cache
+ * Scale one row of the image in both directions
  *
- * @param row - The row number of the first row to cache
+ * @param x The offset into the row to get
+ * @param y The row number to get
+ * @param width The number of pixels to get from the row
+ * @param data The location to return the scaled pixels
  */
 
-bool CScaledBitmap::cacheRows(unsigned int row)
+bool CScaledBitmap::scaleRun(nxgl_coord_t x, nxgl_coord_t y,
+                             nxgl_coord_t width, FAR uint8_t *data)
 {
-  nxgl_coord_t bitmapWidth  = m_bitmap->getWidth();
-  nxgl_coord_t bitmapHeight = m_bitmap->getHeight();
-
-  // A common case is to advance by one row.  In this case, we only
-  // need to read one row
-
-  if (row == m_row + 1)
+  if (!m_rowCache[0] || !m_rowCache[1] || !m_xIndex || !m_xWeight)
     {
-      // Swap rows
-
-      FAR uint8_t *saveRow = m_rowCache[0];
-      m_rowCache[0] = m_rowCache[1];
-      m_rowCache[1] = saveRow;
-
-      // Save number of the first row that we have in the cache
-
-      m_row = row;
-
-      // Now read the new row into the second row cache buffer
-
-      if (++row >= (unsigned int)bitmapHeight)
-        {
-          row = bitmapHeight - 1;
-        }
-
-      if (!m_bitmap->getRun(0, row, bitmapWidth, m_rowCache[1]))
-        {
-          gerr("ERROR: Failed to read bitmap row %d\n", row);
-          return false;
-        }
+      return false;
     }
 
-  // Do we need to read two new rows?  Or do we already have the
-  // request row in the cache?
-
-  else if (row != m_row)
-    {
-      // Read the first row into the cache
+  // Get the row number in the unscaled image corresponding to the
+  // requested y position.  This must be either the exact row or the
+  // closest row just before the requested position
 
-      if (row >= (unsigned int)bitmapHeight)
-        {
-          row = bitmapHeight - 1;
-        }
+  b16_t row16      = y * m_yScale;
+  nxgl_coord_t row = b16toi(row16);
 
-      if (!m_bitmap->getRun(0, row, bitmapWidth, m_rowCache[0]))
-        {
-          gerr("ERROR: Failed to read bitmap row %d\n", row);
-          return false;
-        }
+  // Get that row and the one after it into the row cache. We know that
+  // the pixel value that we want is one between the two rows.  In normal
+  // usage we will be traversing each image from top-left to bottom-right
+  // in order.  In that case each unscaled row is read and horizontally
+  // scaled only once.
 
-      // Save number of the first row that we have in the cache
+  if (!cacheRows(row))
+    {
+      return false;
+    }
 
-      m_row = row;
+  // Now interpolate between the two horizontally scaled rows
 
-      // Read the next row into the cache
+  unsigned int weight = (unsigned int)(b16frac(row16) >> (16 - SCALE_SHIFT));
+  FAR const uint8_t *row1 = m_rowCache[0];
+  FAR const uint8_t *row2 = m_rowCache[1];
 
-      if (++row >= (unsigned int)bitmapHeight)
-        {
-          row = bitmapHeight - 1;
-        }
+  if (weight == 0)
+    {
+      unsigned int bpp = m_bitmap->getBitsPerPixel();
+      memcpy(data, &row1[(x * bpp) >> 3], (width * bpp) >> 3);
+      return true;
+    }
 
-      if (!m_bitmap->getRun(0, row, bitmapWidth, m_rowCache[1]))
-        {
-          gerr("ERROR: Failed to read bitmap row %d\n", row);
-          return false;
-        }
+  for (int i = 0; i < width; i++)
+    {
+      storePixel(data, i, blendPixel(loadPixel(row1, x + i),
+                                     loadPixel(row2, x + i), weight));
     }
 
   return true;
 }
 
 /**
- * Given an two RGB colors and a fractional value, return the scaled
- * value between the two colors.
+ * Read one row of the unscaled image and scale it horizontally
  *
- * @param incolor1 - The first color to be used
- * @param incolor2 - The second color to be used
- * @param fraction - The fractional value
- * @param outcolor - The returned, scaled color
+ * @param row - The row number in the unscaled image
+ * @param dest - The location to return the scaled row
  */
 
-bool CScaledBitmap::scaleColor(FAR const struct rgbcolor_s &incolor1,
-                               FAR const struct rgbcolor_s &incolor2,
-                               b16_t fraction, FAR struct rgbcolor_s &outcolor)
+bool CScaledBitmap::scaleRow(unsigned int row, FAR uint8_t *dest)
 {
-  uint32_t component;
-  b16_t red;
-  b16_t green;
-  b16_t blue;
-
-  // A fraction of < 0.5 would mean to use use mostly color1; a fraction
-  // greater than 0.5 would men to use mostly color2
-
-  b16_t remainder = b16ONE - fraction;
-
-  // Interpolate each color value  (converting to b15)
-
-  red   = (b16_t)incolor1.r * remainder + (b16_t)incolor2.r * fraction;
-  green = (b16_t)incolor1.g * remainder + (b16_t)incolor2.g * fraction;
-  blue  = (b16_t)incolor1.b * remainder + (b16_t)incolor2.b * fraction;
+  if (!m_bitmap->getRun(0, row, m_bitmap->getWidth(), m_srcRow))
+    {
+      gerr("ERROR: Failed to read bitmap row %d\n", row);
+      return false;
+    }
 
-  // Return the integer, interpolated values, clipping to the range of
-  // uint8_t
+  for (int x = 0; x < m_size.w; x++)
+    {
+      unsigned int col    = m_xIndex[x];
+      unsigned int weight = m_xWeight[x];
+      uint32_t pixel      = loadPixel(m_srcRow, col);
 
-  component  = b16toi(red);
-  outcolor.r = component < 256 ? component : 255;
+      if (weight != 0)
+        {
+          pixel = blendPixel(pixel, loadPixel(m_srcRow, col + 1), weight);
+        }
 
-  component  = b16toi(green);
-  outcolor.g = component < 256 ? component : 255;
+      storePixel(dest, x, pixel);
+    }
 
-  component  = b16toi(blue);
-  outcolor.b = component < 256 ? component : 255;
   return true;
 }
 
 /**
- * Given an image row and a non-integer column offset, return the
- * interpolated RGB color value corresponding to that position
- *
- * @param row - The pointer to the row in the row cache to use
- * @param column - The non-integer column offset
- * @param outcolor - The returned, interpolated color
+ * Read and horizontally scale two rows into the row cache
  *
+ * @param row - The row number of the first row to cache
  */
 
-bool CScaledBitmap::rowColor(FAR uint8_t *row, b16_t column,
-                             FAR struct rgbcolor_s &outcolor)
+bool CScaledBitmap::cacheRows(unsigned int row)
 {
-  // This is the col at or just before the pixel of interest
+  unsigned int bitmapHeight = (unsigned int)m_bitmap->getHeight();
 
-  nxgl_coord_t col1 = b16toi(column);
-  nxgl_coord_t col2 = col1 + 1;
-
-  nxgl_coord_t bitmapWidth  = m_bitmap->getWidth();
-  if (col2 >= bitmapWidth)
+  if (row >= bitmapHeight)
     {
-      col2 = bitmapWidth - 1;
+      row = bitmapHeight - 1;
     }
 
-  b16_t fraction = b16frac(column);
-
-  struct rgbcolor_s color1;
-  struct rgbcolor_s color2;
-
-  bool transparent1;
-  bool transparent2;
-
-#if CONFIG_NXWIDGETS_FMT == FB_FMT_RGB8_332
-  uint8_t color = row[col1];
-  color1.r = RGB8RED(color);
-  color1.g = RGB8GREEN(color);
-  color1.b = RGB8BLUE(color);
-
-  transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-  color = row[col2];
-  color2.r = RGB8RED(color);
-  color2.g = RGB8GREEN(color);
-  color2.b = RGB8BLUE(color);
-
-  transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB16_565
-  FAR uint16_t *row16 = (FAR uint16_t*)row;
-  uint16_t color = row16[col1];
-  color1.r = RGB16RED(color);
-  color1.g = RGB16GREEN(color);
-  color1.b = RGB16BLUE(color);
-
-  transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-  color = row16[col2];
-  color2.r = RGB16RED(color);
-  color2.g = RGB16GREEN(color);
-  color2.b = RGB16BLUE(color);
-
-  transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
+  // The row after the first row, clipped to the image
 
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB24
-  unsigned int ndx = 3*col1;
-  color1.r = row[ndx+2];
-  color1.g = row[ndx+1];
-  color1.b = row[ndx];
-
-  uint32_t color = RGBTO24(color1.r, color1.g, color1.b);
-  transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-  ndx      = 3*col2;
-  color2.r = row[ndx+2];
-  color2.g = row[ndx+1];
-  color2.b = row[ndx];
-
-  color = RGBTO24(color2.r, color2.g, color2.b);
-  transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-#elif CONFIG_NXWIDGETS_FMT == FB_FMT_RGB32
-  FAR uint32_t *row32 = (FAR uint32_t*)row;
-  uint32_t color = row32[col1];
-  color1.r = RGB24RED(color);
-  color1.g = RGB24GREEN(color);
-  color1.b = RGB24BLUE(color);
+  unsigned int next = row + 1 < bitmapHeight ? row + 1 : row;
 
-  transparent1 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
+  // Do we already have the request row in the cache?
 
-  color    = row32[col2];
-  color2.r = RGB24RED(color);
-  color2.g = RGB24GREEN(color);
-  color2.b = RGB24BLUE(color);
-
-  transparent2 = (color == CONFIG_NXWIDGETS_TRANSPARENT_COLOR);
-
-#else
-#  error Unsupported, invalid, or undefined color format
-#endif
+  if (row == m_row)
+    {
+      return true;
+    }
 
-  // Is one of the colors transparent?
+  // A common case is to advance by one row.  In this case, we only
+  // need to read one row
 
-  if (transparent1 || transparent2)
+  if (m_row != UINT_MAX && row == m_row + 1)
     {
-      // Yes.. don't interpolate within transparent regions or
-      // between transparent and opaque regions.
+      // Swap rows
 
-      // Return the color closest to the requested position
-      //
-      // A fraction of < 0.5 would mean to use use mostly color1; a fraction
-      // greater than 0.5 would men to use mostly color2
+      FAR uint8_t *saveRow = m_rowCache[0];
+      m_rowCache[0] = m_rowCache[1];
+      m_rowCache[1] = saveRow;
+    }
+  else
+    {
+      // Read and scale the first row into the cache
 
-      if (fraction < b16HALF)
+      m_row = UINT_MAX;
+      if (!scaleRow(row, m_rowCache[0]))
         {
-          outcolor.r = color1.r;
-          outcolor.g = color1.b;
-          outcolor.g = color1.g;
-        }
-      else
-        {
-          outcolor.r = color2.r;
-          outcolor.g = color2.b;
-          outcolor.g = color2.g;
+          return false;
         }
+    }
 
-      return true;
+  // Now read and scale the new row into the second row cache buffer.  At
+  // the bottom of the image, both rows are the same.
+
+  if (next == row)
+    {
+      memcpy(m_rowCache[1], m_rowCache[0], getStride());
     }
-  else
+  else if (!scaleRow(next, m_rowCache[1]))
     {
-      // No.. both colors are opaque
-
-      return scaleColor(color1, color2, fraction, outcolor);
+      m_row = UINT_MAX;
+      return false;
     }
+
+  // Save number of the first row that we have in the cache
+
+  m_row = row;
+  return true;
 }
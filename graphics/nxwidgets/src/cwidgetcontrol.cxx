@@ -75,6 +75,8 @@ CWidgetControl::CWidgetControl(FAR const CWidgetStyle *style)
   m_haveGeometry       = false;
   m_clickedWidget      = NULL;
   m_focusedWidget      = NULL;
+  m_batchRedraw        = false;
+  m_flushingRedraw     = false;
 
   // Initialize data that we will get from the position callback
 
@@ -220,6 +222,7 @@ void CWidgetControl::postWindowEvent(void)
  *   pollMouseEvents(widget)
  *   pollKeyboardEvents()
  *   pollCursorControlEvents()
+ *   flushRedraw()
  *
  * @param widget.  Specific widget to poll.  Use NULL to run the
  *    all widgets in the window.
@@ -243,6 +246,10 @@ bool CWidgetControl::pollEvents(CNxWidget *widget)
   // Handle cursor control input
 
   bool cursorControlEvent = pollCursorControlEvents();
+
+  // Draw everything that the events above invalidated
+
+  flushRedraw();
   return mouseEvent || keyboardEvent || cursorControlEvent;
 }
 
@@ -281,6 +288,194 @@ void CWidgetControl::removeControlledWidget(CNxWidget *widget)
     {
       m_widgets.erase(index);
     }
+
+  // And make sure that it is not drawn after it is gone
+
+  for (int i = m_redrawQueue.size() - 1; i >= 0; i--)
+    {
+      if (m_redrawQueue[i] == widget)
+        {
+          m_redrawQueue.erase(i);
+        }
+    }
+}
+
+/**
+ * Check if one widget is an ancestor of another.
+ *
+ * @param ancestor The possible ancestor.
+ * @param widget The widget whose parents are checked.
+ * @return True if ancestor is a parent, grandparent, etc. of widget.
+ */
+
+bool CWidgetControl::isAncestor(const CNxWidget *ancestor,
+                                const CNxWidget *widget)
+{
+  for (const CNxWidget *parent = widget->getParent(); parent != NULL;
+       parent = parent->getParent())
+    {
+      if (parent == ancestor)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/**
+ * Redraw the damaged parts of a widget and of its children in z-order.
+ * Called by flushRedraw().
+ *
+ * @param widget The widget to redraw.
+ * @param painted The area painted so far in this flush.
+ */
+
+void CWidgetControl::flushRedraw(CNxWidget *widget, CDamageRegion &painted)
+{
+  // Hidden widgets hide their children too
+
+  if (!widget->isDrawingEnabled())
+    {
+      return;
+    }
+
+  struct nxgl_rect_s rect;
+  rect.pt1.x = widget->getX();
+  rect.pt1.y = widget->getY();
+  rect.pt2.x = rect.pt1.x + widget->getWidth() - 1;
+  rect.pt2.y = rect.pt1.y + widget->getHeight() - 1;
+
+  bool queued = false;
+  for (int i = 0; i < m_redrawQueue.size(); i++)
+    {
+      if (m_redrawQueue[i] == widget)
+        {
+          queued = true;
+          break;
+        }
+    }
+
+  if (queued)
+    {
+      painted.add(&rect);
+      widget->redrawClipped(&rect);
+    }
+  else
+    {
+      for (int i = 0; i < painted.getRectCount(); i++)
+        {
+          struct nxgl_rect_s clip;
+          nxgl_rectintersect(&clip, &rect, painted.getRect(i));
+          if (!nxgl_nullrect(&clip))
+            {
+              widget->redrawClipped(&clip);
+            }
+        }
+    }
+
+  for (int i = 0; i < widget->getChildCount(); i++)
+    {
+      flushRedraw(widget->getChild(i), painted);
+    }
+}
+
+/**
+ * Enable or disable batched redraws.
+ *
+ * @param enable True to batch redraws.
+ */
+
+void CWidgetControl::setRedrawBatching(bool enable)
+{
+  if (!enable)
+    {
+      flushRedraw();
+    }
+
+  m_batchRedraw = enable;
+}
+
+/**
+ * Queue a widget for redraw.  Called by CNxWidget::redraw().
+ *
+ * @param widget The widget that must be redrawn.
+ * @return True if the redraw was queued, false if the caller must
+ *   draw the widget now.
+ */
+
+bool CWidgetControl::queueRedraw(CNxWidget *widget)
+{
+  // Widgets that redraw themselves while flushRedraw() draws them are
+  // drawn immediately
+
+  if (!m_batchRedraw || m_flushingRedraw)
+    {
+      return false;
+    }
+
+  // Nothing to do if the widget or one of its ancestors is already queued
+
+  for (int i = 0; i < m_redrawQueue.size(); i++)
+    {
+      if (m_redrawQueue[i] == widget || isAncestor(m_redrawQueue[i], widget))
+        {
+          return true;
+        }
+    }
+
+  // Queued descendants will be drawn as part of this widget
+
+  for (int i = m_redrawQueue.size() - 1; i >= 0; i--)
+    {
+      if (isAncestor(widget, m_redrawQueue[i]))
+        {
+          m_redrawQueue.erase(i);
+        }
+    }
+
+  m_redrawQueue.push_back(widget);
+
+#ifdef CONFIG_NXWIDGET_EVENTWAIT
+  postWindowEvent();
+#endif
+
+  return true;
+}
+
+/**
+ * Draw all widgets queued for redraw.
+ */
+
+void CWidgetControl::flushRedraw(void)
+{
+  if (m_redrawQueue.size() == 0 || m_flushingRedraw)
+    {
+      return;
+    }
+
+  m_flushingRedraw = true;
+
+  // Walk the widget trees bottom to top:  Top-level widgets in the order
+  // that they were created, each followed by its children in their
+  // z-order, which is the order that CNxWidget::redraw() paints them in.
+  // The damage region tracks what has been painted so far.  A queued
+  // widget is drawn in full and adds its area to the region, any other
+  // widget is redrawn only where it overlaps the region so that it stays
+  // on top of what was painted underneath.
+
+  CDamageRegion painted;
+
+  for (int i = 0; i < m_widgets.size(); i++)
+    {
+      if (m_widgets[i]->getParent() == NULL)
+        {
+          flushRedraw(m_widgets[i], painted);
+        }
+    }
+
+  m_redrawQueue.clear();
+  m_flushingRedraw = false;
 }
 
 /**
@@ -423,7 +618,28 @@ void CWidgetControl::geometryEvent(NXHANDLE hWindow,
 
 void CWidgetControl::redrawEvent(FAR const struct nxgl_rect_s *nxRect, bool more)
 {
-  m_eventHandlers.raiseRedrawEvent(nxRect, more);
+  if (!m_batchRedraw && m_exposed.isEmpty())
+    {
+      m_eventHandlers.raiseRedrawEvent(nxRect, more);
+      return;
+    }
+
+  // Accumulate the series of exposed areas and report the merged region
+  // once the last one has been received.
+
+  m_exposed.add(nxRect);
+
+  if (!more || !m_batchRedraw)
+    {
+      int nRects = m_exposed.getRectCount();
+      for (int i = 0; i < nRects; i++)
+        {
+          m_eventHandlers.raiseRedrawEvent(m_exposed.getRect(i),
+                                           more || i < nRects - 1);
+        }
+
+      m_exposed.clear();
+    }
 }
 
 /**
@@ -456,7 +456,10 @@ bool CTaskbar::startApplication(IApplication *app, bool minimized)
       iconSize.w = CONFIG_NXWM_TASKBAR_ICONWIDTH;
       iconSize.h = CONFIG_NXWM_TASKBAR_ICONHEIGHT;
 
-      scaler = new NXWidgets::CScaledBitmap(bitmap, iconSize);
+      // Task bar icons never change, so keep the scaled image rather
+      // than re-scaling it each time that the task bar is redrawn.
+
+      scaler = new NXWidgets::CScaledBitmap(bitmap, iconSize, true);
       if (!scaler)
         {
           return false;
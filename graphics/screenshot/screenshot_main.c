@@ -32,6 +32,8 @@
 #include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
+#include <unistd.h>
+#include <time.h>
 #include <semaphore.h>
 #include <errno.h>
 
@@ -55,10 +57,44 @@
 #  define CONFIG_SCREENSHOT_FORMAT FB_FMT_RGB16_565
 #endif
 
+#ifndef CONFIG_SCREENSHOT_RPS
+#  define CONFIG_SCREENSHOT_RPS 8
+#endif
+
+#if defined(CONFIG_SCREENSHOT_COMPRESS_LZW)
+#  define SCREENSHOT_COMPRESS TAG_COMP_LZW
+#elif defined(CONFIG_SCREENSHOT_COMPRESS_PACKBITS)
+#  define SCREENSHOT_COMPRESS TAG_COMP_PACKBITS
+#else
+#  define SCREENSHOT_COMPRESS TAG_COMP_NONE
+#endif
+
+#define SCREENSHOT_IOSIZE   512
+#define NSEC_PER_SEC        1000000000L
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+/* State shared by all frames of one screenshot session */
+
+struct screenshot_s
+{
+  NXHANDLE server;           /* Connection to the NX server */
+  NXWINDOW window;           /* Invisible window used to read the display */
+  struct nxgl_size_s size;   /* Size of the captured area */
+  nxgl_coord_t rps;          /* Rows per strip */
+  nxgl_coord_t nstrips;      /* Number of strips per frame */
+  uint16_t compress;         /* TIFF compression, TAG_COMP_* */
+  size_t stride;             /* Bytes per row */
+  size_t stripsize;          /* Bytes per strip */
+  FAR uint8_t *strip;        /* The strip being captured */
+  FAR uint8_t *prev;         /* The previous strip of the frame */
+  FAR uint8_t *iobuffer;     /* I/O buffer for the TIFF library */
+  FAR uint32_t *hashes;      /* Strip hashes of the last saved frame */
+  bool havehashes;           /* True when hashes holds a saved frame */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,151 +129,485 @@ static void replace_extension(FAR const char *filename,
 }
 
 /****************************************************************************
- * Public Functions
+ * Name: frame_filename
+ *
+ * Description:
+ *   Create the name of one frame of a capture series by inserting the
+ *   frame number before the extension:  "shot.tif" becomes
+ *   "shot_0012.tif".
+ *
  ****************************************************************************/
 
+static void frame_filename(FAR const char *filename, int frame,
+                           FAR char *dest, size_t size)
+{
+  FAR const char *p = strrchr(filename, '.');
+  int len = strlen(filename);
+
+  if (p != NULL)
+    {
+      len = p - filename;
+    }
+  else
+    {
+      p = ".tif";
+    }
+
+  snprintf(dest, size, "%.*s_%04d%s", len, filename, frame, p);
+}
+
 /****************************************************************************
- * Name: save_screenshot
+ * Name: screenshot_stride
  *
  * Description:
- *   Takes a screenshot and saves it to a tif file.
+ *   Return the number of bytes in one row of the TIFF color format.
  *
  ****************************************************************************/
 
-int save_screenshot(FAR const char *filename)
+static size_t screenshot_stride(uint8_t colorfmt, nxgl_coord_t width)
+{
+  switch (colorfmt)
+    {
+      case FB_FMT_Y1:
+        return (width + 7) >> 3;
+
+      case FB_FMT_Y4:
+        return (width + 1) >> 1;
+
+      case FB_FMT_Y8:
+        return width;
+
+      case FB_FMT_RGB16_565:
+        return 2 * width;
+
+      case FB_FMT_RGB24:
+      default:
+        return 3 * width;
+    }
+}
+
+/****************************************************************************
+ * Name: screenshot_hash
+ *
+ * Description:
+ *   32-bit FNV-1a hash of a strip, used to detect unchanged frames.
+ *
+ ****************************************************************************/
+
+static uint32_t screenshot_hash(FAR const uint8_t *data, size_t len)
+{
+  uint32_t hash = 2166136261u;
+
+  while (len-- > 0)
+    {
+      hash = (hash ^ *data++) * 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: screenshot_getstrip
+ *
+ * Description:
+ *   Read one strip of the display into ss->strip.  Rows of the last strip
+ *   that are below the bottom of the image are cleared.
+ *
+ ****************************************************************************/
+
+static int screenshot_getstrip(FAR struct screenshot_s *ss, int index)
+{
+  struct nxgl_rect_s rect;
+  int nrows;
+
+  rect.pt1.x = 0;
+  rect.pt1.y = index * ss->rps;
+  rect.pt2.x = ss->size.w - 1;
+  rect.pt2.y = rect.pt1.y + ss->rps - 1;
+
+  if (rect.pt2.y >= ss->size.h)
+    {
+      rect.pt2.y = ss->size.h - 1;
+    }
+
+  nrows = rect.pt2.y - rect.pt1.y + 1;
+  if (nrows < ss->rps)
+    {
+      memset(ss->strip + nrows * ss->stride, 0,
+             (ss->rps - nrows) * ss->stride);
+    }
+
+  return nx_getrectangle(ss->window, &rect, 0, ss->strip, ss->stride);
+}
+
+/****************************************************************************
+ * Name: screenshot_unchanged
+ *
+ * Description:
+ *   Return true if the display still matches the last saved frame.  The
+ *   comparison stops at the first changed strip.
+ *
+ ****************************************************************************/
+
+static bool screenshot_unchanged(FAR struct screenshot_s *ss)
+{
+  int i;
+
+  if (!ss->havehashes)
+    {
+      return false;
+    }
+
+  for (i = 0; i < ss->nstrips; i++)
+    {
+      if (screenshot_getstrip(ss, i) < 0 ||
+          screenshot_hash(ss->strip, ss->stripsize) != ss->hashes[i])
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: screenshot_frame
+ *
+ * Description:
+ *   Save the display to a TIFF file.  A strip that is identical to the
+ *   strip above it is stored only once.
+ *
+ ****************************************************************************/
+
+static int screenshot_frame(FAR struct screenshot_s *ss,
+                            FAR const char *filename)
 {
   struct tiff_info_s info;
-  struct nx_callback_s cb =
-  {
-  };
+  FAR uint8_t *tmp;
+  char tempf1[64];
+  char tempf2[64];
+  int ret;
+  int i;
+
+  replace_extension(filename, ".tm1", tempf1, sizeof(tempf1));
+  replace_extension(filename, ".tm2", tempf2, sizeof(tempf2));
+
+  /* The hashes are only valid once the whole frame has been saved */
+
+  ss->havehashes = false;
+
+  /* Configure the TIFF structure */
+
+  memset(&info, 0, sizeof(struct tiff_info_s));
+  info.outfile   = filename;
+  info.tmpfile1  = tempf1;
+  info.tmpfile2  = tempf2;
+  info.colorfmt  = CONFIG_SCREENSHOT_FORMAT;
+  info.rps       = ss->rps;
+  info.imgwidth  = ss->size.w;
+  info.imgheight = ss->size.h;
+  info.compress  = ss->compress;
+  info.iobuffer  = ss->iobuffer;
+  info.iosize    = SCREENSHOT_IOSIZE;
+
+  /* Initialize the TIFF library */
 
-  struct nxgl_size_s size =
+  ret = tiff_initialize(&info);
+  if (ret < 0)
+    {
+      printf("tiff_initialize() failed: %d\n", ret);
+      return ret;
+    }
+
+  /* Add each strip to the TIFF file */
+
+  for (i = 0; i < ss->nstrips; i++)
+    {
+      ret = screenshot_getstrip(ss, i);
+      if (ret < 0)
+        {
+          printf("nx_getrectangle() #%d failed: %d\n", i, ret);
+          tiff_abort(&info);
+          return ret;
+        }
+
+      if (i > 0 && memcmp(ss->strip, ss->prev, ss->stripsize) == 0)
+        {
+          ret = tiff_repeatstrip(&info);
+        }
+      else
+        {
+          ret = tiff_addstrip(&info, ss->strip);
+        }
+
+      if (ret < 0)
+        {
+          printf("tiff_addstrip() #%d failed: %d\n", i, ret);
+          return ret;
+        }
+
+      if (ss->hashes != NULL)
+        {
+          ss->hashes[i] = screenshot_hash(ss->strip, ss->stripsize);
+        }
+
+      tmp       = ss->prev;
+      ss->prev  = ss->strip;
+      ss->strip = tmp;
+    }
+
+  /* Then finalize the TIFF file */
+
+  ret = tiff_finalize(&info);
+  if (ret < 0)
+    {
+      printf("tiff_finalize() failed: %d\n", ret);
+      return ret;
+    }
+
+  ss->havehashes = ss->hashes != NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: screenshot_open
+ *
+ * Description:
+ *   Connect to the NX server and allocate the strip buffers.
+ *
+ ****************************************************************************/
+
+static int screenshot_open(FAR struct screenshot_s *ss, uint16_t compress,
+                           bool series)
+{
+  struct nx_callback_s cb =
   {
-    CONFIG_SCREENSHOT_WIDTH, CONFIG_SCREENSHOT_HEIGHT
   };
 
 #ifdef CONFIG_VNCSERVER
   struct boardioc_vncstart_s vnc;
-#endif
-  FAR uint8_t *strip;
-  NXHANDLE server;
-  NXWINDOW window;
-  char tempf1[64];
-  char tempf2[64];
-  int row;
   int ret;
+#endif
 
-  replace_extension(filename, ".tm1", tempf1, sizeof(tempf1));
-  replace_extension(filename, ".tm2", tempf2, sizeof(tempf2));
+  memset(ss, 0, sizeof(struct screenshot_s));
+  ss->size.w    = CONFIG_SCREENSHOT_WIDTH;
+  ss->size.h    = CONFIG_SCREENSHOT_HEIGHT;
+  ss->compress  = compress;
+  ss->rps       = CONFIG_SCREENSHOT_RPS;
+
+  /* The StripOffsets and StripByteCounts of a single strip image would
+   * have to be stored in the IFD itself.  Always use at least two strips.
+   */
+
+  if (ss->rps > (ss->size.h + 1) / 2)
+    {
+      ss->rps = (ss->size.h + 1) / 2;
+    }
+
+  ss->nstrips   = (ss->size.h + ss->rps - 1) / ss->rps;
+  ss->stride    = screenshot_stride(CONFIG_SCREENSHOT_FORMAT, ss->size.w);
+  ss->stripsize = ss->stride * ss->rps;
+
+  ss->strip    = malloc(ss->stripsize);
+  ss->prev     = malloc(ss->stripsize);
+  ss->iobuffer = malloc(SCREENSHOT_IOSIZE);
+  if (series)
+    {
+      ss->hashes = malloc(ss->nstrips * sizeof(uint32_t));
+    }
+
+  if (ss->strip == NULL || ss->prev == NULL || ss->iobuffer == NULL ||
+      (series && ss->hashes == NULL))
+    {
+      printf("Failed to allocate buffers\n");
+      goto errout;
+    }
 
   /* Connect to NX server */
 
-  server = nx_connect();
-  if (!server)
+  ss->server = nx_connect();
+  if (!ss->server)
     {
       perror("nx_connect");
-      return 1;
+      goto errout;
     }
 
 #ifdef CONFIG_VNCSERVER
   /* Setup the VNC server to support keyboard/mouse inputs */
 
   vnc.display = 0;
-  vnc.handle  = server;
+  vnc.handle  = ss->server;
 
   ret = boardctl(BOARDIOC_VNC_START, (uintptr_t)&vnc);
   if (ret < 0)
     {
       printf("boardctl(BOARDIOC_VNC_START) failed: %d\n", ret);
-      nx_disconnect(server);
-      return 1;
+      goto errout_with_server;
     }
 #endif
 
   /* Wait for "connected" event */
 
-  if (nx_eventhandler(server) < 0)
+  if (nx_eventhandler(ss->server) < 0)
     {
       perror("nx_eventhandler");
-      nx_disconnect(server);
-      return 1;
+      goto errout_with_server;
     }
 
   /* Open invisible dummy window for communication */
 
-  window = nx_openwindow(server, 0, &cb, NULL);
-  if (!window)
+  ss->window = nx_openwindow(ss->server, 0, &cb, NULL);
+  if (!ss->window)
     {
       perror("nx_openwindow");
-      nx_disconnect(server);
-      return 1;
+      goto errout_with_server;
     }
 
-  nx_setsize(window, &size);
+  nx_setsize(ss->window, &ss->size);
+  return OK;
 
-  /* Configure the TIFF structure */
+errout_with_server:
+  nx_disconnect(ss->server);
 
-  memset(&info, 0, sizeof(struct tiff_info_s));
-  info.outfile   = filename;
-  info.tmpfile1  = tempf1;
-  info.tmpfile2  = tempf2;
-  info.colorfmt  = CONFIG_SCREENSHOT_FORMAT;
-  info.rps       = 1;
-  info.imgwidth  = size.w;
-  info.imgheight = size.h;
-  info.iobuffer  = (uint8_t *)malloc(300);
-  info.iosize    = 300;
+errout:
+  free(ss->strip);
+  free(ss->prev);
+  free(ss->iobuffer);
+  free(ss->hashes);
+  return ERROR;
+}
 
-  /* Initialize the TIFF library */
+/****************************************************************************
+ * Name: screenshot_close
+ ****************************************************************************/
 
-  ret = tiff_initialize(&info);
-  if (ret < 0)
-    {
-      printf("tiff_initialize() failed: %d\n", ret);
-      return 1;
-    }
+static void screenshot_close(FAR struct screenshot_s *ss)
+{
+  nx_closewindow(ss->window);
+  nx_disconnect(ss->server);
 
-  /* Add each strip to the TIFF file */
+  free(ss->strip);
+  free(ss->prev);
+  free(ss->iobuffer);
+  free(ss->hashes);
+}
+
+/****************************************************************************
+ * Name: screenshot_series
+ *
+ * Description:
+ *   Capture frames at a fixed rate.  Frame n is sampled n / rate seconds
+ *   after the start and saved to filename_n.tif, unless the display has
+ *   not changed since the last saved frame.  Frames whose sample time has
+ *   passed while the previous frame was being saved are skipped.
+ *
+ ****************************************************************************/
+
+static int screenshot_series(FAR struct screenshot_s *ss,
+                             FAR const char *filename, int nframes,
+                             int rate)
+{
+  struct timespec start;
+  struct timespec next;
+  struct timespec now;
+  char framef[64];
+  long long elapsed;
+  long long period;
+  int nsaved = 0;
+  int nsame  = 0;
+  int nmissed = 0;
+  int frame;
+  int ret;
 
-  strip = malloc(size.w * 3);
+  period = NSEC_PER_SEC / rate;
+  clock_gettime(CLOCK_MONOTONIC, &start);
 
-  for (row = 0; row < size.h; row++)
+  for (frame = 0; frame < nframes; )
     {
-      struct nxgl_rect_s rect =
-      {
+      if (screenshot_unchanged(ss))
         {
-          0, row
-        },
+          nsame++;
+        }
+      else
         {
-          size.w - 1, row
+          frame_filename(filename, frame, framef, sizeof(framef));
+          ret = screenshot_frame(ss, framef);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          nsaved++;
         }
-      };
 
-      nx_getrectangle(window, &rect, 0, strip, 0);
+      /* Advance to the next sample time that has not passed yet */
 
-      ret = tiff_addstrip(&info, strip);
-      if (ret < 0)
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      elapsed = (long long)(now.tv_sec - start.tv_sec) * NSEC_PER_SEC +
+                (now.tv_nsec - start.tv_nsec);
+
+      frame++;
+      while (frame < nframes && frame * period <= elapsed)
+        {
+          frame++;
+          nmissed++;
+        }
+
+      if (frame < nframes)
         {
-          printf("tiff_addstrip() #%d failed: %d\n", row, ret);
-          break;
+          next.tv_sec  = start.tv_sec + (frame * period) / NSEC_PER_SEC;
+          next.tv_nsec = start.tv_nsec + (frame * period) % NSEC_PER_SEC;
+          if (next.tv_nsec >= NSEC_PER_SEC)
+            {
+              next.tv_sec++;
+              next.tv_nsec -= NSEC_PER_SEC;
+            }
+
+          clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
         }
     }
 
-  free(strip);
+  printf("%d frames: %d saved, %d unchanged, %d missed\n",
+         nframes, nsaved, nsame, nmissed);
+  return OK;
+}
 
-  /* Then finalize the TIFF file */
+static void show_usage(FAR const char *progname)
+{
+  fprintf(stderr, "Usage: %s [-c none|packbits|lzw] [-n frames] "
+                  "[-r rate] file.tif\n", progname);
+  fprintf(stderr, "  -c: Strip compression\n");
+  fprintf(stderr, "  -n: Capture a series of frames to file_NNNN.tif. "
+                  "Unchanged frames are not saved.\n");
+  fprintf(stderr, "  -r: Frames per second of the series (default 1)\n");
+}
 
-  ret = tiff_finalize(&info);
-  if (ret < 0)
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: save_screenshot
+ *
+ * Description:
+ *   Takes a screenshot and saves it to a tif file.
+ *
+ ****************************************************************************/
+
+int save_screenshot(FAR const char *filename)
+{
+  struct screenshot_s ss;
+  int ret;
+
+  if (screenshot_open(&ss, SCREENSHOT_COMPRESS, false) < 0)
     {
-      printf("tiff_finalize() failed: %d\n", ret);
+      return 1;
     }
 
-  free(info.iobuffer);
-  nx_closewindow(window);
-  nx_disconnect(server);
+  ret = screenshot_frame(&ss, filename);
+  screenshot_close(&ss);
 
-  return 0;
+  return ret < 0 ? 1 : 0;
 }
 
 /****************************************************************************
@@ -250,11 +620,71 @@ int save_screenshot(FAR const char *filename)
 
 int main(int argc, FAR char *argv[])
 {
-  if (argc != 2)
+  struct screenshot_s ss;
+  uint16_t compress = SCREENSHOT_COMPRESS;
+  int nframes = 1;
+  int rate = 1;
+  int option;
+  int ret;
+
+  while ((option = getopt(argc, argv, "c:n:r:")) != ERROR)
+    {
+      switch (option)
+        {
+          case 'c':
+            if (strcmp(optarg, "none") == 0)
+              {
+                compress = TAG_COMP_NONE;
+              }
+            else if (strcmp(optarg, "packbits") == 0)
+              {
+                compress = TAG_COMP_PACKBITS;
+              }
+            else if (strcmp(optarg, "lzw") == 0)
+              {
+                compress = TAG_COMP_LZW;
+              }
+            else
+              {
+                show_usage(argv[0]);
+                return 1;
+              }
+            break;
+
+          case 'n':
+            nframes = atoi(optarg);
+            break;
+
+          case 'r':
+            rate = atoi(optarg);
+            break;
+
+          default:
+            show_usage(argv[0]);
+            return 1;
+        }
+    }
+
+  if (optind != argc - 1 || nframes < 1 || rate < 1)
     {
-      fprintf(stderr, "Usage: screenshot file.tif\n");
+      show_usage(argv[0]);
       return 1;
     }
 
-  return save_screenshot(argv[1]);
+  if (screenshot_open(&ss, compress, nframes > 1) < 0)
+    {
+      return 1;
+    }
+
+  if (nframes > 1)
+    {
+      ret = screenshot_series(&ss, argv[optind], nframes, rate);
+    }
+  else
+    {
+      ret = screenshot_frame(&ss, argv[optind]);
+    }
+
+  screenshot_close(&ss);
+  return ret < 0 ? 1 : 0;
 }
@@ -54,11 +54,40 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tiff_putstrip
+ *
+ * Description:
+ *   Write strip data to tmpfile2, compressing it if compression is enabled.
+ *
+ * Input Parameters:
+ *   info    - A pointer to the caller allocated parameter passing/TIFF state
+ *             instance.
+ *   buffer  - The strip data to write.
+ *   count   - The number of bytes to write.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int tiff_putstrip(FAR struct tiff_info_s *info,
+                         FAR const uint8_t *buffer, size_t count)
+{
+  if (info->encoder != NULL)
+    {
+      return tiff_encoder_write(info, buffer, count);
+    }
+
+  return tiff_write(info->tmp2fd, buffer, count);
+}
+
 /****************************************************************************
  * Name: tiff_addstrip
  *
  * Description:
- *   Convert an RGB565 strip to an RGB888 strip and write it to tmpfile2.
+ *   Convert an RGB565 strip to an RGB888 strip and write it to tmpfile2
+ *   (compressing it if compression is enabled).
  *
  *   Add an image data strip.  The size of the strip in pixels must be equal
  *   to the RowsPerStrip x ImageWidth values that were provided to
@@ -115,7 +144,7 @@ int tiff_convstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
 
       if (nbytes > (info->iosize-3))
         {
-          ret = tiff_write(info->tmp2fd, info->iobuffer, nbytes);
+          ret = tiff_putstrip(info, info->iobuffer, nbytes);
           if (ret < 0)
             {
               return ret;
@@ -130,7 +159,7 @@ int tiff_convstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
 
   /* Flush any buffer data to tmpfile2 */
 
-  ret = tiff_write(info->tmp2fd, info->iobuffer, nbytes);
+  ret = tiff_putstrip(info, info->iobuffer, nbytes);
 #ifdef CONFIG_DEBUG_GRAPHICS
   DEBUGASSERT(ntotal == info->bps);
 #endif
@@ -161,8 +190,14 @@ int tiff_convstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
 int tiff_addstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
 {
   ssize_t newsize;
+  size_t nbytes;
   int ret;
 
+  if (info->encoder != NULL)
+    {
+      tiff_encoder_begin(info);
+    }
+
   /* Add the new strip based on the color format.  For FB_FMT_RGB16_565,
    * will have to perform a conversion to RGB888.
    */
@@ -176,7 +211,7 @@ int tiff_addstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
 
   else
     {
-      ret = tiff_write(info->tmp2fd, strip, info->bps);
+      ret = tiff_putstrip(info, strip, info->bps);
     }
 
   if (ret < 0)
@@ -184,9 +219,24 @@ int tiff_addstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
       goto errout;
     }
 
+  /* Complete the compressed strip to learn its size */
+
+  nbytes = info->bps;
+  if (info->encoder != NULL)
+    {
+      newsize = tiff_encoder_end(info);
+      if (newsize < 0)
+        {
+          ret = (int)newsize;
+          goto errout;
+        }
+
+      nbytes = (size_t)newsize;
+    }
+
   /* Write the byte count to the outfile and the offset to tmpfile1 */
 
-  ret = tiff_putint32(info->outfd, info->bps);
+  ret = tiff_putint32(info->outfd, nbytes);
   if (ret < 0)
     {
       goto errout;
@@ -200,9 +250,13 @@ int tiff_addstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip)
     }
   info->tmp1size += 4;
 
-  /* Increment the size of tmp2file. */
+  /* Remember the strip in case it is repeated, then increment the size of
+   * tmp2file.
+   */
 
-  info->tmp2size += info->bps;
+  info->prevoff   = info->tmp2size;
+  info->prevcount = nbytes;
+  info->tmp2size += nbytes;
 
   /* Pad tmpfile2 as necessary achieve word alignment */
 
@@ -223,3 +277,54 @@ errout:
   tiff_abort(info);
   return ret;
 }
+
+/****************************************************************************
+ * Name: tiff_repeatstrip
+ *
+ * Description:
+ *   Add a strip that is identical to the previous one.  No image data is
+ *   written; the new strip refers to the data of the previous strip.  This
+ *   is much faster than tiff_addstrip() and keeps the file small when an
+ *   image has large uniform areas.
+ *
+ * Input Parameters:
+ *   info    - A pointer to the caller allocated parameter passing/TIFF state
+ *             instance.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tiff_repeatstrip(FAR struct tiff_info_s *info)
+{
+  int ret;
+
+  if (info->nstrips < 1)
+    {
+      return -EINVAL;
+    }
+
+  /* Write the byte count and offset of the previous strip again */
+
+  ret = tiff_putint32(info->outfd, info->prevcount);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+  info->outsize += 4;
+
+  ret = tiff_putint32(info->tmp1fd, info->prevoff);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+  info->tmp1size += 4;
+
+  info->nstrips++;
+  return OK;
+
+errout:
+  tiff_abort(info);
+  return ret;
+}
@@ -0,0 +1,559 @@
+/****************************************************************************
+ * apps/graphics/tiff/tiff_encoder.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include "graphics/tiff.h"
+
+#include "tiff_internal.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tiff_flushout
+ *
+ * Description:
+ *   Write the compressed output buffer to tmpfile2.  Errors are latched in
+ *   errcode and reported when the strip is completed.
+ *
+ ****************************************************************************/
+
+static void tiff_flushout(FAR struct tiff_encoder_s *enc)
+{
+  int ret;
+
+  if (enc->nbuf > 0 && enc->errcode == OK)
+    {
+      ret = tiff_write(enc->fd, enc->outbuf, enc->nbuf);
+      if (ret < 0)
+        {
+          enc->errcode = ret;
+        }
+    }
+
+  enc->nbuf = 0;
+}
+
+/****************************************************************************
+ * Name: tiff_putbyte
+ ****************************************************************************/
+
+static inline void tiff_putbyte(FAR struct tiff_encoder_s *enc,
+                                uint8_t value)
+{
+  enc->outbuf[enc->nbuf++] = value;
+  enc->nout++;
+
+  if (enc->nbuf >= TIFF_ENC_BUFSIZE)
+    {
+      tiff_flushout(enc);
+    }
+}
+
+/****************************************************************************
+ * Name: tiff_pbflushlit
+ *
+ * Description:
+ *   Emit the pending PackBits literal, if any.
+ *
+ ****************************************************************************/
+
+static void tiff_pbflushlit(FAR struct tiff_encoder_s *enc)
+{
+  int i;
+
+  if (enc->nlit > 0)
+    {
+      tiff_putbyte(enc, enc->nlit - 1);
+      for (i = 0; i < enc->nlit; i++)
+        {
+          tiff_putbyte(enc, enc->lit[i]);
+        }
+
+      enc->nlit = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: tiff_pbendrun
+ *
+ * Description:
+ *   Emit the pending PackBits run.  Runs of three or more bytes (or of two
+ *   bytes that do not follow a literal) are encoded as a repeat; shorter
+ *   runs are cheaper as part of a literal.
+ *
+ ****************************************************************************/
+
+static void tiff_pbendrun(FAR struct tiff_encoder_s *enc)
+{
+  int i;
+
+  if (enc->nrun >= 3 || (enc->nrun == 2 && enc->nlit == 0))
+    {
+      tiff_pbflushlit(enc);
+      tiff_putbyte(enc, (uint8_t)(1 - enc->nrun));
+      tiff_putbyte(enc, enc->runbyte);
+    }
+  else
+    {
+      for (i = 0; i < enc->nrun; i++)
+        {
+          enc->lit[enc->nlit++] = enc->runbyte;
+          if (enc->nlit >= TIFF_PACKBITS_MAX)
+            {
+              tiff_pbflushlit(enc);
+            }
+        }
+    }
+
+  enc->nrun = 0;
+}
+
+/****************************************************************************
+ * Name: tiff_pbwrite
+ *
+ * Description:
+ *   PackBits-compress strip data.  As required by TIFF, each row is packed
+ *   separately.
+ *
+ ****************************************************************************/
+
+static void tiff_pbwrite(FAR struct tiff_encoder_s *enc,
+                         FAR const uint8_t *buffer, size_t count)
+{
+  uint8_t value;
+
+  while (count-- > 0)
+    {
+      value = *buffer++;
+
+      if (enc->nrun > 0 && value == enc->runbyte &&
+          enc->nrun < TIFF_PACKBITS_MAX)
+        {
+          enc->nrun++;
+        }
+      else
+        {
+          if (enc->nrun > 0)
+            {
+              tiff_pbendrun(enc);
+            }
+
+          enc->runbyte = value;
+          enc->nrun    = 1;
+        }
+
+      if (--enc->rowleft == 0)
+        {
+          tiff_pbendrun(enc);
+          tiff_pbflushlit(enc);
+          enc->rowleft = enc->rowbytes;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tiff_lzwputcode
+ *
+ * Description:
+ *   Emit one LZW code at the current code width, most significant bit
+ *   first.
+ *
+ ****************************************************************************/
+
+static inline void tiff_lzwputcode(FAR struct tiff_encoder_s *enc,
+                                   unsigned int code)
+{
+  enc->bitbuf  = (enc->bitbuf << enc->nbits) | code;
+  enc->bitcnt += enc->nbits;
+
+  while (enc->bitcnt >= 8)
+    {
+      enc->bitcnt -= 8;
+      tiff_putbyte(enc, (uint8_t)(enc->bitbuf >> enc->bitcnt));
+    }
+}
+
+/****************************************************************************
+ * Name: tiff_lzwreset
+ *
+ * Description:
+ *   Empty the LZW string table by starting a new key generation.
+ *
+ ****************************************************************************/
+
+static void tiff_lzwreset(FAR struct tiff_encoder_s *enc)
+{
+  if (++enc->gen > TIFF_LZW_MAXGEN)
+    {
+      memset(enc->hkey, 0, TIFF_LZW_HSIZE * sizeof(uint32_t));
+      enc->gen = 1;
+    }
+
+  enc->nextcode = TIFF_LZW_FIRST;
+  enc->nbits    = TIFF_LZW_MINBITS;
+  enc->maxcode  = TIFF_LZW_MAXCODE(TIFF_LZW_MINBITS);
+}
+
+/****************************************************************************
+ * Name: tiff_lzwwrite
+ *
+ * Description:
+ *   LZW-compress strip data.  The code stream follows the TIFF 6.0
+ *   conventions (and libtiff):  It begins with a Clear code, code widths
+ *   grow one code early and the table is reset before it overflows.
+ *
+ ****************************************************************************/
+
+static void tiff_lzwwrite(FAR struct tiff_encoder_s *enc,
+                          FAR const uint8_t *buffer, size_t count)
+{
+  uint32_t genbits = (uint32_t)enc->gen << TIFF_LZW_GENSHIFT;
+  uint32_t key;
+  int prefix = enc->prefix;
+  int disp;
+  int h;
+  uint8_t value;
+
+  if (prefix < 0 && count > 0)
+    {
+      tiff_lzwputcode(enc, TIFF_LZW_CLEAR);
+      prefix = *buffer++;
+      count--;
+    }
+
+  while (count-- > 0)
+    {
+      value = *buffer++;
+      key   = genbits | ((uint32_t)prefix << 8) | value;
+      h     = ((int)value << 4) ^ prefix;
+
+      /* Look for the string prefix + value in the table */
+
+      if (enc->hkey[h] == key)
+        {
+          prefix = enc->hcode[h];
+          continue;
+        }
+
+      if ((enc->hkey[h] >> TIFF_LZW_GENSHIFT) == enc->gen)
+        {
+          disp = (h == 0) ? 1 : TIFF_LZW_HSIZE - h;
+          do
+            {
+              h -= disp;
+              if (h < 0)
+                {
+                  h += TIFF_LZW_HSIZE;
+                }
+            }
+          while (enc->hkey[h] != key &&
+                 (enc->hkey[h] >> TIFF_LZW_GENSHIFT) == enc->gen);
+
+          if (enc->hkey[h] == key)
+            {
+              prefix = enc->hcode[h];
+              continue;
+            }
+        }
+
+      /* Not found.  Emit the prefix and add the new string in the free
+       * slot.
+       */
+
+      tiff_lzwputcode(enc, prefix);
+      prefix         = value;
+      enc->hkey[h]   = key;
+      enc->hcode[h]  = enc->nextcode++;
+
+      if (enc->nextcode == TIFF_LZW_MAXCODE(TIFF_LZW_MAXBITS) - 1)
+        {
+          tiff_lzwputcode(enc, TIFF_LZW_CLEAR);
+          tiff_lzwreset(enc);
+          genbits = (uint32_t)enc->gen << TIFF_LZW_GENSHIFT;
+        }
+      else if (enc->nextcode > enc->maxcode)
+        {
+          enc->nbits++;
+          enc->maxcode = TIFF_LZW_MAXCODE(enc->nbits);
+        }
+    }
+
+  enc->prefix = prefix;
+}
+
+/****************************************************************************
+ * Name: tiff_lzwend
+ *
+ * Description:
+ *   Emit the final string and the end of information code.  The decoder
+ *   adds one more table entry after reading the final string, so the code
+ *   width may have to change before the end of information code.
+ *
+ ****************************************************************************/
+
+static void tiff_lzwend(FAR struct tiff_encoder_s *enc)
+{
+  if (enc->prefix >= 0)
+    {
+      tiff_lzwputcode(enc, enc->prefix);
+      enc->prefix = -1;
+
+      if (++enc->nextcode == TIFF_LZW_MAXCODE(TIFF_LZW_MAXBITS) - 1)
+        {
+          tiff_lzwputcode(enc, TIFF_LZW_CLEAR);
+          enc->nbits = TIFF_LZW_MINBITS;
+        }
+      else if (enc->nextcode > enc->maxcode)
+        {
+          enc->nbits++;
+        }
+    }
+
+  tiff_lzwputcode(enc, TIFF_LZW_EOI);
+
+  if (enc->bitcnt > 0)
+    {
+      tiff_putbyte(enc, (uint8_t)(enc->bitbuf << (8 - enc->bitcnt)));
+      enc->bitcnt = 0;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tiff_encoder_initialize
+ *
+ * Description:
+ *   Allocate the strip compression state selected by info->compress.
+ *   Nothing is allocated for uncompressed images.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tiff_encoder_initialize(FAR struct tiff_info_s *info)
+{
+  FAR struct tiff_encoder_s *enc;
+  size_t size;
+
+  DEBUGASSERT(info->encoder == NULL);
+
+  if (info->compress == 0)
+    {
+      info->compress = TAG_COMP_NONE;
+    }
+
+  if (info->compress == TAG_COMP_NONE)
+    {
+      return OK;
+    }
+
+  size = sizeof(struct tiff_encoder_s);
+  if (info->compress == TAG_COMP_LZW)
+    {
+      size += TIFF_LZW_HSIZE * (sizeof(uint32_t) + sizeof(uint16_t));
+    }
+  else if (info->compress != TAG_COMP_PACKBITS)
+    {
+      gerr("ERROR: Unsupported compression: %u\n", info->compress);
+      return -EINVAL;
+    }
+
+  enc = (FAR struct tiff_encoder_s *)zalloc(size);
+  if (enc == NULL)
+    {
+      gerr("ERROR: Failed to allocate the encoder\n");
+      return -ENOMEM;
+    }
+
+  enc->compress = info->compress;
+  enc->fd       = info->tmp2fd;
+  enc->prefix   = -1;
+
+  /* PackBits packs each row separately.  The strip size of the sub-byte
+   * formats is not always a whole number of rows; pack the whole strip as
+   * one row then.
+   */
+
+  enc->rowbytes = info->bps;
+  if (info->rps > 0 && info->bps % info->rps == 0)
+    {
+      enc->rowbytes = info->bps / info->rps;
+    }
+
+  if (info->compress == TAG_COMP_LZW)
+    {
+      enc->hkey  = (FAR uint32_t *)(enc + 1);
+      enc->hcode = (FAR uint16_t *)(enc->hkey + TIFF_LZW_HSIZE);
+    }
+
+  info->encoder = enc;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: tiff_encoder_release
+ *
+ * Description:
+ *   Free the strip compression state, if any.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tiff_encoder_release(FAR struct tiff_info_s *info)
+{
+  free(info->encoder);
+  info->encoder = NULL;
+}
+
+/****************************************************************************
+ * Name: tiff_encoder_begin
+ *
+ * Description:
+ *   Prepare to compress a new strip.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tiff_encoder_begin(FAR struct tiff_info_s *info)
+{
+  FAR struct tiff_encoder_s *enc = info->encoder;
+
+  enc->errcode = OK;
+  enc->nout    = 0;
+  enc->nbuf    = 0;
+
+  if (enc->compress == TAG_COMP_LZW)
+    {
+      enc->prefix = -1;
+      enc->bitcnt = 0;
+      enc->bitbuf = 0;
+      tiff_lzwreset(enc);
+    }
+  else
+    {
+      enc->rowleft = enc->rowbytes;
+      enc->nrun    = 0;
+      enc->nlit    = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: tiff_encoder_write
+ *
+ * Description:
+ *   Compress strip data and write the result to tmpfile2.  The strip may be
+ *   passed in any number of pieces.
+ *
+ * Input Parameters:
+ *   info   - A pointer to the caller allocated parameter passing/TIFF state
+ *            instance.
+ *   buffer - The uncompressed strip data
+ *   count  - The number of bytes in buffer
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tiff_encoder_write(FAR struct tiff_info_s *info,
+                       FAR const uint8_t *buffer, size_t count)
+{
+  FAR struct tiff_encoder_s *enc = info->encoder;
+
+  if (enc->compress == TAG_COMP_LZW)
+    {
+      tiff_lzwwrite(enc, buffer, count);
+    }
+  else
+    {
+      tiff_pbwrite(enc, buffer, count);
+    }
+
+  return enc->errcode;
+}
+
+/****************************************************************************
+ * Name: tiff_encoder_end
+ *
+ * Description:
+ *   Finish the current strip, flushing all compressed data to tmpfile2.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   The compressed size of the strip on success.  A negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t tiff_encoder_end(FAR struct tiff_info_s *info)
+{
+  FAR struct tiff_encoder_s *enc = info->encoder;
+
+  if (enc->compress == TAG_COMP_LZW)
+    {
+      tiff_lzwend(enc);
+    }
+  else
+    {
+      tiff_pbendrun(enc);
+      tiff_pbflushlit(enc);
+    }
+
+  tiff_flushout(enc);
+  return enc->errcode < 0 ? (ssize_t)enc->errcode : (ssize_t)enc->nout;
+}
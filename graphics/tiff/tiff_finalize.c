@@ -167,6 +167,10 @@ static void tiff_cleanup(FAR struct tiff_info_s *info)
 
   info->tmp2fd = -1;
 
+  /* Free the compression state */
+
+  tiff_encoder_release(info);
+
   /* And remove the temporary files */
 
   unlink(info->tmpfile1);
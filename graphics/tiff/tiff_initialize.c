@@ -52,7 +52,7 @@
  *           12    NewSubfileType
  *           24    ImageWidth                  Number of columns is a user parameter
  *           36    ImageLength                 Number of rows is a user parameter
- *           48    Compression                 Hard-coded no compression (for now)
+ *           48    Compression                 Value is a user parameter
  *           60    PhotometricInterpretation   Value is a user parameter
  *           72    StripOffsets                Offset and count determined as strips added
  *           84    RowsPerStrip                Value is a user parameter
@@ -105,7 +105,7 @@
  *           24    ImageWidth                  Number of columns is a user parameter
  *           36    ImageLength                 Number of rows is a user parameter
  *           48    BitsPerSample
- *           60    Compression                 Hard-coded no compression (for now)
+ *           60    Compression                 Value is a user parameter
  *           72    PhotometricInterpretation   Value is a user parameter
  *           84    StripOffsets                Offset and count determined as strips added
  *           96    RowsPerStrip                Value is a user parameter
@@ -151,7 +151,7 @@
  *           24    ImageWidth                  Number of columns is a user parameter
  *           36    ImageLength                 Number of rows is a user parameter
  *           48    BitsPerSample               8, 8, 8
- *           60    Compression                 Hard-coded no compression (for now)
+ *           60    Compression                 Value is a user parameter
  *           72    PhotometricInterpretation   Value is a user parameter
  *           84    StripOffsets                Offset and count determined as strips added
  *           96    SamplesPerPixel             Hard-coded to 3
@@ -513,6 +513,14 @@ int tiff_initialize(FAR struct tiff_info_s *info)
         return -EINVAL;
     }
 
+  /* Set up strip compression */
+
+  ret = tiff_encoder_initialize(info);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
   /* Write the TIFF header data to the outfile:
    *
    * Header:    0    Byte Order                  "II" or "MM"
@@ -608,12 +616,13 @@ int tiff_initialize(FAR struct tiff_info_s *info)
 
   /* Write Compression:
    *
-   * Bi-level Images: Offset 48 Hard-coded no compression (for now)
-   * Greyscale:       Offset 60  "  " "   " "" "          " " " " "
-   * RGB:             Offset 60 "  " "   " "" "          " " " " "
+   * Bi-level Images: Offset 48 Value is a user parameter
+   * Greyscale:       Offset 60 Value is a user parameter
+   * RGB:             Offset 60 Value is a user parameter
    */
 
-  ret = tiff_putifdentry16(info, IFD_TAG_COMPRESSION, IFD_FIELD_SHORT, 1, TAG_COMP_NONE);
+  ret = tiff_putifdentry16(info, IFD_TAG_COMPRESSION, IFD_FIELD_SHORT, 1,
+                           info->compress);
   if (ret < 0)
     {
       goto errout;
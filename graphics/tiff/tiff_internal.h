@@ -64,10 +64,66 @@
 #define IMGFLAGS_ISRGB(f) \
   (((f) & IMGFLAGS_FMT_RGB24) != 0)
 
+/* Strip Compression ********************************************************/
+
+#define TIFF_ENC_BUFSIZE       256  /* Compressed output buffer size */
+#define TIFF_PACKBITS_MAX      128  /* Longest PackBits run or literal */
+
+#define TIFF_LZW_HSIZE        5003  /* String table hash size (prime) */
+#define TIFF_LZW_MINBITS         9  /* Initial code width */
+#define TIFF_LZW_MAXBITS        12  /* Maximum code width */
+#define TIFF_LZW_CLEAR         256  /* Clear code */
+#define TIFF_LZW_EOI           257  /* End of information code */
+#define TIFF_LZW_FIRST         258  /* First string table code */
+#define TIFF_LZW_MAXCODE(n)    ((1 << (n)) - 1)
+
+/* Each hash key holds the string prefix code and the appended byte in its
+ * lower 20 bits and a table generation number above them.  Starting a new
+ * generation empties the string table without having to clear it.
+ */
+
+#define TIFF_LZW_GENSHIFT       20
+#define TIFF_LZW_MAXGEN       4095
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
 
+/* Strip compression state.  Compressed data is collected in outbuf and
+ * written to tmpfile2 whenever the buffer fills.
+ */
+
+struct tiff_encoder_s
+{
+  uint16_t compress;                 /* TAG_COMP_PACKBITS or TAG_COMP_LZW */
+  int      fd;                       /* tmpfile2 file descriptor */
+  int      errcode;                  /* First write error in this strip */
+  size_t   nout;                     /* Compressed bytes in this strip */
+  uint16_t nbuf;                     /* Bytes held in outbuf */
+  uint8_t  outbuf[TIFF_ENC_BUFSIZE]; /* Compressed output buffer */
+
+  /* PackBits.  Runs and literals never cross a row boundary. */
+
+  size_t   rowbytes;                 /* Bytes per image row */
+  size_t   rowleft;                  /* Bytes left in the current row */
+  uint8_t  runbyte;                  /* Value of the pending run */
+  uint8_t  nrun;                     /* Length of the pending run */
+  uint8_t  nlit;                     /* Length of the pending literal */
+  uint8_t  lit[TIFF_PACKBITS_MAX];   /* Pending literal bytes */
+
+  /* LZW */
+
+  int      prefix;                   /* Code of the current string or -1 */
+  uint16_t nextcode;                 /* Next free string table code */
+  uint16_t maxcode;                  /* Largest code at the current width */
+  uint16_t gen;                      /* Generation of the valid hash keys */
+  uint8_t  nbits;                    /* Current code width */
+  uint8_t  bitcnt;                   /* Bits held in bitbuf */
+  uint32_t bitbuf;                   /* Pending output bits */
+  FAR uint32_t *hkey;                /* Hash keys: gen|prefix|byte */
+  FAR uint16_t *hcode;               /* Code of each hash entry */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -191,6 +247,97 @@ int tiff_putstring(int fd, FAR const char *string, int len);
 
 ssize_t tiff_wordalign(int fd, size_t size);
 
+/****************************************************************************
+ * Name: tiff_encoder_initialize
+ *
+ * Description:
+ *   Allocate the strip compression state selected by info->compress.
+ *   Nothing is allocated for uncompressed images.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tiff_encoder_initialize(FAR struct tiff_info_s *info);
+
+/****************************************************************************
+ * Name: tiff_encoder_release
+ *
+ * Description:
+ *   Free the strip compression state, if any.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tiff_encoder_release(FAR struct tiff_info_s *info);
+
+/****************************************************************************
+ * Name: tiff_encoder_begin
+ *
+ * Description:
+ *   Prepare to compress a new strip.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void tiff_encoder_begin(FAR struct tiff_info_s *info);
+
+/****************************************************************************
+ * Name: tiff_encoder_write
+ *
+ * Description:
+ *   Compress strip data and write the result to tmpfile2.  The strip may be
+ *   passed in any number of pieces.
+ *
+ * Input Parameters:
+ *   info   - A pointer to the caller allocated parameter passing/TIFF state
+ *            instance.
+ *   buffer - The uncompressed strip data
+ *   count  - The number of bytes in buffer
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tiff_encoder_write(FAR struct tiff_info_s *info,
+                       FAR const uint8_t *buffer, size_t count);
+
+/****************************************************************************
+ * Name: tiff_encoder_end
+ *
+ * Description:
+ *   Finish the current strip, flushing all compressed data to tmpfile2.
+ *
+ * Input Parameters:
+ *   info - A pointer to the caller allocated parameter passing/TIFF state
+ *          instance.
+ *
+ * Returned Value:
+ *   The compressed size of the strip on success.  A negated errno value on
+ *   failure.
+ *
+ ****************************************************************************/
+
+ssize_t tiff_encoder_end(FAR struct tiff_info_s *info);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -54,6 +54,25 @@ typedef struct fmsynth_sound_s
   FAR struct fmsynth_sound_s *next_sound;
 } fmsynth_sound_t;
 
+/* One voice of a polyphonic voice pool.  The operators of the sound are
+ * set up by the user; the other fields are managed by the pool.
+ */
+
+typedef struct fmsynth_voice_s
+{
+  fmsynth_sound_t sound;
+  int note;      /* Note being played, -1 when idle or released */
+  int active;    /* Non-zero while the voice is sounding */
+  uint32_t age;  /* Note on order, for voice stealing */
+} fmsynth_voice_t;
+
+typedef struct fmsynth_voicepool_s
+{
+  FAR fmsynth_voice_t *voices;
+  int nvoices;
+  uint32_t age;
+} fmsynth_voicepool_t;
+
 typedef CODE void (*fmsynth_tickcb_t)(unsigned long cbarg);
 
 /****************************************************************************
@@ -79,6 +98,15 @@ int fmsynth_rendering(FAR fmsynth_sound_t *snd,
                       FAR int16_t *sample, int sample_num, int chnum,
                       fmsynth_tickcb_t cb, unsigned long cbarg);
 
+int fmsynth_voicepool_initialize(FAR fmsynth_voicepool_t *pool,
+                                 FAR fmsynth_voice_t *voices, int nvoices);
+FAR fmsynth_voice_t *fmsynth_voice_noteon(FAR fmsynth_voicepool_t *pool,
+                                          int note, float freq, float vol);
+void fmsynth_voice_noteoff(FAR fmsynth_voicepool_t *pool, int note);
+int fmsynth_voicepool_rendering(FAR fmsynth_voicepool_t *pool,
+                                FAR int16_t *sample, int sample_num,
+                                int chnum);
+
 #ifdef __cplusplus
 }
 #endif
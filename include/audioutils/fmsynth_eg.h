@@ -95,6 +95,8 @@ int fmsyntheg_set_param(FAR fmsynth_eg_t *eg,
 void fmsyntheg_start(FAR fmsynth_eg_t *eg);
 void fmsyntheg_stop(FAR fmsynth_eg_t *eg);
 int fmsyntheg_operate(FAR fmsynth_eg_t *eg);
+void fmsyntheg_operate_block(FAR fmsynth_eg_t *eg, FAR int *out,
+                             int nsamples);
 
 #ifdef __cplusplus
 }
@@ -27,6 +27,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdint.h>
+
 #include <audioutils/fmsynth_eg.h>
 
 /****************************************************************************
@@ -35,6 +37,20 @@
 
 #define FMSYNTH_PI (0x10000)
 
+/* Phase accumulators are Q15 fixed point in units of the FMSYNTH_PI scale,
+ * so that a full 2 * FMSYNTH_PI turn wraps a 32-bit accumulator exactly.
+ */
+
+#define FMSYNTH_PHASE_FRACBITS (15)
+
+/* Number of samples rendered per block */
+
+#ifdef CONFIG_AUDIOUTILS_FMSYNTH_BLOCKSIZE
+#  define FMSYNTH_BLOCKSIZE CONFIG_AUDIOUTILS_FMSYNTH_BLOCKSIZE
+#else
+#  define FMSYNTH_BLOCKSIZE (32)
+#endif
+
 #define FMSYNTH_OPFUNC_SIN      (0)
 #define FMSYNTH_OPFUNC_TRIANGLE (1)
 #define FMSYNTH_OPFUNC_SAWTOOTH (2)
@@ -62,8 +78,8 @@ typedef struct fmsynth_op_s
 
   float freq_rate;
   float sound_freq;
-  float delta_phase;
-  float current_phase;
+  uint32_t delta_phase;   /* Q15, see FMSYNTH_PHASE_FRACBITS */
+  uint32_t current_phase; /* Q15, see FMSYNTH_PHASE_FRACBITS */
 } fmsynth_op_t;
 
 /****************************************************************************
@@ -96,6 +112,8 @@ void fmsynthop_set_soundfreqrate(FAR fmsynth_op_t *op, float rate);
 void fmsynthop_start(FAR fmsynth_op_t *op);
 void fmsynthop_stop(FAR fmsynth_op_t *op);
 int fmsynthop_operate(FAR fmsynth_op_t *op, int phase_time);
+int fmsynthop_operate_block(FAR fmsynth_op_t *op, int phase_time,
+                            FAR int *out, int nsamples);
 
 #ifdef __cplusplus
 }
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <mqueue.h>
 #include <nuttx/audio/audio.h>
 
@@ -35,6 +36,8 @@
  * Public Data Types
  ****************************************************************************/
 
+struct nxaudio_render_s;
+
 struct nxaudio_s
 {
   int fd;
@@ -44,6 +47,30 @@ struct nxaudio_s
   mqd_t mq;
 
   int chnum;
+  int fs;
+  int bps;
+
+  FAR struct nxaudio_render_s *render;  /* State of nxaudio_render_start() */
+};
+
+/* Render callback of the pull model.  It is called on the render thread
+ * whenever a buffer is free and must write up to nframes frames of
+ * interleaved samples to buf.  It returns the number of frames written;
+ * fewer than nframes ends the stream once they have been played and a
+ * negative value stops playback at once.
+ */
+
+typedef CODE int (*nxaudio_render_t)(unsigned long arg, FAR void *buf,
+                                     int nframes);
+
+struct nxaudio_stats_s
+{
+  int      nbuffers;       /* Buffers currently kept queued */
+  int      nframes;        /* Frames per buffer */
+  uint32_t latency_us;     /* Enqueue to dequeue time of the last buffer */
+  uint32_t maxlatency_us;  /* Worst enqueue to dequeue time */
+  uint32_t maxrender_us;   /* Worst time spent in the render callback */
+  uint32_t xruns;          /* Times the driver ran out of buffers */
 };
 
 struct nxaudio_callbacks_s
@@ -78,6 +105,12 @@ int nxaudio_start(FAR struct nxaudio_s *nxaudio);
 int nxaudio_msgloop(FAR struct nxaudio_s *nxaudio,
                     FAR struct nxaudio_callbacks_s *cbs, unsigned long arg);
 int nxaudio_stop(FAR struct nxaudio_s *nxaudio);
+int nxaudio_render_start(FAR struct nxaudio_s *nxaudio,
+                         uint32_t latency_us, nxaudio_render_t render,
+                         unsigned long arg);
+int nxaudio_render_stop(FAR struct nxaudio_s *nxaudio);
+int nxaudio_getstats(FAR struct nxaudio_s *nxaudio,
+                     FAR struct nxaudio_stats_s *stats);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,150 @@
+/****************************************************************************
+ * apps/include/graphics/nxwidgets/cdamageregion.hxx
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CDAMAGEREGION_HXX
+#define __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CDAMAGEREGION_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  /**
+   * CDamageRegion accumulates invalidated rectangles into a small, fixed
+   * number of rectangles.  Rectangles are merged whenever their bounding
+   * box covers no more pixels than the two rectangles themselves (one
+   * contains the other, they overlap heavily or they share an edge); when
+   * the list is full, the two rectangles whose union wastes the least area
+   * are merged.  The region may therefore cover somewhat more than the
+   * exact union of the added rectangles, but never less.
+   */
+
+  class CDamageRegion
+  {
+  private:
+    struct nxgl_rect_s m_rects[CONFIG_NXWIDGETS_DAMAGE_NRECTS]; /**< Rectangles */
+    uint8_t            m_nRects;                                /**< Number in use */
+
+    /**
+     * Remove the rectangle at the given index.
+     */
+
+    void remove(int index);
+
+    /**
+     * Merge rectangles that are better represented by their union until
+     * no such pair remains.
+     */
+
+    void coalesce(void);
+
+  public:
+
+    /**
+     * Constructor.  The region is initially empty.
+     */
+
+    inline CDamageRegion(void)
+    {
+      m_nRects = 0;
+    }
+
+    /**
+     * Add a rectangle to the region.
+     *
+     * @param rect The rectangle to add.  Empty rectangles are ignored.
+     */
+
+    void add(FAR const struct nxgl_rect_s *rect);
+
+    /**
+     * Check if a rectangle overlaps the region.
+     *
+     * @param rect The rectangle to check.
+     * @return True if any part of the rectangle is in the region.
+     */
+
+    bool intersects(FAR const struct nxgl_rect_s *rect) const;
+
+    /**
+     * Empty the region.
+     */
+
+    inline void clear(void)
+    {
+      m_nRects = 0;
+    }
+
+    /**
+     * Check if the region is empty.
+     */
+
+    inline bool isEmpty(void) const
+    {
+      return m_nRects == 0;
+    }
+
+    /**
+     * Get the number of rectangles making up the region.
+     */
+
+    inline int getRectCount(void) const
+    {
+      return m_nRects;
+    }
+
+    /**
+     * Get one of the rectangles making up the region.
+     *
+     * @param index The index of the rectangle, less than getRectCount().
+     */
+
+    inline FAR const struct nxgl_rect_s *getRect(int index) const
+    {
+      return &m_rects[index];
+    }
+  };
+}
+
+#endif // __cplusplus
+
+#endif // __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CDAMAGEREGION_HXX
@@ -0,0 +1,233 @@
+/****************************************************************************
+ * apps/include/graphics/nxwidgets/cglyphcache.hxx
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CGLYPHCACHE_HXX
+#define __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CGLYPHCACHE_HXX
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/nx/nxglib.h>
+#include <nuttx/nx/nxfonts.h>
+
+#include "graphics/nxwidgets/nxconfig.hxx"
+
+/****************************************************************************
+ * Pre-Processor Definitions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Implementation Classes
+ ****************************************************************************/
+
+#if defined(__cplusplus)
+
+namespace NXWidgets
+{
+  class CNxFont;
+
+  /**
+   * One pre-rendered glyph.  The bitmap is width x height pixels with
+   * the given stride and is fully opaque:  The glyph has already been
+   * rendered over the background color it was cached with.
+   *
+   * A mask entry instead holds the one bit per pixel coverage of the
+   * inked part of the glyph, width x height pixels at metrics.xoffset and
+   * metrics.yoffset within the character cell, most significant bit
+   * first.  It does not depend on any color and is used to draw text
+   * transparently.
+   */
+
+  struct SCachedGlyph
+  {
+    nxwidget_char_t        letter;     /**< The character */
+    nxgl_mxpixel_t         color;      /**< Font color used to render */
+    nxgl_mxpixel_t         background; /**< Background color used to render */
+    bool                   mask;       /**< Coverage mask, not a bitmap */
+    struct nx_fontmetric_s metrics;    /**< Font metrics of the character */
+    nxgl_coord_t           width;      /**< Bitmap width in pixels */
+    nxgl_coord_t           height;     /**< Bitmap height in rows */
+    unsigned int           stride;     /**< Bitmap row length in bytes */
+    FAR uint8_t           *data;       /**< Rendered bitmap memory */
+    uint16_t               hashNext;   /**< Next entry in the hash chain */
+    uint16_t               lruPrev;    /**< More recently used entry */
+    uint16_t               lruNext;    /**< Less recently used entry */
+  };
+
+  /**
+   * CGlyphCache holds a fixed number of rendered glyphs of one font in
+   * least-recently-used order.  Entries are looked up by character, font
+   * color and background color so that the same font may be drawn with
+   * several color combinations without thrashing.  All memory is
+   * allocated once, when the cache is created.
+   */
+
+  class CGlyphCache
+  {
+  private:
+    CNxFont                *m_pFont;      /**< The font being cached */
+    FAR struct SCachedGlyph *m_entries;   /**< Array of cache entries */
+    FAR uint16_t           *m_buckets;    /**< Hash bucket heads */
+    FAR uint8_t            *m_pool;       /**< Bitmap memory for all entries */
+    uint16_t                m_nEntries;   /**< Number of cache entries */
+    uint16_t                m_nUsed;      /**< Number of entries in use */
+    uint16_t                m_bucketMask; /**< Number of buckets - 1 */
+    uint16_t                m_lruHead;    /**< Most recently used entry */
+    uint16_t                m_lruTail;    /**< Least recently used entry */
+    unsigned int            m_glyphSize;  /**< Bitmap bytes per entry */
+
+    /**
+     * Hash a cache key into a bucket index.
+     */
+
+    inline unsigned int hash(nxwidget_char_t letter, nxgl_mxpixel_t color,
+                             nxgl_mxpixel_t background, bool mask) const
+    {
+      uint32_t h = (uint32_t)letter * 0x9e3779b1u;
+      h ^= (uint32_t)color + 0x7f4a7c15u + (h << 6) + (h >> 2);
+      h ^= (uint32_t)background + 0x7f4a7c15u + (h << 6) + (h >> 2);
+      h ^= mask ? 0x5bd1e995u : 0;
+      return h & m_bucketMask;
+    }
+
+    /**
+     * Remove an entry from the LRU list.
+     */
+
+    void lruUnlink(uint16_t index);
+
+    /**
+     * Insert an entry at the most-recently-used end of the LRU list.
+     */
+
+    void lruPushFront(uint16_t index);
+
+    /**
+     * Remove an entry from its hash chain.
+     */
+
+    void hashUnlink(uint16_t index);
+
+    /**
+     * Render a glyph into a cache entry.
+     */
+
+    void render(FAR struct SCachedGlyph *entry);
+
+    /**
+     * Copy the coverage mask of a glyph into a cache entry.
+     */
+
+    void renderMask(FAR struct SCachedGlyph *entry);
+
+    /**
+     * Find an entry, filling the least recently used one on a miss.
+     */
+
+    FAR const struct SCachedGlyph *lookup(nxwidget_char_t letter,
+                                          nxgl_mxpixel_t color,
+                                          nxgl_mxpixel_t background,
+                                          bool mask);
+
+    /**
+     * Copy constructor is private to prevent usage.
+     */
+
+    inline CGlyphCache(const CGlyphCache &cache) { }
+
+  public:
+
+    /**
+     * Constructor.
+     *
+     * @param font The font whose glyphs are cached.  The font must outlive
+     *   the cache.
+     * @param entries The number of glyphs to cache.
+     */
+
+    CGlyphCache(CNxFont *font, unsigned int entries);
+
+    /**
+     * Destructor.
+     */
+
+    ~CGlyphCache(void);
+
+    /**
+     * Return true if the cache memory was successfully allocated.
+     */
+
+    inline bool isValid(void) const
+    {
+      return m_pool != (FAR uint8_t *)0;
+    }
+
+    /**
+     * Get a rendered glyph, rendering it into the least recently used
+     * entry if it is not already cached.  The returned entry is valid
+     * until the next call to getGlyph() or flush().
+     *
+     * @param letter The character to get.
+     * @param color The font color to render with.
+     * @param background The opaque background color.
+     * @return The cached glyph or NULL if the cache is not valid.
+     */
+
+    inline FAR const struct SCachedGlyph *
+    getGlyph(nxwidget_char_t letter, nxgl_mxpixel_t color,
+             nxgl_mxpixel_t background)
+    {
+      return lookup(letter, color, background, false);
+    }
+
+    /**
+     * Get the coverage mask of a glyph, copying it into the least
+     * recently used entry if it is not already cached.  The returned
+     * entry is valid until the next call to getGlyph(), getMask() or
+     * flush().
+     *
+     * @param letter The character to get.
+     * @return The cached mask or NULL if the cache is not valid.
+     */
+
+    inline FAR const struct SCachedGlyph *getMask(nxwidget_char_t letter)
+    {
+      return lookup(letter, 0, 0, true);
+    }
+
+    /**
+     * Discard all cached glyphs.
+     */
+
+    void flush(void);
+  };
+}
+
+#endif // __cplusplus
+
+#endif // __APPS_INCLUDE_GRAPHICS_NXWIDGETS_CGLYPHCACHE_HXX
@@ -99,6 +99,58 @@ namespace NXWidgets
 #ifdef CONFIG_NX_WRITEONLY
     nxgl_mxpixel_t m_backColor;  /**< The background color to use */
 #endif
+    FAR uint8_t   *m_glyph;      /**< Scratch memory for rendering glyphs */
+    unsigned int   m_glyphSize;  /**< Size of the scratch memory in bytes */
+    struct nxgl_rect_s m_clip;   /**< Window-relative clipping rectangle */
+    bool           m_clipped;    /**< True: Drawing is limited to m_clip */
+
+    /**
+     * Return scratch memory of at least the requested size for rendering
+     * glyphs.  The memory is retained across calls.
+     *
+     * @param size The number of bytes required.
+     * @return The scratch memory or NULL if it could not be allocated.
+     */
+
+    FAR uint8_t *getGlyphBuffer(unsigned int size);
+
+    /**
+     * Fill a rectangle of the window, limited to the clipping rectangle.
+     *
+     * @param rect The window-relative rectangle to fill.
+     * @param color The fill color.
+     * @return True if successful or if nothing was left to fill.
+     */
+
+    bool fillClipped(FAR const struct nxgl_rect_s *rect,
+                     nxgl_mxpixel_t color);
+
+    /**
+     * Copy a bitmap to the window, limited to the clipping rectangle.
+     *
+     * @param dest The window-relative rectangle that receives the bitmap.
+     * @param src The bitmap memory.
+     * @param origin The window-relative position of the upper left corner
+     *   of the full bitmap.
+     * @param stride The width of a bitmap row in bytes.
+     * @return True if successful or if nothing was left to copy.
+     */
+
+    bool bitmapClipped(FAR const struct nxgl_rect_s *dest,
+                       FAR const void *src,
+                       FAR const struct nxgl_point_s *origin,
+                       unsigned int stride);
+
+    /**
+     * Move a rectangle of the window, limited to the clipping rectangle at
+     * the destination.
+     *
+     * @param rect The window-relative rectangle to move.
+     * @param offset The distance to move it by.
+     */
+
+    void moveClipped(FAR const struct nxgl_rect_s *rect,
+                     FAR const struct nxgl_point_s *offset);
 
     /**
      * The underlying implementation for drawText functions
@@ -157,6 +209,22 @@ namespace NXWidgets
 
     const nxgl_coord_t getY(void) const;
 
+    /**
+     * Limit all drawing to a rectangle of the window.
+     *
+     * @param rect The window-relative clipping rectangle, or NULL to draw
+     *   anywhere in the window again.
+     */
+
+    inline void setClipRect(FAR const struct nxgl_rect_s *rect)
+    {
+      m_clipped = rect != NULL;
+      if (m_clipped)
+        {
+          m_clip = *rect;
+        }
+    }
+
     /**
      * Get the background color that will be used to fill in the spaces
      * when rendering fonts.  This background color is ONLY used if the
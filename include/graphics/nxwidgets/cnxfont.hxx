@@ -50,7 +50,9 @@
 namespace NXWidgets
 {
   class CNxString;
+  class CGlyphCache;
   struct SBitmap;
+  struct SCachedGlyph;
 
   /**
    * Class defining the properties of one font.
@@ -64,6 +66,26 @@ namespace NXWidgets
     FAR const struct nx_font_s *m_pFontSet; /** < The font set metrics */
     nxgl_mxpixel_t m_fontColor;             /**< Color to draw the font with when rendering. */
     nxgl_mxpixel_t m_transparentColor;      /**< Background color that should not be rendered. */
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+    CGlyphCache *m_pGlyphCache;             /**< Rendered glyphs, created on first use */
+#endif
+
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+    /**
+     * Get the glyph cache, creating it on first use.
+     *
+     * @return The cache or NULL if it could not be allocated.
+     */
+
+    CGlyphCache *getGlyphCache(void);
+#endif
+
+    /**
+     * Copy constructor is private to prevent usage.  Each font owns its
+     * glyph cache.
+     */
+
+    inline CNxFont(const CNxFont &font) { }
 
   public:
 
@@ -83,7 +105,7 @@ namespace NXWidgets
      * CNxFont Destructor.
      */
 
-    ~CNxFont() { }
+    ~CNxFont(void);
 
     /**
      * Checks if supplied character is blank in the current font.
@@ -147,6 +169,45 @@ namespace NXWidgets
 
     void drawChar(FAR SBitmap *bitmap, nxwidget_char_t letter);
 
+    /**
+     * Get the monochrome font bitmap of a character.
+     *
+     * @param letter The character to get.
+     * @return The font bitmap or NULL if the character is blank.
+     */
+
+    inline FAR const struct nx_fontbitmap_s *
+    getFontBitmap(nxwidget_char_t letter) const
+    {
+      return nxf_getbitmap(m_fontHandle, letter);
+    }
+
+#if CONFIG_NXWIDGETS_GLYPHCACHE_SIZE > 0
+    /**
+     * Get a glyph rendered in the current font color over an opaque
+     * background from the font's glyph cache.  The returned glyph is valid
+     * until the next call to this method.
+     *
+     * @param letter The character to get.
+     * @param background The background color to render over.
+     * @return The cached glyph or NULL if no cache could be allocated.
+     */
+
+    FAR const struct SCachedGlyph *getCachedGlyph(nxwidget_char_t letter,
+                                                  nxgl_mxpixel_t background);
+
+    /**
+     * Get the coverage mask of a glyph, for drawing it transparently,
+     * from the font's glyph cache.  The returned mask is valid until the
+     * next call to this method or to getCachedGlyph().
+     *
+     * @param letter The character to get.
+     * @return The cached mask or NULL if no cache could be allocated.
+     */
+
+    FAR const struct SCachedGlyph *getCachedMask(nxwidget_char_t letter);
+#endif
+
     /**
      * Get the width of a string in pixels when drawn with this font.
      *
@@ -1007,6 +1007,16 @@ namespace NXWidgets
 
     void redraw(void);
 
+    /**
+     * Draws the part of the widget, but not of its children, that lies
+     * within a rectangle.  Used by CWidgetControl::flushRedraw(), which
+     * visits the children itself.
+     *
+     * @param clip The window-relative rectangle to draw.
+     */
+
+    void redrawClipped(FAR const struct nxgl_rect_s *clip);
+
     /**
      * Enables the widget.
      *
@@ -1312,6 +1322,18 @@ namespace NXWidgets
 
     const CNxWidget *getChild(int index) const;
 
+    /**
+     * Get the child widget at the specified index.
+     *
+     * @param index Index of the child to retrieve.
+     * @return Pointer to the child at the specified index.
+     */
+
+    inline CNxWidget *getChild(int index)
+    {
+      return index < (int)m_children.size() ? m_children[index] : NULL;
+    }
+
     /**
      * Get the number of child widgets.
      *
@@ -53,7 +53,14 @@
 namespace NXWidgets
 {
   /**
-   * Class for scaling layer for any bitmap that inherits from IBitMap
+   * Class for scaling layer for any bitmap that inherits from IBitMap.
+   *
+   * Scaling is bilinear and done in the native pixel format.  The source
+   * column and interpolation weight of every output column are computed
+   * once, when the scaler is created.  Each source row is then scaled
+   * horizontally only once, into a two row cache, and output rows are
+   * interpolated vertically from that cache.  For static images, the
+   * whole scaled image may instead be rendered once and kept in memory.
    */
 
   class CScaledBitmap : public IBitmap
@@ -61,13 +68,17 @@ namespace NXWidgets
   protected:
     FAR IBitmap       *m_bitmap;      /**< The bitmap that is being scaled */
     struct nxgl_size_s m_size;        /**< Scaled size of the image */
-    FAR uint8_t       *m_rowCache[2]; /**< Two cached rows of the image */
+    FAR uint8_t       *m_srcRow;      /**< One unscaled row of the image */
+    FAR uint8_t       *m_rowCache[2]; /**< Two horizontally scaled rows */
+    FAR uint8_t       *m_image;       /**< The whole scaled image (optional) */
+    FAR uint16_t      *m_xIndex;      /**< Source column of each column */
+    FAR uint8_t       *m_xWeight;     /**< Weight of the next source column */
     unsigned int       m_row;         /**< Row number of the first cached row */
     b16_t              m_xScale;      /**< X scale factor */
     b16_t              m_yScale;      /**< Y scale factor */
 
     /**
-     * Read two rows into the row cache
+     * Read and horizontally scale two rows into the row cache
      *
      * @param row - The row number of the first row to cache
      */
@@ -75,31 +86,25 @@ namespace NXWidgets
     bool cacheRows(unsigned int row);
 
     /**
-     * Given an two RGB colors and a fractional value, return the scaled
-     * value between the two colors.
+     * Read one row of the unscaled image and scale it horizontally
      *
-     * @param incolor1 - The first color to be used
-     * @param incolor2 - The second color to be used
-     * @param fraction - The fractional value
-     * @param outcolor - The returned, scaled color
+     * @param row - The row number in the unscaled image
+     * @param dest - The location to return the scaled row
      */
 
-    bool scaleColor(FAR const struct rgbcolor_s &incolor1,
-                    FAR const struct rgbcolor_s &incolor2,
-                    b16_t fraction, FAR struct rgbcolor_s &outcolor);
+    bool scaleRow(unsigned int row, FAR uint8_t *dest);
 
     /**
-     * Given an image row and a non-integer column offset, return the
-     * interpolated RGB color value corresponding to that position
-     *
-     * @param row - The pointer to the row in the row cache to use
-     * @param column - The non-integer column offset
-     * @param outcolor - The returned, interpolated color
+     * Scale one row of the image in both directions
      *
+     * @param x The offset into the row to get
+     * @param y The row number to get
+     * @param width The number of pixels to get from the row
+     * @param data The location to return the scaled pixels
      */
 
-    bool rowColor(FAR uint8_t *row, b16_t column,
-                  FAR struct rgbcolor_s &outcolor);
+    bool scaleRun(nxgl_coord_t x, nxgl_coord_t y, nxgl_coord_t width,
+                  FAR uint8_t *data);
 
     /**
      * Copy constructor is protected to prevent usage.
@@ -114,9 +119,14 @@ namespace NXWidgets
      *
      * @param bitmap The bitmap structure being scaled.
      * @newSize The new, scaled size of the image
+     * @param cacheImage True: Scale the whole image now and keep it in
+     *   memory.  This costs getStride() * getHeight() bytes but makes every
+     *   later getRun() a simple copy, which suits static images like
+     *   icons that are drawn repeatedly.
      */
 
-    CScaledBitmap(IBitmap *bitmap, struct nxgl_size_s &newSize);
+    CScaledBitmap(IBitmap *bitmap, struct nxgl_size_s &newSize,
+                  bool cacheImage = false);
 
     /**
      * Destructor.
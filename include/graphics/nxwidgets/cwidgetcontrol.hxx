@@ -36,6 +36,7 @@
 #include <time.h>
 
 #include "graphics/nxwidgets/nxconfig.hxx"
+#include "graphics/nxwidgets/cdamageregion.hxx"
 #include "graphics/nxwidgets/cgraphicsport.hxx"
 #include "graphics/nxwidgets/cnxwidget.hxx"
 #include "graphics/nxwidgets/crect.hxx"
@@ -198,6 +199,19 @@ namespace NXWidgets
     sem_t                       m_boundsSem;      /**< Posted when bounds are valid */
     CWindowEventHandlerList     m_eventHandlers;  /**< List of event handlers. */
 
+    /**
+     * Batched redraw
+     */
+
+    TNxArray<CNxWidget*>        m_redrawQueue;    /**< Widgets awaiting
+                                                       redraw. */
+    CDamageRegion               m_exposed;        /**< Exposed areas not yet
+                                                       reported to handlers */
+    bool                        m_batchRedraw;    /**< True: defer widget
+                                                       redraws */
+    bool                        m_flushingRedraw; /**< True: flushRedraw() is
+                                                       in progress */
+
     /**
      * Style
      */
@@ -246,6 +260,27 @@ namespace NXWidgets
 
     const int getWidgetIndex(const CNxWidget *widget) const;
 
+    /**
+     * Check if one widget is an ancestor of another.
+     *
+     * @param ancestor The possible ancestor.
+     * @param widget The widget whose parents are checked.
+     * @return True if ancestor is a parent, grandparent, etc. of widget.
+     */
+
+    static bool isAncestor(const CNxWidget *ancestor,
+                           const CNxWidget *widget);
+
+    /**
+     * Redraw the damaged parts of a widget and of its children in z-order.
+     * Called by flushRedraw().
+     *
+     * @param widget The widget to redraw.
+     * @param painted The area painted so far in this flush.
+     */
+
+    void flushRedraw(CNxWidget *widget, CDamageRegion &painted);
+
     /**
      * Delete any widgets in the deletion queue.
      */
@@ -453,6 +488,52 @@ namespace NXWidgets
 
     void removeControlledWidget(CNxWidget* widget);
 
+    /**
+     * Enable or disable batched redraws.  While enabled, CNxWidget::redraw()
+     * only queues the widget and the queued widgets are drawn together by
+     * flushRedraw():  Each widget is drawn once no matter how often it was
+     * invalidated, widgets whose ancestor is also queued are drawn only as
+     * part of that ancestor, and widgets above a redrawn widget in z-order
+     * are redrawn where they overlap it so that they stay on top.
+     * Consecutive NX expose (redraw) events are also merged and reported
+     * to the window event handlers when the last one of a series arrives.
+     *
+     * Disabling batching flushes any queued redraws.
+     *
+     * @param enable True to batch redraws.
+     */
+
+    void setRedrawBatching(bool enable);
+
+    /**
+     * Check if redraws are being batched.
+     *
+     * @return True if widget redraws are deferred until flushRedraw().
+     */
+
+    inline bool isRedrawBatching(void) const
+    {
+      return m_batchRedraw;
+    }
+
+    /**
+     * Queue a widget for redraw.  Called by CNxWidget::redraw().
+     *
+     * @param widget The widget that must be redrawn.
+     * @return True if the redraw was queued, false if the caller must
+     *   draw the widget now.
+     */
+
+    bool queueRedraw(CNxWidget *widget);
+
+    /**
+     * Draw all widgets queued for redraw.  pollEvents() calls this after
+     * processing input.  Logic that changes widgets outside of
+     * pollEvents() must call it when done with a batch of updates.
+     */
+
+    void flushRedraw(void);
+
     /**
      * Get the number of controlled widgets.
      *
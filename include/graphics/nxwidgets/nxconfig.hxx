@@ -73,6 +73,11 @@
  *   The smallest BPP configuration supported by NX.
  * CONFIG_NXWIDGETS_SIZEOFCHAR - Size of character {1 or 2 bytes}.  Default
  *   Determined by CONFIG_NXWIDGETS_SIZEOFCHAR
+ * CONFIG_NXWIDGETS_GLYPHCACHE_SIZE - Number of rendered glyphs and glyph
+ *   masks cached per font for text drawing.  Zero disables the cache.
+ *   Default: 32
+ * CONFIG_NXWIDGETS_DAMAGE_NRECTS - Maximum number of rectangles used to
+ *   track invalidated window areas for batched redraws.  Default: 8
  *
  * NXWidget Default Values
  *
@@ -285,6 +290,18 @@
 #  error "Unsupported character width (CONFIG_NXWIDGETS_SIZEOFCHAR)"
 #endif
 
+/* Rendered glyph cache */
+
+#ifndef CONFIG_NXWIDGETS_GLYPHCACHE_SIZE
+#  define CONFIG_NXWIDGETS_GLYPHCACHE_SIZE 32
+#endif
+
+/* Damage region tracking for batched redraws */
+
+#ifndef CONFIG_NXWIDGETS_DAMAGE_NRECTS
+#  define CONFIG_NXWIDGETS_DAMAGE_NRECTS 8
+#endif
+
 /* NXWidget Default Values **************************************************/
 /**
  * Default font ID
@@ -276,6 +276,10 @@ struct tiff_filefmt_s
   uint16_t sbcoffset;      /* Offset to StripByteCount values */
 };
 
+/* Strip compression state, opaque to users of the library */
+
+struct tiff_encoder_s;
+
 /* These type is used to hold information about the TIFF file under
  * construction
  */
@@ -304,6 +308,11 @@ struct tiff_info_s
    * rps       - TIFF RowsPerStrip
    * imgwidth  - TIFF ImageWidth, Number of columns in the image
    * imgheight - TIFF ImageLength, Number of rows in the image
+   * compress  - TIFF Compression applied to each strip.  Zero or
+   *             TAG_COMP_NONE writes uncompressed strips.  TAG_COMP_PACKBITS
+   *             and TAG_COMP_LZW are also supported.  LZW gives the better
+   *             ratio on most images but needs about 30Kb of heap for its
+   *             string table while the file is being created.
    */
 
   FAR const char *outfile;  /* Full path to the final output file name */
@@ -314,6 +323,7 @@ struct tiff_info_s
   nxgl_coord_t rps;         /* TIFF RowsPerStrip */
   nxgl_coord_t imgwidth;    /* TIFF ImageWidth, Number of columns in the image */
   nxgl_coord_t imgheight;   /* TIFF ImageLength, Number of rows in the image */
+  uint16_t     compress;    /* TIFF Compression, TAG_COMP_* */
 
   /* The caller must provide an I/O buffer as well.  This I/O buffer will
    * used for color conversions and as the intermediate buffer for copying
@@ -341,6 +351,12 @@ struct tiff_info_s
   off_t        outsize;     /* Current size of outfile */
   off_t        tmp1size;    /* Current size of tmpfile1 */
   off_t        tmp2size;    /* Current size of tmpfile2 */
+  off_t        prevoff;     /* Offset of the last strip in tmpfile2 */
+  size_t       prevcount;   /* Byte count of the last strip */
+
+  /* Strip compression state.  Allocated by tiff_initialize() */
+
+  FAR struct tiff_encoder_s *encoder;
 
   /* Points to an internal constant structure of file offsets */
 
@@ -402,6 +418,26 @@ int tiff_initialize(FAR struct tiff_info_s *info);
 
 int tiff_addstrip(FAR struct tiff_info_s *info, FAR const uint8_t *strip);
 
+/****************************************************************************
+ * Name: tiff_repeatstrip
+ *
+ * Description:
+ *   Add a strip that is identical to the previous one.  No image data is
+ *   written; the new strip refers to the data of the previous strip.  This
+ *   is much faster than tiff_addstrip() and keeps the file small when an
+ *   image has large uniform areas.
+ *
+ * Input Parameters:
+ *   info    - A pointer to the caller allocated parameter passing/TIFF state
+ *             instance.
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  A negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tiff_repeatstrip(FAR struct tiff_info_s *info);
+
 /****************************************************************************
  * Name: tiff_finalize
  *
@@ -0,0 +1,182 @@
+/****************************************************************************
+ * apps/include/inertial/madgwick.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_INERTIAL_MADGWICK_H
+#define __INCLUDE_INERTIAL_MADGWICK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nuttx/uorb.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Fractional bits of the fixed-point quaternion */
+
+#define MADGWICK_FIXED_SHIFT  30
+#define MADGWICK_FIXED_ONE    (INT32_C(1) << MADGWICK_FIXED_SHIFT)
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Madgwick's gradient descent IMU filter.  q is the orientation of the
+ * earth frame relative to the sensor frame as w, x, y, z.
+ */
+
+struct madgwick_s
+{
+  float q[4];
+  float beta;                     /* Gain of the accelerometer correction */
+};
+
+/* The same filter in fixed point, for cores without an FPU.  q is in
+ * Q2.30; the gyroscope scale is folded together with the sample period.
+ */
+
+struct madgwick_fixed_s
+{
+  int32_t q[4];
+  int32_t beta_dt;                /* beta * dt, Q2.30 */
+  int32_t gyro_scale;             /* dt / 2 * rad/s per LSB, mantissa */
+  int gyro_shift;                 /* ... and its exponent */
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: madgwick_init
+ *
+ * Description:
+ *   Reset the filter to the identity orientation.
+ *
+ * Input Parameters:
+ *   m    - The filter
+ *   beta - Gain of the accelerometer correction, in rad/s.  Madgwick
+ *          suggests sqrt(3 / 4) times the gyroscope noise, 0.033 to 0.1 for
+ *          MEMS parts.
+ *
+ ****************************************************************************/
+
+void madgwick_init(FAR struct madgwick_s *m, float beta);
+
+/****************************************************************************
+ * Name: madgwick_update
+ *
+ * Description:
+ *   Update the filter with one sample.  This is the straightforward
+ *   implementation of the published algorithm; it is kept as the reference
+ *   the batch and fixed-point updates are tested against.
+ *
+ * Input Parameters:
+ *   m          - The filter
+ *   gx, gy, gz - Angular rate in rad/s
+ *   ax, ay, az - Acceleration in any unit.  A zero vector skips the
+ *                correction.
+ *   dt         - Time since the previous sample in seconds
+ *
+ ****************************************************************************/
+
+void madgwick_update(FAR struct madgwick_s *m, float gx, float gy, float gz,
+                     float ax, float ay, float az, float dt);
+
+/****************************************************************************
+ * Name: madgwick_update_batch
+ *
+ * Description:
+ *   Update the filter with nsamples pairs of samples, as read from batched
+ *   uORB gyroscope and accelerometer topics: gyro[i] and accel[i] must have
+ *   been taken at the same instant, dt apart.  Timestamps are not used.
+ *
+ *   The result tracks madgwick_update() called on each pair within the
+ *   rounding sensitivity of the algorithm, which the float reference
+ *   shares: expect agreement to well under 0.1 degree, often to a
+ *   millidegree on mild motion.  q is kept unit to a few ppm and must
+ *   start as a unit quaternion.
+ *
+ ****************************************************************************/
+
+void madgwick_update_batch(FAR struct madgwick_s *m,
+                           FAR const struct sensor_gyro *gyro,
+                           FAR const struct sensor_accel *accel,
+                           size_t nsamples, float dt);
+
+/****************************************************************************
+ * Name: madgwick_fixed_init
+ *
+ * Description:
+ *   Reset a fixed-point filter to the identity orientation.  Only this
+ *   function uses floating point.
+ *
+ * Input Parameters:
+ *   m        - The filter
+ *   beta     - Gain of the accelerometer correction, in rad/s
+ *   gyro_lsb - Gyroscope sensitivity in rad/s per LSB
+ *   dt       - Sample period in seconds
+ *
+ ****************************************************************************/
+
+void madgwick_fixed_init(FAR struct madgwick_fixed_s *m, float beta,
+                         float gyro_lsb, float dt);
+
+/****************************************************************************
+ * Name: madgwick_fixed_update_batch
+ *
+ * Description:
+ *   Update a fixed-point filter with nsamples raw samples, as read from an
+ *   IMU FIFO: gyro and accel each hold nsamples x, y, z triples.  Any
+ *   accelerometer scale may be used.
+ *
+ *   The result tracks madgwick_update() on the same samples as closely as
+ *   madgwick_update_batch() does: within about 0.1 degree.
+ *
+ ****************************************************************************/
+
+void madgwick_fixed_update_batch(FAR struct madgwick_fixed_s *m,
+                                 FAR const int16_t *gyro,
+                                 FAR const int16_t *accel,
+                                 size_t nsamples);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_INERTIAL_MADGWICK_H */
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * apps/include/math/kissfft_plan.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_MATH_KISSFFT_PLAN_H
+#define __INCLUDE_MATH_KISSFFT_PLAN_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stddef.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Plan flags */
+
+#define KISSFFT_FORWARD  0x00  /* Forward transform, exp(-2 pi i k n / N) */
+#define KISSFFT_INVERSE  0x01  /* Inverse transform, not scaled by 1 / N */
+#define KISSFFT_COMPLEX  0x00  /* Complex input and output */
+#define KISSFFT_REAL     0x02  /* Real input (forward) or output (inverse) */
+
+/* Number of floats in the buffer of a transform of nfft points */
+
+#define KISSFFT_BUFLEN(nfft, flags) \
+  (((flags) & KISSFFT_REAL) != 0 ? (nfft) : 2 * (nfft))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A transform of one size and type, shared by all its users */
+
+struct kissfft_plan_s;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: kissfft_plan_get
+ *
+ * Description:
+ *   Return the plan of an nfft point transform, creating it on first use.
+ *   Plans are cached by size and flags: the twiddle factors are computed
+ *   once and shared, and a plan released by its last user stays cached
+ *   until kissfft_plan_flush().
+ *
+ *   nfft must be a product of 2, 3 and 5, and even for real transforms.
+ *   Power-of-two complex lengths (nfft for complex, nfft / 2 for real
+ *   transforms) use in-place radix-4 butterflies, vectorized when
+ *   CONFIG_MATH_KISSFFT_PLAN_SIMD is set and the target has a float vector
+ *   unit.  Other lengths run kiss_fft through a scratch buffer of the plan.
+ *
+ * Input Parameters:
+ *   nfft  - Number of points
+ *   flags - KISSFFT_FORWARD or KISSFFT_INVERSE, and KISSFFT_COMPLEX or
+ *           KISSFFT_REAL
+ *
+ * Returned Value:
+ *   The plan, or NULL with errno set to EINVAL or ENOMEM.
+ *
+ ****************************************************************************/
+
+FAR struct kissfft_plan_s *kissfft_plan_get(size_t nfft, int flags);
+
+/****************************************************************************
+ * Name: kissfft_plan_put
+ *
+ * Description:
+ *   Release a plan returned by kissfft_plan_get().
+ *
+ ****************************************************************************/
+
+void kissfft_plan_put(FAR struct kissfft_plan_s *plan);
+
+/****************************************************************************
+ * Name: kissfft_plan_flush
+ *
+ * Description:
+ *   Free the cached plans that have no users.
+ *
+ ****************************************************************************/
+
+void kissfft_plan_flush(void);
+
+/****************************************************************************
+ * Name: kissfft_plan_exec
+ *
+ * Description:
+ *   Transform buf in place.  buf holds KISSFFT_BUFLEN(nfft, flags) floats:
+ *
+ *   - Complex transforms: nfft interleaved real and imaginary parts.
+ *   - Real forward: nfft samples in, the spectrum out in the CMSIS-DSP
+ *     arm_rfft_fast_f32() layout: buf[0] is the DC bin, buf[1] the real
+ *     Nyquist bin, and buf[2 * k], buf[2 * k + 1] bin k for
+ *     0 < k < nfft / 2.
+ *   - Real inverse: a spectrum in that layout in, nfft samples out.
+ *
+ *   Power-of-two plans may be run by several threads at once; the others
+ *   serialize on their scratch buffer.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int kissfft_plan_exec(FAR struct kissfft_plan_s *plan, FAR float *buf);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_MATH_KISSFFT_PLAN_H */
@@ -40,6 +40,8 @@
  * Public Type Declarations
  ****************************************************************************/
 
+struct nxplayer_prefetch_s;
+
 struct nxplayer_dec_ops_s
 {
   int format;
@@ -48,6 +50,23 @@ struct nxplayer_dec_ops_s
   CODE int (*fill_data)(int fd, FAR struct ap_buffer_s *apb);
 };
 
+#ifdef CONFIG_NXPLAYER_PREFETCH
+/* Read-ahead statistics, for tuning CONFIG_NXPLAYER_PREFETCH_BUFSIZE */
+
+struct nxplayer_stats_s
+{
+  uint32_t bufsize;      /* Size of the read-ahead ring in bytes */
+  uint32_t level;        /* Number of bytes currently buffered */
+  uint32_t lowwater;     /* Fewest bytes buffered when filling a buffer */
+  uint64_t nbytes;       /* Number of bytes read from the media */
+  uint32_t nreads;       /* Number of reads issued to the media */
+  uint32_t maxread_us;   /* Longest single read of the media */
+  uint32_t underruns;    /* Buffer fills that waited for the media */
+  uint32_t maxwait_us;   /* Longest wait of a single buffer fill */
+  uint64_t totalwait_us; /* Total time buffer fills waited */
+};
+#endif
+
 /* This structure describes the internal state of the NxPlayer */
 
 struct nxplayer_s
@@ -81,6 +100,10 @@ struct nxplayer_s
   uint16_t        treble;                      /* Treble as a whole % */
   uint16_t        bass;                        /* Bass as a whole % */
 #endif
+#ifdef CONFIG_NXPLAYER_PREFETCH
+  FAR struct nxplayer_prefetch_s *prefetch;    /* Read-ahead of the media file */
+  struct nxplayer_stats_s stats;               /* Statistics of last playback */
+#endif
 
   FAR const struct nxplayer_dec_ops_s *ops;
 };
@@ -555,6 +578,100 @@ int nxplayer_fill_mp3(int fd, FAR struct ap_buffer_s *apb);
 
 int nxplayer_fill_common(int fd, FAR struct ap_buffer_s *apb);
 
+#ifdef CONFIG_NXPLAYER_PREFETCH
+
+/****************************************************************************
+ * Name: nxplayer_getstats
+ *
+ *   Returns the read-ahead statistics of the current playback, or of the
+ *   last one if the player is idle.
+ *
+ * Input Parameters:
+ *   pplayer   - Pointer to the NxPlayer context
+ *   stats     - Location to return the statistics
+ *
+ * Returned Value:
+ *   OK
+ *
+ ****************************************************************************/
+
+int nxplayer_getstats(FAR struct nxplayer_s *pplayer,
+                      FAR struct nxplayer_stats_s *stats);
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_create
+ *
+ *   Allocates a read-ahead ring of bufsize bytes and starts a thread that
+ *   keeps it filled from the media file.
+ *
+ * Input Parameters:
+ *   fd        - The media file to read ahead
+ *   bufsize   - Size of the ring in bytes
+ *
+ * Returned Value:
+ *   The prefetch context or NULL if it could not be created.
+ *
+ ****************************************************************************/
+
+FAR struct nxplayer_prefetch_s *nxplayer_prefetch_create(int fd,
+                                                         size_t bufsize);
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_fill
+ *
+ *   Performs the same function as nxplayer_fill_common(), but takes the
+ *   data from the read-ahead ring.  Never blocks for long on a stalled
+ *   media, so that the caller can keep servicing its message queue.
+ *
+ * Input Parameters:
+ *   pf        - The prefetch context
+ *   apb       - The buffer to fill
+ *
+ * Returned Value:
+ *   OK if the buffer was filled, possibly short if the media stalled,
+ *   -EAGAIN if the media stalled before any data arrived and -ENODATA at
+ *   the end of the media.
+ *
+ ****************************************************************************/
+
+int nxplayer_prefetch_fill(FAR struct nxplayer_prefetch_s *pf,
+                           FAR struct ap_buffer_s *apb);
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_getstats
+ *
+ *   Returns a snapshot of the read-ahead statistics.
+ *
+ * Input Parameters:
+ *   pf        - The prefetch context
+ *   stats     - Location to return the statistics
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxplayer_prefetch_getstats(FAR struct nxplayer_prefetch_s *pf,
+                                FAR struct nxplayer_stats_s *stats);
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_destroy
+ *
+ *   Stops the read-ahead thread and frees the ring.  The media file is
+ *   not closed.
+ *
+ * Input Parameters:
+ *   pf        - The prefetch context
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxplayer_prefetch_destroy(FAR struct nxplayer_prefetch_s *pf);
+
+#endif /* CONFIG_NXPLAYER_PREFETCH */
+
 #undef EXTERN
 #ifdef __cplusplus
 }
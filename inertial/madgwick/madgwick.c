@@ -0,0 +1,464 @@
+/****************************************************************************
+ * apps/inertial/madgwick/madgwick.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* S. O. H. Madgwick, "An efficient orientation filter for inertial and
+ * inertial/magnetic sensor arrays", 2010, with the IMU-only gradient of
+ * its reference implementation.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <math.h>
+#include <stdbool.h>
+#include <string.h>
+#include <strings.h>
+
+#include <inertial/madgwick.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* a * b + c, rounded once where the FPU has a fused multiply-add */
+
+#ifdef __FP_FAST_FMAF
+#  define FMA(a, b, c)  fmaf(a, b, c)
+#else
+#  define FMA(a, b, c)  ((a) * (b) + (c))
+#endif
+
+/* Fixed-point formats: Q2.30 for unit quantities, Q2.29 for the objective
+ * function, whose terms reach 2, and Q4.27 for its gradient, which
+ * reaches 8.
+ */
+
+#define Q30           MADGWICK_FIXED_SHIFT
+#define Q29           (Q30 - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* 1 / sqrt(m) at the middle of [i / 16, (i + 1) / 16), Q2.14, for the
+ * normalized mantissas m in [1 / 4, 1)
+ */
+
+static const uint16_t g_rsqrt_seed[12] =
+{
+  30894, 27945, 25705, 23930, 22479, 21263,
+  20225, 19326, 18536, 17837, 17211, 16646
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fast_rsqrtf
+ *
+ * Description:
+ *   1 / sqrt(x) for x > 0 from the exponent trick and two Newton steps,
+ *   within 5e-6.  Much cheaper than sqrtf() and a division on FPUs that
+ *   iterate both.
+ *
+ ****************************************************************************/
+
+static inline float fast_rsqrtf(float x)
+{
+  float hx = 0.5f * x;
+  uint32_t i;
+  float y;
+
+  memcpy(&i, &x, sizeof(i));
+  i = 0x5f375a86 - (i >> 1);
+  memcpy(&y, &i, sizeof(y));
+
+  y = y * FMA(-hx, y * y, 1.5f);
+  y = y * FMA(-hx, y * y, 1.5f);
+  return y;
+}
+
+/****************************************************************************
+ * Name: fixed_shr
+ *
+ * Description:
+ *   Shift v right by shift >= 0 bits, rounding to nearest.
+ *
+ ****************************************************************************/
+
+static inline int32_t fixed_shr(int64_t v, int shift)
+{
+  if (shift == 0)
+    {
+      return (int32_t)v;
+    }
+
+  return (int32_t)((v + ((int64_t)1 << (shift - 1))) >> shift);
+}
+
+/****************************************************************************
+ * Name: fixed_normalize
+ *
+ * Description:
+ *   Scale the n components of v, whatever their format, to a unit vector
+ *   in Q2.30.  The sum of their squares must fit 64 bits.  Returns false
+ *   and leaves out alone if v is zero.
+ *
+ ****************************************************************************/
+
+static bool fixed_normalize(FAR const int32_t *v, FAR int32_t *out, int n)
+{
+  uint64_t x = 0;
+  uint64_t t;
+  uint32_t y;
+  uint32_t m;
+  int k;
+  int i;
+
+  for (i = 0; i < n; i++)
+    {
+      x += (uint64_t)((int64_t)v[i] * v[i]);
+    }
+
+  if (x == 0)
+    {
+      return false;
+    }
+
+  /* x = m * 2^(2k - 32) with m in [2^30, 2^32): 1 / sqrt(x) is
+   * 1 / sqrt(m / 2^32) * 2^-k, and the former lies in (1, 2].
+   */
+
+  k = (flsll(x) + 1) / 2;
+  m = 2 * k >= 32 ? (uint32_t)(x >> (2 * k - 32)) :
+                    (uint32_t)(x << (32 - 2 * k));
+
+  /* Table seed within 6 %, then three Newton steps, Q3.29 */
+
+  y = (uint32_t)g_rsqrt_seed[(m >> 28) - 4] << (Q29 - 14);
+  for (i = 0; i < 3; i++)
+    {
+      t = ((uint64_t)y * y) >> Q29;
+      t = (t * m) >> 32;
+      y = (uint32_t)(((uint64_t)y * ((3u << Q29) - t)) >> Q30);
+    }
+
+  for (i = 0; i < n; i++)
+    {
+      out[i] = fixed_shr((int64_t)v[i] * y, k - 1);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+void madgwick_init(FAR struct madgwick_s *m, float beta)
+{
+  m->q[0] = 1.0f;
+  m->q[1] = 0.0f;
+  m->q[2] = 0.0f;
+  m->q[3] = 0.0f;
+  m->beta = beta;
+}
+
+void madgwick_update(FAR struct madgwick_s *m, float gx, float gy, float gz,
+                     float ax, float ay, float az, float dt)
+{
+  float q0 = m->q[0];
+  float q1 = m->q[1];
+  float q2 = m->q[2];
+  float q3 = m->q[3];
+  float qdot0;
+  float qdot1;
+  float qdot2;
+  float qdot3;
+  float s0;
+  float s1;
+  float s2;
+  float s3;
+  float norm;
+
+  /* Rate of change of the quaternion from the gyroscope */
+
+  qdot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+  qdot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+  qdot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+  qdot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+  if (ax != 0.0f || ay != 0.0f || az != 0.0f)
+    {
+      norm = 1.0f / sqrtf(ax * ax + ay * ay + az * az);
+      ax *= norm;
+      ay *= norm;
+      az *= norm;
+
+      /* Gradient of the error between measured and estimated gravity */
+
+      s0 = 4.0f * q0 * q2 * q2 + 2.0f * q2 * ax +
+           4.0f * q0 * q1 * q1 - 2.0f * q1 * ay;
+      s1 = 4.0f * q1 * q3 * q3 - 2.0f * q3 * ax +
+           4.0f * q0 * q0 * q1 - 2.0f * q0 * ay - 4.0f * q1 +
+           8.0f * q1 * q1 * q1 + 8.0f * q1 * q2 * q2 + 4.0f * q1 * az;
+      s2 = 4.0f * q0 * q0 * q2 + 2.0f * q0 * ax +
+           4.0f * q2 * q3 * q3 - 2.0f * q3 * ay - 4.0f * q2 +
+           8.0f * q2 * q1 * q1 + 8.0f * q2 * q2 * q2 + 4.0f * q2 * az;
+      s3 = 4.0f * q1 * q1 * q3 - 2.0f * q1 * ax +
+           4.0f * q2 * q2 * q3 - 2.0f * q2 * ay;
+
+      norm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+      if (norm > 0.0f)
+        {
+          norm = 1.0f / sqrtf(norm);
+          qdot0 -= m->beta * s0 * norm;
+          qdot1 -= m->beta * s1 * norm;
+          qdot2 -= m->beta * s2 * norm;
+          qdot3 -= m->beta * s3 * norm;
+        }
+    }
+
+  q0 += qdot0 * dt;
+  q1 += qdot1 * dt;
+  q2 += qdot2 * dt;
+  q3 += qdot3 * dt;
+
+  norm = 1.0f / sqrtf(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+  m->q[0] = q0 * norm;
+  m->q[1] = q1 * norm;
+  m->q[2] = q2 * norm;
+  m->q[3] = q3 * norm;
+}
+
+void madgwick_update_batch(FAR struct madgwick_s *m,
+                           FAR const struct sensor_gyro *gyro,
+                           FAR const struct sensor_accel *accel,
+                           size_t nsamples, float dt)
+{
+  float q0 = m->q[0];
+  float q1 = m->q[1];
+  float q2 = m->q[2];
+  float q3 = m->q[3];
+  float hdt = 0.5f * dt;
+  float bdt = m->beta * dt;
+  size_t i;
+
+  /* The same step as madgwick_update() with the quaternion kept in
+   * registers across the batch, the constants folded, the gradient in its
+   * factored J^T f form (half the multiplies of the expanded one) and
+   * approximate inverse square roots.
+   */
+
+  for (i = 0; i < nsamples; i++)
+    {
+      float gx = gyro[i].x * hdt;
+      float gy = gyro[i].y * hdt;
+      float gz = gyro[i].z * hdt;
+      float ax = accel[i].x;
+      float ay = accel[i].y;
+      float az = accel[i].z;
+      float d0;
+      float d1;
+      float d2;
+      float d3;
+      float norm;
+
+      d0 = -FMA(q1, gx, FMA(q2, gy, q3 * gz));
+      d1 = FMA(q0, gx, FMA(q2, gz, -q3 * gy));
+      d2 = FMA(q0, gy, FMA(q3, gx, -q1 * gz));
+      d3 = FMA(q0, gz, FMA(q1, gy, -q2 * gx));
+
+      norm = FMA(ax, ax, FMA(ay, ay, az * az));
+      if (norm > 0.0f)
+        {
+          float f1;
+          float f2;
+          float f3;
+          float s0;
+          float s1;
+          float s2;
+          float s3;
+
+          norm = fast_rsqrtf(norm);
+          ax *= norm;
+          ay *= norm;
+          az *= norm;
+
+          /* Estimated minus measured gravity, and half its gradient */
+
+          f1 = 2.0f * FMA(q1, q3, -q0 * q2) - ax;
+          f2 = 2.0f * FMA(q0, q1, q2 * q3) - ay;
+          f3 = FMA(-2.0f, FMA(q1, q1, q2 * q2), 1.0f) - az;
+
+          s0 = FMA(q1, f2, -q2 * f1);
+          s1 = FMA(q3, f1, FMA(q0, f2, -2.0f * q1 * f3));
+          s2 = FMA(q3, f2, FMA(-q0, f1, -2.0f * q2 * f3));
+          s3 = FMA(q1, f1, q2 * f2);
+
+          norm = FMA(s0, s0, FMA(s1, s1, FMA(s2, s2, s3 * s3)));
+          if (norm > 0.0f)
+            {
+              norm = bdt * fast_rsqrtf(norm);
+              d0 = FMA(-norm, s0, d0);
+              d1 = FMA(-norm, s1, d1);
+              d2 = FMA(-norm, s2, d2);
+              d3 = FMA(-norm, s3, d3);
+            }
+        }
+
+      q0 += d0;
+      q1 += d1;
+      q2 += d2;
+      q3 += d3;
+
+      /* |q|^2 only moved from 1 by the square of the step: one Newton
+       * step from 1 renormalizes it to the fourth power of the step.
+       */
+
+      norm = FMA(q0, q0, FMA(q1, q1, FMA(q2, q2, q3 * q3)));
+      norm = FMA(-0.5f, norm, 1.5f);
+      q0 *= norm;
+      q1 *= norm;
+      q2 *= norm;
+      q3 *= norm;
+    }
+
+  m->q[0] = q0;
+  m->q[1] = q1;
+  m->q[2] = q2;
+  m->q[3] = q3;
+}
+
+void madgwick_fixed_init(FAR struct madgwick_fixed_s *m, float beta,
+                         float gyro_lsb, float dt)
+{
+  int exp;
+  float frac;
+
+  m->q[0] = MADGWICK_FIXED_ONE;
+  m->q[1] = 0;
+  m->q[2] = 0;
+  m->q[3] = 0;
+  m->beta_dt = (int32_t)lrintf(ldexpf(beta * dt, Q30));
+
+  /* Half the rotation of one LSB over a period, in Q2.30, as a 23 bit
+   * mantissa: a 16 bit sample times it fits 64 bits.
+   */
+
+  frac = frexpf(0.5f * dt * gyro_lsb, &exp);
+  m->gyro_scale = (int32_t)lrintf(ldexpf(frac, 23));
+  m->gyro_shift = 23 - Q30 - exp;
+  DEBUGASSERT(m->gyro_shift >= 0);
+}
+
+void madgwick_fixed_update_batch(FAR struct madgwick_fixed_s *m,
+                                 FAR const int16_t *gyro,
+                                 FAR const int16_t *accel,
+                                 size_t nsamples)
+{
+  int32_t q[4];
+  int32_t d[4];
+  int32_t s[4];
+  int32_t a[3];
+  int32_t norm;
+  int32_t f1;
+  int32_t f2;
+  int32_t f3;
+  int32_t gx;
+  int32_t gy;
+  int32_t gz;
+  int64_t n2;
+  size_t i;
+  int j;
+
+  memcpy(q, m->q, sizeof(q));
+
+  for (i = 0; i < nsamples; i++, gyro += 3, accel += 3)
+    {
+      gx = fixed_shr((int64_t)gyro[0] * m->gyro_scale, m->gyro_shift);
+      gy = fixed_shr((int64_t)gyro[1] * m->gyro_scale, m->gyro_shift);
+      gz = fixed_shr((int64_t)gyro[2] * m->gyro_scale, m->gyro_shift);
+
+      d[0] = fixed_shr(-(int64_t)q[1] * gx - (int64_t)q[2] * gy -
+                       (int64_t)q[3] * gz, Q30);
+      d[1] = fixed_shr((int64_t)q[0] * gx + (int64_t)q[2] * gz -
+                       (int64_t)q[3] * gy, Q30);
+      d[2] = fixed_shr((int64_t)q[0] * gy - (int64_t)q[1] * gz +
+                       (int64_t)q[3] * gx, Q30);
+      d[3] = fixed_shr((int64_t)q[0] * gz + (int64_t)q[1] * gy -
+                       (int64_t)q[2] * gx, Q30);
+
+      a[0] = accel[0];
+      a[1] = accel[1];
+      a[2] = accel[2];
+
+      if (fixed_normalize(a, a, 3))
+        {
+          f1 = fixed_shr((int64_t)q[1] * q[3] - (int64_t)q[0] * q[2], Q30) -
+               a[0] / 2;
+          f2 = fixed_shr((int64_t)q[0] * q[1] + (int64_t)q[2] * q[3], Q30) -
+               a[1] / 2;
+          f3 = (1 << Q29) -
+               fixed_shr((int64_t)q[1] * q[1] + (int64_t)q[2] * q[2], Q30) -
+               a[2] / 2;
+
+          /* Q2.30 times Q2.29 down to Q4.27 */
+
+          s[0] = fixed_shr((int64_t)q[1] * f2 - (int64_t)q[2] * f1, 32);
+          s[1] = fixed_shr((int64_t)q[3] * f1 + (int64_t)q[0] * f2 -
+                           2 * (int64_t)q[1] * f3, 32);
+          s[2] = fixed_shr((int64_t)q[3] * f2 - (int64_t)q[0] * f1 -
+                           2 * (int64_t)q[2] * f3, 32);
+          s[3] = fixed_shr((int64_t)q[1] * f1 + (int64_t)q[2] * f2, 32);
+
+          if (fixed_normalize(s, s, 4))
+            {
+              for (j = 0; j < 4; j++)
+                {
+                  d[j] -= fixed_shr((int64_t)m->beta_dt * s[j], Q30);
+                }
+            }
+        }
+
+      /* Renormalize with one Newton step from 1, as the float update */
+
+      for (j = 0, n2 = 0; j < 4; j++)
+        {
+          q[j] += d[j];
+          n2 += (int64_t)q[j] * q[j];
+        }
+
+      norm = (3 << Q29) - fixed_shr(n2, Q30 + 1);
+      for (j = 0; j < 4; j++)
+        {
+          q[j] = fixed_shr((int64_t)q[j] * norm, Q30);
+        }
+    }
+
+  memcpy(m->q, q, sizeof(q));
+}
@@ -33,6 +33,8 @@
  * Included Files
  ****************************************************************************/
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -158,6 +160,7 @@
 #define ERR_NOTINT 21
 
 #define MAXFORS 32              /* Maximum number of nested fors */
+#define HASHSIZE 64             /* Buckets in the variable hash tables */
 
 /****************************************************************************
  * Private Types
@@ -166,12 +169,41 @@
 struct mb_line_s
 {
   int no;                       /* Line number */
+  int tok;                      /* Index of the line's first token */
   FAR const char *str;          /* Points to start of line */
 };
 
+/* The script is lexed once, by setup(), into an array of tokens.  The
+ * parser then walks the array instead of re-reading the source text each
+ * time a line runs.  Line breaks are not tokens (the lexer has always
+ * skipped them as white space), so each token records whether one
+ * preceded it.
+ */
+
+struct mb_token_s
+{
+  int16_t type;                 /* Token type */
+  uint8_t newline;              /* Set if a line break precedes the token */
+  uint8_t error;                /* Error raised when the token is matched */
+  int line;                     /* Index of the line a GOTO target names */
+  union
+  {
+    double value;               /* VALUE: the number */
+    int var;                    /* STRID, FLTID, DIM*ID: variable slot */
+    FAR char *str;              /* QUOTE: the literal (NULL if unended) */
+  } u;
+};
+
+/* Variables are interned by name while the script is lexed, so every
+ * identifier token carries the index of its table entry.  An entry only
+ * becomes visible to the script once it has been assigned (or DIMed).
+ */
+
 struct mb_variable_s
 {
   char id[32];                  /* Id of variable */
+  int next;                     /* Next entry in the hash chain, or -1 */
+  bool defined;                 /* Set once the script creates it */
   double dval;                  /* Its value if a real */
   FAR char *sval;               /* Its value if a string (malloced) */
 };
@@ -179,6 +211,8 @@ struct mb_variable_s
 struct mb_dimvar_s
 {
   char id[32];                  /* Id of dimensioned variable */
+  int next;                     /* Next entry in the hash chain, or -1 */
+  bool defined;                 /* Set once the script DIMs it */
   int type;                     /* Its type, STRID or FLTID */
   int ndims;                    /* Number of dimensions */
   int dim[5];                   /* Dimensions in x y order */
@@ -195,8 +229,8 @@ struct mb_lvalue_s
 
 struct mb_forloop_s
 {
-  char id[32];                  /* Id of control variable */
   int nextline;                 /* Line below FOR to which control passes */
+  int nextindex;                /* Index of that line in g_lines */
   double toval;                 /* Terminal value */
   double step;                  /* Step size */
 };
@@ -220,18 +254,24 @@ static int nfors;                               /* Number of fors on stack */
 
 static FAR struct mb_variable_s *g_variables;   /* The script's variables */
 static int g_nvariables;                        /* Number of variables */
+static int g_varhash[HASHSIZE];                 /* Hash chains of g_variables */
 
 static FAR struct mb_dimvar_s *g_dimvariables;  /* Dimensioned arrays */
 static int g_ndimvariables;                     /* Number of dimensioned arrays */
+static int g_dimhash[HASHSIZE];                 /* Hash chains of g_dimvariables */
 
 static FAR struct mb_line_s *g_lines;           /* List of line starts */
 static int nlines;                              /* Number of BASIC g_lines in program */
+static int g_jumpline;                          /* Index of the line jumped to, or -1 */
+
+static FAR struct mb_token_s *g_tokens;         /* The lexed script */
+static int g_ntokens;                           /* Number of tokens */
 
 static FILE *g_fpin;                            /* Input stream */
 static FILE *g_fpout;                           /* Output stream */
 static FILE *g_fperr;                           /* Error stream */
 
-static FAR const char *g_string;                /* String we are parsing */
+static FAR const struct mb_token_s *g_tok;      /* Token we are parsing */
 static int g_token;                             /* Current token (lookahead) */
 static int g_errorflag;                         /* Set when error in input encountered */
 static char g_iobuffer[IOBUFSIZE];              /* I/O buffer */
@@ -241,10 +281,12 @@ static char g_iobuffer[IOBUFSIZE];              /* I/O buffer */
  ****************************************************************************/
 
 static int setup(FAR const char *script);
+static int tokenize(FAR const char *script);
 static void cleanup(void);
 
 static void reporterror(int lineno);
 static int findline(int no);
+static int nextline(void);
 
 static int line(void);
 static void doprint(void);
@@ -270,13 +312,15 @@ static double instr(void);
 static double variable(void);
 static double dimvariable(void);
 
-static FAR struct mb_variable_s *findvariable(FAR const char *id);
-static FAR struct mb_dimvar_s *finddimvar(FAR const char *id);
-static FAR struct mb_dimvar_s *dimension(FAR const char *id, int ndims, ...);
+static int hashid(FAR const char *id);
+static int internvar(FAR const char *id);
+static int interndimvar(FAR const char *id);
+static FAR struct mb_variable_s *findvariable(int var);
+static FAR struct mb_dimvar_s *finddimvar(int var);
+static FAR struct mb_dimvar_s *dimension(int var, int ndims, ...);
 static FAR void *getdimvar(FAR struct mb_dimvar_s *dv, ...);
-static FAR struct mb_variable_s *addfloat(FAR const char *id);
-static FAR struct mb_variable_s *addstring(FAR const char *id);
-static FAR struct mb_dimvar_s *adddimvar(FAR const char *id);
+static FAR struct mb_variable_s *addvariable(int var);
+static FAR struct mb_dimvar_s *adddimvar(int var);
 
 static FAR char *stringexpr(void);
 static FAR char *chrstring(void);
@@ -293,13 +337,12 @@ static int integer(double x);
 
 static void match(int tok);
 static void seterror(int errorcode);
-static int getnextline(FAR const char *str);
 static int gettoken(FAR const char *str);
 static int tokenlen(FAR const char *str, int tokenid);
 
 static int isstring(int tokenid);
 static double getvalue(FAR const char *str, FAR int *len);
-static void getid(FAR const char *str, FAR char *out, FAR int *len);
+static int getid(FAR const char *str, FAR char *out, FAR int *len);
 
 static void mystrgrablit(FAR char *dest, FAR const char *src);
 static FAR char *mystrend(FAR const char *str, char quote);
@@ -388,9 +431,183 @@ static int setup(FAR const char *script)
   g_dimvariables = 0;
   g_ndimvariables = 0;
 
+  for (i = 0; i < HASHSIZE; i++)
+    {
+      g_varhash[i] = -1;
+      g_dimhash[i] = -1;
+    }
+
+  if (tokenize(g_lines[0].str) == -1)
+    {
+      if (g_fperr)
+        {
+          fprintf(g_fperr, "Out of memory\n");
+        }
+
+      cleanup();
+      return -1;
+    }
+
   return 0;
 }
 
+/****************************************************************************
+ * Name: tokenize
+ *
+ * Description:
+ *   Lex the script into g_tokens, interning the variables it names, and
+ *   note the first token of every line.  The tokens are exactly those the
+ *   parser used to read from the text, so lexing errors still only show
+ *   when a line that contains one runs.
+ *   Params: script - start of the first line
+ *   Returns: 0 on success, -1 on failure
+ *
+ ****************************************************************************/
+
+static int tokenize(FAR const char *script)
+{
+  FAR const char *str = script;
+  FAR struct mb_token_s *tokens;
+  FAR struct mb_token_s *tok;
+  FAR char *end;
+  char name[32];
+  bool newline = false;
+  bool comment = false;
+  int size = 0;
+  int line = 0;
+  int len;
+
+  while (1)
+    {
+      while (isspace(*str))
+        {
+          if (*str == '\n')
+            {
+              newline = true;
+            }
+
+          str++;
+        }
+
+      if (g_ntokens == size)
+        {
+          size = size ? size * 2 : 64;
+          tokens = realloc(g_tokens, size * sizeof(struct mb_token_s));
+          if (!tokens)
+            {
+              return -1;
+            }
+
+          g_tokens = tokens;
+        }
+
+      tok = &g_tokens[g_ntokens++];
+      tok->type = gettoken(str);
+      tok->newline = newline;
+      tok->error = 0;
+      tok->line = -1;
+      tok->u.str = NULL;
+      newline = false;
+
+      if (line < nlines && str == g_lines[line].str)
+        {
+          g_lines[line++].tok = g_ntokens - 1;
+        }
+
+      switch (tok->type)
+        {
+        case EOS:
+          return 0;
+
+        case VALUE:
+          tok->u.value = getvalue(str, &len);
+
+          /* Resolve constant jump targets now */
+
+          if (g_ntokens > 1 &&
+              (tok[-1].type == GOTO || tok[-1].type == THEN) &&
+              tok->u.value >= INT_MIN && tok->u.value <= INT_MAX &&
+              tok->u.value == floor(tok->u.value))
+            {
+              tok->line = findline((int)tok->u.value);
+            }
+          break;
+
+        case FLTID:
+        case STRID:
+          if (getid(str, name, &len) != 0)
+            {
+              tok->error = ERR_IDTOOLONG;
+            }
+
+          tok->u.var = internvar(name);
+          if (tok->u.var < 0)
+            {
+              return -1;
+            }
+          break;
+
+        case DIMFLTID:
+        case DIMSTRID:
+          if (getid(str, name, &len) != 0)
+            {
+              tok->error = ERR_IDTOOLONG;
+            }
+
+          tok->u.var = interndimvar(name);
+          if (tok->u.var < 0)
+            {
+              return -1;
+            }
+          break;
+
+        case QUOTE:
+          end = mystrend(str, '"');
+          if (end)
+            {
+              tok->u.str = malloc(end - str);
+              if (!tok->u.str)
+                {
+                  return -1;
+                }
+
+              mystrgrablit(tok->u.str, str);
+              len = end + 1 - str;
+              break;
+            }
+
+          /* An unterminated literal is a syntax error when parsed */
+
+          /* Fall through. */
+
+        case SYNTAX_ERROR:
+
+          /* The parser cannot get past this token, carry on with the next
+           * line.
+           */
+
+          str += strcspn(str, "\n");
+          comment = false;
+          continue;
+
+        default:
+          len = tokenlen(str, tok->type);
+          break;
+        }
+
+      str += len;
+
+      /* Only the token following REM is ever looked at */
+
+      if (comment && !tok->newline)
+        {
+          str += strcspn(str, "\n");
+        }
+
+      comment = tok->type == REM;
+    }
+}
+
 /****************************************************************************
  * Name: cleanup
  *
@@ -458,6 +675,22 @@ static void cleanup(void)
   g_dimvariables = 0;
   g_ndimvariables = 0;
 
+  for (i = 0; i < g_ntokens; i++)
+    {
+      if (g_tokens[i].type == QUOTE && g_tokens[i].u.str)
+        {
+          free(g_tokens[i].u.str);
+        }
+    }
+
+  if (g_tokens)
+    {
+      free(g_tokens);
+    }
+
+  g_tokens = 0;
+  g_ntokens = 0;
+
   if (g_lines)
     {
       free(g_lines);
@@ -634,6 +867,47 @@ static int findline(int no)
   return mid;
 }
 
+/****************************************************************************
+ * Name: nextline
+ *
+ * Description:
+ *   Get the line after the current token.
+ *   Returns: line no of the first line starting after the last token
+ *            matched, 0 if end.  Sets g_jumpline to its index.
+ *
+ ****************************************************************************/
+
+static int nextline(void)
+{
+  int tok = g_tok - g_tokens;
+  int high;
+  int low;
+  int mid;
+
+  low = 0;
+  high = nlines;
+  while (low < high)
+    {
+      mid = (high + low) / 2;
+      if (g_lines[mid].tok < tok)
+        {
+          low = mid + 1;
+        }
+      else
+        {
+          high = mid;
+        }
+    }
+
+  if (low == nlines)
+    {
+      return 0;
+    }
+
+  g_jumpline = low;
+  return g_lines[low].no;
+}
+
 /****************************************************************************
  * Name: line
  *
@@ -645,7 +919,6 @@ static int findline(int no)
 static int line(void)
 {
   int answer = 0;
-  FAR const char *str;
 
   match(VALUE);
 
@@ -692,27 +965,11 @@ static int line(void)
       break;
     }
 
-  if (g_token != EOS)
-    {
-      /* match(VALUE); */
-
-      /* check for a newline */
-
-      str = g_string;
-      while (isspace(*str))
-        {
-          if (*str == '\n')
-            {
-              break;
-            }
+  /* check for a newline */
 
-          str++;
-        }
-
-      if (*str != '\n')
-        {
-          seterror(ERR_SYNTAX);
-        }
+  if (g_token != EOS && !g_tok->newline)
+    {
+      seterror(ERR_SYNTAX);
     }
 
   return answer;
@@ -821,8 +1078,7 @@ static void dodim(void)
 {
   int ndims = 0;
   double dims[6];
-  char name[32];
-  int len;
+  int var;
   FAR struct mb_dimvar_s *dimvar;
   int i;
   int size = 1;
@@ -833,7 +1089,7 @@ static void dodim(void)
     {
     case DIMFLTID:
     case DIMSTRID:
-      getid(g_string, name, &len);
+      var = g_tok->u.var;
       match(g_token);
       dims[ndims++] = expr();
       while (g_token == COMMA)
@@ -861,27 +1117,27 @@ static void dodim(void)
       switch (ndims)
         {
         case 1:
-          dimvar = dimension(name, 1, (int)dims[0]);
+          dimvar = dimension(var, 1, (int)dims[0]);
           break;
 
         case 2:
-          dimvar = dimension(name, 2, (int)dims[0], (int)dims[1]);
+          dimvar = dimension(var, 2, (int)dims[0], (int)dims[1]);
           break;
 
         case 3:
-          dimvar = dimension(name, 3, (int)dims[0],
+          dimvar = dimension(var, 3, (int)dims[0],
                              (int)dims[1], (int)dims[2]);
           break;
 
         case 4:
           dimvar =
-            dimension(name, 4, (int)dims[0], (int)dims[1], (int)dims[2],
+            dimension(var, 4, (int)dims[0], (int)dims[1], (int)dims[2],
                       (int)dims[3]);
           break;
 
         case 5:
           dimvar =
-            dimension(name, 5, (int)dims[0], (int)dims[1], (int)dims[2],
+            dimension(var, 5, (int)dims[0], (int)dims[1], (int)dims[2],
                       (int)dims[3], (int)dims[4]);
           break;
         }
@@ -975,6 +1231,7 @@ static int doif(void)
   match(IF);
   condition = boolexpr();
   match(THEN);
+  g_jumpline = g_tok->line;
   jump = integer(expr());
   if (condition)
     {
@@ -998,6 +1255,7 @@ static int doif(void)
 static int dogoto(void)
 {
   match(GOTO);
+  g_jumpline = g_tok->line;
   return integer(expr());
 }
 
@@ -1015,17 +1273,16 @@ static int dogoto(void)
 static int dofor(void)
 {
   struct mb_lvalue_s lv;
-  char id[32];
-  char nextid[32];
-  int len;
+  FAR const struct mb_token_s *id;
+  FAR const struct mb_token_s *savetok;
+  FAR const struct mb_token_s *tok;
   double initval;
   double toval;
   double stepval;
-  FAR const char *savestring;
   int answer;
 
   match(FOR);
-  getid(g_string, id, &len);
+  id = g_tok;
 
   lvalue(&lv);
   if (lv.type != FLTID)
@@ -1060,36 +1317,50 @@ static int dofor(void)
   if ((stepval < 0 && initval < toval) ||
       (stepval > 0 && initval > toval))
     {
-      savestring = g_string;
-      while ((g_string = strchr(g_string, '\n')) != NULL)
+      /* Look for the matching NEXT at the start of each following line */
+
+      savetok = g_tok;
+      for (tok = g_tok; tok->type != EOS; tok++)
         {
+          if (!tok->newline)
+            {
+              continue;
+            }
+
           g_errorflag = 0;
-          g_token = gettoken(g_string);
+          g_tok = tok;
+          g_token = tok->type;
           match(VALUE);
           if (g_token == NEXT)
             {
               match(NEXT);
-              if (g_token == FLTID || g_token == DIMFLTID)
+              if ((g_token == FLTID || g_token == DIMFLTID) &&
+                  g_token == id->type && g_tok->u.var == id->u.var)
                 {
-                  getid(g_string, nextid, &len);
-                  if (!strcmp(id, nextid))
+                  if (g_tok->error)
                     {
-                      answer = getnextline(g_string);
-                      g_string = savestring;
-                      g_token = gettoken(g_string);
-                      return answer ? answer : -1;
+                      seterror(g_tok->error);
                     }
+
+                  answer = nextline();
+                  g_tok = savetok;
+                  g_token = g_tok->type;
+                  return answer ? answer : -1;
                 }
             }
         }
 
+      g_tok = savetok;
+      g_token = g_tok->type;
+
       seterror(ERR_NONEXT);
       return -1;
     }
   else
     {
-      strlcpy(g_forstack[nfors].id, id, sizeof(g_forstack[nfors].id));
-      g_forstack[nfors].nextline = getnextline(g_string);
+      g_forstack[nfors].nextline = nextline();
+      g_forstack[nfors].nextindex = g_jumpline;
+      g_jumpline = -1;
       g_forstack[nfors].step = stepval;
       g_forstack[nfors].toval = toval;
       nfors++;
@@ -1108,15 +1379,12 @@ static int dofor(void)
 
 static int donext(void)
 {
-  char id[32];
-  int len;
   struct mb_lvalue_s lv;
 
   match(NEXT);
 
   if (nfors)
     {
-      getid(g_string, id, &len);
       lvalue(&lv);
       if (lv.type != FLTID)
         {
@@ -1135,6 +1403,7 @@ static int donext(void)
         }
       else
         {
+          g_jumpline = g_forstack[nfors - 1].nextindex;
           return g_forstack[nfors - 1].nextline;
         }
     }
@@ -1267,8 +1536,7 @@ static void dorem(void)
 
 static void lvalue(FAR struct mb_lvalue_s *lv)
 {
-  char name[32];
-  int len;
+  int id;
   FAR struct mb_variable_s *var;
   FAR struct mb_dimvar_s *dimvar;
   int index[5];
@@ -1283,12 +1551,12 @@ static void lvalue(FAR struct mb_lvalue_s *lv)
     {
     case FLTID:
       {
-        getid(g_string, name, &len);
+        id = g_tok->u.var;
         match(FLTID);
-        var = findvariable(name);
+        var = findvariable(id);
         if (!var)
           {
-            var = addfloat(name);
+            var = addvariable(id);
           }
 
         if (!var)
@@ -1305,12 +1573,12 @@ static void lvalue(FAR struct mb_lvalue_s *lv)
 
     case STRID:
       {
-        getid(g_string, name, &len);
+        id = g_tok->u.var;
         match(STRID);
-        var = findvariable(name);
+        var = findvariable(id);
         if (!var)
           {
-            var = addstring(name);
+            var = addvariable(id);
           }
 
         if (!var)
@@ -1329,9 +1597,9 @@ static void lvalue(FAR struct mb_lvalue_s *lv)
     case DIMSTRID:
       {
         type = (g_token == DIMFLTID) ? FLTID : STRID;
-        getid(g_string, name, &len);
+        id = g_tok->u.var;
         match(g_token);
-        dimvar = finddimvar(name);
+        dimvar = finddimvar(id);
         if (dimvar)
           {
             switch (dimvar->ndims)
@@ -1750,7 +2018,6 @@ static double factor(void)
   double answer = 0;
   FAR char *str;
   FAR char *end;
-  int len;
 
   switch (g_token)
     {
@@ -1761,7 +2028,7 @@ static double factor(void)
       break;
 
     case VALUE:
-      answer = getvalue(g_string, &len);
+      answer = g_tok->u.value;
       match(VALUE);
       break;
 
@@ -2088,10 +2355,8 @@ static double instr(void)
 static double variable(void)
 {
   FAR struct mb_variable_s *var;
-  char id[32];
-  int len;
+  int id = g_tok->u.var;
 
-  getid(g_string, id, &len);
   match(FLTID);
   var = findvariable(id);
   if (var)
@@ -2117,12 +2382,10 @@ static double variable(void)
 static double dimvariable(void)
 {
   FAR struct mb_dimvar_s *dimvar;
-  char id[32];
-  int len;
+  int id = g_tok->u.var;
   int index[5];
   FAR double *answer = NULL;
 
-  getid(g_string, id, &len);
   match(DIMFLTID);
   dimvar = finddimvar(id);
   if (!dimvar)
@@ -2194,53 +2457,143 @@ static double dimvariable(void)
 }
 
 /****************************************************************************
- * Name: findvariable
+ * Name: hashid
  *
  * Description:
- *   Find a scalar variable invariables list
- *   Params: id - id to get
- *   Returns: pointer to that entry, 0 on fail
+ *   Hash a variable id
+ *   Params: id - id to hash
+ *   Returns: the hash chain the id belongs to
+ *
+ ****************************************************************************/
+
+static int hashid(FAR const char *id)
+{
+  unsigned int hash = 5381;
+
+  while (*id)
+    {
+      hash = hash * 33 + (unsigned char)*id++;
+    }
+
+  return hash % HASHSIZE;
+}
+
+/****************************************************************************
+ * Name: internvar
+ *
+ * Description:
+ *   Look a scalar variable up by name, adding an undefined entry for it
+ *   if it is not in the table yet.
+ *   Params: id - id of the variable (including trailing $ for strings)
+ *   Returns: index of the entry, -1 if out of memory
  *
  ****************************************************************************/
 
-static FAR struct mb_variable_s *findvariable(FAR const char *id)
+static int internvar(FAR const char *id)
 {
+  FAR struct mb_variable_s *vars;
+  int hash = hashid(id);
   int i;
 
-  for (i = 0; i < g_nvariables; i++)
+  for (i = g_varhash[hash]; i >= 0; i = g_variables[i].next)
     {
       if (!strcmp(g_variables[i].id, id))
         {
-          return &g_variables[i];
+          return i;
         }
     }
 
-  return 0;
+  vars =
+    realloc(g_variables, (g_nvariables + 1) * sizeof(struct mb_variable_s));
+  if (!vars)
+    {
+      return -1;
+    }
+
+  g_variables = vars;
+  i = g_nvariables++;
+  strlcpy(g_variables[i].id, id, sizeof(g_variables[i].id));
+  g_variables[i].next = g_varhash[hash];
+  g_variables[i].defined = false;
+  g_variables[i].dval = 0.0;
+  g_variables[i].sval = NULL;
+  g_varhash[hash] = i;
+  return i;
 }
 
 /****************************************************************************
- * Name: finddimvar
+ * Name: interndimvar
  *
  * Description:
- *   Get a dimensioned array by name
- *   Params: id (includes opening parenthesis)
- *   Returns: pointer to array entry or 0 on fail
+ *   Look a dimensioned array up by name, adding an undefined entry for it
+ *   if it is not in the table yet.
+ *   Params: id - id of the array (include leading ()
+ *   Returns: index of the entry, -1 if out of memory
  *
  ****************************************************************************/
 
-static struct mb_dimvar_s *finddimvar(FAR const char *id)
+static int interndimvar(FAR const char *id)
 {
+  FAR struct mb_dimvar_s *vars;
+  int hash = hashid(id);
   int i;
 
-  for (i = 0; i < g_ndimvariables; i++)
+  for (i = g_dimhash[hash]; i >= 0; i = g_dimvariables[i].next)
     {
       if (!strcmp(g_dimvariables[i].id, id))
         {
-          return &g_dimvariables[i];
+          return i;
         }
     }
 
-  return 0;
+  vars = realloc(g_dimvariables,
+                 (g_ndimvariables + 1) * sizeof(struct mb_dimvar_s));
+  if (!vars)
+    {
+      return -1;
+    }
+
+  g_dimvariables = vars;
+  i = g_ndimvariables++;
+  strlcpy(g_dimvariables[i].id, id, sizeof(g_dimvariables[i].id));
+  g_dimvariables[i].next    = g_dimhash[hash];
+  g_dimvariables[i].defined = false;
+  g_dimvariables[i].type    = strchr(id, '$') ? STRID : FLTID;
+  g_dimvariables[i].ndims   = 0;
+  g_dimvariables[i].dval    = NULL;
+  g_dimvariables[i].str     = NULL;
+  g_dimhash[hash] = i;
+  return i;
+}
+
+/****************************************************************************
+ * Name: findvariable
+ *
+ * Description:
+ *   Find a scalar variable invariables list
+ *   Params: var - slot of the variable
+ *   Returns: pointer to that entry, 0 if the script has not created it
+ *
+ ****************************************************************************/
+
+static FAR struct mb_variable_s *findvariable(int var)
+{
+  return g_variables[var].defined ? &g_variables[var] : 0;
+}
+
+/****************************************************************************
+ * Name: finddimvar
+ *
+ * Description:
+ *   Get a dimensioned array
+ *   Params: var - slot of the array
+ *   Returns: pointer to array entry or 0 if the script has not DIMed it
+ *
+ ****************************************************************************/
+
+static struct mb_dimvar_s *finddimvar(int var)
+{
+  return g_dimvariables[var].defined ? &g_dimvariables[var] : 0;
 }
 
 /****************************************************************************
@@ -2248,13 +2601,13 @@ static struct mb_dimvar_s *finddimvar(FAR const char *id)
  *
  * Description:
  *   Dimension an array.
- *   Params: id - the id of the array (include leading ()
+ *   Params: var - slot of the array
  *           ndims - number of dimension (1-5)
  *         ... - integers giving dimension size,
  *
  ****************************************************************************/
 
-static FAR struct mb_dimvar_s *dimension(FAR const char *id, int ndims, ...)
+static FAR struct mb_dimvar_s *dimension(int var, int ndims, ...)
 {
   FAR struct mb_dimvar_s *dv;
   va_list vargs;
@@ -2271,10 +2624,10 @@ static FAR struct mb_dimvar_s *dimension(FAR const char *id, int ndims, ...)
       return 0;
     }
 
-  dv = finddimvar(id);
+  dv = finddimvar(var);
   if (!dv)
     {
-      dv = adddimvar(id);
+      dv = adddimvar(var);
     }
 
   if (!dv)
@@ -2481,71 +2834,21 @@ static FAR void *getdimvar(FAR struct mb_dimvar_s *dv, ...)
 }
 
 /****************************************************************************
- * Name: addfloat
+ * Name: addvariable
  *
  * Description:
- *   Add a real variable to our variable list
- *   Params: id - id of variable to add.
+ *   Add a real or string variable to our variable list
+ *   Params: var - slot of variable to add.
  *   Returns: pointer to new entry in table
  *
  ****************************************************************************/
 
-static FAR struct mb_variable_s *addfloat(FAR const char *id)
-{
-  FAR struct mb_variable_s *vars;
-
-  vars =
-    realloc(g_variables, (g_nvariables + 1) * sizeof(struct mb_variable_s));
-  if (vars)
-    {
-      g_variables = vars;
-      strlcpy(g_variables[g_nvariables].id, id,
-              sizeof(g_variables[g_nvariables].id));
-      g_variables[g_nvariables].dval = 0.0;
-      g_variables[g_nvariables].sval = NULL;
-      g_nvariables++;
-      return &g_variables[g_nvariables - 1];
-    }
-  else
-    {
-      seterror(ERR_OUTOFMEMORY);
-    }
-
-  return 0;
-}
-
-/****************************************************************************
- * Name: addstring
- *
- * Description:
- *   Add a string variable to table.
- *   Params: id - id of variable to get (including trailing $)
- *   Returns: pointer to new entry in table, 0 on fail.
- *
- ****************************************************************************/
-
-static FAR struct mb_variable_s *addstring(FAR const char *id)
+static FAR struct mb_variable_s *addvariable(int var)
 {
-  FAR struct mb_variable_s *vars;
-
-  vars =
-    realloc(g_variables, (g_nvariables + 1) * sizeof(struct mb_variable_s));
-  if (vars)
-    {
-      g_variables = vars;
-      strlcpy(g_variables[g_nvariables].id, id,
-              sizeof(g_variables[g_nvariables].id));
-      g_variables[g_nvariables].sval = NULL;
-      g_variables[g_nvariables].dval = 0.0;
-      g_nvariables++;
-      return &g_variables[g_nvariables - 1];
-    }
-  else
-    {
-      seterror(ERR_OUTOFMEMORY);
-    }
-
-  return 0;
+  g_variables[var].defined = true;
+  g_variables[var].dval = 0.0;
+  g_variables[var].sval = NULL;
+  return &g_variables[var];
 }
 
 /****************************************************************************
@@ -2553,35 +2856,18 @@ static FAR struct mb_variable_s *addstring(FAR const char *id)
  *
  * Description:
  *   Add a new array to our symbol table.
- *   Params: id - id of array (include leading ()
- *   Returns: pointer to new entry, 0 on fail.
+ *   Params: var - slot of array
+ *   Returns: pointer to new entry
  *
  ****************************************************************************/
 
-static FAR struct mb_dimvar_s *adddimvar(FAR const char *id)
+static FAR struct mb_dimvar_s *adddimvar(int var)
 {
-  FAR struct mb_dimvar_s *vars;
-
-  vars = realloc(g_dimvariables,
-                 (g_ndimvariables + 1) * sizeof(struct mb_dimvar_s));
-  if (vars)
-    {
-      g_dimvariables = vars;
-      strlcpy(g_dimvariables[g_ndimvariables].id, id,
-              sizeof(g_dimvariables[g_ndimvariables].id));
-      g_dimvariables[g_ndimvariables].dval  = NULL;
-      g_dimvariables[g_ndimvariables].str   = NULL;
-      g_dimvariables[g_ndimvariables].ndims = 0;
-      g_dimvariables[g_ndimvariables].type = strchr(id, '$') ? STRID : FLTID;
-      g_ndimvariables++;
-      return &g_dimvariables[g_ndimvariables - 1];
-    }
-  else
-    {
-      seterror(ERR_OUTOFMEMORY);
-    }
-
-  return 0;
+  g_dimvariables[var].defined = true;
+  g_dimvariables[var].dval  = NULL;
+  g_dimvariables[var].str   = NULL;
+  g_dimvariables[var].ndims = 0;
+  return &g_dimvariables[var];
 }
 
 /****************************************************************************
@@ -2982,13 +3268,11 @@ static FAR char *stringstring(void)
 
 static FAR char *stringdimvar(void)
 {
-  char id[32];
-  int len;
+  int id = g_tok->u.var;
   FAR struct mb_dimvar_s *dimvar;
   FAR char **answer = NULL;
   int index[5];
 
-  getid(g_string, id, &len);
   match(DIMSTRID);
   dimvar = finddimvar(id);
 
@@ -3073,11 +3357,9 @@ static FAR char *stringdimvar(void)
 
 static FAR char *stringvar(void)
 {
-  char id[32];
-  int len;
+  int id = g_tok->u.var;
   FAR struct mb_variable_s *var;
 
-  getid(g_string, id, &len);
   match(STRID);
   var = findvariable(id);
   if (var)
@@ -3107,31 +3389,21 @@ static FAR char *stringvar(void)
 
 static FAR char *stringliteral(void)
 {
-  int len = 1;
   FAR char *answer = 0;
   FAR char *temp;
   FAR char *substr;
-  FAR char *end;
 
   while (g_token == QUOTE)
     {
-      while (isspace(*g_string))
+      if (g_tok->u.str)
         {
-          g_string++;
-        }
-
-      end = mystrend(g_string, '"');
-      if (end)
-        {
-          len = end - g_string;
-          substr = malloc(len);
+          substr = mystrdup(g_tok->u.str);
           if (!substr)
             {
               seterror(ERR_OUTOFMEMORY);
               return answer;
             }
 
-          mystrgrablit(substr, g_string);
           if (answer)
             {
               temp = mystrconcat(answer, substr);
@@ -3148,8 +3420,6 @@ static FAR char *stringliteral(void)
             {
               answer = substr;
             }
-
-          g_string = end;
         }
       else
         {
@@ -3203,13 +3473,17 @@ static void match(int tok)
       return;
     }
 
-  while (isspace(*g_string))
+  if (g_tok->error)
+    {
+      seterror(g_tok->error);
+    }
+
+  if (g_token != EOS)
     {
-      g_string++;
+      g_tok++;
     }
 
-  g_string += tokenlen(g_string, g_token);
-  g_token = gettoken(g_string);
+  g_token = g_tok->type;
   if (g_token == SYNTAX_ERROR)
     {
       seterror(ERR_SYNTAX);
@@ -3234,42 +3508,6 @@ static void seterror(int errorcode)
     }
 }
 
-/****************************************************************************
- * Name: getnextline
- *
- * Description:
- *   Get the next line number
- *   Params: str - pointer to parse string
- *   Returns: line no of next line, 0 if end
- *   Notes: goes to newline, then finds
- *          first line starting with a digit.
- *
- ****************************************************************************/
-
-static int getnextline(FAR const char *str)
-{
-  while (*str)
-    {
-      while (*str && *str != '\n')
-        {
-          str++;
-        }
-
-      if (*str == 0)
-        {
-          return 0;
-        }
-
-      str++;
-      if (isdigit(*str))
-        {
-          return atoi(str);
-        }
-    }
-
-  return 0;
-}
-
 /****************************************************************************
  * Name: gettoken
  *
@@ -3828,14 +4066,16 @@ static double getvalue(FAR const char *str, FAR int *len)
  *   Params: str - string to search
  *           out - id output [32 chars max ]
  *         len - return pointer for id length
- *   Notes: triggers an error if id > 31 chars
- *          the id includes the $ and ( qualifiers.
+ *   Returns: 0, or ERR_IDTOOLONG if id > 31 chars
+ *   Notes: the id includes the $ and ( qualifiers.
  *
  ****************************************************************************/
 
-static void getid(FAR const char *str, FAR char *out, FAR int *len)
+static int getid(FAR const char *str, FAR char *out, FAR int *len)
 {
+  int error = 0;
   int nread = 0;
+
   while (isspace(*str))
     {
       str++;
@@ -3850,7 +4090,7 @@ static void getid(FAR const char *str, FAR char *out, FAR int *len)
         }
       else
         {
-          seterror(ERR_IDTOOLONG);
+          error = ERR_IDTOOLONG;
           break;
         }
     }
@@ -3863,7 +4103,7 @@ static void getid(FAR const char *str, FAR char *out, FAR int *len)
         }
       else
         {
-          seterror(ERR_IDTOOLONG);
+          error = ERR_IDTOOLONG;
         }
     }
 
@@ -3875,12 +4115,13 @@ static void getid(FAR const char *str, FAR char *out, FAR int *len)
         }
       else
         {
-          seterror(ERR_IDTOOLONG);
+          error = ERR_IDTOOLONG;
         }
     }
 
   out[nread] = 0;
   *len = nread;
+  return error;
 }
 
 /****************************************************************************
@@ -4097,9 +4338,10 @@ int basic(FAR const char *script, FILE * in, FILE * out, FILE * err)
 
   while (curline != -1)
     {
-      g_string = g_lines[curline].str;
-      g_token = gettoken(g_string);
+      g_tok = &g_tokens[g_lines[curline].tok];
+      g_token = g_tok->type;
       g_errorflag = 0;
+      g_jumpline = -1;
 
       nextline = line();
       if (g_errorflag)
@@ -4122,7 +4364,19 @@ int basic(FAR const char *script, FILE * in, FILE * out, FILE * err)
         }
       else
         {
-          curline = findline(nextline);
+          /* Statements that know the index of the line they jump to leave
+           * it in g_jumpline; anything computed is searched for.
+           */
+
+          if (g_jumpline >= 0 && g_lines[g_jumpline].no == nextline)
+            {
+              curline = g_jumpline;
+            }
+          else
+            {
+              curline = findline(nextline);
+            }
+
           if (curline == -1)
             {
               if (g_fperr)
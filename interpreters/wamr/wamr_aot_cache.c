@@ -0,0 +1,300 @@
+/****************************************************************************
+ * apps/interpreters/wamr/wamr_aot_cache.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <syslog.h>
+#include <unistd.h>
+
+#include "wamr_aot_cache.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* 64-bit FNV-1a, the key tools/Wasm/wamr_cache.py names the images by */
+
+#define CACHE_FNV_OFFSET  UINT64_C(0xcbf29ce484222325)
+#define CACHE_FNV_PRIME   UINT64_C(0x00000100000001b3)
+
+/* Images start with the AOT magic "\0aot" and a 32-bit version */
+
+#define CACHE_AOT_HEADER  8
+
+#define CACHE_ENTRIES     CONFIG_INTERPRETERS_WAMR_AOT_CACHE_ENTRIES
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct wamr_cache_s
+{
+  uint64_t key;          /* Hash of the bytecode the image was built from */
+  wasm_module_t module;  /* Module loaded from the image */
+  FAR void *image;       /* Mapped or read image, kept until unloaded */
+  size_t size;           /* Image size in bytes */
+  bool mapped;           /* image is a mapping rather than a heap copy */
+  int refs;              /* Callers holding module, 0 if the slot is free */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct wamr_cache_s g_cache[CACHE_ENTRIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cache_hash
+ ****************************************************************************/
+
+static uint64_t cache_hash(FAR const uint8_t *buf, uint32_t size)
+{
+  uint64_t hash = CACHE_FNV_OFFSET;
+  uint32_t i;
+
+  for (i = 0; i < size; i++)
+    {
+      hash ^= buf[i];
+      hash *= CACHE_FNV_PRIME;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: cache_release
+ ****************************************************************************/
+
+static void cache_release(FAR struct wamr_cache_s *entry)
+{
+  if (entry->mapped)
+    {
+      munmap(entry->image, entry->size);
+    }
+  else
+    {
+      free(entry->image);
+    }
+
+  memset(entry, 0, sizeof(*entry));
+}
+
+/****************************************************************************
+ * Name: cache_open
+ *
+ * Description:
+ *   Map the image stored under key into entry, or read it into the heap
+ *   where the filesystem cannot map files.  The AOT loader writes into
+ *   the buffer (it moves strings and terminates them in place), so the
+ *   mapping is private and writable, and the file is never modified.
+ *
+ ****************************************************************************/
+
+static int cache_open(FAR struct wamr_cache_s *entry, uint64_t key)
+{
+  char path[PATH_MAX];
+  FAR uint8_t *image;
+  struct stat st;
+  ssize_t nread;
+  size_t done;
+  int fd;
+
+  snprintf(path, sizeof(path), "%s/%016" PRIx64 ".aot",
+           CONFIG_INTERPRETERS_WAMR_AOT_CACHE_PATH, key);
+
+  fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    {
+      return -ENOENT;
+    }
+
+  if (fstat(fd, &st) < 0 || st.st_size < CACHE_AOT_HEADER ||
+      st.st_size > UINT32_MAX)
+    {
+      close(fd);
+      return -EINVAL;
+    }
+
+  entry->size = st.st_size;
+  entry->mapped = true;
+  image = mmap(NULL, entry->size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+               fd, 0);
+  if (image == MAP_FAILED)
+    {
+      entry->mapped = false;
+      image = malloc(entry->size);
+      if (image == NULL)
+        {
+          close(fd);
+          return -ENOMEM;
+        }
+
+      for (done = 0; done < entry->size; done += nread)
+        {
+          nread = read(fd, image + done, entry->size - done);
+          if (nread <= 0)
+            {
+              free(image);
+              close(fd);
+              return -EIO;
+            }
+        }
+    }
+
+  close(fd);
+  entry->image = image;
+
+  if (memcmp(image, "\0aot", 4) != 0)
+    {
+      cache_release(entry);
+      return -EINVAL;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wamr_cache_load
+ ****************************************************************************/
+
+wasm_module_t wamr_cache_load(uint8_t *buf, uint32_t size,
+                              char *error_buf, uint32_t error_buf_size)
+{
+  FAR struct wamr_cache_s *entry = NULL;
+  wasm_module_t module = NULL;
+  uint64_t key;
+  int i;
+
+  /* AOT and XIP files are loaded as they are */
+
+  if (size < 4 || memcmp(buf, "\0asm", 4) != 0)
+    {
+      return wasm_runtime_load(buf, size, error_buf, error_buf_size);
+    }
+
+  key = cache_hash(buf, size);
+
+  pthread_mutex_lock(&g_cache_lock);
+
+  for (i = 0; i < CACHE_ENTRIES; i++)
+    {
+      if (g_cache[i].refs > 0 && g_cache[i].key == key)
+        {
+          g_cache[i].refs++;
+          module = g_cache[i].module;
+          goto out;
+        }
+
+      if (g_cache[i].refs == 0 && entry == NULL)
+        {
+          entry = &g_cache[i];
+        }
+    }
+
+  if (entry == NULL || cache_open(entry, key) < 0)
+    {
+      goto out;
+    }
+
+  /* A stale image, or one built by another wamrc version or for another
+   * target, fails to load; run the bytecode then.
+   */
+
+  entry->module = wasm_runtime_load(entry->image, entry->size,
+                                    error_buf, error_buf_size);
+  if (entry->module == NULL)
+    {
+      syslog(LOG_WARNING, "wamr: AOT cache %016" PRIx64 " unusable: %s\n",
+             key, error_buf);
+      cache_release(entry);
+      goto out;
+    }
+
+  entry->key = key;
+  entry->refs = 1;
+  module = entry->module;
+
+out:
+  pthread_mutex_unlock(&g_cache_lock);
+
+  if (module == NULL)
+    {
+      module = wasm_runtime_load(buf, size, error_buf, error_buf_size);
+    }
+
+  return module;
+}
+
+/****************************************************************************
+ * Name: wamr_cache_unload
+ ****************************************************************************/
+
+void wamr_cache_unload(wasm_module_t module)
+{
+  int i;
+
+  pthread_mutex_lock(&g_cache_lock);
+
+  for (i = 0; i < CACHE_ENTRIES; i++)
+    {
+      if (g_cache[i].refs > 0 && g_cache[i].module == module)
+        {
+          if (--g_cache[i].refs == 0)
+            {
+              wasm_runtime_unload(module);
+              cache_release(&g_cache[i]);
+            }
+
+          pthread_mutex_unlock(&g_cache_lock);
+          return;
+        }
+    }
+
+  pthread_mutex_unlock(&g_cache_lock);
+  wasm_runtime_unload(module);
+}
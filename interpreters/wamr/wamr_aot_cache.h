@@ -0,0 +1,79 @@
+/****************************************************************************
+ * apps/interpreters/wamr/wamr_aot_cache.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_INTERPRETERS_WAMR_WAMR_AOT_CACHE_H
+#define __APPS_INTERPRETERS_WAMR_WAMR_AOT_CACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+
+#include "wasm_export.h"
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: wamr_cache_load
+ *
+ * Description:
+ *   Drop-in replacement for wasm_runtime_load().  For a bytecode module,
+ *   look up the AOT image that the build stored in
+ *   CONFIG_INTERPRETERS_WAMR_AOT_CACHE_PATH under the hash of the module
+ *   content, and load the mapped image instead of the bytecode.  Modules
+ *   loaded from the cache are shared by every caller that loads the same
+ *   content until the last one unloads it.  Without a usable image the
+ *   bytecode is loaded as usual.
+ *
+ ****************************************************************************/
+
+wasm_module_t wamr_cache_load(uint8_t *buf, uint32_t size,
+                              char *error_buf, uint32_t error_buf_size);
+
+/****************************************************************************
+ * Name: wamr_cache_unload
+ *
+ * Description:
+ *   Drop-in replacement for wasm_runtime_unload(), releasing a module
+ *   returned by wamr_cache_load().
+ *
+ ****************************************************************************/
+
+void wamr_cache_unload(wasm_module_t module);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APPS_INTERPRETERS_WAMR_WAMR_AOT_CACHE_H */
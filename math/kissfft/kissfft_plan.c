@@ -0,0 +1,810 @@
+/****************************************************************************
+ * apps/math/kissfft/kissfft_plan.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <math/kissfft_plan.h>
+
+#include "kiss_fft.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The butterflies work on two complex numbers per 128-bit vector.  GCC
+ * vector extensions are only worth it with a float vector unit; without
+ * one they are lowered to the same scalar code, so the loops below are
+ * used instead.
+ */
+
+#if defined(CONFIG_MATH_KISSFFT_PLAN_SIMD) && defined(__GNUC__) && \
+    (defined(__SSE2__) || defined(__ARM_NEON) || \
+     (defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 2)))
+#  define KISSFFT_PLAN_VECTOR
+#endif
+
+#ifdef KISSFFT_PLAN_VECTOR
+#  ifdef __clang__
+#    define VSHUF(a, i0, i1, i2, i3) \
+       __builtin_shufflevector(a, a, i0, i1, i2, i3)
+#  else
+#    define VSHUF(a, i0, i1, i2, i3) \
+       __builtin_shuffle(a, (v4si_t){i0, i1, i2, i3})
+#  endif
+#endif
+
+/* Floats per radix-4 twiddle factor.  The vector butterflies keep the
+ * real part and the signed imaginary part of a factor spread over whole
+ * vectors, so that a complex multiply takes a single shuffle.
+ */
+
+#ifdef KISSFFT_PLAN_VECTOR
+#  define PLAN_TWLEN   4
+#else
+#  define PLAN_TWLEN   2
+#endif
+
+/* Longest radix-4 transform, the bit reversal table holds 16-bit indices */
+
+#define PLAN_POW2_MAX  65536
+
+/* Offsets of the plan parts, in one allocation */
+
+#define PLAN_ALIGN(x)  (((x) + 15) & ~(size_t)15)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef KISSFFT_PLAN_VECTOR
+/* Two interleaved complex numbers; buffers need only float alignment */
+
+typedef float v4sf_t __attribute__((vector_size(16), aligned(4)));
+typedef int32_t v4si_t __attribute__((vector_size(16)));
+#endif
+
+struct kissfft_plan_s
+{
+  FAR struct kissfft_plan_s *flink;
+  size_t nfft;                  /* Points, as requested */
+  size_t ncfft;                 /* Length of the complex transform */
+  int flags;
+  int crefs;                    /* Users, the plan is cached at zero */
+
+  /* Power-of-two lengths: w^j, w^2j and w^3j of every radix-4 stage but
+   * the last, and the index pairs swapped by the bit reversal.
+   */
+
+  FAR float *twiddles;
+  FAR uint16_t *swaps;
+  size_t nswaps;
+
+  /* Real transforms: the twiddles that split the half-length transform */
+
+  FAR kiss_fft_cpx *super;
+
+  /* Other lengths: kiss_fft, out of place through the scratch buffer */
+
+  kiss_fft_cfg cfg;
+  FAR kiss_fft_cpx *scratch;
+  pthread_mutex_t lock;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static pthread_mutex_t g_plan_lock = PTHREAD_MUTEX_INITIALIZER;
+static FAR struct kissfft_plan_s *g_plans;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: plan_twiddles
+ *
+ * Description:
+ *   Return the number of floats in the radix-4 twiddle table of a
+ *   power-of-two length n, and fill it in if tw is not NULL.
+ *
+ ****************************************************************************/
+
+static size_t plan_twiddles(size_t n, bool inverse, FAR float *tw)
+{
+  double sign = inverse ? 1.0 : -1.0;
+  size_t count = 0;
+  FAR float *w;
+  double phase;
+  size_t len;
+  size_t q;
+  size_t j;
+  int m;
+
+  /* The last stage, len 4 or 2, only has unit factors */
+
+  for (len = n; len >= 8; len /= 4)
+    {
+      q = len / 4;
+      for (m = 1; m <= 3 && tw != NULL; m++)
+        {
+          w = tw + count + (m - 1) * q * PLAN_TWLEN;
+          for (j = 0; j < q; j++)
+            {
+              phase = sign * 2.0 * M_PI * (double)(m * j) / len;
+
+#ifdef KISSFFT_PLAN_VECTOR
+              /* Pairs {r0, r0, r1, r1}, {-i0, i0, -i1, i1} */
+
+              w[(j & ~1) * 4 + (j & 1) * 2]     = (float)cos(phase);
+              w[(j & ~1) * 4 + (j & 1) * 2 + 1] = (float)cos(phase);
+              w[(j & ~1) * 4 + (j & 1) * 2 + 4] = (float)-sin(phase);
+              w[(j & ~1) * 4 + (j & 1) * 2 + 5] = (float)sin(phase);
+#else
+              w[2 * j]     = (float)cos(phase);
+              w[2 * j + 1] = (float)sin(phase);
+#endif
+            }
+        }
+
+      count += 3 * q * PLAN_TWLEN;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: plan_bitrev
+ *
+ * Description:
+ *   Return the number of swaps of the bit reversal permutation of n
+ *   points, and store their index pairs if swaps is not NULL.
+ *
+ ****************************************************************************/
+
+static size_t plan_bitrev(size_t n, FAR uint16_t *swaps)
+{
+  size_t count = 0;
+  size_t i;
+  size_t j;
+  size_t k;
+
+  for (i = 0, j = 0; i < n; i++)
+    {
+      if (i < j)
+        {
+          if (swaps != NULL)
+            {
+              swaps[2 * count]     = (uint16_t)i;
+              swaps[2 * count + 1] = (uint16_t)j;
+            }
+
+          count++;
+        }
+
+      for (k = n >> 1; k > 0 && (j & k) != 0; k >>= 1)
+        {
+          j ^= k;
+        }
+
+      j |= k;
+    }
+
+  return count;
+}
+
+/****************************************************************************
+ * Name: cmul
+ ****************************************************************************/
+
+static inline kiss_fft_cpx cmul(kiss_fft_cpx a, kiss_fft_cpx b)
+{
+  kiss_fft_cpx r;
+
+  r.r = a.r * b.r - a.i * b.i;
+  r.i = a.r * b.i + a.i * b.r;
+  return r;
+}
+
+/****************************************************************************
+ * Name: butterfly4
+ *
+ * Description:
+ *   The radix-4 butterfly on f[0], f[q], f[2q] and f[3q], before the
+ *   twiddle factors.  The outputs are stored in the order of two radix-2
+ *   decimation in frequency stages, so the transform ends with a plain bit
+ *   reversal whatever the number of radix-4 stages.
+ *
+ ****************************************************************************/
+
+static inline void butterfly4(FAR kiss_fft_cpx *f, size_t q, bool inverse)
+{
+  kiss_fft_cpx s02;
+  kiss_fft_cpx d02;
+  kiss_fft_cpx s13;
+  kiss_fft_cpx jd13;
+
+  s02.r = f[0].r + f[2 * q].r;
+  s02.i = f[0].i + f[2 * q].i;
+  d02.r = f[0].r - f[2 * q].r;
+  d02.i = f[0].i - f[2 * q].i;
+  s13.r = f[q].r + f[3 * q].r;
+  s13.i = f[q].i + f[3 * q].i;
+
+  /* -i (f1 - f3) forward, +i (f1 - f3) inverse */
+
+  if (inverse)
+    {
+      jd13.r = f[3 * q].i - f[q].i;
+      jd13.i = f[q].r - f[3 * q].r;
+    }
+  else
+    {
+      jd13.r = f[q].i - f[3 * q].i;
+      jd13.i = f[3 * q].r - f[q].r;
+    }
+
+  f[0].r     = s02.r + s13.r;
+  f[0].i     = s02.i + s13.i;
+  f[q].r     = s02.r - s13.r;
+  f[q].i     = s02.i - s13.i;
+  f[2 * q].r = d02.r + jd13.r;
+  f[2 * q].i = d02.i + jd13.i;
+  f[3 * q].r = d02.r - jd13.r;
+  f[3 * q].i = d02.i - jd13.i;
+}
+
+#ifdef KISSFFT_PLAN_VECTOR
+/****************************************************************************
+ * Name: vcmul
+ *
+ * Description:
+ *   Multiply two complex numbers by two twiddle factors laid out by
+ *   plan_twiddles().
+ *
+ ****************************************************************************/
+
+static inline v4sf_t vcmul(v4sf_t a, FAR const float *w)
+{
+  return a * *(FAR const v4sf_t *)w +
+         VSHUF(a, 1, 0, 3, 2) * *(FAR const v4sf_t *)(w + 4);
+}
+
+/****************************************************************************
+ * Name: radix4
+ *
+ * Description:
+ *   One radix-4 stage of quarter length q, two butterflies at a time.
+ *
+ ****************************************************************************/
+
+static void radix4(FAR kiss_fft_cpx *f, size_t n, size_t q,
+                   FAR const float *tw, bool inverse)
+{
+  const v4sf_t rot =
+    {
+      1.0f, -1.0f, 1.0f, -1.0f
+    };
+
+  v4sf_t irot = inverse ? -rot : rot;
+  FAR v4sf_t *p0;
+  FAR v4sf_t *p1;
+  FAR v4sf_t *p2;
+  FAR v4sf_t *p3;
+  v4sf_t s02;
+  v4sf_t d02;
+  v4sf_t s13;
+  v4sf_t jd13;
+  size_t base;
+  size_t j;
+
+  for (base = 0; base < n; base += 4 * q)
+    {
+      for (j = 0; j < q; j += 2)
+        {
+          p0 = (FAR v4sf_t *)&f[base + j];
+          p1 = (FAR v4sf_t *)&f[base + j + q];
+          p2 = (FAR v4sf_t *)&f[base + j + 2 * q];
+          p3 = (FAR v4sf_t *)&f[base + j + 3 * q];
+
+          s02  = *p0 + *p2;
+          d02  = *p0 - *p2;
+          s13  = *p1 + *p3;
+          jd13 = *p1 - *p3;
+          jd13 = VSHUF(jd13, 1, 0, 3, 2) * irot;
+
+          *p0 = s02 + s13;
+          *p1 = vcmul(s02 - s13, tw + 4 * (q + j));
+          *p2 = vcmul(d02 + jd13, tw + 4 * j);
+          *p3 = vcmul(d02 - jd13, tw + 4 * (2 * q + j));
+        }
+    }
+}
+#else
+/****************************************************************************
+ * Name: radix4
+ *
+ * Description:
+ *   One radix-4 stage of quarter length q.
+ *
+ ****************************************************************************/
+
+static void radix4(FAR kiss_fft_cpx *f, size_t n, size_t q,
+                   FAR const float *tw, bool inverse)
+{
+  FAR const kiss_fft_cpx *w = (FAR const kiss_fft_cpx *)tw;
+  FAR kiss_fft_cpx *x;
+  size_t base;
+  size_t j;
+
+  for (base = 0; base < n; base += 4 * q)
+    {
+      for (j = 0; j < q; j++)
+        {
+          x = &f[base + j];
+          butterfly4(x, q, inverse);
+
+          x[q]     = cmul(x[q], w[q + j]);
+          x[2 * q] = cmul(x[2 * q], w[j]);
+          x[3 * q] = cmul(x[3 * q], w[2 * q + j]);
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: plan_pow2
+ *
+ * Description:
+ *   In-place complex transform of a power-of-two length.
+ *
+ ****************************************************************************/
+
+static void plan_pow2(FAR struct kissfft_plan_s *plan,
+                      FAR kiss_fft_cpx *f)
+{
+  bool inverse = (plan->flags & KISSFFT_INVERSE) != 0;
+  FAR const uint16_t *swaps = plan->swaps;
+  FAR const float *tw = plan->twiddles;
+  size_t n = plan->ncfft;
+  kiss_fft_cpx t;
+  size_t len;
+  size_t i;
+
+  for (len = n; len >= 8; len /= 4)
+    {
+      radix4(f, n, len / 4, tw, inverse);
+      tw += 3 * (len / 4) * PLAN_TWLEN;
+    }
+
+  /* The last stage has unit twiddle factors: a radix-4 one, or a radix-2
+   * one for an odd number of radix-2 stages.
+   */
+
+  if (len == 4)
+    {
+      for (i = 0; i < n; i += 4)
+        {
+          butterfly4(&f[i], 1, inverse);
+        }
+    }
+  else if (len == 2)
+    {
+      for (i = 0; i < n; i += 2)
+        {
+          t = f[i + 1];
+          f[i + 1].r = f[i].r - t.r;
+          f[i + 1].i = f[i].i - t.i;
+          f[i].r += t.r;
+          f[i].i += t.i;
+        }
+    }
+
+  for (i = 0; i < plan->nswaps; i++, swaps += 2)
+    {
+      t = f[swaps[0]];
+      f[swaps[0]] = f[swaps[1]];
+      f[swaps[1]] = t;
+    }
+}
+
+/****************************************************************************
+ * Name: plan_complex
+ ****************************************************************************/
+
+static int plan_complex(FAR struct kissfft_plan_s *plan,
+                        FAR kiss_fft_cpx *f)
+{
+  int ret;
+
+  if (plan->cfg == NULL)
+    {
+      plan_pow2(plan, f);
+      return 0;
+    }
+
+  ret = pthread_mutex_lock(&plan->lock);
+  if (ret != 0)
+    {
+      return -ret;
+    }
+
+  kiss_fft(plan->cfg, f, plan->scratch);
+  memcpy(f, plan->scratch, plan->ncfft * sizeof(kiss_fft_cpx));
+  pthread_mutex_unlock(&plan->lock);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: plan_split
+ *
+ * Description:
+ *   Turn the transform of the even and odd samples, taken as one complex
+ *   signal, into the first half of the real spectrum, as kiss_fftr() does.
+ *   Bins k and ncfft - k only depend on each other, so this works in place.
+ *
+ ****************************************************************************/
+
+static void plan_split(FAR struct kissfft_plan_s *plan, FAR kiss_fft_cpx *f)
+{
+  size_t n = plan->ncfft;
+  kiss_fft_cpx fpk;
+  kiss_fft_cpx fpnk;
+  kiss_fft_cpx f1k;
+  kiss_fft_cpx tw;
+  float dc = f[0].r;
+  size_t k;
+
+  /* DC and Nyquist are real: pack them into the first bin */
+
+  f[0].r = dc + f[0].i;
+  f[0].i = dc - f[0].i;
+
+  for (k = 1; k <= n / 2; k++)
+    {
+      fpk = f[k];
+      fpnk.r = f[n - k].r;
+      fpnk.i = -f[n - k].i;
+
+      f1k.r = fpk.r + fpnk.r;
+      f1k.i = fpk.i + fpnk.i;
+      tw.r = fpk.r - fpnk.r;
+      tw.i = fpk.i - fpnk.i;
+      tw = cmul(tw, plan->super[k - 1]);
+
+      f[k].r = 0.5f * (f1k.r + tw.r);
+      f[k].i = 0.5f * (f1k.i + tw.i);
+      f[n - k].r = 0.5f * (f1k.r - tw.r);
+      f[n - k].i = 0.5f * (tw.i - f1k.i);
+    }
+}
+
+/****************************************************************************
+ * Name: plan_merge
+ *
+ * Description:
+ *   The inverse of plan_split(), as kiss_fftri() does it.
+ *
+ ****************************************************************************/
+
+static void plan_merge(FAR struct kissfft_plan_s *plan, FAR kiss_fft_cpx *f)
+{
+  size_t n = plan->ncfft;
+  kiss_fft_cpx fk;
+  kiss_fft_cpx fnkc;
+  kiss_fft_cpx fek;
+  kiss_fft_cpx fok;
+  float dc = f[0].r;
+  size_t k;
+
+  f[0].r = dc + f[0].i;
+  f[0].i = dc - f[0].i;
+
+  for (k = 1; k <= n / 2; k++)
+    {
+      fk = f[k];
+      fnkc.r = f[n - k].r;
+      fnkc.i = -f[n - k].i;
+
+      fek.r = fk.r + fnkc.r;
+      fek.i = fk.i + fnkc.i;
+      fok.r = fk.r - fnkc.r;
+      fok.i = fk.i - fnkc.i;
+      fok = cmul(fok, plan->super[k - 1]);
+
+      f[k].r = fek.r + fok.r;
+      f[k].i = fek.i + fok.i;
+      f[n - k].r = fek.r - fok.r;
+      f[n - k].i = fok.i - fek.i;
+    }
+}
+
+/****************************************************************************
+ * Name: plan_create
+ ****************************************************************************/
+
+static FAR struct kissfft_plan_s *plan_create(size_t nfft, int flags)
+{
+  FAR struct kissfft_plan_s *plan;
+  bool inverse = (flags & KISSFFT_INVERSE) != 0;
+  size_t ncfft = (flags & KISSFFT_REAL) != 0 ? nfft / 2 : nfft;
+  size_t ntwiddles = 0;
+  size_t nswaps = 0;
+  size_t nsuper = (flags & KISSFFT_REAL) != 0 ? ncfft / 2 : 0;
+  size_t cfglen = 0;
+  size_t offset;
+  size_t i;
+
+  if ((ncfft & (ncfft - 1)) == 0 && ncfft <= PLAN_POW2_MAX)
+    {
+      ntwiddles = plan_twiddles(ncfft, inverse, NULL);
+      nswaps = plan_bitrev(ncfft, NULL);
+    }
+  else
+    {
+      kiss_fft_alloc((int)ncfft, inverse, NULL, &cfglen);
+    }
+
+  offset = PLAN_ALIGN(sizeof(struct kissfft_plan_s));
+  plan = malloc(offset + PLAN_ALIGN(ntwiddles * sizeof(float)) +
+                PLAN_ALIGN(nswaps * 2 * sizeof(uint16_t)) +
+                PLAN_ALIGN(nsuper * sizeof(kiss_fft_cpx)) +
+                PLAN_ALIGN(cfglen) +
+                (cfglen != 0 ? ncfft * sizeof(kiss_fft_cpx) : 0));
+  if (plan == NULL)
+    {
+      return NULL;
+    }
+
+  memset(plan, 0, sizeof(struct kissfft_plan_s));
+  plan->nfft  = nfft;
+  plan->ncfft = ncfft;
+  plan->flags = flags;
+
+  if (ntwiddles != 0)
+    {
+      plan->twiddles = (FAR float *)((FAR char *)plan + offset);
+      plan_twiddles(ncfft, inverse, plan->twiddles);
+      offset += PLAN_ALIGN(ntwiddles * sizeof(float));
+    }
+
+  if (nswaps != 0)
+    {
+      plan->swaps = (FAR uint16_t *)((FAR char *)plan + offset);
+      plan->nswaps = plan_bitrev(ncfft, plan->swaps);
+      offset += PLAN_ALIGN(nswaps * 2 * sizeof(uint16_t));
+    }
+
+  if (nsuper != 0)
+    {
+      plan->super = (FAR kiss_fft_cpx *)((FAR char *)plan + offset);
+      for (i = 0; i < nsuper; i++)
+        {
+          double phase = -M_PI * ((double)(i + 1) / ncfft + 0.5);
+
+          if (inverse)
+            {
+              phase = -phase;
+            }
+
+          plan->super[i].r = (float)cos(phase);
+          plan->super[i].i = (float)sin(phase);
+        }
+
+      offset += PLAN_ALIGN(nsuper * sizeof(kiss_fft_cpx));
+    }
+
+  if (cfglen != 0)
+    {
+      plan->cfg = kiss_fft_alloc((int)ncfft, inverse,
+                                 (FAR char *)plan + offset, &cfglen);
+      plan->scratch = (FAR kiss_fft_cpx *)((FAR char *)plan + offset +
+                                           PLAN_ALIGN(cfglen));
+      pthread_mutex_init(&plan->lock, NULL);
+    }
+
+  return plan;
+}
+
+/****************************************************************************
+ * Name: plan_valid
+ *
+ * Description:
+ *   kiss_fft has butterflies for factors 2, 3, 4 and 5.  The generic one
+ *   would allocate a temporary buffer, which the port patches out.
+ *
+ ****************************************************************************/
+
+static bool plan_valid(size_t nfft, int flags)
+{
+  if (nfft == 0 || nfft > INT_MAX ||
+      (flags & ~(KISSFFT_INVERSE | KISSFFT_REAL)) != 0)
+    {
+      return false;
+    }
+
+  if ((flags & KISSFFT_REAL) != 0)
+    {
+      if ((nfft & 1) != 0)
+        {
+          return false;
+        }
+
+      nfft /= 2;
+    }
+
+  while (nfft % 2 == 0)
+    {
+      nfft /= 2;
+    }
+
+  while (nfft % 3 == 0)
+    {
+      nfft /= 3;
+    }
+
+  while (nfft % 5 == 0)
+    {
+      nfft /= 5;
+    }
+
+  return nfft == 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: kissfft_plan_get
+ ****************************************************************************/
+
+FAR struct kissfft_plan_s *kissfft_plan_get(size_t nfft, int flags)
+{
+  FAR struct kissfft_plan_s *plan;
+
+  if (!plan_valid(nfft, flags))
+    {
+      errno = EINVAL;
+      return NULL;
+    }
+
+  pthread_mutex_lock(&g_plan_lock);
+
+  for (plan = g_plans; plan != NULL; plan = plan->flink)
+    {
+      if (plan->nfft == nfft && plan->flags == flags)
+        {
+          break;
+        }
+    }
+
+  if (plan == NULL)
+    {
+      plan = plan_create(nfft, flags);
+      if (plan == NULL)
+        {
+          pthread_mutex_unlock(&g_plan_lock);
+          errno = ENOMEM;
+          return NULL;
+        }
+
+      plan->flink = g_plans;
+      g_plans = plan;
+    }
+
+  plan->crefs++;
+  pthread_mutex_unlock(&g_plan_lock);
+  return plan;
+}
+
+/****************************************************************************
+ * Name: kissfft_plan_put
+ ****************************************************************************/
+
+void kissfft_plan_put(FAR struct kissfft_plan_s *plan)
+{
+  if (plan != NULL)
+    {
+      pthread_mutex_lock(&g_plan_lock);
+      DEBUGASSERT(plan->crefs > 0);
+      plan->crefs--;
+      pthread_mutex_unlock(&g_plan_lock);
+    }
+}
+
+/****************************************************************************
+ * Name: kissfft_plan_flush
+ ****************************************************************************/
+
+void kissfft_plan_flush(void)
+{
+  FAR struct kissfft_plan_s **prev;
+  FAR struct kissfft_plan_s *plan;
+
+  pthread_mutex_lock(&g_plan_lock);
+
+  for (prev = &g_plans; (plan = *prev) != NULL; )
+    {
+      if (plan->crefs == 0)
+        {
+          *prev = plan->flink;
+          if (plan->cfg != NULL)
+            {
+              pthread_mutex_destroy(&plan->lock);
+            }
+
+          free(plan);
+        }
+      else
+        {
+          prev = &plan->flink;
+        }
+    }
+
+  pthread_mutex_unlock(&g_plan_lock);
+}
+
+/****************************************************************************
+ * Name: kissfft_plan_exec
+ ****************************************************************************/
+
+int kissfft_plan_exec(FAR struct kissfft_plan_s *plan, FAR float *buf)
+{
+  FAR kiss_fft_cpx *f = (FAR kiss_fft_cpx *)buf;
+  int ret;
+
+  DEBUGASSERT(plan != NULL && buf != NULL);
+
+  switch (plan->flags)
+    {
+      case KISSFFT_REAL | KISSFFT_FORWARD:
+        ret = plan_complex(plan, f);
+        if (ret >= 0)
+          {
+            plan_split(plan, f);
+          }
+
+        return ret;
+
+      case KISSFFT_REAL | KISSFFT_INVERSE:
+        plan_merge(plan, f);
+        return plan_complex(plan, f);
+
+      default:
+        return plan_complex(plan, f);
+    }
+}
@@ -0,0 +1,200 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_avgpool_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Channels summed per pass over the pooling window */
+
+#define POOL_CH_BLOCK 64
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Add one window position to the channel sums: sum[i] += src[i] */
+
+static void avgpool_tap_s8(int32_t *sum, const int8_t *src, int32_t count)
+{
+  int32_t i = 0;
+
+#if defined(__AVX2__)
+  for (; i + 16 <= count; i += 16)
+    {
+      __m256i lo = _mm256_cvtepi8_epi32(
+          _mm_loadl_epi64((const __m128i *)(src + i)));
+      __m256i hi = _mm256_cvtepi8_epi32(
+          _mm_loadl_epi64((const __m128i *)(src + i + 8)));
+
+      lo = _mm256_add_epi32(lo,
+          _mm256_loadu_si256((const __m256i *)(sum + i)));
+      hi = _mm256_add_epi32(hi,
+          _mm256_loadu_si256((const __m256i *)(sum + i + 8)));
+      _mm256_storeu_si256((__m256i *)(sum + i), lo);
+      _mm256_storeu_si256((__m256i *)(sum + i + 8), hi);
+    }
+#elif defined(__SSE2__)
+  for (; i + 8 <= count; i += 8)
+    {
+      __m128i in = _mm_loadl_epi64((const __m128i *)(src + i));
+      __m128i lo;
+      __m128i hi;
+
+      in = _mm_unpacklo_epi8(in, in);
+      lo = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 24);
+      hi = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 24);
+
+      lo = _mm_add_epi32(lo, _mm_loadu_si128((const __m128i *)(sum + i)));
+      hi = _mm_add_epi32(hi,
+          _mm_loadu_si128((const __m128i *)(sum + i + 4)));
+      _mm_storeu_si128((__m128i *)(sum + i), lo);
+      _mm_storeu_si128((__m128i *)(sum + i + 4), hi);
+    }
+#endif
+
+  for (; i < count; i++)
+    {
+      sum[i] += src[i];
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* s8 average pooling function.
+ *
+ * Refer header file for details.  Replaces the scalar reference kernel on
+ * targets without the Arm DSP/MVE extensions: the channels of one output
+ * pixel are summed side by side instead of walking the window once per
+ * channel.  Rounding matches the reference exactly.
+ */
+
+arm_cmsis_nn_status arm_avgpool_s8(const cmsis_nn_context *ctx,
+                                   const cmsis_nn_pool_params *pool_params,
+                                   const cmsis_nn_dims *input_dims,
+                                   const int8_t *src,
+                                   const cmsis_nn_dims *filter_dims,
+                                   const cmsis_nn_dims *output_dims,
+                                   int8_t *dst)
+{
+  const int32_t input_y = input_dims->h;
+  const int32_t input_x = input_dims->w;
+  const int32_t output_y = output_dims->h;
+  const int32_t output_x = output_dims->w;
+  const int32_t stride_y = pool_params->stride.h;
+  const int32_t stride_x = pool_params->stride.w;
+  const int32_t kernel_y = filter_dims->h;
+  const int32_t kernel_x = filter_dims->w;
+  const int32_t pad_y = pool_params->padding.h;
+  const int32_t pad_x = pool_params->padding.w;
+  const int32_t act_min = pool_params->activation.min;
+  const int32_t act_max = pool_params->activation.max;
+  const int32_t ch_src = input_dims->c;
+  int32_t batch_cnt = input_dims->n;
+  int32_t sum[POOL_CH_BLOCK];
+
+  (void)ctx;
+
+  if (batch_cnt < 1)
+    {
+      return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+  while (batch_cnt)
+    {
+      for (int32_t i_y = 0; i_y < output_y; i_y++)
+        {
+          const int32_t idx_y = i_y * stride_y - pad_y;
+          const int32_t k_y_start = MAX(0, -idx_y);
+          const int32_t k_y_end = MIN(kernel_y, input_y - idx_y);
+
+          for (int32_t i_x = 0; i_x < output_x; i_x++)
+            {
+              const int32_t idx_x = i_x * stride_x - pad_x;
+              const int32_t k_x_start = MAX(0, -idx_x);
+              const int32_t k_x_end = MIN(kernel_x, input_x - idx_x);
+              const int32_t count = (k_y_end - k_y_start) *
+                                    (k_x_end - k_x_start);
+
+              /* Prevent static code issue DIVIDE_BY_ZERO. */
+
+              if (k_y_end <= k_y_start || k_x_end <= k_x_start)
+                {
+                  return ARM_CMSIS_NN_ARG_ERROR;
+                }
+
+              for (int32_t ch = 0; ch < ch_src; ch += POOL_CH_BLOCK)
+                {
+                  const int32_t block = MIN(POOL_CH_BLOCK, ch_src - ch);
+                  int32_t i;
+
+                  for (i = 0; i < block; i++)
+                    {
+                      sum[i] = 0;
+                    }
+
+                  for (int32_t k_y = k_y_start; k_y < k_y_end; k_y++)
+                    {
+                      for (int32_t k_x = k_x_start; k_x < k_x_end; k_x++)
+                        {
+                          avgpool_tap_s8(sum, src + ch + ch_src *
+                                         (k_x + idx_x +
+                                          (idx_y + k_y) * input_x),
+                                         block);
+                        }
+                    }
+
+                  for (i = 0; i < block; i++)
+                    {
+                      int32_t avg = sum[i] > 0 ?
+                                    (sum[i] + count / 2) / count :
+                                    (sum[i] - count / 2) / count;
+
+                      avg = MAX(avg, act_min);
+                      avg = MIN(avg, act_max);
+                      dst[ch + i] = (int8_t)avg;
+                    }
+                }
+
+              dst += ch_src;
+            }
+        }
+
+      src += input_y * input_x * ch_src;
+      batch_cnt--;
+    }
+
+  return ARM_CMSIS_NN_SUCCESS;
+}
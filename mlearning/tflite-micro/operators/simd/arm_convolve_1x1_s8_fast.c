@@ -0,0 +1,63 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_convolve_1x1_s8_fast.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Fast s8 version for 1x1 convolution (non-square shape).
+ *
+ * Refer header file for details.  The wrapper picks this kernel for the
+ * pointwise layers; route it to arm_convolve_s8(), which reads the input
+ * pixels in place for them and splits large layers across threads.
+ */
+
+arm_cmsis_nn_status
+arm_convolve_1x1_s8_fast(const cmsis_nn_context *ctx,
+                         const cmsis_nn_conv_params *conv_params,
+                         const cmsis_nn_per_channel_quant_params *quant_params,
+                         const cmsis_nn_dims *input_dims,
+                         const int8_t *input_data,
+                         const cmsis_nn_dims *filter_dims,
+                         const int8_t *filter_data,
+                         const cmsis_nn_dims *bias_dims,
+                         const int32_t *bias_data,
+                         const cmsis_nn_dims *output_dims,
+                         int8_t *output_data)
+{
+  if (conv_params->padding.w != 0 || conv_params->padding.h != 0 ||
+      conv_params->stride.w != 1 || conv_params->stride.h != 1)
+    {
+      return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+  return arm_convolve_s8(ctx, conv_params, quant_params, input_dims,
+                         input_data, filter_dims, filter_data, bias_dims,
+                         bias_data, output_dims, output_data);
+}
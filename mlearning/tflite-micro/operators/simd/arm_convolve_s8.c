@@ -0,0 +1,360 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_convolve_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdbool.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include "tflm_parallel.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct conv_job_s
+{
+  const cmsis_nn_context *ctx;
+  const cmsis_nn_conv_params *conv_params;
+  const cmsis_nn_per_channel_quant_params *quant_params;
+  const cmsis_nn_dims *input_dims;
+  const int8_t *input;
+  const cmsis_nn_dims *filter_dims;
+  const int8_t *kernel;
+  const int32_t *bias;
+  const cmsis_nn_dims *output_dims;
+  int8_t *output;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* sum((lhs[i] + lhs_offset) * rhs[i]) for a pointwise filter, which reads
+ * the input pixel in place.
+ */
+
+static int32_t conv_dot_s8(const int8_t *lhs, const int8_t *rhs,
+                           int32_t count, int32_t lhs_offset)
+{
+  int32_t sum = 0;
+  int32_t i = 0;
+
+#if defined(__AVX2__)
+  const __m256i offset = _mm256_set1_epi16((int16_t)lhs_offset);
+  __m256i acc = _mm256_setzero_si256();
+  __m128i acc128;
+
+  for (; i + 16 <= count; i += 16)
+    {
+      __m256i a = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(lhs + i)));
+      __m256i b = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(rhs + i)));
+
+      acc = _mm256_add_epi32(acc,
+          _mm256_madd_epi16(_mm256_add_epi16(a, offset), b));
+    }
+
+  acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                         _mm256_extracti128_si256(acc, 1));
+  acc128 = _mm_add_epi32(acc128,
+      _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc128 = _mm_add_epi32(acc128,
+      _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(acc128);
+#elif defined(__SSE2__)
+  const __m128i offset = _mm_set1_epi16((int16_t)lhs_offset);
+  __m128i acc = _mm_setzero_si128();
+
+  for (; i + 8 <= count; i += 8)
+    {
+      __m128i a = _mm_loadl_epi64((const __m128i *)(lhs + i));
+      __m128i b = _mm_loadl_epi64((const __m128i *)(rhs + i));
+
+      a = _mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8);
+      b = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+      acc = _mm_add_epi32(acc,
+          _mm_madd_epi16(_mm_add_epi16(a, offset), b));
+    }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(acc);
+#endif
+
+  for (; i < count; i++)
+    {
+      sum += (lhs[i] + lhs_offset) * rhs[i];
+    }
+
+  return sum;
+}
+
+/* sum(col[i] * rhs[i]) for a column that already holds the offset input */
+
+static int32_t conv_dot_s16(const int16_t *col, const int8_t *rhs,
+                            int32_t count)
+{
+  int32_t sum = 0;
+  int32_t i = 0;
+
+#if defined(__AVX2__)
+  __m256i acc = _mm256_setzero_si256();
+  __m128i acc128;
+
+  for (; i + 16 <= count; i += 16)
+    {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(col + i));
+      __m256i b = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(rhs + i)));
+
+      acc = _mm256_add_epi32(acc, _mm256_madd_epi16(a, b));
+    }
+
+  acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                         _mm256_extracti128_si256(acc, 1));
+  acc128 = _mm_add_epi32(acc128,
+      _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc128 = _mm_add_epi32(acc128,
+      _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(acc128);
+#elif defined(__SSE2__)
+  __m128i acc = _mm_setzero_si128();
+
+  for (; i + 8 <= count; i += 8)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i *)(col + i));
+      __m128i b = _mm_loadl_epi64((const __m128i *)(rhs + i));
+
+      b = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(a, b));
+    }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(acc);
+#endif
+
+  for (; i < count; i++)
+    {
+      sum += col[i] * rhs[i];
+    }
+
+  return sum;
+}
+
+/* Compute the output rows [start, end), counted over all batches.  Filters
+ * larger than one pixel gather the window into an int16 column (im2col),
+ * in the context buffer for the caller and in the pool scratch buffer for
+ * the other threads.
+ */
+
+static void conv_rows(void *arg, int start, int end, int worker)
+{
+  const struct conv_job_s *job = arg;
+  const cmsis_nn_conv_params *conv_params = job->conv_params;
+  const int32_t input_x = job->input_dims->w;
+  const int32_t input_y = job->input_dims->h;
+  const int32_t input_ch = job->input_dims->c;
+  const int32_t kernel_x = job->filter_dims->w;
+  const int32_t kernel_y = job->filter_dims->h;
+  const int32_t output_x = job->output_dims->w;
+  const int32_t output_y = job->output_dims->h;
+  const int32_t output_ch = job->output_dims->c;
+  const int32_t pad_x = conv_params->padding.w;
+  const int32_t pad_y = conv_params->padding.h;
+  const int32_t stride_x = conv_params->stride.w;
+  const int32_t stride_y = conv_params->stride.h;
+  const int32_t dilation_x = conv_params->dilation.w;
+  const int32_t dilation_y = conv_params->dilation.h;
+  const int32_t input_offset = conv_params->input_offset;
+  const int32_t out_offset = conv_params->output_offset;
+  const int32_t act_min = conv_params->activation.min;
+  const int32_t act_max = conv_params->activation.max;
+  const int32_t *output_mult = job->quant_params->multiplier;
+  const int32_t *output_shift = job->quant_params->shift;
+  const int32_t rhs_cols = kernel_x * kernel_y * input_ch;
+  const bool pointwise = kernel_x == 1 && kernel_y == 1 &&
+                         pad_x == 0 && pad_y == 0;
+
+  int8_t *output = job->output + start * output_x * output_ch;
+  int16_t *col = worker == 0 ? job->ctx->buf :
+                               tflm_parallel_scratch(worker);
+  int32_t row;
+
+  for (row = start; row < end; row++)
+    {
+      const int32_t base_idx_y = (row % output_y) * stride_y - pad_y;
+      const int8_t *input = job->input +
+                            (row / output_y) * input_x * input_y * input_ch;
+
+      for (int32_t i_out_x = 0; i_out_x < output_x; i_out_x++)
+        {
+          const int32_t base_idx_x = i_out_x * stride_x - pad_x;
+          const int8_t *ker_ptr = job->kernel;
+          const int8_t *in_ptr = NULL;
+          int32_t i;
+
+          if (pointwise)
+            {
+              in_ptr = input + (base_idx_y * input_x + base_idx_x) *
+                       input_ch;
+            }
+          else
+            {
+              int16_t *dst = col;
+
+              for (int32_t i_ker_y = 0; i_ker_y < kernel_y; i_ker_y++)
+                {
+                  const int32_t idx_y = base_idx_y + dilation_y * i_ker_y;
+
+                  for (int32_t i_ker_x = 0; i_ker_x < kernel_x; i_ker_x++)
+                    {
+                      const int32_t idx_x = base_idx_x +
+                                            dilation_x * i_ker_x;
+                      const int8_t *src;
+
+                      /* Padding is zero once the offset is applied */
+
+                      if (idx_y < 0 || idx_y >= input_y ||
+                          idx_x < 0 || idx_x >= input_x)
+                        {
+                          for (i = 0; i < input_ch; i++)
+                            {
+                              dst[i] = 0;
+                            }
+                        }
+                      else
+                        {
+                          src = input + (idx_y * input_x + idx_x) *
+                                input_ch;
+                          for (i = 0; i < input_ch; i++)
+                            {
+                              dst[i] = (int16_t)(src[i] + input_offset);
+                            }
+                        }
+
+                      dst += input_ch;
+                    }
+                }
+            }
+
+          for (i = 0; i < output_ch; i++)
+            {
+              int32_t sum = pointwise ?
+                            conv_dot_s8(in_ptr, ker_ptr, rhs_cols,
+                                        input_offset) :
+                            conv_dot_s16(col, ker_ptr, rhs_cols);
+
+              if (job->bias)
+                {
+                  sum += job->bias[i];
+                }
+
+              sum = arm_nn_requantize(sum, output_mult[i], output_shift[i]);
+              sum += out_offset;
+              sum = MAX(sum, act_min);
+              sum = MIN(sum, act_max);
+              output[i] = (int8_t)sum;
+              ker_ptr += rhs_cols;
+            }
+
+          output += output_ch;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Basic s8 convolution function.
+ *
+ * Refer header file for details.  Replaces the scalar reference kernel on
+ * targets without the Arm DSP/MVE extensions.  The int16 im2col column
+ * needs only half of the arm_convolve_s8_get_buffer_size() buffer, and
+ * pointwise filters read the input in place without one.  Large layers
+ * are split by output row across the tflm_parallel threads.
+ */
+
+arm_cmsis_nn_status
+arm_convolve_s8(const cmsis_nn_context *ctx,
+                const cmsis_nn_conv_params *conv_params,
+                const cmsis_nn_per_channel_quant_params *quant_params,
+                const cmsis_nn_dims *input_dims,
+                const int8_t *input_data,
+                const cmsis_nn_dims *filter_dims,
+                const int8_t *filter_data,
+                const cmsis_nn_dims *bias_dims,
+                const int32_t *bias_data,
+                const cmsis_nn_dims *output_dims,
+                int8_t *output_data)
+{
+  struct conv_job_s job;
+  const int32_t rhs_cols = filter_dims->w * filter_dims->h *
+                           input_dims->c;
+  const int32_t rows = input_dims->n * output_dims->h;
+  uint64_t macs = (uint64_t)rows * output_dims->w * output_dims->c *
+                  rhs_cols;
+  bool pointwise = filter_dims->w == 1 && filter_dims->h == 1 &&
+                   conv_params->padding.w == 0 &&
+                   conv_params->padding.h == 0;
+
+  (void)bias_dims;
+
+  if (!pointwise && ctx->buf == NULL)
+    {
+      return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+  job.ctx = ctx;
+  job.conv_params = conv_params;
+  job.quant_params = quant_params;
+  job.input_dims = input_dims;
+  job.input = input_data;
+  job.filter_dims = filter_dims;
+  job.kernel = filter_data;
+  job.bias = bias_data;
+  job.output_dims = output_dims;
+  job.output = output_data;
+
+  if (!pointwise &&
+      tflm_parallel_reserve(rhs_cols * sizeof(int16_t)) < 0)
+    {
+      conv_rows(&job, 0, rows, 0);
+    }
+  else
+    {
+      tflm_parallel_for(rows, (uint32_t)MIN(macs, UINT32_MAX),
+                        conv_rows, &job);
+    }
+
+  return ARM_CMSIS_NN_SUCCESS;
+}
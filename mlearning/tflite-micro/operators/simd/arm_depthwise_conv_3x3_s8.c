@@ -0,0 +1,73 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_depthwise_conv_3x3_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Optimized s8 depthwise convolution function with constraint that
+ * in_channel equals out_channel and the kernel is 3x3.
+ *
+ * Refer header file for details.  The wrapper picks this kernel for most
+ * depthwise layers; without the Arm DSP extension the reference version is
+ * plain scalar code, so route it to the channel-vectorized generic kernel.
+ */
+
+arm_cmsis_nn_status
+arm_depthwise_conv_3x3_s8(const cmsis_nn_context *ctx,
+                          const cmsis_nn_dw_conv_params *dw_conv_params,
+                          const cmsis_nn_per_channel_quant_params *quant_params,
+                          const cmsis_nn_dims *input_dims,
+                          const int8_t *input,
+                          const cmsis_nn_dims *filter_dims,
+                          const int8_t *kernel,
+                          const cmsis_nn_dims *bias_dims,
+                          const int32_t *bias,
+                          const cmsis_nn_dims *output_dims,
+                          int8_t *output)
+{
+  /* Check input constraints input_ch == output_ch */
+
+  if (input_dims->c != output_dims->c)
+    {
+      return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+  /* Check input constraints pad_x <= 1 */
+
+  if (dw_conv_params->padding.w > 1 ||
+      filter_dims->w != 3 || filter_dims->h != 3)
+    {
+      return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+  return arm_depthwise_conv_s8(ctx, dw_conv_params, quant_params,
+                               input_dims, input, filter_dims, kernel,
+                               bias_dims, bias, output_dims, output);
+}
@@ -0,0 +1,295 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_depthwise_conv_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include "tflm_parallel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Output channels accumulated per pass over the filter window, bounded so
+ * that the accumulators fit on the stack (no scratch buffer is requested
+ * for the generic kernel).
+ */
+
+#define DW_CH_BLOCK 64
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct dw_job_s
+{
+  const cmsis_nn_dw_conv_params *dw_conv_params;
+  const cmsis_nn_per_channel_quant_params *quant_params;
+  const cmsis_nn_dims *input_dims;
+  const int8_t *input;
+  const cmsis_nn_dims *filter_dims;
+  const int8_t *kernel;
+  const int32_t *bias;
+  const cmsis_nn_dims *output_dims;
+  int8_t *output;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Accumulate one filter tap for a channel multiplier of 1:
+ *
+ *   acc[i] += (input[i] + input_offset) * filter[i]
+ *
+ * The input offset is the negated int8 zero point, so the offset input
+ * lies within [-255, 255] and its product with an int8 weight within
+ * int16, which lets the vector paths multiply 16-bit lanes.
+ */
+
+static void dw_tap_s8(int32_t *acc, const int8_t *input,
+                      const int8_t *filter, int32_t count,
+                      int32_t input_offset)
+{
+  int32_t i = 0;
+
+#if defined(__AVX2__)
+  const __m256i offset = _mm256_set1_epi16((int16_t)input_offset);
+
+  for (; i + 16 <= count; i += 16)
+    {
+      __m256i in = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(input + i)));
+      __m256i w = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(filter + i)));
+      __m256i prod = _mm256_mullo_epi16(_mm256_add_epi16(in, offset), w);
+      __m256i lo = _mm256_cvtepi16_epi32(_mm256_castsi256_si128(prod));
+      __m256i hi = _mm256_cvtepi16_epi32(
+          _mm256_extracti128_si256(prod, 1));
+
+      lo = _mm256_add_epi32(lo,
+          _mm256_loadu_si256((const __m256i *)(acc + i)));
+      hi = _mm256_add_epi32(hi,
+          _mm256_loadu_si256((const __m256i *)(acc + i + 8)));
+      _mm256_storeu_si256((__m256i *)(acc + i), lo);
+      _mm256_storeu_si256((__m256i *)(acc + i + 8), hi);
+    }
+#elif defined(__SSE2__)
+  const __m128i offset = _mm_set1_epi16((int16_t)input_offset);
+
+  for (; i + 8 <= count; i += 8)
+    {
+      __m128i in = _mm_loadl_epi64((const __m128i *)(input + i));
+      __m128i w = _mm_loadl_epi64((const __m128i *)(filter + i));
+      __m128i prod;
+      __m128i lo;
+      __m128i hi;
+
+      in = _mm_srai_epi16(_mm_unpacklo_epi8(in, in), 8);
+      w = _mm_srai_epi16(_mm_unpacklo_epi8(w, w), 8);
+      prod = _mm_mullo_epi16(_mm_add_epi16(in, offset), w);
+      lo = _mm_srai_epi32(_mm_unpacklo_epi16(prod, prod), 16);
+      hi = _mm_srai_epi32(_mm_unpackhi_epi16(prod, prod), 16);
+
+      lo = _mm_add_epi32(lo, _mm_loadu_si128((const __m128i *)(acc + i)));
+      hi = _mm_add_epi32(hi,
+          _mm_loadu_si128((const __m128i *)(acc + i + 4)));
+      _mm_storeu_si128((__m128i *)(acc + i), lo);
+      _mm_storeu_si128((__m128i *)(acc + i + 4), hi);
+    }
+#endif
+
+  for (; i < count; i++)
+    {
+      acc[i] += (input[i] + input_offset) * filter[i];
+    }
+}
+
+/* Compute the output rows [start, end), counted over all batches */
+
+static void dw_rows(void *arg, int start, int end, int worker)
+{
+  const struct dw_job_s *job = arg;
+  const cmsis_nn_dw_conv_params *dw_conv_params = job->dw_conv_params;
+  const int32_t input_x = job->input_dims->w;
+  const int32_t input_y = job->input_dims->h;
+  const int32_t input_ch = job->input_dims->c;
+  const int32_t kernel_x = job->filter_dims->w;
+  const int32_t kernel_y = job->filter_dims->h;
+  const int32_t output_x = job->output_dims->w;
+  const int32_t output_y = job->output_dims->h;
+  const int32_t output_ch = job->output_dims->c;
+  const int32_t ch_mult = dw_conv_params->ch_mult;
+  const int32_t pad_x = dw_conv_params->padding.w;
+  const int32_t pad_y = dw_conv_params->padding.h;
+  const int32_t stride_x = dw_conv_params->stride.w;
+  const int32_t stride_y = dw_conv_params->stride.h;
+  const int32_t dilation_x = dw_conv_params->dilation.w;
+  const int32_t dilation_y = dw_conv_params->dilation.h;
+  const int32_t input_offset = dw_conv_params->input_offset;
+  const int32_t output_offset = dw_conv_params->output_offset;
+  const int32_t act_min = dw_conv_params->activation.min;
+  const int32_t act_max = dw_conv_params->activation.max;
+  const int32_t *output_mult = job->quant_params->multiplier;
+  const int32_t *output_shift = job->quant_params->shift;
+  const int32_t *bias = job->bias;
+  const int8_t *kernel = job->kernel;
+
+  int8_t *output = job->output + start * output_x * output_ch;
+  int32_t acc[DW_CH_BLOCK];
+  int32_t row;
+
+  (void)worker;
+
+  for (row = start; row < end; row++)
+    {
+      const int32_t i_out_y = row % output_y;
+      const int32_t base_idx_y = i_out_y * stride_y - pad_y;
+      const int8_t *input = job->input +
+                            (row / output_y) * input_x * input_y * input_ch;
+
+      for (int32_t i_out_x = 0; i_out_x < output_x; i_out_x++)
+        {
+          const int32_t base_idx_x = i_out_x * stride_x - pad_x;
+
+          for (int32_t ch = 0; ch < output_ch; ch += DW_CH_BLOCK)
+            {
+              const int32_t count = MIN(DW_CH_BLOCK, output_ch - ch);
+              int32_t i;
+
+              for (i = 0; i < count; i++)
+                {
+                  acc[i] = bias ? bias[ch + i] : 0;
+                }
+
+              for (int32_t i_ker_y = 0; i_ker_y < kernel_y; i_ker_y++)
+                {
+                  const int32_t idx_y = base_idx_y + dilation_y * i_ker_y;
+
+                  if (idx_y < 0 || idx_y >= input_y)
+                    {
+                      continue;
+                    }
+
+                  for (int32_t i_ker_x = 0; i_ker_x < kernel_x; i_ker_x++)
+                    {
+                      const int32_t idx_x = base_idx_x +
+                                            dilation_x * i_ker_x;
+                      const int8_t *in_ptr;
+                      const int8_t *ker_ptr;
+
+                      if (idx_x < 0 || idx_x >= input_x)
+                        {
+                          continue;
+                        }
+
+                      in_ptr = input + (idx_y * input_x + idx_x) * input_ch;
+                      ker_ptr = kernel + (i_ker_y * kernel_x + i_ker_x) *
+                                output_ch + ch;
+
+                      if (ch_mult == 1)
+                        {
+                          dw_tap_s8(acc, in_ptr + ch, ker_ptr, count,
+                                    input_offset);
+                          continue;
+                        }
+
+                      for (i = 0; i < count; i++)
+                        {
+                          acc[i] += (in_ptr[(ch + i) / ch_mult] +
+                                     input_offset) * ker_ptr[i];
+                        }
+                    }
+                }
+
+              for (i = 0; i < count; i++)
+                {
+                  int32_t sum = arm_nn_requantize(acc[i],
+                                                  output_mult[ch + i],
+                                                  output_shift[ch + i]);
+                  sum += output_offset;
+                  sum = MAX(sum, act_min);
+                  sum = MIN(sum, act_max);
+                  output[ch + i] = (int8_t)sum;
+                }
+            }
+
+          output += output_ch;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* Basic s8 depthwise convolution function.
+ *
+ * Refer header file for details.  Replaces the scalar reference kernel on
+ * targets without the Arm DSP/MVE extensions: the output channels of one
+ * output pixel are accumulated side by side, which turns the innermost
+ * loop into contiguous, vectorizable int8 loads.  Requantization uses
+ * arm_nn_requantize() so results are bit-exact with the reference.  Large
+ * layers are split by output row across the tflm_parallel threads.
+ */
+
+arm_cmsis_nn_status
+arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
+                      const cmsis_nn_dw_conv_params *dw_conv_params,
+                      const cmsis_nn_per_channel_quant_params *quant_params,
+                      const cmsis_nn_dims *input_dims,
+                      const int8_t *input,
+                      const cmsis_nn_dims *filter_dims,
+                      const int8_t *kernel,
+                      const cmsis_nn_dims *bias_dims,
+                      const int32_t *bias,
+                      const cmsis_nn_dims *output_dims,
+                      int8_t *output)
+{
+  struct dw_job_s job;
+  int32_t rows = input_dims->n * output_dims->h;
+  uint64_t macs = (uint64_t)rows * output_dims->w * output_dims->c *
+                  filter_dims->w * filter_dims->h;
+
+  (void)ctx;
+  (void)bias_dims;
+
+  job.dw_conv_params = dw_conv_params;
+  job.quant_params = quant_params;
+  job.input_dims = input_dims;
+  job.input = input;
+  job.filter_dims = filter_dims;
+  job.kernel = kernel;
+  job.bias = bias;
+  job.output_dims = output_dims;
+  job.output = output;
+
+  tflm_parallel_for(rows, (uint32_t)MIN(macs, UINT32_MAX), dw_rows, &job);
+  return ARM_CMSIS_NN_SUCCESS;
+}
@@ -0,0 +1,216 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_fully_connected_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+#include "tflm_parallel.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct fc_job_s
+{
+  const cmsis_nn_fc_params *fc_params;
+  const cmsis_nn_per_tensor_quant_params *quant_params;
+  const int8_t *input;
+  const int8_t *kernel;
+  const int32_t *bias;
+  int8_t *output;
+  int32_t batches;
+  int32_t accum_depth;
+  int32_t output_depth;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* Dot product of one input vector and one weight row:
+ *
+ *   sum((lhs[i] + lhs_offset) * rhs[i])
+ *
+ * The offset input and the weights both fit in 16 bits, so the vector
+ * paths multiply-add 16-bit pairs straight into 32-bit lanes.
+ */
+
+static int32_t fc_dot_s8(const int8_t *lhs, const int8_t *rhs,
+                         int32_t count, int32_t lhs_offset)
+{
+  int32_t sum = 0;
+  int32_t i = 0;
+
+#if defined(__AVX2__)
+  const __m256i offset = _mm256_set1_epi16((int16_t)lhs_offset);
+  __m256i acc = _mm256_setzero_si256();
+  __m128i acc128;
+
+  for (; i + 16 <= count; i += 16)
+    {
+      __m256i a = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(lhs + i)));
+      __m256i b = _mm256_cvtepi8_epi16(
+          _mm_loadu_si128((const __m128i *)(rhs + i)));
+
+      acc = _mm256_add_epi32(acc,
+          _mm256_madd_epi16(_mm256_add_epi16(a, offset), b));
+    }
+
+  acc128 = _mm_add_epi32(_mm256_castsi256_si128(acc),
+                         _mm256_extracti128_si256(acc, 1));
+  acc128 = _mm_add_epi32(acc128,
+      _mm_shuffle_epi32(acc128, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc128 = _mm_add_epi32(acc128,
+      _mm_shuffle_epi32(acc128, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(acc128);
+#elif defined(__SSE2__)
+  const __m128i offset = _mm_set1_epi16((int16_t)lhs_offset);
+  __m128i acc = _mm_setzero_si128();
+
+  for (; i + 8 <= count; i += 8)
+    {
+      __m128i a = _mm_loadl_epi64((const __m128i *)(lhs + i));
+      __m128i b = _mm_loadl_epi64((const __m128i *)(rhs + i));
+
+      a = _mm_srai_epi16(_mm_unpacklo_epi8(a, a), 8);
+      b = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+      acc = _mm_add_epi32(acc,
+          _mm_madd_epi16(_mm_add_epi16(a, offset), b));
+    }
+
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  sum = _mm_cvtsi128_si32(acc);
+#endif
+
+  for (; i < count; i++)
+    {
+      sum += (lhs[i] + lhs_offset) * rhs[i];
+    }
+
+  return sum;
+}
+
+/* Compute the output rows [start, end) of every batch */
+
+static void fc_rows(void *arg, int start, int end, int worker)
+{
+  const struct fc_job_s *job = arg;
+  const int32_t accum_depth = job->accum_depth;
+  const int32_t output_depth = job->output_depth;
+  const int32_t input_offset = job->fc_params->input_offset;
+  const int32_t output_offset = job->fc_params->output_offset;
+  const int32_t act_min = job->fc_params->activation.min;
+  const int32_t act_max = job->fc_params->activation.max;
+  const int32_t multiplier = job->quant_params->multiplier;
+  const int32_t shift = job->quant_params->shift;
+  const int8_t *input = job->input;
+  int8_t *output = job->output;
+  int32_t batch_cnt = job->batches;
+
+  (void)worker;
+
+  while (batch_cnt)
+    {
+      const int8_t *ker_ptr = job->kernel + start * accum_depth;
+      int32_t i;
+
+      for (i = start; i < end; i++)
+        {
+          int32_t sum = fc_dot_s8(input, ker_ptr, accum_depth,
+                                  input_offset);
+
+          if (job->bias)
+            {
+              sum += job->bias[i];
+            }
+
+          sum = arm_nn_requantize(sum, multiplier, shift);
+          sum += output_offset;
+          sum = MAX(sum, act_min);
+          sum = MIN(sum, act_max);
+          output[i] = (int8_t)sum;
+          ker_ptr += accum_depth;
+        }
+
+      input += accum_depth;
+      output += output_depth;
+      batch_cnt--;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* S8 basic fully-connected and matrix multiplication layer function for
+ * TensorFlow Lite.
+ *
+ * Refer header file for details.  Replaces the scalar reference kernel on
+ * targets without the Arm DSP/MVE extensions; requantization uses
+ * arm_nn_requantize() so results are bit-exact with the reference.  Large
+ * layers are split by output row across the tflm_parallel threads.
+ */
+
+arm_cmsis_nn_status
+arm_fully_connected_s8(const cmsis_nn_context *ctx,
+                       const cmsis_nn_fc_params *fc_params,
+                       const cmsis_nn_per_tensor_quant_params *quant_params,
+                       const cmsis_nn_dims *input_dims,
+                       const int8_t *input,
+                       const cmsis_nn_dims *filter_dims,
+                       const int8_t *kernel,
+                       const cmsis_nn_dims *bias_dims,
+                       const int32_t *bias,
+                       const cmsis_nn_dims *output_dims,
+                       int8_t *output)
+{
+  struct fc_job_s job;
+  uint64_t macs;
+
+  (void)bias_dims;
+  (void)ctx;
+  (void)fc_params->filter_offset;
+
+  job.fc_params = fc_params;
+  job.quant_params = quant_params;
+  job.input = input;
+  job.kernel = kernel;
+  job.bias = bias;
+  job.output = output;
+  job.batches = input_dims->n;
+  job.accum_depth = filter_dims->n;
+  job.output_depth = output_dims->c;
+
+  macs = (uint64_t)job.batches * job.accum_depth * job.output_depth;
+  tflm_parallel_for(job.output_depth, (uint32_t)MIN(macs, UINT32_MAX),
+                    fc_rows, &job);
+  return ARM_CMSIS_NN_SUCCESS;
+}
@@ -0,0 +1,178 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/simd/arm_max_pool_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#  include <immintrin.h>
+#endif
+
+#include "arm_nnfunctions.h"
+#include "arm_nnsupportfunctions.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/* dst[i] = MAX(dst[i], src[i]) */
+
+static void max_tap_s8(int8_t *dst, const int8_t *src, int32_t count)
+{
+  int32_t i = 0;
+
+#if defined(__AVX2__)
+  for (; i + 32 <= count; i += 32)
+    {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(dst + i));
+      __m256i b = _mm256_loadu_si256((const __m256i *)(src + i));
+
+      _mm256_storeu_si256((__m256i *)(dst + i), _mm256_max_epi8(a, b));
+    }
+#elif defined(__SSE2__)
+  /* SSE2 only has an unsigned byte maximum: flip the sign bits so that
+   * the signed order maps onto the unsigned one, and back.
+   */
+
+  const __m128i sign = _mm_set1_epi8((char)0x80);
+
+  for (; i + 16 <= count; i += 16)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i *)(dst + i));
+      __m128i b = _mm_loadu_si128((const __m128i *)(src + i));
+      __m128i max = _mm_max_epu8(_mm_xor_si128(a, sign),
+                                 _mm_xor_si128(b, sign));
+
+      _mm_storeu_si128((__m128i *)(dst + i), _mm_xor_si128(max, sign));
+    }
+#endif
+
+  for (; i < count; i++)
+    {
+      dst[i] = MAX(dst[i], src[i]);
+    }
+}
+
+static void clamp_s8(int8_t *dst, int32_t count, int8_t act_min,
+                     int8_t act_max)
+{
+  int32_t i;
+
+  for (i = 0; i < count; i++)
+    {
+      int8_t val = dst[i];
+
+      val = MAX(val, act_min);
+      val = MIN(val, act_max);
+      dst[i] = val;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/* s8 max pooling function.
+ *
+ * Refer header file for details.  Replaces the scalar reference kernel on
+ * targets without the Arm DSP/MVE extensions.
+ */
+
+arm_cmsis_nn_status arm_max_pool_s8(const cmsis_nn_context *ctx,
+                                    const cmsis_nn_pool_params *pool_params,
+                                    const cmsis_nn_dims *input_dims,
+                                    const int8_t *src,
+                                    const cmsis_nn_dims *filter_dims,
+                                    const cmsis_nn_dims *output_dims,
+                                    int8_t *dst)
+{
+  const int32_t input_y = input_dims->h;
+  const int32_t input_x = input_dims->w;
+  const int32_t output_y = output_dims->h;
+  const int32_t output_x = output_dims->w;
+  const int32_t stride_y = pool_params->stride.h;
+  const int32_t stride_x = pool_params->stride.w;
+  const int32_t kernel_y = filter_dims->h;
+  const int32_t kernel_x = filter_dims->w;
+  const int32_t pad_y = pool_params->padding.h;
+  const int32_t pad_x = pool_params->padding.w;
+  const int8_t act_min = pool_params->activation.min;
+  const int8_t act_max = pool_params->activation.max;
+  const int32_t channel_in = input_dims->c;
+  int32_t batch_cnt = input_dims->n;
+
+  (void)ctx;
+
+  if (batch_cnt < 1)
+    {
+      return ARM_CMSIS_NN_ARG_ERROR;
+    }
+
+  while (batch_cnt)
+    {
+      for (int32_t i_y = 0; i_y < output_y; i_y++)
+        {
+          const int32_t idx_y = i_y * stride_y - pad_y;
+          const int32_t k_y_start = MAX(0, -idx_y);
+          const int32_t k_y_end = MIN(kernel_y, input_y - idx_y);
+
+          for (int32_t i_x = 0; i_x < output_x; i_x++)
+            {
+              const int32_t idx_x = i_x * stride_x - pad_x;
+              const int32_t k_x_start = MAX(0, -idx_x);
+              const int32_t k_x_end = MIN(kernel_x, input_x - idx_x);
+              int32_t count = 0;
+
+              for (int32_t k_y = k_y_start; k_y < k_y_end; k_y++)
+                {
+                  for (int32_t k_x = k_x_start; k_x < k_x_end; k_x++)
+                    {
+                      const int8_t *start = src + channel_in *
+                                            (k_x + idx_x +
+                                             (idx_y + k_y) * input_x);
+
+                      if (count == 0)
+                        {
+                          arm_memcpy_s8(dst, start, channel_in);
+                          count++;
+                        }
+                      else
+                        {
+                          max_tap_s8(dst, start, channel_in);
+                        }
+                    }
+                }
+
+              /* Clamp while the pixel is still in the cache */
+
+              clamp_s8(dst, channel_in, act_min, act_max);
+              dst += channel_in;
+            }
+        }
+
+      src += input_y * input_x * channel_in;
+      batch_cnt--;
+    }
+
+  return ARM_CMSIS_NN_SUCCESS;
+}
@@ -0,0 +1,491 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/tflm_parallel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "tflm_parallel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(__i386__) || defined(__x86_64__)
+#  define tflm_relax() __builtin_ia32_pause()
+#elif defined(__arm__) || defined(__aarch64__)
+#  define tflm_relax() __asm__ __volatile__("yield")
+#else
+#  define tflm_relax()
+#endif
+
+/* Set in pending by a caller that went to sleep on the job */
+
+#define TFLM_PENDING_WAITING  0x10000
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tflm_worker_s
+{
+  pthread_t thread;
+  sem_t sem;                 /* Posted to wake a sleeping worker */
+  atomic_int sleeping;       /* Set while the worker may block on sem */
+  FAR void *scratch;         /* See tflm_parallel_reserve() */
+  size_t scratch_size;
+  int index;
+};
+
+struct tflm_pool_s
+{
+  pthread_mutex_t lock;      /* Held by the operator using the pool */
+  atomic_uint generation;    /* Bumped to publish a job */
+  atomic_int pending;        /* Pool threads still running the job */
+  sem_t done;                /* Posted by the last pool thread to finish */
+  tflm_parallel_func_t func;
+  FAR void *arg;
+  int count;
+  int active;                /* Threads sharing the work of the job */
+  int nthreads;              /* Threads in the pool, the caller included */
+  bool started;
+  bool stop;
+#ifdef CONFIG_SMP
+  pid_t pinned;              /* Caller pinned by tflm_parallel_init() */
+  cpu_set_t affinity;        /* Its affinity before, restored on stop */
+#endif
+  struct tflm_worker_s workers[CONFIG_TFLITEMICRO_PARALLEL_THREADS];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tflm_pool_s g_tflm_pool =
+{
+  .lock = PTHREAD_MUTEX_INITIALIZER,
+  .done = SEM_INITIALIZER(0),
+  .nthreads = 1,
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static void tflm_parallel_run(FAR struct tflm_pool_s *pool, int worker)
+{
+  int start = (int)((int64_t)pool->count * worker / pool->active);
+  int end = (int)((int64_t)pool->count * (worker + 1) / pool->active);
+
+  if (start < end)
+    {
+      pool->func(pool->arg, start, end, worker);
+    }
+}
+
+/* Wait for the generation to move past seen: spin for a while since the
+ * next large operator usually follows within microseconds, then sleep so
+ * that an idle model does not keep the CPUs busy.
+ */
+
+static unsigned int tflm_parallel_wait(FAR struct tflm_pool_s *pool,
+                                       FAR struct tflm_worker_s *worker,
+                                       unsigned int seen)
+{
+  unsigned int gen;
+  int spin;
+
+  for (spin = 0; spin < CONFIG_TFLITEMICRO_PARALLEL_SPIN; spin++)
+    {
+      gen = atomic_load_explicit(&pool->generation, memory_order_acquire);
+      if (gen != seen)
+        {
+          return gen;
+        }
+
+      tflm_relax();
+    }
+
+  /* Announce the sleep before the last check.  The publisher bumps the
+   * generation before it takes the flag, so either the check below sees
+   * the new job or the publisher sees the flag and posts.  The post may
+   * also come from the publisher of the job just done, still walking the
+   * pool when this thread finished it: sleep again then.
+   */
+
+  do
+    {
+      atomic_store(&worker->sleeping, 1);
+      gen = atomic_load(&pool->generation);
+      if (gen == seen || atomic_exchange(&worker->sleeping, 0) == 0)
+        {
+          /* Either nothing is published yet, or the publisher already
+           * took the flag and its post has to be consumed.
+           */
+
+          while (sem_wait(&worker->sem) < 0 && errno == EINTR)
+            {
+            }
+        }
+
+      gen = atomic_load_explicit(&pool->generation, memory_order_acquire);
+    }
+  while (gen == seen);
+
+  return gen;
+}
+
+static FAR void *tflm_parallel_worker(FAR void *arg)
+{
+  FAR struct tflm_worker_s *worker = arg;
+  FAR struct tflm_pool_s *pool = &g_tflm_pool;
+  unsigned int seen = 0;
+
+  for (; ; )
+    {
+      seen = tflm_parallel_wait(pool, worker, seen);
+      if (pool->stop)
+        {
+          break;
+        }
+
+      /* Threads beyond the job's share acknowledge it as well, so that
+       * the next job is never published before all of them saw this one.
+       */
+
+      if (worker->index < pool->active)
+        {
+          tflm_parallel_run(pool, worker->index);
+        }
+
+      /* The last one wakes the caller if it went to sleep, see
+       * tflm_parallel_join().
+       */
+
+      if (atomic_fetch_sub(&pool->pending, 1) ==
+          (TFLM_PENDING_WAITING | 1))
+        {
+          sem_post(&pool->done);
+        }
+    }
+
+  return NULL;
+}
+
+/* Wait for the pool threads to finish the job: spin as long as a pool
+ * thread would for the next job, then sleep.  Spinning alone is not safe:
+ * a pool thread may share the CPU of the caller (when the caller is not
+ * the thread that started the pool) and would never run under FIFO.
+ */
+
+static void tflm_parallel_join(FAR struct tflm_pool_s *pool)
+{
+  int spin;
+
+  for (spin = 0; spin < CONFIG_TFLITEMICRO_PARALLEL_SPIN; spin++)
+    {
+      if (atomic_load_explicit(&pool->pending, memory_order_acquire) == 0)
+        {
+          return;
+        }
+
+      tflm_relax();
+    }
+
+  /* The flag lives in pending itself: a pool thread that finished the
+   * previous job late must not be able to take it for this one.
+   */
+
+  if (atomic_fetch_or(&pool->pending, TFLM_PENDING_WAITING) != 0)
+    {
+      while (sem_wait(&pool->done) < 0 && errno == EINTR)
+        {
+        }
+    }
+}
+
+/* Start the pool with the configured size on first use */
+
+static void tflm_parallel_start(FAR struct tflm_pool_s *pool)
+{
+  if (!pool->started)
+    {
+      tflm_parallel_init(CONFIG_TFLITEMICRO_PARALLEL_THREADS);
+    }
+}
+
+/* Wake the pool threads sleeping on the job just published */
+
+static void tflm_parallel_wake(FAR struct tflm_pool_s *pool)
+{
+  int i;
+
+  for (i = 1; i < pool->nthreads; i++)
+    {
+      if (atomic_exchange(&pool->workers[i].sleeping, 0))
+        {
+          sem_post(&pool->workers[i].sem);
+        }
+    }
+}
+
+static void tflm_parallel_stop(FAR struct tflm_pool_s *pool)
+{
+  int i;
+
+  if (pool->nthreads > 1)
+    {
+      pool->stop = true;
+      pool->active = pool->nthreads;
+      atomic_fetch_add(&pool->generation, 1);
+      tflm_parallel_wake(pool);
+
+      for (i = 1; i < pool->nthreads; i++)
+        {
+          pthread_join(pool->workers[i].thread, NULL);
+          sem_destroy(&pool->workers[i].sem);
+        }
+    }
+
+  for (i = 1; i < CONFIG_TFLITEMICRO_PARALLEL_THREADS; i++)
+    {
+      free(pool->workers[i].scratch);
+      pool->workers[i].scratch = NULL;
+      pool->workers[i].scratch_size = 0;
+    }
+
+  pool->nthreads = 1;
+  pool->stop = false;
+
+#ifdef CONFIG_SMP
+  if (pool->pinned > 0)
+    {
+      sched_setaffinity(pool->pinned, sizeof(pool->affinity),
+                        &pool->affinity);
+      pool->pinned = 0;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int tflm_parallel_init(int nthreads)
+{
+  FAR struct tflm_pool_s *pool = &g_tflm_pool;
+  struct sched_param param;
+  pthread_attr_t attr;
+#ifdef CONFIG_SMP
+  cpu_set_t cpuset;
+  int cpu;
+#endif
+  int ret = 0;
+  int i;
+
+  if (nthreads < 1 || nthreads > CONFIG_TFLITEMICRO_PARALLEL_THREADS)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_SMP
+  /* One thread per CPU: a second thread on a CPU only takes turns */
+
+  if (nthreads > CONFIG_SMP_NCPUS)
+    {
+      nthreads = CONFIG_SMP_NCPUS;
+    }
+#endif
+
+  pthread_mutex_lock(&pool->lock);
+  tflm_parallel_stop(pool);
+  pool->started = true;
+
+#ifdef CONFIG_SMP
+  /* Keep the caller on the CPU it runs on and give the pool threads the
+   * others, so that none of them waits for the caller to yield its CPU.
+   * The caller's affinity is put back when the pool is stopped.
+   */
+
+  cpu = sched_getcpu();
+  if (cpu < 0)
+    {
+      cpu = 0;
+    }
+
+  if (nthreads > 1 &&
+      sched_getaffinity(0, sizeof(pool->affinity), &pool->affinity) == 0)
+    {
+      CPU_ZERO(&cpuset);
+      CPU_SET(cpu, &cpuset);
+      if (sched_setaffinity(0, sizeof(cpuset), &cpuset) == 0)
+        {
+          pool->pinned = gettid();
+        }
+    }
+#endif
+
+  /* Workers start from generation 0, see tflm_parallel_worker() */
+
+  atomic_store(&pool->generation, 0);
+  sched_getparam(0, &param);
+
+  for (i = 1; i < nthreads; i++)
+    {
+      FAR struct tflm_worker_s *worker = &pool->workers[i];
+
+      worker->index = i;
+      atomic_store(&worker->sleeping, 0);
+      sem_init(&worker->sem, 0, 0);
+
+      pthread_attr_init(&attr);
+      pthread_attr_setstacksize(&attr,
+                                CONFIG_TFLITEMICRO_PARALLEL_STACKSIZE);
+      pthread_attr_setschedparam(&attr, &param);
+#ifdef CONFIG_SMP
+      CPU_ZERO(&cpuset);
+      CPU_SET((cpu + i) % CONFIG_SMP_NCPUS, &cpuset);
+      pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+#endif
+
+      ret = pthread_create(&worker->thread, &attr, tflm_parallel_worker,
+                           worker);
+      pthread_attr_destroy(&attr);
+      if (ret != 0)
+        {
+          sem_destroy(&worker->sem);
+          tflm_parallel_stop(pool);
+          ret = -ret;
+          break;
+        }
+
+      pool->nthreads = i + 1;
+    }
+
+  pthread_mutex_unlock(&pool->lock);
+  return ret;
+}
+
+void tflm_parallel_deinit(void)
+{
+  FAR struct tflm_pool_s *pool = &g_tflm_pool;
+
+  pthread_mutex_lock(&pool->lock);
+  tflm_parallel_stop(pool);
+  pool->started = false;
+  pthread_mutex_unlock(&pool->lock);
+}
+
+int tflm_parallel_threads(void)
+{
+  return g_tflm_pool.nthreads;
+}
+
+int tflm_parallel_for(int count, uint32_t macs, tflm_parallel_func_t func,
+                      FAR void *arg)
+{
+  FAR struct tflm_pool_s *pool = &g_tflm_pool;
+  int active;
+
+  tflm_parallel_start(pool);
+  if (count < 2 || macs < CONFIG_TFLITEMICRO_PARALLEL_MIN_MACS ||
+      pthread_mutex_trylock(&pool->lock) != 0)
+    {
+      func(arg, 0, count, 0);
+      return 1;
+    }
+
+  active = pool->nthreads < count ? pool->nthreads : count;
+  if (active < 2)
+    {
+      pthread_mutex_unlock(&pool->lock);
+      func(arg, 0, count, 0);
+      return 1;
+    }
+
+  pool->func = func;
+  pool->arg = arg;
+  pool->count = count;
+  pool->active = active;
+  atomic_store(&pool->pending, pool->nthreads - 1);
+
+  atomic_fetch_add(&pool->generation, 1);
+  tflm_parallel_wake(pool);
+
+  /* The caller does the first range, then waits for the others */
+
+  tflm_parallel_run(pool, 0);
+  tflm_parallel_join(pool);
+
+  pthread_mutex_unlock(&pool->lock);
+  return active;
+}
+
+int tflm_parallel_reserve(size_t size)
+{
+  FAR struct tflm_pool_s *pool = &g_tflm_pool;
+  int ret = 0;
+  int i;
+
+  tflm_parallel_start(pool);
+  pthread_mutex_lock(&pool->lock);
+
+  for (i = 1; i < pool->nthreads; i++)
+    {
+      FAR struct tflm_worker_s *worker = &pool->workers[i];
+      FAR void *scratch;
+
+      if (worker->scratch_size >= size)
+        {
+          continue;
+        }
+
+      scratch = realloc(worker->scratch, size);
+      if (scratch == NULL)
+        {
+          ret = -ENOMEM;
+          break;
+        }
+
+      worker->scratch = scratch;
+      worker->scratch_size = size;
+    }
+
+  pthread_mutex_unlock(&pool->lock);
+  return ret;
+}
+
+FAR void *tflm_parallel_scratch(int worker)
+{
+  return g_tflm_pool.workers[worker].scratch;
+}
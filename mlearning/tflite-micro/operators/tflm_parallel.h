@@ -0,0 +1,175 @@
+/****************************************************************************
+ * apps/mlearning/tflite-micro/operators/tflm_parallel.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __APPS_MLEARNING_TFLITE_MICRO_OPERATORS_TFLM_PARALLEL_H
+#define __APPS_MLEARNING_TFLITE_MICRO_OPERATORS_TFLM_PARALLEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Run the work items [start, end).  worker is 0 for the calling thread and
+ * 1 .. threads - 1 for the pool threads.
+ */
+
+typedef CODE void (*tflm_parallel_func_t)(FAR void *arg, int start,
+                                          int end, int worker);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+
+/****************************************************************************
+ * Name: tflm_parallel_init
+ *
+ * Description:
+ *   (Re)start the pool with nthreads threads, the caller included, at
+ *   most one per CPU.  The caller is pinned to the CPU it runs on and
+ *   each extra thread to one of the others, at the priority of the
+ *   caller, so operators should be run from the thread that starts the
+ *   pool.  The caller keeps that pinning until the pool is stopped by
+ *   tflm_parallel_deinit() or the next tflm_parallel_init(), which
+ *   restore its previous affinity.  One thread runs every operator on
+ *   the caller.  The pool is started with
+ *   CONFIG_TFLITEMICRO_PARALLEL_THREADS on first use if this is never
+ *   called, which pins the thread running that first operator.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int tflm_parallel_init(int nthreads);
+
+/****************************************************************************
+ * Name: tflm_parallel_deinit
+ *
+ * Description:
+ *   Stop the pool threads, free their scratch buffers and restore the
+ *   affinity of the thread that tflm_parallel_init() pinned.
+ *
+ ****************************************************************************/
+
+void tflm_parallel_deinit(void);
+
+/****************************************************************************
+ * Name: tflm_parallel_threads
+ *
+ * Description:
+ *   Return the number of threads an operator may be split across.
+ *
+ ****************************************************************************/
+
+int tflm_parallel_threads(void);
+
+/****************************************************************************
+ * Name: tflm_parallel_for
+ *
+ * Description:
+ *   Split count work items into contiguous ranges, one per thread, and
+ *   run func on all of them, returning once every range is done.  Work
+ *   costing fewer than CONFIG_TFLITEMICRO_PARALLEL_MIN_MACS multiplies, or
+ *   arriving while another operator holds the pool, runs on the caller.
+ *
+ * Returned Value:
+ *   The number of threads that took part.
+ *
+ ****************************************************************************/
+
+int tflm_parallel_for(int count, uint32_t macs, tflm_parallel_func_t func,
+                      FAR void *arg);
+
+/****************************************************************************
+ * Name: tflm_parallel_reserve
+ *
+ * Description:
+ *   Make sure every pool thread has a scratch buffer of at least size
+ *   bytes.  The caller (worker 0) keeps using the buffer of the kernel
+ *   context.
+ *
+ * Returned Value:
+ *   Zero on success, -ENOMEM if a buffer could not be grown.
+ *
+ ****************************************************************************/
+
+int tflm_parallel_reserve(size_t size);
+
+/****************************************************************************
+ * Name: tflm_parallel_scratch
+ *
+ * Description:
+ *   Return the scratch buffer of a pool thread, see
+ *   tflm_parallel_reserve().
+ *
+ ****************************************************************************/
+
+FAR void *tflm_parallel_scratch(int worker);
+
+#else
+
+static inline int tflm_parallel_for(int count, uint32_t macs,
+                                    tflm_parallel_func_t func,
+                                    FAR void *arg)
+{
+  func(arg, 0, count, 0);
+  return 1;
+}
+
+static inline int tflm_parallel_reserve(size_t size)
+{
+  return -ENOSYS;
+}
+
+static inline FAR void *tflm_parallel_scratch(int worker)
+{
+  return NULL;
+}
+
+#endif /* CONFIG_TFLITEMICRO_PARALLEL */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __APPS_MLEARNING_TFLITE_MICRO_OPERATORS_TFLM_PARALLEL_H */
@@ -24,29 +24,429 @@
  * Included Files
  ****************************************************************************/
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <memory>
+#include <new>
+#include <vector>
 
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/micro/micro_profiler.h"
+#include "tensorflow/lite/micro/micro_time.h"
+
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+#include "tflm_parallel.h"
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Arena sizes probed by -A are rounded to this */
+
+#define ARENA_ALIGN      16
+
+/* Largest arena -A will try */
+
+#define ARENA_MAX        (64 * 1024 * 1024)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Keeps the duration of every profiler event of every benchmark run.  The
+ * interpreter emits the events of one Invoke() in the same order each
+ * time, one per operator, so event i of every run belongs to the same op.
+ */
+
+class BenchProfiler : public tflite::MicroProfilerInterface
+{
+public:
+  uint32_t BeginEvent(const char* tag) override
+  {
+    Event event = {tag, tflite::GetCurrentTimeTicks(), 0};
+    events_.push_back(event);
+    return events_.size() - 1;
+  }
+
+  void EndEvent(uint32_t handle) override
+  {
+    if (handle < events_.size())
+      {
+        events_[handle].end = tflite::GetCurrentTimeTicks();
+      }
+  }
+
+  /* Move the events of the last Invoke() into the samples */
+
+  void Collect(void)
+  {
+    if (tags_.size() < events_.size())
+      {
+        tags_.resize(events_.size());
+        samples_.resize(events_.size());
+      }
+
+    for (size_t i = 0; i < events_.size(); i++)
+      {
+        tags_[i] = events_[i].tag;
+        samples_[i].push_back(events_[i].end - events_[i].start);
+      }
+
+    events_.clear();
+  }
+
+  /* Forget the samples, to measure again from scratch */
+
+  void Reset(void)
+  {
+    events_.clear();
+    tags_.clear();
+    samples_.clear();
+  }
+
+  void Report(uint32_t totalTicks) const;
+
+private:
+  struct Event
+  {
+    const char* tag;
+    uint32_t start;
+    uint32_t end;
+  };
+
+  std::vector<Event> events_;
+  std::vector<const char*> tags_;
+  std::vector<std::vector<uint32_t>> samples_;
+};
+
+class ModelFile
+{
+public:
+  ~ModelFile();
+
+  bool Load(const char* path, bool useMmap);
+
+  const uint8_t* data(void) const
+  {
+    return data_;
+  }
+
+  size_t size(void) const
+  {
+    return size_;
+  }
+
+  bool mapped(void) const
+  {
+    return mapped_;
+  }
+
+private:
+  std::unique_ptr<uint8_t[]> heap_;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+};
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+static uint32_t ticksToUs(uint32_t ticks)
+{
+  uint32_t tps = tflite::ticks_per_second();
+
+  return tps ? (uint32_t)((uint64_t)ticks * 1000000 / tps) : ticks;
+}
+
+static void printStats(const char* index, const char* name,
+                       std::vector<uint32_t> samples)
+{
+  uint64_t sum = 0;
+  size_t n = samples.size();
+
+  if (n == 0)
+    {
+      return;
+    }
+
+  std::sort(samples.begin(), samples.end());
+  for (uint32_t v : samples)
+    {
+      sum += v;
+    }
+
+  printf("%4s %-24s %10lu %10lu %10lu %10lu %10lu\n", index, name,
+         (unsigned long)ticksToUs(sum / n),
+         (unsigned long)ticksToUs(samples[(n - 1) / 2]),
+         (unsigned long)ticksToUs(samples[(n - 1) * 90 / 100]),
+         (unsigned long)ticksToUs(samples[(n - 1) * 99 / 100]),
+         (unsigned long)ticksToUs(samples[n - 1]));
+}
+
+void BenchProfiler::Report(uint32_t totalTicks) const
+{
+  std::vector<uint32_t> totals;
+  size_t runs = samples_.empty() ? 0 : samples_[0].size();
+
+  printf("%4s %-24s %10s %10s %10s %10s %10s\n", "idx", "op (us)",
+         "avg", "p50", "p90", "p99", "max");
+
+  for (size_t i = 0; i < samples_.size(); i++)
+    {
+      char index[24];
+
+      snprintf(index, sizeof(index), "%zu", i);
+      printStats(index, tags_[i], samples_[i]);
+    }
+
+  /* The per-invoke total is the sum of the ops of that run */
+
+  totals.resize(runs);
+  for (size_t i = 0; i < samples_.size(); i++)
+    {
+      for (size_t r = 0; r < runs && r < samples_[i].size(); r++)
+        {
+          totals[r] += samples_[i][r];
+        }
+    }
+
+  printStats("", "ops total", totals);
+  printf("%zu runs, %lu us wall clock\n", runs,
+         (unsigned long)ticksToUs(totalTicks));
+}
+
+/* Map the model read-only, falling back to reading it into the heap.
+ * The data stays valid as long as the object, so declare it before the
+ * interpreter.
+ */
+
+ModelFile::~ModelFile()
+{
+  if (mapped_)
+    {
+      munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+bool ModelFile::Load(const char* path, bool useMmap)
+{
+  if (useMmap)
+    {
+      int fd = open(path, O_RDONLY);
+      struct stat st;
+
+      if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+          void* addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE,
+                            fd, 0);
+          if (addr != MAP_FAILED)
+            {
+              close(fd);
+              data_ = static_cast<const uint8_t*>(addr);
+              size_ = st.st_size;
+              mapped_ = true;
+              return true;
+            }
+        }
+
+      if (fd >= 0)
+        {
+          close(fd);
+        }
+
+      printf("mmap %s failed, reading it instead.\n", path);
+    }
+
+  std::ifstream ifs(path, std::ios::binary);
+  if (!ifs)
+    {
+      return false;
+    }
+
+  ifs.seekg(0, std::ios::end);
+  size_ = ifs.tellg();
+  heap_.reset(new (std::nothrow) uint8_t[size_]);
+  if (!heap_)
+    {
+      return false;
+    }
+
+  ifs.seekg(0, std::ios::beg);
+  ifs.read(reinterpret_cast<char*>(heap_.get()), size_);
+  ifs.close();
+  data_ = heap_.get();
+  return true;
+}
+
+/* Check whether the model fits an arena of the given size, returns the
+ * bytes actually used or 0.
+ */
+
+static size_t tryArena(const tflite::Model* model,
+                       const tflite::MicroOpResolver& resolver,
+                       size_t size)
+{
+  std::unique_ptr<uint8_t[]> arena(new (std::nothrow) uint8_t[size]);
+  if (!arena)
+    {
+      return 0;
+    }
+
+  tflite::MicroInterpreter interpreter(model, resolver, arena.get(), size);
+  if (interpreter.AllocateTensors() != kTfLiteOk)
+    {
+      return 0;
+    }
+
+  return interpreter.arena_used_bytes();
+}
+
+/* Find the smallest arena that holds the model: grow until it fits, then
+ * bisect between the last failure and the first success.
+ */
+
+static size_t sizeArena(const tflite::Model* model,
+                        const tflite::MicroOpResolver& resolver,
+                        size_t start, size_t& used)
+{
+  size_t lo = 0;
+  size_t hi = (std::max<size_t>(start, 1) + ARENA_ALIGN - 1) /
+              ARENA_ALIGN * ARENA_ALIGN;
+
+  while ((used = tryArena(model, resolver, hi)) == 0)
+    {
+      if (hi >= ARENA_MAX)
+        {
+          return 0;
+        }
+
+      lo = hi;
+      hi = std::min<size_t>(hi * 2, ARENA_MAX);
+    }
+
+  /* What the allocator reports is a good lower bound */
+
+  lo = std::max(lo, (used - 1) / ARENA_ALIGN * ARENA_ALIGN);
+
+  while (hi - lo > ARENA_ALIGN)
+    {
+      size_t mid = (lo + (hi - lo) / 2) / ARENA_ALIGN * ARENA_ALIGN;
+      size_t midUsed = tryArena(model, resolver, mid);
+
+      if (midUsed != 0)
+        {
+          hi = mid;
+          used = midUsed;
+        }
+      else
+        {
+          lo = mid;
+        }
+    }
+
+  return hi;
+}
+
+/* Time runs warm evaluations, the samples of each landing in profiler */
+
+static bool benchInvoke(tflite::MicroInterpreter& interpreter,
+                        BenchProfiler& profiler, int runs,
+                        uint32_t& ticks)
+{
+  /* The first run pays for lazy initialization, leave it out */
+
+  interpreter.Invoke();
+  profiler.Reset();
+
+  uint32_t start = tflite::GetCurrentTimeTicks();
+  for (int i = 0; i < runs; i++)
+    {
+      if (interpreter.Invoke() != kTfLiteOk)
+        {
+          printf("Invoke failed in run %d.\n", i);
+          return false;
+        }
+
+      profiler.Collect();
+    }
+
+  ticks = tflite::GetCurrentTimeTicks() - start;
+  return true;
+}
+
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+/* Benchmark with 1 .. maxThreads threads per operator and print the
+ * invoke latency and the speedup over one thread.  The pool is left with
+ * maxThreads threads.
+ */
+
+static bool benchThreads(tflite::MicroInterpreter& interpreter,
+                         BenchProfiler& profiler, int runs,
+                         int maxThreads)
+{
+  uint32_t base = 0;
+
+  printf("%7s %12s %8s\n", "threads", "invoke (us)", "speedup");
+
+  for (int n = 1; n <= maxThreads; n++)
+    {
+      uint32_t ticks;
+      uint32_t us;
+
+      if (tflm_parallel_init(n) < 0)
+        {
+          printf("Failed to start %d threads.\n", n);
+          return false;
+        }
+
+      if (!benchInvoke(interpreter, profiler, runs, ticks))
+        {
+          return false;
+        }
+
+      us = ticksToUs(ticks / runs);
+      if (n == 1)
+        {
+          base = us;
+        }
+
+      /* Speedup in hundredths, printed without floating point */
+
+      uint32_t speedup = us ? (uint32_t)((uint64_t)base * 100 / us) : 0;
+      printf("%7d %12lu %5lu.%02lux\n", n, (unsigned long)us,
+             (unsigned long)(speedup / 100),
+             (unsigned long)(speedup % 100));
+    }
+
+  printf("\n");
+  return true;
+}
+#endif
+
 static void usage(void)
 {
   printf("\nUtility to use tflite micro on nuttx.\n"
     "[ -C       ] Compile tflite model into c++ codes.\n"
     "[ -E       ] Do once evaluation (for profiling).\n"
+    "[ -B <int> ] Benchmark: per-op latency of <int> warm evaluations.\n"
     "[ -i <str> ] Readable model file path.\n"
     "[ -o <str> ] Writable c++ file path.\n"
     "[ -p <str> ] Prefix of compiled code.\n"
     "[ -a <int> ] Arena size (mempool).\n"
+    "[ -A       ] Find the smallest arena, starting from -a.\n"
+    "[ -m       ] Map the model file instead of reading it.\n"
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+    "[ -j <int> ] Threads per operator; with -B, benchmark 1 to <int>.\n"
+#endif
     "[ -h       ] Print this message.\n");
 }
 
@@ -61,10 +461,14 @@ extern "C" int main(int argc, FAR char* argv[])
   const char* prefix = "NXAI";
   bool need_compile = false;
   bool need_invoke = false;
-  int arenaSize = 1024 * 8;
+  bool need_size = false;
+  bool use_mmap = false;
+  int benchRuns = 0;
+  int threads = 0;
+  size_t arenaSize = 1024 * 8;
 
   int ch;
-  while ((ch = getopt(argc, argv, "CEhi:o:p:a:")) != EOF)
+  while ((ch = getopt(argc, argv, "CEB:Amj:hi:o:p:a:")) != EOF)
     {
       switch (ch)
         {
@@ -74,6 +478,18 @@ extern "C" int main(int argc, FAR char* argv[])
           case 'E':
             need_invoke = true;
             break;
+          case 'B':
+            benchRuns = strtol(optarg, NULL, 0);
+            break;
+          case 'A':
+            need_size = true;
+            break;
+          case 'm':
+            use_mmap = true;
+            break;
+          case 'j':
+            threads = strtol(optarg, NULL, 0);
+            break;
           case 'p':
             prefix = optarg;
             break;
@@ -93,20 +509,29 @@ extern "C" int main(int argc, FAR char* argv[])
         }
     }
 
-  if (!modelFileName || !codeFileName)
+  if (!modelFileName || (need_compile && !codeFileName) || benchRuns < 0 ||
+      threads < 0)
     {
       usage();
       return -1;
     }
 
-  std::ifstream ifs(modelFileName, std::ios::binary);
-  ifs.seekg(0, std::ios::end);
-  size_t modelSize = ifs.tellg();
-  std::unique_ptr<uint8_t[]> pModel(new uint8_t[modelSize]);
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+  if (threads > 0 && benchRuns == 0 && tflm_parallel_init(threads) < 0)
+    {
+      printf("Failed to start %d threads.\n", threads);
+      return -1;
+    }
+#endif
 
-  ifs.seekg(0, std::ios::beg);
-  ifs.read(reinterpret_cast<char*>(pModel.get()), modelSize);
-  ifs.close();
+  ModelFile modelFile;
+  if (!modelFile.Load(modelFileName, use_mmap))
+    {
+      printf("Failed to load %s.\n", modelFileName);
+      return -1;
+    }
+
+  const tflite::Model* model = tflite::GetModel(modelFile.data());
 
   /* HACK: can change operators here. */
 
@@ -120,22 +545,82 @@ extern "C" int main(int argc, FAR char* argv[])
   resolver.AddFullyConnected(tflite::Register_FULLY_CONNECTED_INT8());
   resolver.AddSoftmax(tflite::Register_SOFTMAX_INT8());
 
-  std::unique_ptr<uint8_t[]> pArena(new uint8_t[arenaSize]);
+  if (need_size)
+    {
+      size_t used;
+
+      arenaSize = sizeArena(model, resolver, arenaSize, used);
+      if (arenaSize == 0)
+        {
+          printf("No arena up to %d bytes holds the model.\n", ARENA_MAX);
+          return -1;
+        }
+
+      printf("arena: %zu bytes needed, %zu bytes used\n", arenaSize, used);
+    }
+
+  std::unique_ptr<uint8_t[]> pArena(new (std::nothrow) uint8_t[arenaSize]);
+  if (!pArena)
+    {
+      printf("Failed to allocate a %zu byte arena.\n", arenaSize);
+      return -1;
+    }
 
   tflite::MicroProfiler profiler;
-  tflite::MicroInterpreter interpreter(tflite::GetModel(pModel.get()),
-    resolver, pArena.get(), arenaSize, nullptr,
-    reinterpret_cast<tflite::MicroProfilerInterface*>(&profiler));
+  BenchProfiler benchProfiler;
+  tflite::MicroProfilerInterface* activeProfiler = &profiler;
+
+  if (benchRuns > 0)
+    {
+      activeProfiler = &benchProfiler;
+    }
+
+  tflite::MicroInterpreter interpreter(model, resolver, pArena.get(),
+    arenaSize, nullptr, activeProfiler);
 
   /* HACK: can add testcases here. */
 
-  if (need_invoke)
+  if (need_invoke && benchRuns == 0)
     {
       interpreter.Invoke();
       profiler.LogCsv();
       profiler.LogTicksPerTagCsv();
     }
 
+  if (benchRuns > 0)
+    {
+      if (interpreter.AllocateTensors() != kTfLiteOk)
+        {
+          printf("Arena of %zu bytes is too small, try -A.\n", arenaSize);
+          return -1;
+        }
+
+      uint32_t ticks;
+
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+      /* The per-op report below then shows the last thread count */
+
+      if (threads > 0 &&
+          !benchThreads(interpreter, benchProfiler, benchRuns, threads))
+        {
+          return -1;
+        }
+#endif
+
+      if (!benchInvoke(interpreter, benchProfiler, benchRuns, ticks))
+        {
+          return -1;
+        }
+
+      benchProfiler.Report(ticks);
+#ifdef CONFIG_TFLITEMICRO_PARALLEL
+      printf("threads: %d per operator\n", tflm_parallel_threads());
+#endif
+      printf("arena: %zu bytes, %zu bytes used, model %zu bytes%s\n",
+             arenaSize, interpreter.arena_used_bytes(), modelFile.size(),
+             modelFile.mapped() ? " (mapped)" : "");
+    }
+
   if (need_compile)
     {
 #ifdef TFLITE_MODEL_COMPILER
@@ -149,4 +634,4 @@ extern "C" int main(int argc, FAR char* argv[])
 
   printf("nxai done!\n");
   return 0;
-}
\ No newline at end of file
+}
@@ -32,9 +32,15 @@
 #include <syslog.h>
 #include <dirent.h>
 #include <elf.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <getopt.h>
+#include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
 
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/streams.h>
@@ -45,13 +51,25 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#ifdef CONFIG_BOARD_COREDUMP_COMPRESSION
-#  define COREDUMP_FILE_SUFFIX ".lzf"
+#define COREDUMP_RAW_SUFFIX ".core"
+#define COREDUMP_LZF_SUFFIX ".lzf"
+
+#if defined(CONFIG_BOARD_COREDUMP_COMPRESSION) || \
+    defined(CONFIG_SYSTEM_COREDUMP_RESTORE_COMPRESSION)
+#  define COREDUMP_FILE_SUFFIX COREDUMP_LZF_SUFFIX
 #else
-#  define COREDUMP_FILE_SUFFIX ".core"
+#  define COREDUMP_FILE_SUFFIX COREDUMP_RAW_SUFFIX
 #endif
 
-#define COREDUMP_FILE_SUFFIX_LEN (sizeof(COREDUMP_FILE_SUFFIX) - 1)
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_DOUBLEBUFFER
+#  define COREDUMP_SWAPBUFFER_NUM 2
+#else
+#  define COREDUMP_SWAPBUFFER_NUM 1
+#endif
+
+#ifndef MIN
+#  define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
 
 /****************************************************************************
  * Private Types
@@ -60,6 +78,40 @@
 typedef CODE void (*dumpfile_cb_t)(FAR char *path, FAR const char *filename,
                                    FAR void *arg);
 
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE
+
+/* Disk usage of the coredump files in the save path */
+
+struct dumpfile_usage_s
+{
+  char   oldest[NAME_MAX + 1];  /* Name of the oldest coredump file */
+  time_t oldest_time;           /* Modification time of the oldest file */
+  size_t total;                 /* Total size of all coredump files */
+  size_t count;                 /* Number of coredump files */
+};
+
+/* Reader of the raw core data in the block/mtd device.  With double
+ * buffering enabled, a helper thread fills one swap buffer while the
+ * other one is compressed and written to the filesystem.
+ */
+
+struct coredump_reader_s
+{
+  int fd;                                        /* Block/mtd device */
+  size_t remain;                                 /* Bytes left to read */
+  FAR unsigned char *buf[COREDUMP_SWAPBUFFER_NUM];
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_DOUBLEBUFFER
+  ssize_t len[COREDUMP_SWAPBUFFER_NUM];          /* Valid bytes or error */
+  int head;                                      /* Buffer to consume */
+  bool stop;                                     /* Ask reader to quit */
+  sem_t empty;                                   /* Free buffer count */
+  sem_t full;                                    /* Filled buffer count */
+  pthread_t thread;
+#endif
+};
+
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -81,19 +133,25 @@ static struct memory_region_s g_memory_region[] =
 
 #ifdef CONFIG_SYSTEM_COREDUMP_RESTORE
 
-static bool dumpfile_is_valid(FAR const char *name)
+static bool dumpfile_has_suffix(FAR const char *name,
+                                FAR const char *suffix)
 {
-  FAR const char *suffix;
-  size_t name_len;
+  size_t name_len = strlen(name);
+  size_t suffix_len = strlen(suffix);
 
-  name_len = strlen(name);
-  if (name_len < COREDUMP_FILE_SUFFIX_LEN)
-    {
-      return false;
-    }
+  return name_len >= suffix_len &&
+         strcmp(name + name_len - suffix_len, suffix) == 0;
+}
+
+/* Both suffixes are accepted whatever the current configuration, so the
+ * files restored before compression was enabled or disabled, and the
+ * incompressible cores kept raw, are still counted and rotated out.
+ */
 
-  suffix = name + name_len - COREDUMP_FILE_SUFFIX_LEN;
-  return !!memcmp(suffix, COREDUMP_FILE_SUFFIX, COREDUMP_FILE_SUFFIX_LEN);
+static bool dumpfile_is_valid(FAR const char *name)
+{
+  return dumpfile_has_suffix(name, COREDUMP_RAW_SUFFIX) ||
+         dumpfile_has_suffix(name, COREDUMP_LZF_SUFFIX);
 }
 
 static int dumpfile_iterate(FAR char *path, dumpfile_cb_t cb, FAR void *arg)
@@ -111,6 +169,10 @@ static int dumpfile_iterate(FAR char *path, dumpfile_cb_t cb, FAR void *arg)
           printf("Coredump mkdir %s fail\n", path);
           return -errno;
         }
+
+      /* A freshly created directory has nothing to iterate */
+
+      return 0;
     }
 
   while ((entry = readdir(dir)) != NULL)
@@ -156,6 +218,205 @@ static void dumpfile_delete(FAR char *path, FAR const char *filename,
     }
 }
 
+/****************************************************************************
+ * dumpfile_usage
+ ****************************************************************************/
+
+static void dumpfile_usage(FAR char *path, FAR const char *filename,
+                           FAR void *arg)
+{
+  FAR struct dumpfile_usage_s *usage = arg;
+  char dumppath[PATH_MAX];
+  struct stat st;
+
+  snprintf(dumppath, sizeof(dumppath), "%s/%s", path, filename);
+  if (stat(dumppath, &st) < 0)
+    {
+      return;
+    }
+
+  /* Without a valid RTC all files may share the same timestamp, so fall
+   * back to the name, which embeds the crash time in hex.
+   */
+
+  if (usage->count == 0 || st.st_mtime < usage->oldest_time ||
+      (st.st_mtime == usage->oldest_time &&
+       strcmp(filename, usage->oldest) < 0))
+    {
+      strlcpy(usage->oldest, filename, sizeof(usage->oldest));
+      usage->oldest_time = st.st_mtime;
+    }
+
+  usage->total += st.st_size;
+  usage->count++;
+}
+
+/****************************************************************************
+ * dumpfile_reclaim
+ *
+ * Description:
+ *   Remove the oldest coredump files until "needed" more bytes fit into
+ *   "maxsize" bytes, or no coredump file is left.
+ *
+ ****************************************************************************/
+
+static int dumpfile_reclaim(FAR char *savepath, size_t needed,
+                            size_t maxsize)
+{
+  struct dumpfile_usage_s usage;
+  char dumppath[PATH_MAX];
+  int ret;
+
+  for (; ; )
+    {
+      memset(&usage, 0, sizeof(usage));
+      ret = dumpfile_iterate(savepath, dumpfile_usage, &usage);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (usage.count == 0 || usage.total + needed <= maxsize)
+        {
+          return 0;
+        }
+
+      snprintf(dumppath, sizeof(dumppath), "%s/%s", savepath, usage.oldest);
+      printf("Remove %s\n", dumppath);
+      if (remove(dumppath) < 0)
+        {
+          printf("Remove %s fail\n", dumppath);
+          return -errno;
+        }
+    }
+}
+
+/****************************************************************************
+ * coredump_reader_*
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_DOUBLEBUFFER
+
+static FAR void *coredump_reader_thread(FAR void *arg)
+{
+  FAR struct coredump_reader_s *reader = arg;
+  ssize_t nread;
+  int i = 0;
+
+  do
+    {
+      sem_wait(&reader->empty);
+      if (reader->stop || reader->remain == 0)
+        {
+          nread = 0;
+        }
+      else
+        {
+          nread = read(reader->fd, reader->buf[i],
+                       MIN(reader->remain,
+                           CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE));
+          if (nread < 0)
+            {
+              nread = -errno;
+            }
+          else
+            {
+              reader->remain -= nread;
+            }
+        }
+
+      reader->len[i] = nread;
+      sem_post(&reader->full);
+      i ^= 1;
+    }
+  while (nread > 0);
+
+  return NULL;
+}
+
+static int coredump_reader_start(FAR struct coredump_reader_s *reader)
+{
+  int ret;
+
+  reader->head = 0;
+  reader->stop = false;
+  sem_init(&reader->empty, 0, COREDUMP_SWAPBUFFER_NUM);
+  sem_init(&reader->full, 0, 0);
+
+  ret = pthread_create(&reader->thread, NULL, coredump_reader_thread,
+                       reader);
+  if (ret != 0)
+    {
+      sem_destroy(&reader->empty);
+      sem_destroy(&reader->full);
+      return -ret;
+    }
+
+  return 0;
+}
+
+static ssize_t coredump_reader_get(FAR struct coredump_reader_s *reader,
+                                   FAR unsigned char **buf)
+{
+  sem_wait(&reader->full);
+  *buf = reader->buf[reader->head];
+  return reader->len[reader->head];
+}
+
+static void coredump_reader_put(FAR struct coredump_reader_s *reader)
+{
+  reader->head ^= 1;
+  sem_post(&reader->empty);
+}
+
+static void coredump_reader_stop(FAR struct coredump_reader_s *reader)
+{
+  reader->stop = true;
+  sem_post(&reader->empty);
+  pthread_join(reader->thread, NULL);
+  sem_destroy(&reader->empty);
+  sem_destroy(&reader->full);
+}
+
+#else
+
+static int coredump_reader_start(FAR struct coredump_reader_s *reader)
+{
+  return 0;
+}
+
+static ssize_t coredump_reader_get(FAR struct coredump_reader_s *reader,
+                                   FAR unsigned char **buf)
+{
+  ssize_t nread;
+
+  if (reader->remain == 0)
+    {
+      return 0;
+    }
+
+  nread = read(reader->fd, reader->buf[0],
+               MIN(reader->remain, CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE));
+  if (nread < 0)
+    {
+      return -errno;
+    }
+
+  reader->remain -= nread;
+  *buf = reader->buf[0];
+  return nread;
+}
+
+static void coredump_reader_put(FAR struct coredump_reader_s *reader)
+{
+}
+
+static void coredump_reader_stop(FAR struct coredump_reader_s *reader)
+{
+}
+
+#endif
+
 /****************************************************************************
  * dumpfile_get_info
  ****************************************************************************/
@@ -211,23 +472,97 @@ static int dumpfile_get_info(int fd, FAR struct coredump_info_s *info)
   return 0;
 }
 
+/****************************************************************************
+ * coredump_copy
+ *
+ * Description:
+ *   Copy the first "size" bytes of the block/mtd device to "stream" and
+ *   flush it.  Return the number of bytes copied, which is short of
+ *   "size" if a read or write failed, or a negated errno.
+ *
+ ****************************************************************************/
+
+static ssize_t coredump_copy(FAR struct coredump_reader_s *reader,
+                             FAR struct lib_outstream_s *stream,
+                             size_t size)
+{
+  FAR unsigned char *buf;
+  ssize_t writesize;
+  ssize_t readsize;
+  size_t offset = 0;
+  int ret;
+
+  if (lseek(reader->fd, 0, SEEK_SET) < 0)
+    {
+      printf("Seek %s fail\n", CONFIG_SYSTEM_COREDUMP_DEVPATH);
+      return -errno;
+    }
+
+  reader->remain = size;
+  ret = coredump_reader_start(reader);
+  if (ret < 0)
+    {
+      printf("Start reader fail: %d\n", ret);
+      return ret;
+    }
+
+  while (offset < size)
+    {
+      readsize = coredump_reader_get(reader, &buf);
+      if (readsize < 0)
+        {
+          printf("Read %s fail\n", CONFIG_SYSTEM_COREDUMP_DEVPATH);
+          break;
+        }
+      else if (readsize == 0)
+        {
+          break;
+        }
+
+      writesize = lib_stream_puts(stream, buf, readsize);
+      coredump_reader_put(reader);
+      if (writesize != readsize)
+        {
+          printf("Write coredump fail\n");
+          break;
+        }
+
+      offset += writesize;
+    }
+
+  coredump_reader_stop(reader);
+  lib_stream_flush(stream);
+  return offset;
+}
+
 /****************************************************************************
  * coredump_restore
  ****************************************************************************/
 
-static void coredump_restore(FAR char *savepath, size_t maxfile)
+static void coredump_restore(FAR char *savepath, size_t maxfile,
+                             size_t maxsize)
 {
+  struct coredump_reader_s reader;
+  struct lib_rawoutstream_s rawstream;
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_COMPRESSION
+  FAR struct lib_lzfoutstream_s *lstream;
+#endif
+  FAR struct lib_outstream_s *stream;
   struct coredump_info_s info;
   char dumppath[PATH_MAX];
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_COMPRESSION
+  char corepath[PATH_MAX];
+#endif
   unsigned char *swap;
   ssize_t writesize;
-  ssize_t readsize;
-  size_t offset = 0;
+  ssize_t copied;
+  size_t offset;
   size_t max = 0;
   int dumpfd;
   int blkfd;
   off_t off;
   int ret;
+  int i;
   Elf_Nhdr nhdr =
     {
       0
@@ -261,6 +596,20 @@ static void coredump_restore(FAR char *savepath, size_t maxfile)
         }
     }
 
+  /* Reserve the raw core size before writing.  The restored file does not
+   * end up larger than that: a core that LZF does not shrink is stored
+   * uncompressed instead.
+   */
+
+  if (maxsize > 0)
+    {
+      ret = dumpfile_reclaim(savepath, info.size, maxsize);
+      if (ret < 0)
+        {
+          goto blkfd_err;
+        }
+    }
+
   /* 'date -d @$(printf "%d" 0x6720C67E)' restore utc to date */
 
   ret = snprintf(dumppath, sizeof(dumppath),
@@ -283,36 +632,84 @@ static void coredump_restore(FAR char *savepath, size_t maxfile)
       goto blkfd_err;
     }
 
-  swap = malloc(CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE);
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_COMPRESSION
+  swap = malloc(CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE *
+                COREDUMP_SWAPBUFFER_NUM + sizeof(*lstream));
+#else
+  swap = malloc(CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE *
+                COREDUMP_SWAPBUFFER_NUM);
+#endif
+
   if (swap == NULL)
     {
       printf("Malloc fail\n");
       goto fd_err;
     }
 
-  lseek(blkfd, 0, SEEK_SET);
-  while (offset < info.size)
+  /* Initialize the output stream, compress on the fly if requested */
+
+  lib_rawoutstream(&rawstream, dumpfd);
+  stream = &rawstream.common;
+
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_COMPRESSION
+  lstream = (FAR void *)(swap + CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE *
+                                COREDUMP_SWAPBUFFER_NUM);
+  lib_lzfoutstream(lstream, stream);
+  stream = &lstream->common;
+#endif
+
+  for (i = 0; i < COREDUMP_SWAPBUFFER_NUM; i++)
+    {
+      reader.buf[i] = swap + CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE * i;
+    }
+
+  reader.fd = blkfd;
+
+  copied = coredump_copy(&reader, stream, info.size);
+  if (copied < 0)
     {
-      readsize = read(blkfd, swap, CONFIG_SYSTEM_COREDUMP_SWAPBUFFER_SIZE);
-      if (readsize < 0)
+      goto swap_err;
+    }
+
+  offset = copied;
+
+#ifdef CONFIG_SYSTEM_COREDUMP_RESTORE_COMPRESSION
+  /* LZF output is larger than its input on incompressible data, keep
+   * the core uncompressed then, so that the stored file never grows past
+   * the size reserved for it.
+   */
+
+  if (offset == info.size && (size_t)rawstream.common.nput >= offset)
+    {
+      snprintf(corepath, sizeof(corepath), "%.*s"COREDUMP_RAW_SUFFIX,
+               (int)(strlen(dumppath) - strlen(COREDUMP_LZF_SUFFIX)),
+               dumppath);
+
+      /* The compressed file is left intact until it can be replaced */
+
+      if (rename(dumppath, corepath) < 0)
         {
-          printf("Read %s fail\n", CONFIG_SYSTEM_COREDUMP_DEVPATH);
-          break;
+          printf("Keep %s compressed\n", dumppath);
         }
-      else if (readsize == 0)
+      else if (lseek(dumpfd, 0, SEEK_SET) < 0 || ftruncate(dumpfd, 0) < 0)
         {
-          break;
+          rename(corepath, dumppath);
+          printf("Keep %s compressed\n", dumppath);
         }
-
-      writesize = write(dumpfd, swap, readsize);
-      if (writesize != readsize)
+      else
         {
-          printf("Write %s fail\n", dumppath);
-          break;
+          strlcpy(dumppath, corepath, sizeof(dumppath));
+          lib_rawoutstream(&rawstream, dumpfd);
+          copied = coredump_copy(&reader, &rawstream.common, info.size);
+          if (copied < 0)
+            {
+              goto swap_err;
+            }
+
+          offset = copied;
         }
-
-      offset += writesize;
     }
+#endif
 
   if (offset < info.size)
     {
@@ -484,6 +881,9 @@ static void usage(FAR const char *progname, int exitcode)
   fprintf(stderr, "\t -s, --savepath <savepath>\n");
   fprintf(stderr, "\t -m, --maxfile <maxfile>,"
                   "Maximum number of coredump files, Default 1\n");
+  fprintf(stderr, "\t -z, --maxsize <bytes>,"
+                  "Maximum total size of coredump files, "
+                  "oldest removed first, Default 0 (unlimited)\n");
 #endif
   exit(exitcode);
 }
@@ -501,6 +901,7 @@ int main(int argc, FAR char *argv[])
 #ifdef CONFIG_SYSTEM_COREDUMP_RESTORE
   FAR char *savepath = NULL;
   size_t maxfile = 1;
+  size_t maxsize = 0;
 #endif
   char *name = NULL;
   int pid = INVALID_PROCESS_ID;
@@ -513,11 +914,12 @@ int main(int argc, FAR char *argv[])
 #ifdef CONFIG_SYSTEM_COREDUMP_RESTORE
       {"savepath", 1, NULL, 's'},
       {"maxfile", 1, NULL, 'm'},
+      {"maxsize", 1, NULL, 'z'},
 #endif
       {"help", 0, NULL, 'h'}
     };
 
-  while ((ret = getopt_long(argc, argv, "p:f:s:m:h", options, NULL))
+  while ((ret = getopt_long(argc, argv, "p:f:s:m:z:h", options, NULL))
          != ERROR)
     {
       switch (ret)
@@ -535,6 +937,9 @@ int main(int argc, FAR char *argv[])
           case 'm':
             maxfile = atoi(optarg);
             break;
+          case 'z':
+            maxsize = strtoul(optarg, NULL, 0);
+            break;
 #endif
           case 'h':
           default:
@@ -546,7 +951,7 @@ int main(int argc, FAR char *argv[])
 #ifdef CONFIG_SYSTEM_COREDUMP_RESTORE
   if (savepath != NULL)
     {
-      coredump_restore(savepath, maxfile);
+      coredump_restore(savepath, maxfile, maxsize);
     }
   else
 #endif
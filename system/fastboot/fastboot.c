@@ -31,6 +31,8 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <inttypes.h>
+#include <pthread.h>
+#include <semaphore.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
@@ -48,6 +50,11 @@
 #include <sys/poll.h>
 #include <sys/wait.h>
 
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+#  include <netinet/in.h>
+#  include <sys/socket.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -62,6 +69,10 @@
 
 #define FASTBOOT_MSG_LEN            64
 
+#define FASTBOOT_TCP_HANDSHAKE      "FB01"
+#define FASTBOOT_TCP_HANDSHAKE_LEN  4
+#define FASTBOOT_TCP_HEADER_LEN     8
+
 #define FASTBOOT_SPARSE_MAGIC       0xed26ff3a
 #define FASTBOOT_CHUNK_RAW          0xcac1
 #define FASTBOOT_CHUNK_FILL         0xcac2
@@ -125,10 +136,75 @@ struct fastboot_file_s
   off_t offset;
 };
 
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+
+/* State of the incremental sparse image parser */
+
+enum fastboot_stream_state_e
+{
+  FASTBOOT_STREAM_HEADER,       /* Collecting the sparse file header */
+  FASTBOOT_STREAM_CHUNK_HEADER, /* Collecting a chunk header */
+  FASTBOOT_STREAM_RAW,          /* Programming raw chunk data */
+  FASTBOOT_STREAM_FILL,         /* Collecting the fill value */
+  FASTBOOT_STREAM_SKIP,         /* Skipping chunk data (CRC32, unknown) */
+  FASTBOOT_STREAM_PLAIN,        /* Not a sparse image, program as is */
+  FASTBOOT_STREAM_DONE          /* All chunks handled */
+};
+
+/* Streaming flash: the command thread receives the image into one half of
+ * the download buffer while the program thread writes the other half to
+ * flash, so the image size is not limited by the download buffer.
+ */
+
+struct fastboot_stream_s
+{
+  char partition[NAME_MAX + 1];      /* Armed by "oem stream", or empty */
+  bool done;                         /* Download finished, flash pending */
+  int result;                        /* First flash error, or OK */
+  int fd;
+  enum fastboot_stream_state_e state;
+  struct fastboot_sparse_header_s sparse;
+  uint8_t header[FASTBOOT_SPARSE_HEADER];
+  size_t header_len;
+  uint32_t chunks;                   /* Chunks left in the image */
+  uint32_t chunk_blks;               /* Output blocks of the chunk */
+  uint64_t remain;                   /* Bytes left in RAW/SKIP state */
+  off_t offset;                      /* Flash offset of the next write */
+  FAR uint8_t *buf[2];
+  size_t len[2];
+  size_t buf_size;
+  sem_t empty;
+  sem_t full;
+  pthread_t thread;
+};
+
+#endif
+
+struct fastboot_ctx_s;
+
+/* Host transport, USB bulk endpoints or the fastboot TCP protocol */
+
+struct fastboot_transport_ops_s
+{
+  CODE int (*init)(FAR struct fastboot_ctx_s *context);
+  CODE void (*deinit)(FAR struct fastboot_ctx_s *context);
+  CODE ssize_t (*read)(FAR struct fastboot_ctx_s *context,
+                       FAR void *buf, size_t len);
+  CODE int (*write)(FAR struct fastboot_ctx_s *context,
+                    FAR const void *buf, size_t len);
+};
+
 struct fastboot_ctx_s
 {
+  /* usbdev_in and usbdev_out are both the client socket for TCP */
+
   int usbdev_in;
   int usbdev_out;
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+  int tcp_listen;
+  uint64_t tcp_remain;               /* Unread bytes of the current packet */
+#endif
+  FAR const struct fastboot_transport_ops_s *ops;
   int flash_fd;
   size_t download_max;
   size_t download_size;
@@ -137,6 +213,9 @@ struct fastboot_ctx_s
   int wait_ms;
   FAR void *download_buffer;
   FAR struct fastboot_var_s *varlist;
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+  struct fastboot_stream_s stream;
+#endif
   CODE int (*upload_func)(FAR struct fastboot_ctx_s *context);
   struct
     {
@@ -185,6 +264,27 @@ static void fastboot_filedump(FAR struct fastboot_ctx_s *context,
 static void fastboot_shell(FAR struct fastboot_ctx_s *context,
                            FAR const char *arg);
 #endif
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+static void fastboot_stream(FAR struct fastboot_ctx_s *context,
+                            FAR const char *arg);
+#endif
+
+#ifdef CONFIG_USBFASTBOOT
+static int fastboot_usbdev_init(FAR struct fastboot_ctx_s *context);
+static void fastboot_usbdev_deinit(FAR struct fastboot_ctx_s *context);
+static ssize_t fastboot_usbdev_read(FAR struct fastboot_ctx_s *context,
+                                    FAR void *buf, size_t len);
+static int fastboot_usbdev_write(FAR struct fastboot_ctx_s *context,
+                                 FAR const void *buf, size_t len);
+#endif
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+static int fastboot_tcp_init(FAR struct fastboot_ctx_s *context);
+static void fastboot_tcp_deinit(FAR struct fastboot_ctx_s *context);
+static ssize_t fastboot_tcp_read(FAR struct fastboot_ctx_s *context,
+                                 FAR void *buf, size_t len);
+static int fastboot_tcp_write(FAR struct fastboot_ctx_s *context,
+                              FAR const void *buf, size_t len);
+#endif
 
 /****************************************************************************
  * Private Data
@@ -209,7 +309,30 @@ static const struct fastboot_cmd_s g_oem_cmd[] =
 #ifdef CONFIG_SYSTEM_FASTBOOTD_SHELL
   { "shell",              fastboot_shell            },
 #endif
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+  { "stream",             fastboot_stream           },
+#endif
+};
+
+#ifdef CONFIG_USBFASTBOOT
+static const struct fastboot_transport_ops_s g_usb_tran_ops =
+{
+  fastboot_usbdev_init,
+  fastboot_usbdev_deinit,
+  fastboot_usbdev_read,
+  fastboot_usbdev_write
+};
+#endif
+
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+static const struct fastboot_transport_ops_s g_tcp_tran_ops =
+{
+  fastboot_tcp_init,
+  fastboot_tcp_deinit,
+  fastboot_tcp_read,
+  fastboot_tcp_write
 };
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -233,9 +356,9 @@ static ssize_t fastboot_read(int fd, FAR void *buf, size_t len)
   return r < 0 ? -errno : r;
 }
 
-static int fastboot_write(int fd, FAR void *buf, size_t len)
+static int fastboot_write(int fd, FAR const void *buf, size_t len)
 {
-  FAR char *data = buf;
+  FAR const char *data = buf;
 
   while (len > 0)
     {
@@ -264,7 +387,7 @@ static void fastboot_ack(FAR struct fastboot_ctx_s *context,
     }
 
   snprintf(response, FASTBOOT_MSG_LEN, "%s%s", code, reason);
-  fastboot_write(context->usbdev_out, response, strlen(response));
+  context->ops->write(context, response, strlen(response));
 }
 
 static void fastboot_fail(FAR struct fastboot_ctx_s *context,
@@ -307,7 +430,7 @@ static void fastboot_flash_close(int fd)
 }
 
 static int fastboot_flash_write(int fd, off_t offset,
-                                FAR void *data,
+                                FAR const void *data,
                                 size_t size)
 {
   int ret;
@@ -467,6 +590,30 @@ static void fastboot_flash(FAR struct fastboot_ctx_s *context,
   char blkdev[PATH_MAX];
   int ret;
 
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+  if (context->stream.done)
+    {
+      /* The image is already programmed during download */
+
+      context->stream.done = false;
+      if (strcmp(arg, context->stream.partition) != 0)
+        {
+          fastboot_fail(context, "Streamed to %s",
+                        context->stream.partition);
+        }
+      else if (context->stream.result < 0)
+        {
+          fastboot_fail(context, "Image flash failure");
+        }
+      else
+        {
+          fastboot_okay(context, "");
+        }
+
+      return;
+    }
+#endif
+
   snprintf(blkdev, PATH_MAX, FASTBOOT_BLKDEV, arg);
 
   if (context->flash_fd < 0)
@@ -550,6 +697,363 @@ static void fastboot_erase(FAR struct fastboot_ctx_s *context,
   fastboot_flash_close(fd);
 }
 
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+
+/****************************************************************************
+ * Name: fastboot_stream_collect
+ *
+ * Description:
+ *   Accumulate a header that may be split across receive buffers.  Return
+ *   true once "size" bytes are available in stream->header.
+ *
+ ****************************************************************************/
+
+static bool fastboot_stream_collect(FAR struct fastboot_stream_s *stream,
+                                    FAR const uint8_t **data,
+                                    FAR size_t *len, size_t size)
+{
+  size_t n = MIN(*len, size - stream->header_len);
+
+  memcpy(stream->header + stream->header_len, *data, n);
+  stream->header_len += n;
+  *data += n;
+  *len -= n;
+
+  if (stream->header_len < size)
+    {
+      return false;
+    }
+
+  stream->header_len = 0;
+  return true;
+}
+
+static void fastboot_stream_next_chunk(FAR struct fastboot_stream_s *stream)
+{
+  stream->state = stream->chunks-- > 0 ? FASTBOOT_STREAM_CHUNK_HEADER :
+                                         FASTBOOT_STREAM_DONE;
+}
+
+/****************************************************************************
+ * Name: fastboot_stream_program
+ *
+ * Description:
+ *   Feed the next piece of the image to the sparse parser and program the
+ *   flash.  Chunks and headers may be split at any byte.
+ *
+ ****************************************************************************/
+
+static int fastboot_stream_program(FAR struct fastboot_stream_s *stream,
+                                   FAR const uint8_t *data, size_t len)
+{
+  FAR struct fastboot_chunk_header_s *chunk;
+  uint32_t blk_sz = stream->sparse.blk_sz;
+  size_t n;
+  int ret;
+
+  while (len > 0)
+    {
+      switch (stream->state)
+        {
+          case FASTBOOT_STREAM_HEADER:
+            if (!fastboot_stream_collect(stream, &data, &len,
+                                         FASTBOOT_SPARSE_HEADER))
+              {
+                break;
+              }
+
+            memcpy(&stream->sparse, stream->header, FASTBOOT_SPARSE_HEADER);
+            if (stream->sparse.magic != FASTBOOT_SPARSE_MAGIC)
+              {
+                /* No sparse header, the collected bytes are image data */
+
+                ret = fastboot_flash_write(stream->fd, 0, stream->header,
+                                           FASTBOOT_SPARSE_HEADER);
+                if (ret < 0)
+                  {
+                    return ret;
+                  }
+
+                stream->offset = FASTBOOT_SPARSE_HEADER;
+                stream->state  = FASTBOOT_STREAM_PLAIN;
+                break;
+              }
+
+            blk_sz = stream->sparse.blk_sz;
+            stream->chunks = stream->sparse.total_chunks;
+            fastboot_stream_next_chunk(stream);
+            break;
+
+          case FASTBOOT_STREAM_CHUNK_HEADER:
+            if (!fastboot_stream_collect(stream, &data, &len,
+                                         FASTBOOT_CHUNK_HEADER))
+              {
+                break;
+              }
+
+            chunk = (FAR struct fastboot_chunk_header_s *)stream->header;
+            if (chunk->total_sz < FASTBOOT_CHUNK_HEADER)
+              {
+                fb_err("Error chunk size:%" PRIu32 "\n", chunk->total_sz);
+                return -EINVAL;
+              }
+
+            stream->chunk_blks = chunk->chunk_sz;
+            stream->remain = chunk->total_sz - FASTBOOT_CHUNK_HEADER;
+
+            switch (chunk->chunk_type)
+              {
+                case FASTBOOT_CHUNK_RAW:
+                  stream->state = FASTBOOT_STREAM_RAW;
+                  break;
+                case FASTBOOT_CHUNK_FILL:
+                  stream->state = FASTBOOT_STREAM_FILL;
+                  break;
+                case FASTBOOT_CHUNK_DONT_CARE:
+                  stream->offset += (off_t)stream->chunk_blks * blk_sz;
+                  stream->state = FASTBOOT_STREAM_SKIP;
+                  break;
+                case FASTBOOT_CHUNK_CRC32:
+                  stream->state = FASTBOOT_STREAM_SKIP;
+                  break;
+                default:
+                  fb_err("Error chunk type:%d, skip\n", chunk->chunk_type);
+                  stream->state = FASTBOOT_STREAM_SKIP;
+                  break;
+              }
+
+            if (stream->remain == 0)
+              {
+                fastboot_stream_next_chunk(stream);
+              }
+
+            break;
+
+          case FASTBOOT_STREAM_RAW:
+            n = MIN(len, stream->remain);
+            ret = fastboot_flash_write(stream->fd, stream->offset, data, n);
+            if (ret < 0)
+              {
+                return ret;
+              }
+
+            stream->offset += n;
+            stream->remain -= n;
+            data += n;
+            len  -= n;
+
+            if (stream->remain == 0)
+              {
+                fastboot_stream_next_chunk(stream);
+              }
+
+            break;
+
+          case FASTBOOT_STREAM_FILL:
+            if (!fastboot_stream_collect(stream, &data, &len, 4))
+              {
+                break;
+              }
+
+            ret = ffastboot_flash_fill(stream->fd, stream->offset,
+                                       FASTBOOT_GETUINT32(stream->header),
+                                       blk_sz, stream->chunk_blks);
+            if (ret < 0)
+              {
+                return ret;
+              }
+
+            stream->offset += (off_t)stream->chunk_blks * blk_sz;
+            fastboot_stream_next_chunk(stream);
+            break;
+
+          case FASTBOOT_STREAM_SKIP:
+            n = MIN(len, stream->remain);
+            stream->remain -= n;
+            data += n;
+            len  -= n;
+
+            if (stream->remain == 0)
+              {
+                fastboot_stream_next_chunk(stream);
+              }
+
+            break;
+
+          case FASTBOOT_STREAM_PLAIN:
+            ret = fastboot_flash_write(stream->fd, stream->offset, data,
+                                       len);
+            if (ret < 0)
+              {
+                return ret;
+              }
+
+            stream->offset += len;
+            len = 0;
+            break;
+
+          case FASTBOOT_STREAM_DONE:
+            len = 0;
+            break;
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: fastboot_stream_thread
+ *
+ * Description:
+ *   Program each received buffer while the next one is being received.
+ *   A zero length buffer terminates the thread.
+ *
+ ****************************************************************************/
+
+static FAR void *fastboot_stream_thread(FAR void *arg)
+{
+  FAR struct fastboot_stream_s *stream = arg;
+  int i = 0;
+
+  for (; ; )
+    {
+      sem_wait(&stream->full);
+      if (stream->len[i] == 0)
+        {
+          break;
+        }
+
+      /* Keep draining after an error so the host can finish sending */
+
+      if (stream->result >= 0)
+        {
+          stream->result = fastboot_stream_program(stream, stream->buf[i],
+                                                   stream->len[i]);
+        }
+
+      sem_post(&stream->empty);
+      i ^= 1;
+    }
+
+  return NULL;
+}
+
+static void fastboot_stream_download(FAR struct fastboot_ctx_s *context,
+                                     unsigned long len)
+{
+  FAR struct fastboot_stream_s *stream = &context->stream;
+  char response[FASTBOOT_MSG_LEN];
+  char blkdev[PATH_MAX];
+  bool received = true;
+  ssize_t r;
+  size_t n;
+  int ret;
+  int i;
+
+  snprintf(blkdev, PATH_MAX, FASTBOOT_BLKDEV, stream->partition);
+  stream->fd = fastboot_flash_open(blkdev);
+  if (stream->fd < 0)
+    {
+      fastboot_fail(context, "Flash open failure");
+      return;
+    }
+
+  stream->done       = false;
+  stream->result     = OK;
+  stream->state      = FASTBOOT_STREAM_HEADER;
+  stream->header_len = 0;
+  stream->offset     = 0;
+  stream->buf_size   = context->download_max / 2;
+  stream->buf[0]     = context->download_buffer;
+  stream->buf[1]     = stream->buf[0] + stream->buf_size;
+
+  sem_init(&stream->empty, 0, 2);
+  sem_init(&stream->full, 0, 0);
+  ret = pthread_create(&stream->thread, NULL, fastboot_stream_thread,
+                       stream);
+  if (ret != 0)
+    {
+      fastboot_fail(context, "Stream thread failure");
+      goto out_sem;
+    }
+
+  snprintf(response, FASTBOOT_MSG_LEN, "DATA%08lx", len);
+  ret = context->ops->write(context, response, strlen(response));
+  if (ret < 0)
+    {
+      fb_err("Reponse error [%d]\n", -ret);
+      received = false;
+      len = 0;
+    }
+
+  for (i = 0; len > 0; i ^= 1)
+    {
+      sem_wait(&stream->empty);
+
+      /* Fill the whole buffer so that flash sees large sequential writes */
+
+      for (n = 0; n < stream->buf_size && len > 0; )
+        {
+          r = context->ops->read(context, stream->buf[i] + n,
+                                 MIN(stream->buf_size - n, len));
+          if (r <= 0)
+            {
+              fb_err("fastboot_stream_download read error\n");
+              received = false;
+              len = 0;
+              break;
+            }
+
+          n   += r;
+          len -= r;
+        }
+
+      stream->len[i] = n;
+      sem_post(&stream->full);
+    }
+
+  /* The empty buffer tells the program thread to finish */
+
+  sem_wait(&stream->empty);
+  stream->len[i] = 0;
+  sem_post(&stream->full);
+  pthread_join(stream->thread, NULL);
+
+  if (stream->result >= 0 && stream->state == FASTBOOT_STREAM_HEADER &&
+      stream->header_len > 0)
+    {
+      /* An image shorter than a sparse header */
+
+      stream->result = fastboot_flash_write(stream->fd, 0, stream->header,
+                                            stream->header_len);
+    }
+
+  if (!received)
+    {
+      goto out_sem;
+    }
+
+  if (stream->result < 0)
+    {
+      fastboot_fail(context, "Image flash failure");
+    }
+  else
+    {
+      fb_info("Streamed %" PRIdOFF " bytes to %s\n", stream->offset,
+              blkdev);
+      stream->done = true;
+      fastboot_okay(context, "");
+    }
+
+out_sem:
+  sem_destroy(&stream->empty);
+  sem_destroy(&stream->full);
+  fastboot_flash_close(stream->fd);
+  stream->fd = -1;
+}
+
+#endif /* CONFIG_SYSTEM_FASTBOOTD_STREAM */
+
 static void fastboot_download(FAR struct fastboot_ctx_s *context,
                               FAR const char *arg)
 {
@@ -559,6 +1063,15 @@ static void fastboot_download(FAR struct fastboot_ctx_s *context,
   int ret;
 
   len = strtoul(arg, NULL, 16);
+
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+  if (context->stream.partition[0] != '\0')
+    {
+      fastboot_stream_download(context, len);
+      return;
+    }
+#endif
+
   if (len > context->download_max)
     {
       fastboot_fail(context, "Data too large");
@@ -566,7 +1079,7 @@ static void fastboot_download(FAR struct fastboot_ctx_s *context,
     }
 
   snprintf(response, FASTBOOT_MSG_LEN, "DATA%08lx", len);
-  ret = fastboot_write(context->usbdev_out, response, strlen(response));
+  ret = context->ops->write(context, response, strlen(response));
   if (ret < 0)
     {
       fb_err("Reponse error [%d]\n", -ret);
@@ -578,8 +1091,7 @@ static void fastboot_download(FAR struct fastboot_ctx_s *context,
 
   while (len > 0)
     {
-      ssize_t r = fastboot_read(context->usbdev_in,
-                                download, len);
+      ssize_t r = context->ops->read(context, download, len);
       if (r < 0)
         {
           context->download_size = 0;
@@ -600,6 +1112,19 @@ static void fastboot_getvar(FAR struct fastboot_ctx_s *context,
   FAR struct fastboot_var_s *var;
   char buffer[FASTBOOT_MSG_LEN];
 
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+  if (context->stream.partition[0] != '\0' &&
+      !strcmp(arg, "max-download-size"))
+    {
+      /* Streamed images are not buffered, let the host send them whole */
+
+      snprintf(buffer, sizeof(buffer), "0x%08x",
+               CONFIG_SYSTEM_FASTBOOTD_STREAM_MAX);
+      fastboot_okay(context, buffer);
+      return;
+    }
+#endif
+
   for (var = context->varlist; var != NULL; var = var->next)
     {
       if (!strcmp(var->name, arg))
@@ -645,9 +1170,9 @@ static void fastboot_reboot_bootloader(FAR struct fastboot_ctx_s *context,
 
 static int fastboot_memdump_upload(FAR struct fastboot_ctx_s *context)
 {
-  return fastboot_write(context->usbdev_out,
-                        context->upload_param.u.mem.addr,
-                        context->upload_param.size);
+  return context->ops->write(context,
+                             context->upload_param.u.mem.addr,
+                             context->upload_param.size);
 }
 
 /* Usage(host):
@@ -709,9 +1234,9 @@ static int fastboot_filedump_upload(FAR struct fastboot_ctx_s *context)
           break;
         }
       else if (nread < 0 ||
-               fastboot_write(context->usbdev_out,
-                              context->download_buffer,
-                              nread) < 0)
+               context->ops->write(context,
+                                   context->download_buffer,
+                                   nread) < 0)
         {
           fb_err("Upload failed (%zu bytes left)\n", size);
           close(fd);
@@ -815,6 +1340,36 @@ static void fastboot_shell(FAR struct fastboot_ctx_s *context,
 }
 #endif
 
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+
+/* Usage(host):
+ *   fastboot oem stream <partition>
+ *   fastboot flash <partition> <image>
+ *
+ * Program the following downloads straight to /dev/<partition> while they
+ * are received, instead of buffering them for the flash command.  Without
+ * an argument the stream mode is turned off again.
+ */
+
+static void fastboot_stream(FAR struct fastboot_ctx_s *context,
+                            FAR const char *arg)
+{
+  context->stream.done = false;
+  if (arg == NULL)
+    {
+      context->stream.partition[0] = '\0';
+    }
+  else
+    {
+      strlcpy(context->stream.partition, arg,
+              sizeof(context->stream.partition));
+    }
+
+  fb_info("Stream partition: %s\n", context->stream.partition);
+  fastboot_okay(context, "");
+}
+#endif
+
 static void fastboot_upload(FAR struct fastboot_ctx_s *context,
                             FAR const char *arg)
 {
@@ -830,7 +1385,7 @@ static void fastboot_upload(FAR struct fastboot_ctx_s *context,
   snprintf(response, FASTBOOT_MSG_LEN, "DATA%08zx",
            context->upload_param.size);
 
-  ret = fastboot_write(context->usbdev_out, response, strlen(response));
+  ret = context->ops->write(context, response, strlen(response));
   if (ret < 0)
     {
       fb_err("Reponse error [%d]\n", -ret);
@@ -899,11 +1454,10 @@ static void fastboot_command_loop(FAR struct fastboot_ctx_s *context)
       size_t ncmds = nitems(g_fast_cmd);
       size_t index;
 
-      ssize_t r = fastboot_read(context->usbdev_in,
-                                buffer, FASTBOOT_MSG_LEN);
+      ssize_t r = context->ops->read(context, buffer, FASTBOOT_MSG_LEN);
       if (r < 0)
         {
-          fb_err("USB read error\n");
+          fb_err("Transport read error\n");
           break;
         }
 
@@ -968,6 +1522,7 @@ static void fastboot_free_publish(FAR struct fastboot_ctx_s *context)
     }
 }
 
+#ifdef CONFIG_USBFASTBOOT
 static int fastboot_open_usb(int index, int flags)
 {
   int try = FASTBOOT_EP_RETRY_TIMES;
@@ -993,6 +1548,218 @@ static int fastboot_open_usb(int index, int flags)
   return -errno;
 }
 
+static int fastboot_usbdev_init(FAR struct fastboot_ctx_s *context)
+{
+  context->usbdev_in =
+      fastboot_open_usb(FASTBOOT_EP_BULKOUT_IDX, O_RDONLY | O_CLOEXEC);
+  if (context->usbdev_in < 0)
+    {
+      return context->usbdev_in;
+    }
+
+  context->usbdev_out =
+      fastboot_open_usb(FASTBOOT_EP_BULKIN_IDX, O_WRONLY | O_CLOEXEC);
+  if (context->usbdev_out < 0)
+    {
+      close(context->usbdev_in);
+      context->usbdev_in = -1;
+      return context->usbdev_out;
+    }
+
+  return OK;
+}
+
+static void fastboot_usbdev_deinit(FAR struct fastboot_ctx_s *context)
+{
+  close(context->usbdev_out);
+  context->usbdev_out = -1;
+  close(context->usbdev_in);
+  context->usbdev_in = -1;
+}
+
+static ssize_t fastboot_usbdev_read(FAR struct fastboot_ctx_s *context,
+                                    FAR void *buf, size_t len)
+{
+  return fastboot_read(context->usbdev_in, buf, len);
+}
+
+static int fastboot_usbdev_write(FAR struct fastboot_ctx_s *context,
+                                 FAR const void *buf, size_t len)
+{
+  return fastboot_write(context->usbdev_out, buf, len);
+}
+#endif
+
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+
+/* Fastboot over TCP: after a "FB01" handshake in both directions every
+ * message is prefixed with its length as a 64-bit big-endian integer.
+ */
+
+static int fastboot_tcp_readall(int fd, FAR void *buf, size_t len)
+{
+  FAR char *data = buf;
+
+  while (len > 0)
+    {
+      ssize_t r = read(fd, data, len);
+      if (r <= 0)
+        {
+          return r < 0 ? -errno : -ECONNRESET;
+        }
+
+      data += r;
+      len -= r;
+    }
+
+  return OK;
+}
+
+static int fastboot_tcp_init(FAR struct fastboot_ctx_s *context)
+{
+  char handshake[FASTBOOT_TCP_HANDSHAKE_LEN];
+  struct sockaddr_in addr;
+  int optval = 1;
+  int fd;
+  int ret;
+
+  if (context->tcp_listen < 0)
+    {
+      context->tcp_listen = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      if (context->tcp_listen < 0)
+        {
+          fb_err("socket error %d\n", errno);
+          return -errno;
+        }
+
+      setsockopt(context->tcp_listen, SOL_SOCKET, SO_REUSEADDR,
+                 &optval, sizeof(optval));
+
+      memset(&addr, 0, sizeof(addr));
+      addr.sin_family      = AF_INET;
+      addr.sin_port        = htons(CONFIG_SYSTEM_FASTBOOTD_TCP_PORT);
+      addr.sin_addr.s_addr = htonl(INADDR_ANY);
+
+      if (bind(context->tcp_listen, (FAR struct sockaddr *)&addr,
+               sizeof(addr)) < 0 ||
+          listen(context->tcp_listen, 1) < 0)
+        {
+          fb_err("bind/listen error %d\n", errno);
+          ret = -errno;
+          close(context->tcp_listen);
+          context->tcp_listen = -1;
+          return ret;
+        }
+    }
+
+  fd = accept4(context->tcp_listen, NULL, NULL, SOCK_CLOEXEC);
+  if (fd < 0)
+    {
+      ret = -errno;
+      fb_err("accept error %d\n", -ret);
+
+      /* Only a connection that went away is worth another accept() */
+
+      if (ret != -EINTR && ret != -ECONNABORTED)
+        {
+          close(context->tcp_listen);
+          context->tcp_listen = -1;
+        }
+
+      return ret;
+    }
+
+  ret = fastboot_tcp_readall(fd, handshake, sizeof(handshake));
+  if (ret < 0 || memcmp(handshake, FASTBOOT_TCP_HANDSHAKE,
+                        FASTBOOT_TCP_HANDSHAKE_LEN) != 0)
+    {
+      fb_err("Bad handshake\n");
+      close(fd);
+      return ret < 0 ? ret : -EPROTO;
+    }
+
+  ret = fastboot_write(fd, FASTBOOT_TCP_HANDSHAKE,
+                       FASTBOOT_TCP_HANDSHAKE_LEN);
+  if (ret < 0)
+    {
+      close(fd);
+      return ret;
+    }
+
+  context->usbdev_in  = fd;
+  context->usbdev_out = fd;
+  context->tcp_remain = 0;
+  return OK;
+}
+
+static void fastboot_tcp_deinit(FAR struct fastboot_ctx_s *context)
+{
+  close(context->usbdev_in);
+  context->usbdev_in  = -1;
+  context->usbdev_out = -1;
+}
+
+static ssize_t fastboot_tcp_read(FAR struct fastboot_ctx_s *context,
+                                 FAR void *buf, size_t len)
+{
+  uint8_t header[FASTBOOT_TCP_HEADER_LEN];
+  int ret;
+  int i;
+
+  /* Return at most the rest of the current packet, so that a command is
+   * never merged with the following one.
+   */
+
+  while (context->tcp_remain == 0)
+    {
+      ret = fastboot_tcp_readall(context->usbdev_in, header,
+                                 sizeof(header));
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      for (i = 0; i < FASTBOOT_TCP_HEADER_LEN; i++)
+        {
+          context->tcp_remain = (context->tcp_remain << 8) | header[i];
+        }
+    }
+
+  len = MIN(len, context->tcp_remain);
+  ret = fastboot_tcp_readall(context->usbdev_in, buf, len);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  context->tcp_remain -= len;
+  return len;
+}
+
+static int fastboot_tcp_write(FAR struct fastboot_ctx_s *context,
+                              FAR const void *buf, size_t len)
+{
+  uint8_t header[FASTBOOT_TCP_HEADER_LEN];
+  uint64_t size = len;
+  int ret;
+  int i;
+
+  for (i = FASTBOOT_TCP_HEADER_LEN - 1; i >= 0; i--)
+    {
+      header[i] = size & 0xff;
+      size >>= 8;
+    }
+
+  ret = fastboot_write(context->usbdev_out, header, sizeof(header));
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  return fastboot_write(context->usbdev_out, buf, len);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1002,6 +1769,7 @@ int main(int argc, FAR char **argv)
   struct fastboot_ctx_s context;
   FAR void *buffer = NULL;
   int ret = OK;
+  int i;
 
 #ifdef CONFIG_SYSTEM_FASTBOOTD_USB_BOARDCTL
   struct boardioc_usbdev_ctrl_s ctrl;
@@ -1039,19 +1807,30 @@ int main(int argc, FAR char **argv)
     }
 #endif /* SYSTEM_FASTBOOTD_USB_BOARDCTL */
 
-  if (argc > 1)
+#ifdef CONFIG_USBFASTBOOT
+  context.ops = &g_usb_tran_ops;
+#else
+  context.ops = &g_tcp_tran_ops;
+#endif
+
+  context.wait_ms = 0;
+  for (i = 1; i < argc; i++)
     {
-      if (strcmp(argv[1], "-h") == 0)
+      if (strcmp(argv[i], "-h") == 0)
         {
-          fb_err("Usage: fastbootd [wait_ms]\n");
+          fb_err("Usage: fastbootd [-t] [wait_ms]\n");
           return 0;
         }
-
-      context.wait_ms = atoi(argv[1]);
-    }
-  else
-    {
-      context.wait_ms = 0;
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+      else if (strcmp(argv[i], "-t") == 0)
+        {
+          context.ops = &g_tcp_tran_ops;
+        }
+#endif
+      else
+        {
+          context.wait_ms = atoi(argv[i]);
+        }
     }
 
   buffer = malloc(CONFIG_SYSTEM_FASTBOOTD_DOWNLOAD_MAX);
@@ -1061,22 +1840,17 @@ int main(int argc, FAR char **argv)
       return -ENOMEM;
     }
 
-  context.usbdev_in =
-      fastboot_open_usb(FASTBOOT_EP_BULKOUT_IDX, O_RDONLY | O_CLOEXEC);
-  if (context.usbdev_in < 0)
-    {
-      ret = -errno;
-      goto err_with_mem;
-    }
-
-  context.usbdev_out =
-      fastboot_open_usb(FASTBOOT_EP_BULKIN_IDX, O_WRONLY | O_CLOEXEC);
-  if (context.usbdev_out < 0)
-    {
-      ret = -errno;
-      goto err_with_in;
-    }
-
+  context.usbdev_in       = -1;
+  context.usbdev_out      = -1;
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+  context.tcp_listen      = -1;
+#endif
+#ifdef CONFIG_SYSTEM_FASTBOOTD_STREAM
+  memset(&context.stream, 0, sizeof(context.stream));
+  context.stream.fd       = -1;
+#endif
+  context.upload_param.size = 0;
+  context.upload_func     = NULL;
   context.varlist         = NULL;
   context.flash_fd        = -1;
   context.download_buffer = buffer;
@@ -1086,17 +1860,43 @@ int main(int argc, FAR char **argv)
   context.total_imgsize   = 0;
 
   fastboot_create_publish(&context);
-  fastboot_command_loop(&context);
-  fastboot_free_publish(&context);
 
-  close(context.usbdev_out);
-  context.usbdev_out = -1;
+  /* USB serves a single session, TCP accepts the next host whenever the
+   * previous connection is closed.
+   */
+
+  do
+    {
+      ret = context.ops->init(&context);
+      if (ret < 0)
+        {
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+          /* A host failing the handshake only loses its own connection */
 
-err_with_in:
-  close(context.usbdev_in);
-  context.usbdev_in = -1;
+          if (context.ops == &g_tcp_tran_ops && context.tcp_listen >= 0)
+            {
+              continue;
+            }
+#endif
 
-err_with_mem:
+          break;
+        }
+
+      fastboot_command_loop(&context);
+      context.ops->deinit(&context);
+    }
+#ifdef CONFIG_SYSTEM_FASTBOOTD_TCP
+  while (context.ops == &g_tcp_tran_ops);
+
+  if (context.tcp_listen >= 0)
+    {
+      close(context.tcp_listen);
+    }
+#else
+  while (0);
+#endif
+
+  fastboot_free_publish(&context);
   free(buffer);
   return ret;
 }
@@ -24,19 +24,870 @@
  * Included Files
  ****************************************************************************/
 
+#include <nuttx/config.h>
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include <sys/gmon.h>
 
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+#  include <nuttx/allsyms.h>
+#  include <nuttx/symtab.h>
+#endif
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(CONFIG_PROFILE_NONE) || defined(CONFIG_SIM_GPROF)
+#  define GPROF_HAVE_GMON
+#endif
+
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+
+#define GPROF_SAMPLE_SIGNO     SIGALRM
+#define GPROF_SAMPLE_RATE      100    /* Default sampling rate in Hz */
+#define GPROF_SAMPLE_MAXRATE   (1000000 / CONFIG_USEC_PER_TICK)
+#define GPROF_SAMPLE_DURATION  10     /* Default duration in seconds */
+#define GPROF_SAMPLE_POLL_US   10000  /* Ring drain period */
+
+#define GPROF_SAMPLE_DEPTH     CONFIG_SYSTEM_GPROF_SAMPLE_DEPTH
+#define GPROF_SAMPLE_BUFMASK   (CONFIG_SYSTEM_GPROF_SAMPLE_BUFSIZE - 1)
+#define GPROF_SAMPLE_FUNCMASK  (CONFIG_SYSTEM_GPROF_SAMPLE_NFUNCS - 1)
+#define GPROF_SAMPLE_STACKMASK (CONFIG_SYSTEM_GPROF_SAMPLE_NSTACKS - 1)
+
+#define GPROF_STATE_BLOCKED    0
+#define GPROF_STATE_READY      1
+#define GPROF_STATE_RUNNING    2
+
+#define GPROF_OUTPUT_FLAT      (1 << 0)
+#define GPROF_OUTPUT_FOLDED    (1 << 1)
+
+#if (CONFIG_SYSTEM_GPROF_SAMPLE_BUFSIZE & GPROF_SAMPLE_BUFMASK) != 0
+#  error CONFIG_SYSTEM_GPROF_SAMPLE_BUFSIZE must be a power of two
+#endif
+
+#if (CONFIG_SYSTEM_GPROF_SAMPLE_NFUNCS & GPROF_SAMPLE_FUNCMASK) != 0
+#  error CONFIG_SYSTEM_GPROF_SAMPLE_NFUNCS must be a power of two
+#endif
+
+#if (CONFIG_SYSTEM_GPROF_SAMPLE_NSTACKS & GPROF_SAMPLE_STACKMASK) != 0
+#  error CONFIG_SYSTEM_GPROF_SAMPLE_NSTACKS must be a power of two
+#endif
+
+#endif /* CONFIG_SYSTEM_GPROF_SAMPLE */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+
+/* One raw backtrace, pc[0] is the innermost frame */
+
+struct gprof_sample_s
+{
+  pid_t pid;
+  int depth;
+  FAR void *pc[GPROF_SAMPLE_DEPTH];
+};
+
+/* Flat profile entry, keyed by the symbol containing the PC */
+
+struct gprof_func_s
+{
+  FAR const struct symtab_s *sym;
+  uint32_t self;
+  uint32_t total;
+};
+
+/* Folded stack entry, sym[0] is the innermost frame */
+
+struct gprof_stack_s
+{
+  uint32_t hash;
+  uint32_t count;
+  pid_t pid;
+  int depth;
+  FAR const struct symtab_s *sym[GPROF_SAMPLE_DEPTH];
+};
+
+struct gprof_sampler_s
+{
+  /* Single producer (sampler thread), single consumer (main thread)
+   * ring buffer.  The producer only writes head and the consumer only
+   * writes tail, so no lock is needed.
+   */
+
+  atomic_uint head;
+  atomic_uint tail;
+  atomic_uint dropped;
+  struct gprof_sample_s ring[CONFIG_SYSTEM_GPROF_SAMPLE_BUFSIZE];
+
+  volatile bool stop;
+  int depth;
+
+  /* Every thread is scanned on each tick to find the ones on a CPU, the
+   * profiled ones (all of them if npids is zero) are sampled.  The procfs
+   * status file of each thread is opened once and re-read in place, so a
+   * tick costs one read per thread and no path lookup.
+   */
+
+  int nthreads;
+  pid_t threads[CONFIG_SYSTEM_GPROF_SAMPLE_MAXTHREADS];
+  int fds[CONFIG_SYSTEM_GPROF_SAMPLE_MAXTHREADS];
+  int npids;
+  pid_t pids[CONFIG_SYSTEM_GPROF_SAMPLE_MAXTHREADS];
+
+  /* Aggregated results, only touched by the consumer */
+
+  uint32_t nsamples;
+  uint32_t overflow;
+  struct gprof_func_s funcs[CONFIG_SYSTEM_GPROF_SAMPLE_NFUNCS];
+  struct gprof_stack_s stacks[CONFIG_SYSTEM_GPROF_SAMPLE_NSTACKS];
+};
+
+#endif /* CONFIG_SYSTEM_GPROF_SAMPLE */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
+#ifdef GPROF_HAVE_GMON
 extern uint8_t _stext[];
 extern uint8_t _etext[];
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+static const struct symtab_s g_unknown_sym =
+{
+  "[unknown]", NULL
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+
+/****************************************************************************
+ * Name: gprof_status_field
+ *
+ * Description:
+ *   Return the value of a line of a procfs status buffer, or NULL.
+ *
+ ****************************************************************************/
+
+static FAR const char *gprof_status_field(FAR const char *buf,
+                                          FAR const char *name)
+{
+  FAR const char *line = strstr(buf, name);
+
+  if (line == NULL)
+    {
+      return NULL;
+    }
+
+  line += strlen(name);
+  return line + strspn(line, " \t");
+}
+
+/****************************************************************************
+ * Name: gprof_thread_state
+ *
+ * Description:
+ *   Read the scheduler state, CPU and priority of a thread from its open
+ *   procfs status file.  A thread that is assigned to a CPU but not
+ *   running there counts as ready.
+ *
+ ****************************************************************************/
+
+static int gprof_thread_state(int fd, FAR int *cpu, FAR int *prio)
+{
+  FAR const char *value;
+  char buf[256];
+  ssize_t nbytes;
+
+  nbytes = pread(fd, buf, sizeof(buf) - 1, 0);
+  if (nbytes <= 0)
+    {
+      return -1;
+    }
+
+  buf[nbytes] = '\0';
+
+  /* The CPU line is only present with SMP */
+
+  value = gprof_status_field(buf, "\nCPU:");
+  *cpu  = value != NULL ? atoi(value) : 0;
+  value = gprof_status_field(buf, "\nPriority:");
+  *prio = value != NULL ? atoi(value) : 0;
+
+  value = gprof_status_field(buf, "\nState:");
+  if (value == NULL)
+    {
+      return GPROF_STATE_BLOCKED;
+    }
+
+  return strncmp(value, "Running", 7) == 0 ? GPROF_STATE_RUNNING :
+         strncmp(value, "Ready", 5) == 0 ||
+         strncmp(value, "Assigned", 8) == 0 ?
+         GPROF_STATE_READY : GPROF_STATE_BLOCKED;
+}
+
+/****************************************************************************
+ * Name: gprof_sampler_capture
+ *
+ * Description:
+ *   Capture one backtrace of pid into the ring buffer if it is profiled.
+ *
+ ****************************************************************************/
+
+static void gprof_sampler_capture(FAR struct gprof_sampler_s *sampler,
+                                  pid_t pid)
+{
+  FAR struct gprof_sample_s *sample;
+  unsigned int head;
+  int depth;
+  int i;
+
+  for (i = 0; i < sampler->npids; i++)
+    {
+      if (sampler->pids[i] == pid)
+        {
+          break;
+        }
+    }
+
+  if (sampler->npids > 0 && i == sampler->npids)
+    {
+      return;
+    }
+
+  head = atomic_load_explicit(&sampler->head, memory_order_relaxed);
+  if (head - atomic_load_explicit(&sampler->tail, memory_order_acquire) >
+      GPROF_SAMPLE_BUFMASK)
+    {
+      atomic_fetch_add(&sampler->dropped, 1);
+      return;
+    }
+
+  sample = &sampler->ring[head & GPROF_SAMPLE_BUFMASK];
+  depth  = sched_backtrace(pid, sample->pc, sampler->depth, 0);
+  if (depth <= 0)
+    {
+      return;
+    }
+
+  sample->pid   = pid;
+  sample->depth = depth;
+  atomic_store_explicit(&sampler->head, head + 1, memory_order_release);
+}
+
+/****************************************************************************
+ * Name: gprof_sampler_thread
+ *
+ * Description:
+ *   Wait for the periodic timer signal and capture one backtrace per CPU
+ *   per tick into the ring buffer: the thread running on every other CPU
+ *   and the one the sampler preempted on its own.  Blocked threads and
+ *   threads waiting for a CPU are not sampled, so the profile shows where
+ *   CPU time went, idle threads included.
+ *
+ ****************************************************************************/
+
+static FAR void *gprof_sampler_thread(FAR void *arg)
+{
+  FAR struct gprof_sampler_s *sampler = arg;
+  sigset_t set;
+  pid_t preempted;
+  int maxprio;
+  int state;
+  int prio;
+  int self;
+  int cpu;
+  int i;
+
+  sigemptyset(&set);
+  sigaddset(&set, GPROF_SAMPLE_SIGNO);
+
+  while (!sampler->stop)
+    {
+      if (sigwaitinfo(&set, NULL) < 0)
+        {
+          continue;
+        }
+
+      /* The thread the sampler displaced went back to the head of the
+       * ready list, ahead of any ready thread of lower or equal priority
+       * that last ran on this CPU.  Equal priorities cannot be told apart
+       * from procfs, the first one listed is taken.
+       */
+
+      self      = sched_getcpu();
+      preempted = -1;
+      maxprio   = -1;
+
+      for (i = 0; i < sampler->nthreads; i++)
+        {
+          if (sampler->fds[i] < 0)
+            {
+              continue;
+            }
+
+          state = gprof_thread_state(sampler->fds[i], &cpu, &prio);
+          if (state < 0)
+            {
+              /* The thread has exited, stop scanning it */
+
+              close(sampler->fds[i]);
+              sampler->fds[i] = -1;
+            }
+          else if (state == GPROF_STATE_RUNNING)
+            {
+              gprof_sampler_capture(sampler, sampler->threads[i]);
+            }
+          else if (state == GPROF_STATE_READY && cpu == self &&
+                   prio > maxprio)
+            {
+              preempted = sampler->threads[i];
+              maxprio   = prio;
+            }
+        }
+
+      if (preempted >= 0)
+        {
+          gprof_sampler_capture(sampler, preempted);
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: gprof_symbolize
+ ****************************************************************************/
+
+static FAR const struct symtab_s *gprof_symbolize(FAR void *pc, bool ret)
+{
+  FAR const struct symtab_s *sym;
+  size_t size;
+
+  /* Return addresses point past the call, which may already be the next
+   * function if the call was the last instruction.
+   */
+
+  if (ret)
+    {
+      pc = (FAR char *)pc - 1;
+    }
+
+  sym = allsyms_findbyvalue(pc, &size);
+  if (sym == NULL || (uintptr_t)pc >= (uintptr_t)sym->sym_value + size)
+    {
+      return &g_unknown_sym;
+    }
+
+  return sym;
+}
+
+/****************************************************************************
+ * Name: gprof_func_lookup
+ ****************************************************************************/
+
+static FAR struct gprof_func_s *
+gprof_func_lookup(FAR struct gprof_sampler_s *sampler,
+                  FAR const struct symtab_s *sym)
+{
+  FAR struct gprof_func_s *func;
+  uint32_t index;
+  int i;
+
+  index = ((uintptr_t)sym >> 2) * 2654435761u;
+  for (i = 0; i < CONFIG_SYSTEM_GPROF_SAMPLE_NFUNCS; i++, index++)
+    {
+      func = &sampler->funcs[index & GPROF_SAMPLE_FUNCMASK];
+      if (func->sym == sym)
+        {
+          return func;
+        }
+      else if (func->sym == NULL)
+        {
+          func->sym = sym;
+          return func;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: gprof_stack_lookup
+ ****************************************************************************/
+
+static FAR struct gprof_stack_s *
+gprof_stack_lookup(FAR struct gprof_sampler_s *sampler, pid_t pid,
+                   FAR const struct symtab_s **syms, int depth)
+{
+  FAR struct gprof_stack_s *stack;
+  uint32_t hash = 2166136261u ^ pid;
+  uint32_t index;
+  int i;
+
+  for (i = 0; i < depth; i++)
+    {
+      hash = (hash ^ (uintptr_t)syms[i]) * 16777619u;
+    }
+
+  for (i = 0, index = hash; i < CONFIG_SYSTEM_GPROF_SAMPLE_NSTACKS;
+       i++, index++)
+    {
+      stack = &sampler->stacks[index & GPROF_SAMPLE_STACKMASK];
+      if (stack->count == 0)
+        {
+          stack->hash  = hash;
+          stack->pid   = pid;
+          stack->depth = depth;
+          memcpy(stack->sym, syms, depth * sizeof(*syms));
+          return stack;
+        }
+      else if (stack->hash == hash && stack->pid == pid &&
+               stack->depth == depth &&
+               memcmp(stack->sym, syms, depth * sizeof(*syms)) == 0)
+        {
+          return stack;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: gprof_sampler_drain
+ *
+ * Description:
+ *   Symbolize and aggregate all samples pending in the ring buffer.
+ *
+ ****************************************************************************/
+
+static void gprof_sampler_drain(FAR struct gprof_sampler_s *sampler)
+{
+  FAR const struct symtab_s *syms[GPROF_SAMPLE_DEPTH];
+  FAR struct gprof_sample_s *sample;
+  FAR struct gprof_stack_s *stack;
+  FAR struct gprof_func_s *func;
+  unsigned int tail;
+  int i;
+  int j;
+
+  tail = atomic_load_explicit(&sampler->tail, memory_order_relaxed);
+  while (tail != atomic_load_explicit(&sampler->head, memory_order_acquire))
+    {
+      sample = &sampler->ring[tail & GPROF_SAMPLE_BUFMASK];
+      for (i = 0; i < sample->depth; i++)
+        {
+          syms[i] = gprof_symbolize(sample->pc[i], i > 0);
+        }
+
+      atomic_store_explicit(&sampler->tail, ++tail, memory_order_release);
+      sampler->nsamples++;
+
+      /* Self time goes to the innermost frame, total time to every
+       * distinct function on the stack (recursion counted once).
+       */
+
+      for (i = 0; i < sample->depth; i++)
+        {
+          for (j = 0; j < i; j++)
+            {
+              if (syms[j] == syms[i])
+                {
+                  break;
+                }
+            }
+
+          if (j < i)
+            {
+              continue;
+            }
+
+          func = gprof_func_lookup(sampler, syms[i]);
+          if (func == NULL)
+            {
+              sampler->overflow++;
+              continue;
+            }
+
+          func->total++;
+          if (i == 0)
+            {
+              func->self++;
+            }
+        }
+
+      stack = gprof_stack_lookup(sampler, sample->pid, syms,
+                                 sample->depth);
+      if (stack != NULL)
+        {
+          stack->count++;
+        }
+      else
+        {
+          sampler->overflow++;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: gprof_func_compare
+ ****************************************************************************/
+
+static int gprof_func_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct gprof_func_s *fa = a;
+  FAR const struct gprof_func_s *fb = b;
+
+  if (fa->self != fb->self)
+    {
+      return fa->self < fb->self ? 1 : -1;
+    }
+
+  return fa->total < fb->total ? 1 : fa->total > fb->total ? -1 : 0;
+}
+
+/****************************************************************************
+ * Name: gprof_report_flat
+ ****************************************************************************/
+
+static void gprof_report_flat(FAR struct gprof_sampler_s *sampler)
+{
+  FAR struct gprof_func_s *funcs = sampler->funcs;
+  int nfuncs = 0;
+  int i;
+
+  /* Compact the hash table in place, it is not used afterwards */
+
+  for (i = 0; i < CONFIG_SYSTEM_GPROF_SAMPLE_NFUNCS; i++)
+    {
+      if (funcs[i].sym != NULL)
+        {
+          funcs[nfuncs++] = funcs[i];
+        }
+    }
+
+  qsort(funcs, nfuncs, sizeof(*funcs), gprof_func_compare);
+
+  printf("Flat profile: %" PRIu32 " samples, %u dropped, "
+         "%" PRIu32 " overflowed\n",
+         sampler->nsamples, atomic_load(&sampler->dropped),
+         sampler->overflow);
+  printf("  %%self    self   total  %%total  function\n");
+
+  for (i = 0; i < nfuncs; i++)
+    {
+      printf("%6.2f %7" PRIu32 " %7" PRIu32 " %6.2f  %s\n",
+             100.0 * funcs[i].self / sampler->nsamples, funcs[i].self,
+             funcs[i].total, 100.0 * funcs[i].total / sampler->nsamples,
+             funcs[i].sym->sym_name);
+    }
+}
+
+/****************************************************************************
+ * Name: gprof_report_folded
+ *
+ * Description:
+ *   Print one line per distinct stack in the format consumed by
+ *   flamegraph.pl: "thread;outer;...;inner count".
+ *
+ ****************************************************************************/
+
+static void gprof_report_folded(FAR struct gprof_sampler_s *sampler)
+{
+  FAR struct gprof_stack_s *stack;
+  char name[CONFIG_TASK_NAME_SIZE + 1];
+  int i;
+  int j;
+
+  for (i = 0; i < CONFIG_SYSTEM_GPROF_SAMPLE_NSTACKS; i++)
+    {
+      stack = &sampler->stacks[i];
+      if (stack->count == 0)
+        {
+          continue;
+        }
+
+      if (pthread_getname_np(stack->pid, name, sizeof(name)) != 0)
+        {
+          strlcpy(name, "[exited]", sizeof(name));
+        }
+
+      printf("%s-%d", name, stack->pid);
+      for (j = stack->depth - 1; j >= 0; j--)
+        {
+          printf(";%s", stack->sym[j]->sym_name);
+        }
+
+      printf(" %" PRIu32 "\n", stack->count);
+    }
+}
+
+/****************************************************************************
+ * Name: gprof_sampler_addall
+ *
+ * Description:
+ *   Collect every thread listed in procfs except the caller, which only
+ *   sleeps while the sampler runs, and open its status file.
+ *
+ ****************************************************************************/
+
+static void gprof_sampler_addall(FAR struct gprof_sampler_s *sampler)
+{
+  FAR struct dirent *entry;
+  FAR DIR *dir;
+  pid_t self = gettid();
+  char path[32];
+  pid_t pid;
+  int fd;
+
+  dir = opendir("/proc");
+  if (dir == NULL)
+    {
+      fprintf(stderr, "gprof: Open /proc fail: %d\n", errno);
+      return;
+    }
+
+  while ((entry = readdir(dir)) != NULL &&
+         sampler->nthreads < CONFIG_SYSTEM_GPROF_SAMPLE_MAXTHREADS)
+    {
+      if (!isdigit(entry->d_name[0]))
+        {
+          continue;
+        }
+
+      pid = atoi(entry->d_name);
+      if (pid == self)
+        {
+          continue;
+        }
+
+      snprintf(path, sizeof(path), "/proc/%d/status", pid);
+      fd = open(path, O_RDONLY | O_CLOEXEC);
+      if (fd >= 0)
+        {
+          sampler->fds[sampler->nthreads]       = fd;
+          sampler->threads[sampler->nthreads++] = pid;
+        }
+    }
+
+  closedir(dir);
+}
+
+/****************************************************************************
+ * Name: gprof_sampler_closeall
+ ****************************************************************************/
+
+static void gprof_sampler_closeall(FAR struct gprof_sampler_s *sampler)
+{
+  int i;
+
+  for (i = 0; i < sampler->nthreads; i++)
+    {
+      if (sampler->fds[i] >= 0)
+        {
+          close(sampler->fds[i]);
+        }
+    }
+
+  sampler->nthreads = 0;
+}
+
+/****************************************************************************
+ * Name: gprof_sample
+ ****************************************************************************/
+
+static int gprof_sample(int argc, FAR char *argv[])
+{
+  FAR struct gprof_sampler_s *sampler;
+  struct sched_param param;
+  struct itimerspec its;
+  struct timespec start;
+  pthread_attr_t attr;
+  struct timespec now;
+  struct sigevent sev;
+  pthread_t thread;
+  timer_t timerid;
+  sigset_t set;
+  int duration = GPROF_SAMPLE_DURATION;
+  int output = GPROF_OUTPUT_FLAT | GPROF_OUTPUT_FOLDED;
+  int rate = GPROF_SAMPLE_RATE;
+  int ret;
+
+  sampler = zalloc(sizeof(*sampler));
+  if (sampler == NULL)
+    {
+      fprintf(stderr, "gprof: Malloc fail\n");
+      return -ENOMEM;
+    }
+
+  sampler->depth = GPROF_SAMPLE_DEPTH;
+
+  optind = 1;
+  while ((ret = getopt(argc, argv, "r:t:d:p:o:")) != ERROR)
+    {
+      switch (ret)
+        {
+          case 'r':
+            rate = atoi(optarg);
+            break;
+          case 't':
+            duration = atoi(optarg);
+            break;
+          case 'd':
+            sampler->depth = atoi(optarg);
+            break;
+          case 'p':
+            if (sampler->npids < CONFIG_SYSTEM_GPROF_SAMPLE_MAXTHREADS)
+              {
+                sampler->pids[sampler->npids++] = atoi(optarg);
+              }
+            break;
+          case 'o':
+            output = strcmp(optarg, "flat") == 0 ? GPROF_OUTPUT_FLAT :
+                     strcmp(optarg, "folded") == 0 ? GPROF_OUTPUT_FOLDED :
+                     GPROF_OUTPUT_FLAT | GPROF_OUTPUT_FOLDED;
+            break;
+          default:
+            ret = -EINVAL;
+            goto out;
+        }
+    }
+
+  /* The timer cannot fire faster than the system tick */
+
+  if (rate <= 0 || rate > GPROF_SAMPLE_MAXRATE || duration <= 0 ||
+      sampler->depth <= 0 || sampler->depth > GPROF_SAMPLE_DEPTH)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  gprof_sampler_addall(sampler);
+
+  /* Block the timer signal here so that it is only consumed by the
+   * sampler thread, which inherits the mask and waits for it.
+   */
+
+  sigemptyset(&set);
+  sigaddset(&set, GPROF_SAMPLE_SIGNO);
+  pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+  /* The sampler must preempt the busy threads it profiles, however high
+   * their priority, or the hottest ones would never be sampled.
+   */
+
+  pthread_attr_init(&attr);
+  pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+  pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+  param.sched_priority = sched_get_priority_max(SCHED_FIFO);
+  pthread_attr_setschedparam(&attr, &param);
+
+  ret = pthread_create(&thread, &attr, gprof_sampler_thread, sampler);
+  pthread_attr_destroy(&attr);
+  if (ret != 0)
+    {
+      ret = -ret;
+      goto out_mask;
+    }
+
+  pthread_setname_np(thread, "gprof_sampler");
+
+  memset(&sev, 0, sizeof(sev));
+  sev.sigev_notify = SIGEV_SIGNAL;
+  sev.sigev_signo  = GPROF_SAMPLE_SIGNO;
+  ret = timer_create(CLOCK_MONOTONIC, &sev, &timerid);
+  if (ret < 0)
+    {
+      ret = -errno;
+      sampler->stop = true;
+      pthread_kill(thread, GPROF_SAMPLE_SIGNO);
+      pthread_join(thread, NULL);
+      goto out_mask;
+    }
+
+  its.it_value.tv_sec  = 1 / rate;
+  its.it_value.tv_nsec = rate > 1 ? 1000000000 / rate : 0;
+  its.it_interval      = its.it_value;
+  timer_settime(timerid, 0, &its, NULL);
+
+  printf("gprof: Sampling %d threads at %d Hz for %d s\n",
+         sampler->npids > 0 ? sampler->npids : sampler->nthreads,
+         rate, duration);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  do
+    {
+      usleep(GPROF_SAMPLE_POLL_US);
+      gprof_sampler_drain(sampler);
+      clock_gettime(CLOCK_MONOTONIC, &now);
+    }
+  while (now.tv_sec - start.tv_sec < duration);
+
+  /* The timer keeps ticking until the sampler has seen the stop flag */
+
+  sampler->stop = true;
+  pthread_join(thread, NULL);
+  timer_delete(timerid);
+  gprof_sampler_drain(sampler);
+
+  if (sampler->nsamples == 0)
+    {
+      printf("gprof: No samples\n");
+    }
+  else
+    {
+      if (output & GPROF_OUTPUT_FLAT)
+        {
+          gprof_report_flat(sampler);
+        }
+
+      if (output & GPROF_OUTPUT_FOLDED)
+        {
+          /* The flat report reorders funcs only, stacks are intact */
+
+          gprof_report_folded(sampler);
+        }
+    }
+
+  ret = 0;
+
+out_mask:
+  pthread_sigmask(SIG_UNBLOCK, &set, NULL);
+out:
+  gprof_sampler_closeall(sampler);
+  free(sampler);
+  return ret;
+}
+
+#endif /* CONFIG_SYSTEM_GPROF_SAMPLE */
 
 /****************************************************************************
  * Public Functions
@@ -49,6 +900,7 @@ int main(int argc, FAR char *argv[])
       goto help;
     }
 
+#ifdef GPROF_HAVE_GMON
   if (strcmp(argv[1], "dump") == 0)
     {
 #ifndef CONFIG_DISABLE_ENVIRON
@@ -69,6 +921,17 @@ int main(int argc, FAR char *argv[])
       moncontrol(0);
     }
   else
+#endif
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+  if (strcmp(argv[1], "sample") == 0)
+    {
+      if (gprof_sample(argc - 1, argv + 1) < 0)
+        {
+          goto help;
+        }
+    }
+  else
+#endif
     {
       goto help;
     }
@@ -77,9 +940,15 @@ int main(int argc, FAR char *argv[])
 
 help:
   printf("Usage: gprof <command> [<args>]\n"
+#ifdef GPROF_HAVE_GMON
         "  gprof dump [output]\n"
         "  gprof start\n"
-        "  gprof stop\n");
+        "  gprof stop\n"
+#endif
+#ifdef CONFIG_SYSTEM_GPROF_SAMPLE
+        "  gprof sample [-r hz] [-t seconds] [-d depth] [-p pid]...\n"
+        "               [-o flat|folded|all]\n"
+#endif
+        );
   return EXIT_FAILURE;
 }
-
@@ -651,6 +651,64 @@ static int nxplayer_mediasearch(FAR struct nxplayer_s *pplayer,
 }
 #endif
 
+/****************************************************************************
+ * Name: nxplayer_startprefetch
+ *
+ *   Start reading the media file ahead of playback.  Only decoders that
+ *   consume the file as a plain byte stream can be fed from the ring.  If
+ *   the prefetch cannot be started, buffers are read synchronously.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXPLAYER_PREFETCH
+static void nxplayer_startprefetch(FAR struct nxplayer_s *pplayer)
+{
+  FAR struct nxplayer_prefetch_s *pf = NULL;
+
+  if (pplayer->ops->fill_data == nxplayer_fill_common)
+    {
+      pf = nxplayer_prefetch_create(pplayer->fd,
+                                    CONFIG_NXPLAYER_PREFETCH_BUFSIZE);
+    }
+
+  pthread_mutex_lock(&pplayer->mutex);
+  pplayer->prefetch = pf;
+  pthread_mutex_unlock(&pplayer->mutex);
+}
+
+/****************************************************************************
+ * Name: nxplayer_stopprefetch
+ *
+ *   Stop the read-ahead, keeping its statistics.  This must be done before
+ *   the media file is closed.
+ *
+ ****************************************************************************/
+
+static void nxplayer_stopprefetch(FAR struct nxplayer_s *pplayer)
+{
+  FAR struct nxplayer_prefetch_s *pf;
+
+  pthread_mutex_lock(&pplayer->mutex);
+
+  pf = pplayer->prefetch;
+  pplayer->prefetch = NULL;
+  if (pf != NULL)
+    {
+      nxplayer_prefetch_getstats(pf, &pplayer->stats);
+    }
+
+  pthread_mutex_unlock(&pplayer->mutex);
+
+  if (pf != NULL)
+    {
+      nxplayer_prefetch_destroy(pf);
+    }
+}
+#else
+#  define nxplayer_startprefetch(p)
+#  define nxplayer_stopprefetch(p)
+#endif
+
 /****************************************************************************
  * Name: nxplayer_readbuffer
  *
@@ -678,13 +736,30 @@ static int nxplayer_readbuffer(FAR struct nxplayer_s *pplayer,
       return -ENODATA;
     }
 
-  ret = pplayer->ops->fill_data(pplayer->fd, apb);
+#ifdef CONFIG_NXPLAYER_PREFETCH
+  if (pplayer->prefetch != NULL)
+    {
+      ret = nxplayer_prefetch_fill(pplayer->prefetch, apb);
+      if (ret == -EAGAIN)
+        {
+          /* The media stalled, the file is not finished */
+
+          return ret;
+        }
+    }
+  else
+#endif
+    {
+      ret = pplayer->ops->fill_data(pplayer->fd, apb);
+    }
+
   if (ret < 0)
     {
       /* End of file or read error.. We are finished with this file in any
        * event.
        */
 
+      nxplayer_stopprefetch(pplayer);
       close(pplayer->fd);
       pplayer->fd = -1;
     }
@@ -797,6 +872,10 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
   bool                    failed = false;
   struct ap_buffer_info_s buf_info;
   unsigned int            prio;
+#ifdef CONFIG_NXPLAYER_PREFETCH
+  struct timespec         abstime;
+  int                     nparked = 0;
+#endif
 #ifdef CONFIG_DEBUG_FEATURES
   int                     outstanding = 0;
 #endif
@@ -819,6 +898,12 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
   /* Create array of pointers to buffers */
 
   FAR struct ap_buffer_s *buffers[buf_info.nbuffers];
+#ifdef CONFIG_NXPLAYER_PREFETCH
+
+  /* Buffers waiting for a stalled media to deliver data */
+
+  FAR struct ap_buffer_s *parked[buf_info.nbuffers];
+#endif
 
   /* Create our audio pipeline buffers to use for queueing up data */
 
@@ -847,6 +932,10 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
         }
     }
 
+  /* Start reading ahead of playback before the pipeline is filled */
+
+  nxplayer_startprefetch(pplayer);
+
   /* Fill up the pipeline with enqueued buffers */
 
   for (x = 0; x < buf_info.nbuffers; x++)
@@ -854,6 +943,20 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
       /* Read the next buffer of data */
 
       ret = nxplayer_readbuffer(pplayer, buffers[x]);
+#ifdef CONFIG_NXPLAYER_PREFETCH
+      if (ret == -EAGAIN)
+        {
+          /* Retried from the message loop once the media delivers.  It
+           * counts as outstanding until then.
+           */
+
+          parked[nparked++] = buffers[x];
+#ifdef CONFIG_DEBUG_FEATURES
+          outstanding++;
+#endif
+        }
+      else
+#endif
       if (ret != OK)
         {
           /* nxplayer_readbuffer will return an error if there is no further
@@ -896,6 +999,7 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
                * file so that no further data is read.
                */
 
+              nxplayer_stopprefetch(pplayer);
               close(pplayer->fd);
               pplayer->fd = -1;
 
@@ -994,7 +1098,42 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
        * stop, etc.
        */
 
-      size = mq_receive(pplayer->mq, (FAR char *)&msg, sizeof(msg), &prio);
+#ifdef CONFIG_NXPLAYER_PREFETCH
+      if (!streaming && nparked > 0)
+        {
+          /* Stopped or out of data, the parked buffers will never reach
+           * the driver.
+           */
+
+#ifdef CONFIG_DEBUG_FEATURES
+          outstanding -= nparked;
+#endif
+          nparked = 0;
+        }
+
+      if (nparked > 0)
+        {
+          /* The prefetch bounds how long a refill waits for a stalled
+           * media, so only poll the queue and retry a parked buffer as if
+           * the driver had just returned it.
+           */
+
+          clock_gettime(CLOCK_REALTIME, &abstime);
+          size = mq_timedreceive(pplayer->mq, (FAR char *)&msg,
+                                 sizeof(msg), &prio, &abstime);
+          if (size < 0 && errno == ETIMEDOUT)
+            {
+              msg.msg_id = AUDIO_MSG_DEQUEUE;
+              msg.u.ptr  = parked[--nparked];
+              size       = sizeof(msg);
+            }
+        }
+      else
+#endif
+        {
+          size = mq_receive(pplayer->mq, (FAR char *)&msg, sizeof(msg),
+                            &prio);
+        }
 
       /* Validate a message was received */
 
@@ -1032,6 +1171,18 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
                 /* Read the next buffer of data */
 
                 ret = nxplayer_readbuffer(pplayer, msg.u.ptr);
+#ifdef CONFIG_NXPLAYER_PREFETCH
+                if (ret == -EAGAIN)
+                  {
+                    /* Keep servicing messages while the media stalls */
+
+                    parked[nparked++] = msg.u.ptr;
+#ifdef CONFIG_DEBUG_FEATURES
+                    outstanding++;
+#endif
+                  }
+                else
+#endif
                 if (ret != OK)
                   {
                     /* Out of data.  Stay in the loop until the device sends
@@ -1056,6 +1207,7 @@ static FAR void *nxplayer_playthread(pthread_addr_t pvarg)
                          * Close the file so that no further data is read.
                          */
 
+                        nxplayer_stopprefetch(pplayer);
                         close(pplayer->fd);
                         pplayer->fd = -1;
 
@@ -1160,6 +1312,8 @@ err_out:
 
   /* Cleanup */
 
+  nxplayer_stopprefetch(pplayer);
+
   pthread_mutex_lock(&pplayer->mutex);
 
   /* Close the files */
@@ -2192,6 +2346,11 @@ FAR struct nxplayer_s *nxplayer_create(void)
   pplayer->session = NULL;
 #endif
 
+#ifdef CONFIG_NXPLAYER_PREFETCH
+  pplayer->prefetch = NULL;
+  memset(&pplayer->stats, 0, sizeof(pplayer->stats));
+#endif
+
 #ifdef CONFIG_NXPLAYER_INCLUDE_MEDIADIR
   strlcpy(pplayer->mediadir, CONFIG_NXPLAYER_DEFAULT_MEDIADIR,
           sizeof(pplayer->mediadir));
@@ -2325,3 +2484,33 @@ int nxplayer_systemreset(FAR struct nxplayer_s *pplayer)
   return OK;
 }
 #endif /* CONFIG_NXPLAYER_INCLUDE_SYSTEM_RESET */
+
+/****************************************************************************
+ * Name: nxplayer_getstats
+ *
+ *   nxplayer_getstats() returns the read-ahead statistics of the current
+ *   playback, or of the last one if the player is idle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXPLAYER_PREFETCH
+int nxplayer_getstats(FAR struct nxplayer_s *pplayer,
+                      FAR struct nxplayer_stats_s *stats)
+{
+  DEBUGASSERT(pplayer != NULL && stats != NULL);
+
+  pthread_mutex_lock(&pplayer->mutex);
+
+  if (pplayer->prefetch != NULL)
+    {
+      nxplayer_prefetch_getstats(pplayer->prefetch, stats);
+    }
+  else
+    {
+      *stats = pplayer->stats;
+    }
+
+  pthread_mutex_unlock(&pplayer->mutex);
+  return OK;
+}
+#endif /* CONFIG_NXPLAYER_PREFETCH */
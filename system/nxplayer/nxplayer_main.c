@@ -28,6 +28,7 @@
 #include <nuttx/audio/audio.h>
 
 #include <sys/types.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -91,6 +92,10 @@ static int nxplayer_cmd_mediadir(FAR struct nxplayer_s *pplayer, char *parg);
 static int nxplayer_cmd_stop(FAR struct nxplayer_s *pplayer, char *parg);
 #endif
 
+#ifdef CONFIG_NXPLAYER_PREFETCH
+static int nxplayer_cmd_stats(FAR struct nxplayer_s *pplayer, char *parg);
+#endif
+
 #ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
 static int nxplayer_cmd_volume(FAR struct nxplayer_s *pplayer, char *parg);
 #ifndef CONFIG_AUDIO_EXCLUDE_BALANCE
@@ -197,6 +202,14 @@ static struct mp_cmd_s g_nxplayer_cmds[] =
     NXPLAYER_HELP_TEXT("Resume playback")
   },
 #endif
+#ifdef CONFIG_NXPLAYER_PREFETCH
+  {
+    "stats",
+    "",
+    nxplayer_cmd_stats,
+    NXPLAYER_HELP_TEXT("Show read-ahead statistics")
+  },
+#endif
 #ifndef CONFIG_AUDIO_EXCLUDE_STOP
   {
     "stop",
@@ -544,6 +557,35 @@ static int nxplayer_cmd_stop(FAR struct nxplayer_s *pplayer, char *parg)
 }
 #endif
 
+/****************************************************************************
+ * Name: nxplayer_cmd_stats
+ *
+ *   nxplayer_cmd_stats() prints the read-ahead statistics of the current
+ *   or last playback.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXPLAYER_PREFETCH
+static int nxplayer_cmd_stats(FAR struct nxplayer_s *pplayer, char *parg)
+{
+  struct nxplayer_stats_s stats;
+
+  nxplayer_getstats(pplayer, &stats);
+
+  printf("ring     : %" PRIu32 " bytes, %" PRIu32 " buffered, "
+         "low water %" PRIu32 "\n",
+         stats.bufsize, stats.level, stats.lowwater);
+  printf("media    : %" PRIu64 " bytes in %" PRIu32 " reads, "
+         "slowest %" PRIu32 " us\n",
+         stats.nbytes, stats.nreads, stats.maxread_us);
+  printf("underruns: %" PRIu32 ", waited %" PRIu64 " us, "
+         "longest %" PRIu32 " us\n",
+         stats.underruns, stats.totalwait_us, stats.maxwait_us);
+
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: nxplayer_cmd_pause
  *
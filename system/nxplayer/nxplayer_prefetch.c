@@ -0,0 +1,457 @@
+/****************************************************************************
+ * apps/system/nxplayer/nxplayer_prefetch.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+
+#include <debug.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/audio/audio.h>
+
+#include "system/nxplayer.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The prefetch thread does not issue a read until at least this much of
+ * the ring is free, so that a nearly full ring does not turn into many
+ * tiny reads of the media.
+ */
+
+#define PREFETCH_READ_THRESHOLD(pf)  ((pf)->size / 4)
+
+/* How long the prefetch thread waits for the media to become readable
+ * before it checks again whether it was asked to stop.
+ */
+
+#define PREFETCH_POLL_MSEC           100
+
+/* How long nxplayer_prefetch_fill() waits for data when the ring runs
+ * dry.  The playthread also services the message queue, so it must not
+ * block on a stalled media for longer than this.
+ */
+
+#define PREFETCH_FILL_MSEC           100
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct nxplayer_prefetch_s
+{
+  FAR uint8_t            *buf;       /* Ring buffer memory */
+  size_t                 size;       /* Size of the ring buffer */
+  size_t                 rdpos;      /* Offset of the oldest buffered byte */
+  size_t                 wrpos;      /* Offset where the next read lands */
+  size_t                 level;      /* Number of bytes buffered */
+  int                    fd;         /* Media file being read ahead */
+  int                    errcode;    /* Read error that ended the media */
+  bool                   eof;        /* No more data will be read */
+  bool                   stop;       /* Request the thread to exit */
+  pthread_t              tid;        /* The prefetch thread */
+  pthread_mutex_t        lock;       /* Protects all of the above */
+  pthread_cond_t         datacond;   /* Signaled when data is added */
+  pthread_cond_t         spacecond;  /* Signaled when space is freed */
+  struct nxplayer_stats_s stats;     /* Underrun / latency statistics */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_now
+ *
+ *   Return the monotonic time in microseconds.
+ *
+ ****************************************************************************/
+
+static uint64_t nxplayer_prefetch_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_thread
+ *
+ *   Read the media file into the free part of the ring until the end of
+ *   the file is reached or the thread is asked to stop.  The media is read
+ *   straight into the ring memory.
+ *
+ ****************************************************************************/
+
+static FAR void *nxplayer_prefetch_thread(pthread_addr_t pvarg)
+{
+  FAR struct nxplayer_prefetch_s *pf =
+    (FAR struct nxplayer_prefetch_s *)pvarg;
+  struct pollfd fds;
+  uint64_t start;
+  uint32_t elapsed;
+  size_t nfree;
+  ssize_t ret;
+
+  pthread_mutex_lock(&pf->lock);
+
+  while (!pf->stop && !pf->eof)
+    {
+      nfree = pf->size - pf->level;
+      if (nfree == 0 || nfree < PREFETCH_READ_THRESHOLD(pf))
+        {
+          pthread_cond_wait(&pf->spacecond, &pf->lock);
+          continue;
+        }
+
+      /* Read no further than the end of the ring memory */
+
+      if (nfree > pf->size - pf->wrpos)
+        {
+          nfree = pf->size - pf->wrpos;
+        }
+
+      pthread_mutex_unlock(&pf->lock);
+
+      /* A stream, such as an HTTP socket, may stall for any length of
+       * time.  Only read once it will not block, so that the thread sees
+       * a stop request while it waits.  Files are always readable.
+       */
+
+      fds.fd      = pf->fd;
+      fds.events  = POLLIN;
+      fds.revents = 0;
+
+      ret = poll(&fds, 1, PREFETCH_POLL_MSEC);
+      if (ret == 0 || (ret < 0 && errno == EINTR))
+        {
+          pthread_mutex_lock(&pf->lock);
+          continue;
+        }
+
+      start = nxplayer_prefetch_now();
+      ret = read(pf->fd, &pf->buf[pf->wrpos], nfree);
+      elapsed = (uint32_t)(nxplayer_prefetch_now() - start);
+
+      pthread_mutex_lock(&pf->lock);
+
+      pf->stats.nreads++;
+      if (elapsed > pf->stats.maxread_us)
+        {
+          pf->stats.maxread_us = elapsed;
+        }
+
+      if (ret > 0)
+        {
+          pf->wrpos += ret;
+          if (pf->wrpos == pf->size)
+            {
+              pf->wrpos = 0;
+            }
+
+          pf->level        += ret;
+          pf->stats.nbytes += ret;
+        }
+      else if (ret == 0)
+        {
+          pf->eof = true;
+        }
+      else if (errno != EINTR)
+        {
+          pf->errcode = errno;
+          pf->eof     = true;
+        }
+
+      pthread_cond_signal(&pf->datacond);
+    }
+
+  pthread_mutex_unlock(&pf->lock);
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_create
+ *
+ *   nxplayer_prefetch_create() allocates a read-ahead ring of bufsize bytes
+ *   and starts a thread that keeps it filled from fd.
+ *
+ ****************************************************************************/
+
+FAR struct nxplayer_prefetch_s *nxplayer_prefetch_create(int fd,
+                                                         size_t bufsize)
+{
+  FAR struct nxplayer_prefetch_s *pf;
+  struct sched_param sparam;
+  pthread_condattr_t cattr;
+  pthread_attr_t tattr;
+  int ret;
+
+  pf = (FAR struct nxplayer_prefetch_s *)zalloc(sizeof(*pf));
+  if (pf == NULL)
+    {
+      return NULL;
+    }
+
+  pf->buf = (FAR uint8_t *)malloc(bufsize);
+  if (pf->buf == NULL)
+    {
+      auderr("ERROR: Failed to allocate %zu byte prefetch buffer\n",
+             bufsize);
+      free(pf);
+      return NULL;
+    }
+
+  pf->size           = bufsize;
+  pf->fd             = fd;
+  pf->stats.bufsize  = bufsize;
+  pf->stats.lowwater = bufsize;
+
+  pthread_mutex_init(&pf->lock, NULL);
+  /* The fill waits for data with an absolute monotonic timeout */
+
+  pthread_condattr_init(&cattr);
+  pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+  pthread_cond_init(&pf->datacond, &cattr);
+  pthread_condattr_destroy(&cattr);
+  pthread_cond_init(&pf->spacecond, NULL);
+
+  /* Run just below the playthread so that enqueueing buffers takes
+   * precedence over reading ahead.
+   */
+
+  pthread_attr_init(&tattr);
+  sparam.sched_priority = sched_get_priority_max(SCHED_FIFO) - 10;
+  pthread_attr_setschedparam(&tattr, &sparam);
+  pthread_attr_setstacksize(&tattr, CONFIG_NXPLAYER_PREFETCH_STACKSIZE);
+
+  ret = pthread_create(&pf->tid, &tattr, nxplayer_prefetch_thread,
+                       (pthread_addr_t)pf);
+  pthread_attr_destroy(&tattr);
+
+  if (ret != OK)
+    {
+      auderr("ERROR: Failed to create prefetch thread: %d\n", ret);
+      pthread_cond_destroy(&pf->spacecond);
+      pthread_cond_destroy(&pf->datacond);
+      pthread_mutex_destroy(&pf->lock);
+      free(pf->buf);
+      free(pf);
+      return NULL;
+    }
+
+  pthread_setname_np(pf->tid, "prefetch");
+  return pf;
+}
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_fill
+ *
+ *   nxplayer_prefetch_fill() fills an apb buffer from the read-ahead ring,
+ *   waiting for the prefetch thread for at most PREFETCH_FILL_MSEC if the
+ *   ring runs dry.  The return value follows nxplayer_fill_common(), with
+ *   a short buffer if the media stalled part way and -EAGAIN if it stalled
+ *   before any data was copied.
+ *
+ ****************************************************************************/
+
+int nxplayer_prefetch_fill(FAR struct nxplayer_prefetch_s *pf,
+                           FAR struct ap_buffer_s *apb)
+{
+  struct timespec abstime;
+  uint64_t start = 0;
+  uint32_t elapsed;
+  bool timedout = false;
+  size_t n;
+
+  apb->nbytes  = 0;
+  apb->curbyte = 0;
+  apb->flags   = 0;
+
+  pthread_mutex_lock(&pf->lock);
+
+  if (pf->level < pf->stats.lowwater)
+    {
+      pf->stats.lowwater = pf->level;
+    }
+
+  while (apb->nbytes < apb->nmaxbytes)
+    {
+      if (pf->level == 0)
+        {
+          if (pf->eof || timedout)
+            {
+              break;
+            }
+
+          /* The ring ran dry before the buffer was full */
+
+          if (start == 0)
+            {
+              pf->stats.underruns++;
+              start = nxplayer_prefetch_now();
+
+              clock_gettime(CLOCK_MONOTONIC, &abstime);
+              abstime.tv_nsec += PREFETCH_FILL_MSEC * 1000000;
+              if (abstime.tv_nsec >= 1000000000)
+                {
+                  abstime.tv_sec++;
+                  abstime.tv_nsec -= 1000000000;
+                }
+            }
+
+          timedout = pthread_cond_timedwait(&pf->datacond, &pf->lock,
+                                            &abstime) == ETIMEDOUT;
+          continue;
+        }
+
+      n = apb->nmaxbytes - apb->nbytes;
+      if (n > pf->level)
+        {
+          n = pf->level;
+        }
+
+      if (n > pf->size - pf->rdpos)
+        {
+          n = pf->size - pf->rdpos;
+        }
+
+      /* The buffered bytes belong to us until the level is lowered, so
+       * copy them without holding the lock.
+       */
+
+      pthread_mutex_unlock(&pf->lock);
+      memcpy(&apb->samp[apb->nbytes], &pf->buf[pf->rdpos], n);
+      pthread_mutex_lock(&pf->lock);
+
+      apb->nbytes += n;
+      pf->rdpos   += n;
+      if (pf->rdpos == pf->size)
+        {
+          pf->rdpos = 0;
+        }
+
+      pf->level -= n;
+      pthread_cond_signal(&pf->spacecond);
+    }
+
+  if (start != 0)
+    {
+      elapsed = (uint32_t)(nxplayer_prefetch_now() - start);
+      pf->stats.totalwait_us += elapsed;
+      if (elapsed > pf->stats.maxwait_us)
+        {
+          pf->stats.maxwait_us = elapsed;
+        }
+    }
+
+  /* If the media ended during the wait, this is the final buffer */
+
+  if (pf->eof)
+    {
+      timedout = false;
+    }
+
+  pthread_mutex_unlock(&pf->lock);
+
+  /* A stalled media is not the end of it, let the caller come back */
+
+  if (apb->nbytes < apb->nmaxbytes && timedout)
+    {
+      return apb->nbytes > 0 ? OK : -EAGAIN;
+    }
+
+  if (apb->nbytes < apb->nmaxbytes)
+    {
+      audinfo("End of prefetched data, nbytes=%d errcode=%d\n",
+              apb->nbytes, pf->errcode);
+
+      /* Set a flag to indicate that this is the final buffer in the stream */
+
+      apb->flags |= AUDIO_APB_FINAL;
+      return -ENODATA;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_getstats
+ *
+ *   nxplayer_prefetch_getstats() returns a snapshot of the statistics.
+ *
+ ****************************************************************************/
+
+void nxplayer_prefetch_getstats(FAR struct nxplayer_prefetch_s *pf,
+                                FAR struct nxplayer_stats_s *stats)
+{
+  pthread_mutex_lock(&pf->lock);
+  *stats       = pf->stats;
+  stats->level = pf->level;
+  pthread_mutex_unlock(&pf->lock);
+}
+
+/****************************************************************************
+ * Name: nxplayer_prefetch_destroy
+ *
+ *   nxplayer_prefetch_destroy() stops the prefetch thread and frees the
+ *   ring.  The media file is left open.  The thread notices the request
+ *   within PREFETCH_POLL_MSEC even while the media stalls.
+ *
+ ****************************************************************************/
+
+void nxplayer_prefetch_destroy(FAR struct nxplayer_prefetch_s *pf)
+{
+  FAR void *value;
+
+  pthread_mutex_lock(&pf->lock);
+  pf->stop = true;
+  pthread_cond_signal(&pf->spacecond);
+  pthread_mutex_unlock(&pf->lock);
+
+  pthread_join(pf->tid, &value);
+
+  pthread_cond_destroy(&pf->spacecond);
+  pthread_cond_destroy(&pf->datacond);
+  pthread_mutex_destroy(&pf->lock);
+  free(pf->buf);
+  free(pf);
+}
@@ -0,0 +1,310 @@
+/****************************************************************************
+ * apps/testing/drivers/crypto/altcalib.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <err.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <crypto/cryptodev.h>
+
+#include <mbedtls/sha256.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CALIB_MIN_SIZE   16
+#define CALIB_MAX_SIZE   4096
+#define CALIB_LOOPS      200
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef struct crypto_context
+{
+  int fd;
+  int crypto_fd;
+  struct session_op session;
+  struct crypt_op cryp;
+}
+crypto_context;
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static unsigned char g_data[CALIB_MAX_SIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static uint64_t calib_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void calib_free(FAR crypto_context *ctx)
+{
+  if (ctx->crypto_fd != 0)
+    {
+      close(ctx->crypto_fd);
+      ctx->crypto_fd = 0;
+    }
+
+  if (ctx->fd != 0)
+    {
+      close(ctx->fd);
+      ctx->fd = 0;
+    }
+}
+
+static int calib_init(FAR crypto_context *ctx)
+{
+  memset(ctx, 0, sizeof(crypto_context));
+  if ((ctx->fd = open("/dev/crypto", O_RDWR, 0)) < 0)
+    {
+      warn("open /dev/crypto");
+      return 1;
+    }
+
+  if (ioctl(ctx->fd, CRIOGET, &ctx->crypto_fd) == -1)
+    {
+      warn("CRIOGET");
+      calib_free(ctx);
+      return 1;
+    }
+
+  return 0;
+}
+
+/* Hash a whole message the way the alt layer does once it offloads */
+
+static int calib_devhash(FAR crypto_context *ctx, size_t len,
+                         FAR unsigned char *out)
+{
+  ctx->session.mac = CRYPTO_SHA2_256;
+  if (ioctl(ctx->crypto_fd, CIOCGSESSION, &ctx->session) == -1)
+    {
+      warn("CIOCGSESSION");
+      return 1;
+    }
+
+  ctx->cryp.ses = ctx->session.ses;
+  ctx->cryp.op = COP_ENCRYPT;
+  ctx->cryp.flags = COP_FLAG_UPDATE;
+  ctx->cryp.src = (caddr_t)g_data;
+  ctx->cryp.len = len;
+  if (ioctl(ctx->crypto_fd, CIOCCRYPT, &ctx->cryp) == -1)
+    {
+      warn("CIOCCRYPT");
+      return 1;
+    }
+
+  ctx->cryp.flags = 0;
+  ctx->cryp.mac = (caddr_t)out;
+  if (ioctl(ctx->crypto_fd, CIOCCRYPT, &ctx->cryp) == -1)
+    {
+      warn("CIOCCRYPT");
+      return 1;
+    }
+
+  if (ioctl(ctx->crypto_fd, CIOCFSESSION, &ctx->session.ses) == -1)
+    {
+      warn("CIOCFSESSION");
+      return 1;
+    }
+
+  return 0;
+}
+
+static int calib_sha256(FAR crypto_context *ctx)
+{
+  unsigned char out[2][32];
+  uint64_t tdev;
+  uint64_t tsw;
+  uint64_t t0;
+  size_t crossover = 0;
+  size_t len;
+  int i;
+
+  printf("%8s %12s %12s\n", "bytes", "dev ns/op", "sw ns/op");
+
+  for (len = CALIB_MIN_SIZE; len <= CALIB_MAX_SIZE; len <<= 1)
+    {
+      t0 = calib_now();
+      for (i = 0; i < CALIB_LOOPS; i++)
+        {
+          if (calib_devhash(ctx, len, out[0]) != 0)
+            {
+              return 1;
+            }
+        }
+
+      tdev = (calib_now() - t0) / CALIB_LOOPS;
+
+      t0 = calib_now();
+      for (i = 0; i < CALIB_LOOPS; i++)
+        {
+          mbedtls_sha256_sw(g_data, len, out[1], 0);
+        }
+
+      tsw = (calib_now() - t0) / CALIB_LOOPS;
+
+      if (memcmp(out[0], out[1], sizeof(out[0])) != 0)
+        {
+          printf("sha256 mismatch at %zu bytes\n", len);
+          return 1;
+        }
+
+      printf("%8zu %12llu %12llu\n", len, (unsigned long long)tdev,
+             (unsigned long long)tsw);
+
+      if (crossover == 0 && tdev < tsw)
+        {
+          crossover = len;
+        }
+    }
+
+  if (crossover == 0)
+    {
+      printf("software is faster up to %d bytes, "
+             "use at least that as the threshold\n", CALIB_MAX_SIZE);
+    }
+  else
+    {
+      printf("suggested CONFIG_MBEDTLS_SHA256_ALT_THRESHOLD: %zu "
+             "(current %d)\n", crossover / 2,
+             CONFIG_MBEDTLS_SHA256_ALT_THRESHOLD);
+    }
+
+  return 0;
+}
+
+/* Compare a session per block with one session kept for all blocks */
+
+static int calib_aes(FAR crypto_context *ctx)
+{
+  unsigned char key[16];
+  unsigned char iv[16];
+  unsigned char out[16];
+  uint64_t tonce;
+  uint64_t treuse;
+  uint64_t t0;
+  int i;
+
+  memset(key, 0x5a, sizeof(key));
+  ctx->session.mac = 0;
+  ctx->session.cipher = CRYPTO_AES_CBC;
+  ctx->session.key = (caddr_t)key;
+  ctx->session.keylen = sizeof(key);
+
+  ctx->cryp.op = COP_ENCRYPT;
+  ctx->cryp.flags = 0;
+  ctx->cryp.len = sizeof(out);
+  ctx->cryp.src = (caddr_t)g_data;
+  ctx->cryp.dst = (caddr_t)out;
+  ctx->cryp.iv = (caddr_t)iv;
+  ctx->cryp.mac = 0;
+
+  t0 = calib_now();
+  for (i = 0; i < CALIB_LOOPS; i++)
+    {
+      memset(iv, 0, sizeof(iv));
+      if (ioctl(ctx->crypto_fd, CIOCGSESSION, &ctx->session) == -1)
+        {
+          warn("CIOCGSESSION");
+          return 1;
+        }
+
+      ctx->cryp.ses = ctx->session.ses;
+      ioctl(ctx->crypto_fd, CIOCCRYPT, &ctx->cryp);
+      ioctl(ctx->crypto_fd, CIOCFSESSION, &ctx->session.ses);
+    }
+
+  tonce = (calib_now() - t0) / CALIB_LOOPS;
+
+  if (ioctl(ctx->crypto_fd, CIOCGSESSION, &ctx->session) == -1)
+    {
+      warn("CIOCGSESSION");
+      return 1;
+    }
+
+  ctx->cryp.ses = ctx->session.ses;
+  t0 = calib_now();
+  for (i = 0; i < CALIB_LOOPS; i++)
+    {
+      memset(iv, 0, sizeof(iv));
+      ioctl(ctx->crypto_fd, CIOCCRYPT, &ctx->cryp);
+    }
+
+  treuse = (calib_now() - t0) / CALIB_LOOPS;
+  ioctl(ctx->crypto_fd, CIOCFSESSION, &ctx->session.ses);
+
+  printf("aes-128 block: %llu ns/op with a session per op, "
+         "%llu ns/op reusing one\n",
+         (unsigned long long)tonce, (unsigned long long)treuse);
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+int main(void)
+{
+  crypto_context ctx;
+  int ret;
+  int i;
+
+  for (i = 0; i < CALIB_MAX_SIZE; i++)
+    {
+      g_data[i] = (unsigned char)i;
+    }
+
+  if (calib_init(&ctx) != 0)
+    {
+      return 1;
+    }
+
+  ret = calib_sha256(&ctx);
+  if (ret == 0)
+    {
+      ret = calib_aes(&ctx);
+    }
+
+  calib_free(&ctx);
+  return ret;
+}
@@ -0,0 +1,33 @@
+/****************************************************************************
+ * apps/testing/mlearning/tflm_simd/ref_avgpool_s8.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* The CMSIS-NN reference arm_avgpool_s8(), renamed so that it links next to
+ * the vectorized kernel that replaces it in the library.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#define arm_avgpool_s8 ref_arm_avgpool_s8
+
+#include "PoolingFunctions/arm_avgpool_s8.c"
@@ -0,0 +1,698 @@
+/****************************************************************************
+ * apps/testing/mlearning/tflm_simd/tflm_simd_test.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arm_nnfunctions.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Random cases run per kernel */
+
+#define TFLM_SIMD_CASES  500
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tflm_simd_result_s
+{
+  int cases;
+  int skipped;
+  int failed;
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* The CMSIS-NN reference kernels, see ref_*.c */
+
+arm_cmsis_nn_status
+ref_arm_depthwise_conv_s8(const cmsis_nn_context *ctx,
+                          const cmsis_nn_dw_conv_params *dw_conv_params,
+                          const cmsis_nn_per_channel_quant_params *quant,
+                          const cmsis_nn_dims *input_dims,
+                          const int8_t *input,
+                          const cmsis_nn_dims *filter_dims,
+                          const int8_t *kernel,
+                          const cmsis_nn_dims *bias_dims,
+                          const int32_t *bias,
+                          const cmsis_nn_dims *output_dims,
+                          int8_t *output);
+
+arm_cmsis_nn_status
+ref_arm_depthwise_conv_3x3_s8(const cmsis_nn_context *ctx,
+                              const cmsis_nn_dw_conv_params *dw_conv_params,
+                              const cmsis_nn_per_channel_quant_params *quant,
+                              const cmsis_nn_dims *input_dims,
+                              const int8_t *input,
+                              const cmsis_nn_dims *filter_dims,
+                              const int8_t *kernel,
+                              const cmsis_nn_dims *bias_dims,
+                              const int32_t *bias,
+                              const cmsis_nn_dims *output_dims,
+                              int8_t *output);
+
+arm_cmsis_nn_status
+ref_arm_fully_connected_s8(const cmsis_nn_context *ctx,
+                           const cmsis_nn_fc_params *fc_params,
+                           const cmsis_nn_per_tensor_quant_params *quant,
+                           const cmsis_nn_dims *input_dims,
+                           const int8_t *input,
+                           const cmsis_nn_dims *filter_dims,
+                           const int8_t *kernel,
+                           const cmsis_nn_dims *bias_dims,
+                           const int32_t *bias,
+                           const cmsis_nn_dims *output_dims,
+                           int8_t *output);
+
+arm_cmsis_nn_status ref_arm_avgpool_s8(const cmsis_nn_context *ctx,
+                                       const cmsis_nn_pool_params *params,
+                                       const cmsis_nn_dims *input_dims,
+                                       const int8_t *src,
+                                       const cmsis_nn_dims *filter_dims,
+                                       const cmsis_nn_dims *output_dims,
+                                       int8_t *dst);
+
+arm_cmsis_nn_status ref_arm_max_pool_s8(const cmsis_nn_context *ctx,
+                                        const cmsis_nn_pool_params *params,
+                                        const cmsis_nn_dims *input_dims,
+                                        const int8_t *src,
+                                        const cmsis_nn_dims *filter_dims,
+                                        const cmsis_nn_dims *output_dims,
+                                        int8_t *dst);
+
+#ifndef CONFIG_ARM_NEON
+arm_cmsis_nn_status
+ref_arm_convolve_s8(const cmsis_nn_context *ctx,
+                    const cmsis_nn_conv_params *conv_params,
+                    const cmsis_nn_per_channel_quant_params *quant,
+                    const cmsis_nn_dims *input_dims,
+                    const int8_t *input,
+                    const cmsis_nn_dims *filter_dims,
+                    const int8_t *kernel,
+                    const cmsis_nn_dims *bias_dims,
+                    const int32_t *bias,
+                    const cmsis_nn_dims *output_dims,
+                    int8_t *output);
+
+arm_cmsis_nn_status
+ref_arm_convolve_1x1_s8_fast(const cmsis_nn_context *ctx,
+                             const cmsis_nn_conv_params *conv_params,
+                             const cmsis_nn_per_channel_quant_params *quant,
+                             const cmsis_nn_dims *input_dims,
+                             const int8_t *input,
+                             const cmsis_nn_dims *filter_dims,
+                             const int8_t *kernel,
+                             const cmsis_nn_dims *bias_dims,
+                             const int32_t *bias,
+                             const cmsis_nn_dims *output_dims,
+                             int8_t *output);
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+static int tflm_simd_rand(int min, int max)
+{
+  return min + rand() % (max - min + 1);
+}
+
+static void tflm_simd_fill(FAR int8_t *data, int size)
+{
+  int i;
+
+  for (i = 0; i < size; i++)
+    {
+      data[i] = (int8_t)tflm_simd_rand(-128, 127);
+    }
+}
+
+static int tflm_simd_outsize(int in, int kernel, int stride, int pad,
+                             int dilation)
+{
+  return (in + 2 * pad - dilation * (kernel - 1) - 1) / stride + 1;
+}
+
+static void tflm_simd_activation(FAR cmsis_nn_activation *act)
+{
+  if (tflm_simd_rand(0, 3) == 0)
+    {
+      act->min = tflm_simd_rand(-128, 0);
+      act->max = tflm_simd_rand(0, 127);
+    }
+  else
+    {
+      act->min = -128;
+      act->max = 127;
+    }
+}
+
+/* Per channel requantization as produced by the TFLM converter */
+
+static void tflm_simd_quant(FAR int32_t *multiplier, FAR int32_t *shift,
+                            FAR int32_t *bias, int channels)
+{
+  int i;
+
+  for (i = 0; i < channels; i++)
+    {
+      multiplier[i] = tflm_simd_rand(1 << 30, INT32_MAX);
+      shift[i] = tflm_simd_rand(-12, 1);
+      bias[i] = tflm_simd_rand(-20000, 20000);
+    }
+}
+
+/* Record the outcome of one case.  A case the reference kernel rejects
+ * is outside of what it supports and is skipped.
+ */
+
+static void tflm_simd_check(FAR struct tflm_simd_result_s *result,
+                            FAR const char *name, int n,
+                            arm_cmsis_nn_status ref, FAR const int8_t *out1,
+                            arm_cmsis_nn_status simd, FAR const int8_t *out2,
+                            int size)
+{
+  result->cases++;
+
+  if (ref != ARM_CMSIS_NN_SUCCESS)
+    {
+      result->skipped++;
+    }
+  else if (simd != ARM_CMSIS_NN_SUCCESS || memcmp(out1, out2, size) != 0)
+    {
+      printf("%s: case %d differs from the reference\n", name, n);
+      result->failed++;
+    }
+}
+
+static void tflm_simd_depthwise(FAR struct tflm_simd_result_s *result)
+{
+  cmsis_nn_context ctx;
+  cmsis_nn_dw_conv_params params;
+  cmsis_nn_per_channel_quant_params quant;
+  cmsis_nn_dims input_dims;
+  cmsis_nn_dims filter_dims;
+  cmsis_nn_dims output_dims;
+  cmsis_nn_dims bias_dims;
+  arm_cmsis_nn_status ret1;
+  arm_cmsis_nn_status ret2;
+  FAR int8_t *input;
+  FAR int8_t *kernel;
+  FAR int8_t *out1;
+  FAR int8_t *out2;
+  FAR int32_t *bias;
+  FAR int32_t *multiplier;
+  FAR int32_t *shift;
+  bool is3x3;
+  int insize;
+  int ksize;
+  int osize;
+  int n;
+
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&bias_dims, 0, sizeof(bias_dims));
+
+  for (n = 0; n < TFLM_SIMD_CASES; n++)
+    {
+      is3x3 = n % 3 == 0;
+
+      input_dims.n = is3x3 ? 1 : tflm_simd_rand(1, 2);
+      input_dims.h = tflm_simd_rand(1, 12);
+      input_dims.w = tflm_simd_rand(1, 12);
+      input_dims.c = tflm_simd_rand(1, 80);
+
+      params.input_offset = tflm_simd_rand(-127, 128);
+      params.output_offset = tflm_simd_rand(-128, 127);
+      params.ch_mult = is3x3 ? 1 : tflm_simd_rand(1, 3);
+      params.stride.w = tflm_simd_rand(1, 3);
+      params.stride.h = tflm_simd_rand(1, 3);
+      params.dilation.w = is3x3 ? 1 : tflm_simd_rand(1, 2);
+      params.dilation.h = is3x3 ? 1 : tflm_simd_rand(1, 2);
+      tflm_simd_activation(&params.activation);
+
+      filter_dims.n = 1;
+      filter_dims.h = is3x3 ? 3 : tflm_simd_rand(1, 5);
+      filter_dims.w = is3x3 ? 3 : tflm_simd_rand(1, 5);
+      params.padding.w = tflm_simd_rand(0, is3x3 ? 1 : filter_dims.w - 1);
+      params.padding.h = tflm_simd_rand(0, filter_dims.h - 1);
+
+      output_dims.n = input_dims.n;
+      output_dims.h = tflm_simd_outsize(input_dims.h, filter_dims.h,
+                                        params.stride.h, params.padding.h,
+                                        params.dilation.h);
+      output_dims.w = tflm_simd_outsize(input_dims.w, filter_dims.w,
+                                        params.stride.w, params.padding.w,
+                                        params.dilation.w);
+      output_dims.c = input_dims.c * params.ch_mult;
+      filter_dims.c = output_dims.c;
+
+      if (output_dims.h < 1 || output_dims.w < 1)
+        {
+          continue;
+        }
+
+      insize = input_dims.n * input_dims.h * input_dims.w * input_dims.c;
+      ksize = filter_dims.h * filter_dims.w * filter_dims.c;
+      osize = output_dims.n * output_dims.h * output_dims.w *
+              output_dims.c;
+
+      input = malloc(insize);
+      kernel = malloc(ksize);
+      out1 = malloc(osize);
+      out2 = malloc(osize);
+      bias = malloc(output_dims.c * sizeof(int32_t));
+      multiplier = malloc(output_dims.c * sizeof(int32_t));
+      shift = malloc(output_dims.c * sizeof(int32_t));
+
+      if (input && kernel && out1 && out2 && bias && multiplier && shift)
+        {
+          tflm_simd_fill(input, insize);
+          tflm_simd_fill(kernel, ksize);
+          tflm_simd_quant(multiplier, shift, bias, output_dims.c);
+          quant.multiplier = multiplier;
+          quant.shift = shift;
+
+          if (is3x3)
+            {
+              ret1 = ref_arm_depthwise_conv_3x3_s8(&ctx, &params, &quant,
+                                                   &input_dims, input,
+                                                   &filter_dims, kernel,
+                                                   &bias_dims, bias,
+                                                   &output_dims, out1);
+              ret2 = arm_depthwise_conv_3x3_s8(&ctx, &params, &quant,
+                                               &input_dims, input,
+                                               &filter_dims, kernel,
+                                               &bias_dims, bias,
+                                               &output_dims, out2);
+            }
+          else
+            {
+              ret1 = ref_arm_depthwise_conv_s8(&ctx, &params, &quant,
+                                               &input_dims, input,
+                                               &filter_dims, kernel,
+                                               &bias_dims, bias,
+                                               &output_dims, out1);
+              ret2 = arm_depthwise_conv_s8(&ctx, &params, &quant,
+                                           &input_dims, input,
+                                           &filter_dims, kernel,
+                                           &bias_dims, bias,
+                                           &output_dims, out2);
+            }
+
+          tflm_simd_check(result, is3x3 ? "depthwise_conv_3x3_s8" :
+                          "depthwise_conv_s8", n, ret1, out1, ret2, out2,
+                          osize);
+        }
+
+      free(input);
+      free(kernel);
+      free(out1);
+      free(out2);
+      free(bias);
+      free(multiplier);
+      free(shift);
+    }
+}
+
+static void tflm_simd_fully_connected(FAR struct tflm_simd_result_s *result)
+{
+  cmsis_nn_context ctx;
+  cmsis_nn_fc_params params;
+  cmsis_nn_per_tensor_quant_params quant;
+  cmsis_nn_dims input_dims;
+  cmsis_nn_dims filter_dims;
+  cmsis_nn_dims output_dims;
+  cmsis_nn_dims bias_dims;
+  arm_cmsis_nn_status ret1;
+  arm_cmsis_nn_status ret2;
+  FAR int8_t *input;
+  FAR int8_t *kernel;
+  FAR int8_t *out1;
+  FAR int8_t *out2;
+  FAR int32_t *bias;
+  int batches;
+  int depth;
+  int outputs;
+  int n;
+  int i;
+
+  memset(&ctx, 0, sizeof(ctx));
+  memset(&bias_dims, 0, sizeof(bias_dims));
+
+  for (n = 0; n < TFLM_SIMD_CASES; n++)
+    {
+      batches = tflm_simd_rand(1, 3);
+      depth = tflm_simd_rand(1, 700);
+      outputs = tflm_simd_rand(1, 40);
+
+      params.input_offset = tflm_simd_rand(-127, 128);
+      params.filter_offset = 0;
+      params.output_offset = tflm_simd_rand(-128, 127);
+      tflm_simd_activation(&params.activation);
+      quant.multiplier = tflm_simd_rand(1 << 30, INT32_MAX);
+      quant.shift = tflm_simd_rand(-14, 0);
+
+      input_dims.n = batches;
+      input_dims.h = 1;
+      input_dims.w = 1;
+      input_dims.c = depth;
+      filter_dims.n = depth;
+      filter_dims.h = 1;
+      filter_dims.w = 1;
+      filter_dims.c = outputs;
+      output_dims.n = batches;
+      output_dims.h = 1;
+      output_dims.w = 1;
+      output_dims.c = outputs;
+
+      input = malloc(batches * depth);
+      kernel = malloc(depth * outputs);
+      out1 = malloc(batches * outputs);
+      out2 = malloc(batches * outputs);
+      bias = malloc(outputs * sizeof(int32_t));
+
+      if (input && kernel && out1 && out2 && bias)
+        {
+          tflm_simd_fill(input, batches * depth);
+          tflm_simd_fill(kernel, depth * outputs);
+          for (i = 0; i < outputs; i++)
+            {
+              bias[i] = tflm_simd_rand(-50000, 50000);
+            }
+
+          ret1 = ref_arm_fully_connected_s8(&ctx, &params, &quant,
+                                            &input_dims, input,
+                                            &filter_dims, kernel,
+                                            &bias_dims, n & 1 ? bias : NULL,
+                                            &output_dims, out1);
+          ret2 = arm_fully_connected_s8(&ctx, &params, &quant,
+                                        &input_dims, input,
+                                        &filter_dims, kernel,
+                                        &bias_dims, n & 1 ? bias : NULL,
+                                        &output_dims, out2);
+
+          tflm_simd_check(result, "fully_connected_s8", n, ret1, out1,
+                          ret2, out2, batches * outputs);
+        }
+
+      free(input);
+      free(kernel);
+      free(out1);
+      free(out2);
+      free(bias);
+    }
+}
+
+static void tflm_simd_pool(FAR struct tflm_simd_result_s *result)
+{
+  cmsis_nn_context ctx;
+  cmsis_nn_pool_params params;
+  cmsis_nn_dims input_dims;
+  cmsis_nn_dims filter_dims;
+  cmsis_nn_dims output_dims;
+  arm_cmsis_nn_status ret1;
+  arm_cmsis_nn_status ret2;
+  FAR int8_t *input;
+  FAR int8_t *out1;
+  FAR int8_t *out2;
+  FAR void *buf;
+  bool avg;
+  int insize;
+  int osize;
+  int n;
+
+  for (n = 0; n < TFLM_SIMD_CASES; n++)
+    {
+      avg = n & 1;
+
+      input_dims.n = tflm_simd_rand(1, 2);
+      input_dims.h = tflm_simd_rand(1, 14);
+      input_dims.w = tflm_simd_rand(1, 14);
+      input_dims.c = tflm_simd_rand(1, 150);
+
+      filter_dims.n = 1;
+      filter_dims.h = tflm_simd_rand(1, 4);
+      filter_dims.w = tflm_simd_rand(1, 4);
+      filter_dims.c = 1;
+
+      params.stride.w = tflm_simd_rand(1, 3);
+      params.stride.h = tflm_simd_rand(1, 3);
+      params.padding.w = tflm_simd_rand(0, filter_dims.w - 1);
+      params.padding.h = tflm_simd_rand(0, filter_dims.h - 1);
+      tflm_simd_activation(&params.activation);
+
+      output_dims.n = input_dims.n;
+      output_dims.h = tflm_simd_outsize(input_dims.h, filter_dims.h,
+                                        params.stride.h, params.padding.h,
+                                        1);
+      output_dims.w = tflm_simd_outsize(input_dims.w, filter_dims.w,
+                                        params.stride.w, params.padding.w,
+                                        1);
+      output_dims.c = input_dims.c;
+
+      if (output_dims.h < 1 || output_dims.w < 1)
+        {
+          continue;
+        }
+
+      insize = input_dims.n * input_dims.h * input_dims.w * input_dims.c;
+      osize = output_dims.n * output_dims.h * output_dims.w *
+              output_dims.c;
+
+      ctx.size = avg ? arm_avgpool_s8_get_buffer_size(output_dims.w,
+                                                      input_dims.c) : 0;
+      buf = malloc(ctx.size + 1);
+      ctx.buf = buf;
+
+      input = malloc(insize);
+      out1 = malloc(osize);
+      out2 = malloc(osize);
+
+      if (input && out1 && out2 && buf)
+        {
+          tflm_simd_fill(input, insize);
+
+          if (avg)
+            {
+              ret1 = ref_arm_avgpool_s8(&ctx, &params, &input_dims, input,
+                                        &filter_dims, &output_dims, out1);
+              ret2 = arm_avgpool_s8(&ctx, &params, &input_dims, input,
+                                    &filter_dims, &output_dims, out2);
+            }
+          else
+            {
+              ret1 = ref_arm_max_pool_s8(&ctx, &params, &input_dims, input,
+                                         &filter_dims, &output_dims, out1);
+              ret2 = arm_max_pool_s8(&ctx, &params, &input_dims, input,
+                                     &filter_dims, &output_dims, out2);
+            }
+
+          tflm_simd_check(result, avg ? "avgpool_s8" : "max_pool_s8", n,
+                          ret1, out1, ret2, out2, osize);
+        }
+
+      free(input);
+      free(out1);
+      free(out2);
+      free(buf);
+    }
+}
+
+#ifndef CONFIG_ARM_NEON
+static void tflm_simd_convolve(FAR struct tflm_simd_result_s *result)
+{
+  cmsis_nn_context ctx;
+  cmsis_nn_conv_params params;
+  cmsis_nn_per_channel_quant_params quant;
+  cmsis_nn_dims input_dims;
+  cmsis_nn_dims filter_dims;
+  cmsis_nn_dims output_dims;
+  cmsis_nn_dims bias_dims;
+  arm_cmsis_nn_status ret1;
+  arm_cmsis_nn_status ret2;
+  FAR int8_t *input;
+  FAR int8_t *kernel;
+  FAR int8_t *out1;
+  FAR int8_t *out2;
+  FAR int32_t *bias;
+  FAR int32_t *multiplier;
+  FAR int32_t *shift;
+  FAR void *buf;
+  bool is1x1;
+  int insize;
+  int ksize;
+  int osize;
+  int n;
+
+  memset(&bias_dims, 0, sizeof(bias_dims));
+
+  for (n = 0; n < TFLM_SIMD_CASES; n++)
+    {
+      is1x1 = n % 4 == 0;
+
+      input_dims.n = tflm_simd_rand(1, 2);
+      input_dims.h = tflm_simd_rand(1, 10);
+      input_dims.w = tflm_simd_rand(1, 10);
+      input_dims.c = is1x1 ? 4 * tflm_simd_rand(1, 16) :
+                     tflm_simd_rand(1, 40);
+
+      params.input_offset = tflm_simd_rand(-127, 128);
+      params.output_offset = tflm_simd_rand(-128, 127);
+      params.stride.w = is1x1 ? 1 : tflm_simd_rand(1, 2);
+      params.stride.h = is1x1 ? 1 : tflm_simd_rand(1, 2);
+      params.dilation.w = 1;
+      params.dilation.h = 1;
+      tflm_simd_activation(&params.activation);
+
+      filter_dims.n = tflm_simd_rand(1, 40);
+      filter_dims.h = is1x1 ? 1 : tflm_simd_rand(1, 5);
+      filter_dims.w = is1x1 ? 1 : tflm_simd_rand(1, 5);
+      filter_dims.c = input_dims.c;
+      params.padding.w = is1x1 ? 0 : tflm_simd_rand(0, filter_dims.w - 1);
+      params.padding.h = is1x1 ? 0 : tflm_simd_rand(0, filter_dims.h - 1);
+
+      output_dims.n = input_dims.n;
+      output_dims.h = tflm_simd_outsize(input_dims.h, filter_dims.h,
+                                        params.stride.h, params.padding.h,
+                                        1);
+      output_dims.w = tflm_simd_outsize(input_dims.w, filter_dims.w,
+                                        params.stride.w, params.padding.w,
+                                        1);
+      output_dims.c = filter_dims.n;
+
+      if (output_dims.h < 1 || output_dims.w < 1)
+        {
+          continue;
+        }
+
+      insize = input_dims.n * input_dims.h * input_dims.w * input_dims.c;
+      ksize = filter_dims.n * filter_dims.h * filter_dims.w * filter_dims.c;
+      osize = output_dims.n * output_dims.h * output_dims.w *
+              output_dims.c;
+
+      ctx.size = is1x1 ?
+                 arm_convolve_1x1_s8_fast_get_buffer_size(&input_dims) :
+                 arm_convolve_s8_get_buffer_size(&input_dims, &filter_dims);
+      buf = malloc(ctx.size + 1);
+      ctx.buf = buf;
+
+      input = malloc(insize);
+      kernel = malloc(ksize);
+      out1 = malloc(osize);
+      out2 = malloc(osize);
+      bias = malloc(output_dims.c * sizeof(int32_t));
+      multiplier = malloc(output_dims.c * sizeof(int32_t));
+      shift = malloc(output_dims.c * sizeof(int32_t));
+
+      if (input && kernel && out1 && out2 && bias && multiplier && shift &&
+          buf)
+        {
+          tflm_simd_fill(input, insize);
+          tflm_simd_fill(kernel, ksize);
+          tflm_simd_quant(multiplier, shift, bias, output_dims.c);
+          quant.multiplier = multiplier;
+          quant.shift = shift;
+
+          if (is1x1)
+            {
+              ret1 = ref_arm_convolve_1x1_s8_fast(&ctx, &params, &quant,
+                                                  &input_dims, input,
+                                                  &filter_dims, kernel,
+                                                  &bias_dims, bias,
+                                                  &output_dims, out1);
+              ret2 = arm_convolve_1x1_s8_fast(&ctx, &params, &quant,
+                                              &input_dims, input,
+                                              &filter_dims, kernel,
+                                              &bias_dims, bias,
+                                              &output_dims, out2);
+            }
+          else
+            {
+              ret1 = ref_arm_convolve_s8(&ctx, &params, &quant,
+                                         &input_dims, input,
+                                         &filter_dims, kernel,
+                                         &bias_dims, bias,
+                                         &output_dims, out1);
+              ret2 = arm_convolve_s8(&ctx, &params, &quant,
+                                     &input_dims, input,
+                                     &filter_dims, kernel,
+                                     &bias_dims, bias,
+                                     &output_dims, out2);
+            }
+
+          tflm_simd_check(result, is1x1 ? "convolve_1x1_s8_fast" :
+                          "convolve_s8", n, ret1, out1, ret2, out2, osize);
+        }
+
+      free(input);
+      free(kernel);
+      free(out1);
+      free(out2);
+      free(bias);
+      free(multiplier);
+      free(shift);
+      free(buf);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * tflm_simd_test_main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  struct tflm_simd_result_s result;
+
+  memset(&result, 0, sizeof(result));
+  srand(argc > 1 ? strtoul(argv[1], NULL, 0) : 1);
+
+  tflm_simd_depthwise(&result);
+  tflm_simd_fully_connected(&result);
+  tflm_simd_pool(&result);
+#ifndef CONFIG_ARM_NEON
+  tflm_simd_convolve(&result);
+#endif
+
+  printf("tflm_simd_test: %d cases, %d skipped, %d failed\n",
+         result.cases, result.skipped, result.failed);
+  return result.failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * apps/testing/nxplayer_prefetch/nxplayer_prefetch_test.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <nuttx/audio/audio.h>
+
+#include "system/nxplayer.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define PREFETCH_TEST_RING     4096
+#define PREFETCH_TEST_APB      512
+#define PREFETCH_TEST_STALL    256
+
+/* The prefetch bounds its waits to 100 ms, allow for a slow target */
+
+#define PREFETCH_TEST_MAXMSEC  500
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Stands in for the playthread: refills a buffer until asked to stop,
+ * like the message loop does between two messages.
+ */
+
+struct prefetch_player_s
+{
+  FAR struct nxplayer_prefetch_s *pf;
+  FAR struct ap_buffer_s *apb;
+  volatile bool stop;
+  int nagain;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: prefetch_msec
+ ****************************************************************************/
+
+static uint32_t prefetch_msec(FAR const struct timespec *start)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - start->tv_sec) * 1000 +
+         (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+/****************************************************************************
+ * Name: prefetch_check
+ ****************************************************************************/
+
+static bool prefetch_check(bool ok, FAR const char *what)
+{
+  printf("%s: %s\n", ok ? "PASS" : "FAIL", what);
+  return ok;
+}
+
+/****************************************************************************
+ * Name: prefetch_player
+ ****************************************************************************/
+
+static FAR void *prefetch_player(FAR void *arg)
+{
+  FAR struct prefetch_player_s *player = arg;
+
+  while (!player->stop)
+    {
+      if (nxplayer_prefetch_fill(player->pf, player->apb) == -EAGAIN)
+        {
+          player->nagain++;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: main
+ ****************************************************************************/
+
+int main(int argc, FAR char *argv[])
+{
+  FAR struct nxplayer_prefetch_s *pf;
+  struct prefetch_player_s player;
+  struct ap_buffer_s apb;
+  struct timespec start;
+  pthread_t tid;
+  uint8_t data[PREFETCH_TEST_APB];
+  uint8_t samp[PREFETCH_TEST_APB];
+  bool ok = true;
+  int fds[2];
+  int ret;
+  int i;
+
+  for (i = 0; i < PREFETCH_TEST_APB; i++)
+    {
+      data[i] = (uint8_t)(i * 7 + 3);
+    }
+
+  if (pipe(fds) < 0)
+    {
+      printf("ERROR: pipe failed: %d\n", errno);
+      return EXIT_FAILURE;
+    }
+
+  pf = nxplayer_prefetch_create(fds[0], PREFETCH_TEST_RING);
+  if (pf == NULL)
+    {
+      printf("ERROR: nxplayer_prefetch_create failed\n");
+      close(fds[1]);
+      close(fds[0]);
+      return EXIT_FAILURE;
+    }
+
+  memset(&apb, 0, sizeof(apb));
+  apb.samp      = samp;
+  apb.nmaxbytes = PREFETCH_TEST_APB;
+
+  /* Some data, then the stream stalls: a short buffer, not the end */
+
+  write(fds[1], data, PREFETCH_TEST_STALL);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = nxplayer_prefetch_fill(pf, &apb);
+  ok &= prefetch_check(ret == OK && apb.nbytes == PREFETCH_TEST_STALL &&
+                       (apb.flags & AUDIO_APB_FINAL) == 0 &&
+                       memcmp(samp, data, PREFETCH_TEST_STALL) == 0 &&
+                       prefetch_msec(&start) < PREFETCH_TEST_MAXMSEC,
+                       "short buffer when the stream stalls part way");
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  ret = nxplayer_prefetch_fill(pf, &apb);
+  ok &= prefetch_check(ret == -EAGAIN && apb.nbytes == 0 &&
+                       prefetch_msec(&start) < PREFETCH_TEST_MAXMSEC,
+                       "-EAGAIN when the stream stays stalled");
+
+  /* Stop during the stall: the player must still see the request */
+
+  memset(&player, 0, sizeof(player));
+  player.pf  = pf;
+  player.apb = &apb;
+
+  ret = pthread_create(&tid, NULL, prefetch_player, &player);
+  if (ret != 0)
+    {
+      printf("ERROR: pthread_create failed: %d\n", ret);
+      ok = false;
+    }
+  else
+    {
+      usleep(300 * 1000);
+      clock_gettime(CLOCK_MONOTONIC, &start);
+      player.stop = true;
+      pthread_join(tid, NULL);
+      ok &= prefetch_check(player.nagain > 0 &&
+                           prefetch_msec(&start) < PREFETCH_TEST_MAXMSEC,
+                           "stop is serviced while the stream stalls");
+    }
+
+  /* The stream resumes where it stalled */
+
+  write(fds[1], data, PREFETCH_TEST_APB);
+  ret = nxplayer_prefetch_fill(pf, &apb);
+  ok &= prefetch_check(ret == OK && apb.nbytes == PREFETCH_TEST_APB &&
+                       memcmp(samp, data, PREFETCH_TEST_APB) == 0,
+                       "data after the stall is intact");
+
+  /* The end of the stream is still final */
+
+  write(fds[1], data, PREFETCH_TEST_STALL);
+  close(fds[1]);
+  ret = nxplayer_prefetch_fill(pf, &apb);
+  ok &= prefetch_check(ret == -ENODATA &&
+                       apb.nbytes == PREFETCH_TEST_STALL &&
+                       (apb.flags & AUDIO_APB_FINAL) != 0,
+                       "final buffer at the end of the stream");
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  nxplayer_prefetch_destroy(pf);
+  ok &= prefetch_check(prefetch_msec(&start) < PREFETCH_TEST_MAXMSEC,
+                       "destroy returns promptly");
+
+  close(fds[0]);
+
+  printf("nxplayer_prefetch_test: %s\n", ok ? "PASSED" : "FAILED");
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -84,6 +84,9 @@ execute_process(
   OUTPUT_STRIP_TRAILING_WHITESPACE
   OUTPUT_VARIABLE WCC_COMPILER_RT_LIB)
 
+# Installs AoT images in the layout of the iwasm AOT cache
+set(WAMR_CACHE_TOOL ${CMAKE_CURRENT_LIST_DIR}/wamr_cache.py)
+
 # ~~~
 # Function "wasm_add_application" to add a WebAssembly application to the
 # build system.
@@ -330,6 +333,16 @@ function(wasm_add_application)
       if(NOT APP_INSTALL_NAME)
         set(APP_INSTALL_NAME ${APP_NAME}.xip)
       endif()
+    elseif(CONFIG_INTERPRETERS_WAMR_AOT_CACHE)
+      # generate an AoT image for the iwasm AOT cache, named by the hash of
+      # the installed bytecode
+      add_custom_target(
+        ${APP_NAME}_AOT_CACHE ALL
+        COMMAND ${WRC} ${RCFLAGS} -o ${APP_NAME}.aot ${APP_NAME}.wasm
+        COMMAND python3 ${WAMR_CACHE_TOOL} install ${APP_NAME}.wasm
+                ${APP_NAME}.aot ${TOPBINDIR}/wasm/cache
+        DEPENDS ${APP_NAME}_OPT
+        COMMENT "Wamrc Generate AoT cache: ${APP_NAME}.aot")
     endif()
   endif()
 
@@ -0,0 +1,71 @@
+#!/usr/bin/env python3
+############################################################################
+# apps/tools/Wasm/wamr_cache.py
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed to the Apache Software Foundation (ASF) under one or more
+# contributor license agreements.  See the NOTICE file distributed with
+# this work for additional information regarding copyright ownership.  The
+# ASF licenses this file to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance with the
+# License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+# WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+# License for the specific language governing permissions and limitations
+# under the License.
+#
+############################################################################
+"""Store AOT images in the WAMR AOT cache layout
+
+iwasm looks an AOT image up by the 64-bit FNV-1a hash of the bytecode it
+is asked to run (see interpreters/wamr/wamr_aot_cache.c), so the image
+compiled from foo.wasm is installed as <hash>.aot.
+"""
+
+import argparse
+import os
+import shutil
+
+FNV_OFFSET = 0xCBF29CE484222325
+FNV_PRIME = 0x00000100000001B3
+
+
+def cache_key(path: str) -> str:
+    """Return the cache key of the bytecode module at path."""
+    h = FNV_OFFSET
+    with open(path, "rb") as f:
+        for byte in f.read():
+            h = ((h ^ byte) * FNV_PRIME) & 0xFFFFFFFFFFFFFFFF
+    return "%016x" % h
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    key = sub.add_parser("key", help="print the cache key of a module")
+    key.add_argument("wasm", help="bytecode module")
+
+    install = sub.add_parser("install", help="install an image in a cache")
+    install.add_argument("wasm", help="bytecode module the image was built from")
+    install.add_argument("aot", help="AOT image compiled by wamrc")
+    install.add_argument("cachedir", help="cache directory")
+
+    args = parser.parse_args()
+
+    if args.command == "key":
+        print(cache_key(args.wasm))
+    else:
+        os.makedirs(args.cachedir, exist_ok=True)
+        shutil.copyfile(
+            args.aot, os.path.join(args.cachedir, cache_key(args.wasm) + ".aot")
+        )
+
+
+if __name__ == "__main__":
+    main()